@@ -9,6 +9,7 @@ static int test_fail = 0;
 
 void test_irr_array();
 void test_irr_string();
+void test_irr_vertex();
 
 static video::E_DRIVER_TYPE chooseDriver(core::stringc arg_)
 {
@@ -40,6 +41,7 @@ void run_unit_tests() {
 	try {
 		test_irr_array();
 		test_irr_string();
+		test_irr_vertex();
 	} catch (const std::exception &e) {
 		std::cerr << e.what() << std::endl;
 		test_fail++;
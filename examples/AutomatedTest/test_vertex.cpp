@@ -0,0 +1,105 @@
+#include <S3DVertex.h>
+#include <SCompactMeshBuffer.h>
+#include <CMeshBuffer.h>
+#include <SSkinMeshBuffer.h>
+#include "test_helper.h"
+
+using namespace irr;
+using core::vector2df;
+using core::vector3df;
+using video::S3DVertexCompact;
+
+static void test_compact_size() {
+	UASSERTEQ(sizeof(S3DVertexCompact), 20);
+	UASSERTEQ(video::getVertexPitchFromType(video::EVT_COMPACT), 20);
+}
+
+static void test_compact_roundtrip() {
+	const vector3df normals[] = {
+		{0, 0, 1}, {0, 0, -1}, {1, 0, 0}, {0, -1, 0},
+		{1, 1, 1}, {-1, 2, -3}, {0.3f, -0.7f, -0.2f},
+	};
+	for (const vector3df &n : normals) {
+		S3DVertexCompact v(vector3df(-1.f, 0.5f, 1.f), n, 0xff102030, vector2df(0.25f, 1.f));
+		const vector3df expected = vector3df(n).normalize();
+		UASSERT(v.getNormal().equals(expected, 1e-3f));
+		UASSERT(v.getPosition().equals(vector3df(-1.f, 0.5f, 1.f), 1e-4f));
+		UASSERT(v.getTCoords().equals(vector2df(0.25f, 1.f), 1e-4f));
+		UASSERTEQ(v.Color.color, 0xff102030);
+	}
+
+	// out of range values are clamped
+	S3DVertexCompact v(vector3df(2.f, -3.f, 0.f), vector3df(), 0, vector2df(-1.f, 2.f));
+	UASSERT(v.getPosition().equals(vector3df(1.f, -1.f, 0.f)));
+	UASSERT(v.getTCoords().equals(vector2df(0.f, 1.f)));
+}
+
+static void test_compact_append() {
+	scene::SCompactMeshBuffer compact;
+	compact.setPositionRange(core::aabbox3df(0, 0, 0, 1, 1, 1));
+	compact.Vertices.push_back(S3DVertexCompact(compact.encodePosition(vector3df(1, 1, 1)),
+		vector3df(0, 1, 0), 0xff00ff00, vector2df(0.5f, 0.5f)));
+
+	// 32 bit indices, positions outside of the range of the compact buffer
+	scene::SMeshBufferLightMap other;
+	other.Vertices.push_back(video::S3DVertex2TCoords(vector3df(-2, 0, 4), vector3df(1, 0, 0),
+		0xffff0000, vector2df(0, 1), vector2df()));
+	other.Vertices.push_back(video::S3DVertex2TCoords(vector3df(3, 5, 0), vector3df(0, 0, -1),
+		0xff0000ff, vector2df(1, 0), vector2df()));
+	other.Indices.push_back(1);
+	other.Indices.push_back(0);
+
+	compact.append(&other);
+	UASSERTEQ(compact.getVertexCount(), 3);
+	UASSERTEQ(compact.getIndexCount(), 2);
+	UASSERTEQ(compact.getIndices()[0], 2);
+	UASSERTEQ(compact.getIndices()[1], 1);
+
+	// the old vertex is quantized again for the wider range
+	const f32 tolerance = 1e-3f;
+	UASSERT(compact.getPosition(0).equals(vector3df(1, 1, 1), tolerance));
+	UASSERT(compact.getPosition(1).equals(vector3df(-2, 0, 4), tolerance));
+	UASSERT(compact.getPosition(2).equals(vector3df(3, 5, 0), tolerance));
+	UASSERT(compact.getNormal(2).equals(vector3df(0, 0, -1), tolerance));
+	UASSERT(compact.getTCoords(1).equals(vector2df(0, 1), tolerance));
+	UASSERTEQ(compact.Vertices[2].Color.color, 0xff0000ff);
+	UASSERT(compact.getBoundingBox().MinEdge.equals(vector3df(-2, 0, 0), tolerance));
+}
+
+static void test_compact_setters() {
+	scene::SCompactMeshBuffer compact;
+	compact.setPositionRange(core::aabbox3df(-4, -4, -4, 4, 4, 4));
+	compact.Vertices.set_used(1);
+
+	scene::IMeshBuffer *buffer = &compact;
+	buffer->setPosition(0, vector3df(3, -2, 1));
+	buffer->setNormal(0, vector3df(0, 0, -2));
+	buffer->setTCoords(0, vector2df(0.75f, 0.25f));
+	UASSERT(buffer->getPosition(0).equals(vector3df(3, -2, 1), 1e-3f));
+	UASSERT(buffer->getNormal(0).equals(vector3df(0, 0, -1), 1e-3f));
+	UASSERT(buffer->getTCoords(0).equals(vector2df(0.75f, 0.25f), 1e-4f));
+}
+
+static void test_skin_compact() {
+	scene::SSkinMeshBuffer buffer(video::EVT_2TCOORDS);
+	buffer.Vertices_2TCoords.push_back(video::S3DVertex2TCoords(
+		vector3df(0, 0, 0), vector3df(0, 1, 0), video::SColor(0xffffffff),
+		vector2df(0.5f, 0.5f), vector2df(0.5f, 0.5f)));
+
+	// shaders may read the second set, so it is only dropped on request
+	buffer.compact();
+	UASSERTEQ(buffer.getVertexType(), video::EVT_2TCOORDS);
+	buffer.compact(true);
+	UASSERTEQ(buffer.getVertexType(), video::EVT_STANDARD);
+	UASSERTEQ(buffer.getVertexCount(), 1);
+}
+
+void test_irr_vertex()
+{
+	test_compact_size();
+	test_compact_roundtrip();
+	test_compact_append();
+	test_compact_setters();
+	test_skin_compact();
+	std::cout << "    test_irr_vertex PASSED" << std::endl;
+}
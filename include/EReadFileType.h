@@ -24,6 +24,15 @@ namespace io
 		//! CLimitReadFile
 		ERFT_LIMIT_READ_FILE = MAKE_IRR_ID('r','l','i','m'),
 
+		//! CMappedReadFile
+		ERFT_MAPPED_READ_FILE = MAKE_IRR_ID('r','m','a','p'),
+
+		//! CInflateReadFile
+		ERFT_INFLATE_READ_FILE = MAKE_IRR_ID('r','i','n','f'),
+
+		//! CReadAheadFile
+		ERFT_READ_AHEAD_FILE = MAKE_IRR_ID('r','a','h','d'),
+
 		//! Unknown type
 		EFIT_UNKNOWN        = MAKE_IRR_ID('u','n','k','n')
 	};
@@ -28,6 +28,8 @@ enum E_FILE_ARCHIVE_TYPE
 	EFAT_ZIP     = MAKE_IRR_ID('Z','I','P', 0),
 
 	//! A gzip archive
+	/** Its single file is inflated while it is read, when it's big ahead
+	on a worker thread, so memory use stays the same for any size. */
 	EFAT_GZIP    = MAKE_IRR_ID('g','z','i','p'),
 
 	//! A virtual directory
@@ -48,6 +50,9 @@ enum E_FILE_ARCHIVE_TYPE
     //! An Android asset file archive
     EFAT_ANDROID_ASSET = MAKE_IRR_ID('A','S','S','E'),
 
+	//! An Irrlicht pack archive, see IFileSystem::writePackArchive
+	EFAT_IRR_PACK = MAKE_IRR_ID('I','P','A','K'),
+
 	//! The type of this archive is unknown
 	EFAT_UNKNOWN = MAKE_IRR_ID('u','n','k','n')
 };
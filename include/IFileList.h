@@ -74,6 +74,19 @@ public:
 	//! Returns the base path of the file list
 	virtual const io::path& getPath() const = 0;
 
+	//! Tells how findFile() compares names
+	/** The file system uses this to index the lists of its archives.
+	Lists which answer it must store the full names of their items
+	with backslashes replaced, lower case if case is ignored and
+	without path if paths are ignored, like the lists created by
+	IFileSystem::createEmptyFileList().
+	\return False if findFile() follows other rules, the list is then
+	searched with findFile(). */
+	virtual bool getNameRules(bool& ignoreCase, bool& ignorePaths) const
+	{
+		return false;
+	}
+
 	//! Add as a file or folder to the list
 	/** \param fullPath The file name including path, from the root of the file list.
 	\param isDirectory True if this is a directory rather than a file.
@@ -7,6 +7,8 @@
 
 #include "IReferenceCounted.h"
 #include "IFileArchive.h"
+#include "irrArray.h"
+#include "IIOStatistics.h"
 
 namespace irr
 {
@@ -19,6 +21,7 @@ namespace io
 
 class IReadFile;
 class IWriteFile;
+class IMemoryWriteFile;
 class IFileList;
 class IAttributes;
 
@@ -32,7 +35,9 @@ class IFileSystem : public virtual IReferenceCounted
 public:
 
 	//! Opens a file for read access.
-	/** \param filename: Name of file to open.
+	/** Files on disk of 64 KiB and more are memory mapped where the
+	platform supports it, see IReadFile::getMappedData().
+	\param filename: Name of file to open.
 	\return Pointer to the created file interface.
 	The returned pointer should be dropped when no longer needed.
 	See IReferenceCounted::drop() for more information. */
@@ -78,6 +83,16 @@ public:
 	*/
 	virtual IWriteFile* createMemoryWriteFile(void* memory, s32 len, const path& fileName, bool deleteMemoryWhenDropped=false) =0;
 
+	//! Creates an IWriteFile which writes into memory growing as needed
+	/** Useful when the size of the written data is not known in
+	advance, e.g. to encode an image into memory.
+	\param fileName The name given to this file, image writers choose
+	the format by its extension.
+	\return Pointer to the created file interface.
+	The returned pointer should be dropped when no longer needed.
+	See IReferenceCounted::drop() for more information. */
+	virtual IMemoryWriteFile* createGrowableMemoryWriteFile(const path& fileName) =0;
+
 
 	//! Opens a file for write access.
 	/** \param filename: Name of file to open.
@@ -99,6 +114,8 @@ public:
 	IArchiveLoader and passing an instance to addArchiveLoader.
 	Irrlicht supports AES-encrypted zip files, and the advanced compression
 	techniques lzma and bzip2.
+	Archives must not be added or removed while textures requested
+	with IVideoDriver::getTexturesAsync() are loading.
 	\param filename: Filename of the archive to add to the file system.
 	\param ignoreCase: If set to true, files in the archive can be accessed without
 	writing all letters in the right case.
@@ -160,7 +177,8 @@ public:
 	//! Removes an archive from the file system.
 	/** This will close the archive and free any file handles, but will not
 	close resources which have already been loaded and are now cached, for
-	example textures and meshes.
+	example textures and meshes. See addFileArchive() for when
+	archives must not be removed.
 	\param index: The index of the archive to remove
 	\return True on success, false on failure */
 	virtual bool removeFileArchive(u32 index) =0;
@@ -226,11 +244,31 @@ public:
 	\result Absolute filename which points to the same file. */
 	virtual path getAbsolutePath(const path& filename) const =0;
 
+	//! Like getAbsolutePath(), but keeps the result for the next calls with the same name
+	/** Those only copy the kept result instead of asking the operating
+	system, so this is meant for names which are looked up over and over,
+	like the ones of assets. The names are forgotten when the working
+	directory is changed with changeWorkingDirectoryTo(). Symbolic links
+	which are changed later are not noticed. Thread safe.
+	\param filename Possibly relative file or directory name to query.
+	\return Absolute filename which points to the same file. */
+	virtual path getCachedAbsolutePath(const path& filename) const =0;
+
+	//! Returns how often the working directory was changed with changeWorkingDirectoryTo()
+	/** Lets caches of relative names notice when those point elsewhere. */
+	virtual u32 getWorkingDirectoryChanges() const =0;
+
 	//! Get the directory a file is located in.
 	/** \param filename: The file to get the directory from.
 	\return String containing the directory of the file. */
 	virtual path getFileDir(const path& filename) const =0;
 
+	//! Like getFileDir(), but returns a part of filename instead of a new string
+	/** \param filename: View of the name, like path::view(). The string
+	it looks at must outlive the result.
+	\return View into filename, or "." if it has no directory. */
+	virtual path_view getFileDirView(path_view filename) const =0;
+
 	//! Get the base part of a filename, i.e. the name without the directory part.
 	/** If no directory is prefixed, the full name is returned.
 	\param filename: The file to get the basename from
@@ -238,6 +276,10 @@ public:
 	after the final '.' is removed as well. */
 	virtual path getFileBasename(const path& filename, bool keepExtension=true) const =0;
 
+	//! Like getFileBasename(), but returns a part of filename instead of a new string
+	/** \return View into filename, see getFileDirView(). */
+	virtual path_view getFileBasenameView(path_view filename, bool keepExtension=true) const =0;
+
 	//! flatten a path and file name for example: "/you/me/../." becomes "/you"
 	virtual path& flattenFilename(path& directory, const path& root="/") const =0;
 
@@ -263,6 +305,44 @@ public:
 	/** \param filename is the string identifying the file which should be tested for existence.
 	\return True if file exists, and false if it does not exist or an error occurred. */
 	virtual bool existFile(const path& filename) const =0;
+
+	//! Starts reading files in the background which will be opened soon
+	/** Useful when the list of files to load is known in advance, so
+	reading them overlaps with decoding. Files are read on worker
+	threads. Entries of archives are read, and inflated, into a cache
+	of 64 MiB at most, and the next createAndOpenFile() for each of them
+	returns a memory file from the cache. The operating system is asked
+	to read other files ahead, or they are read once to get them into
+	its cache. Removing or moving archives empties the cache. Archives
+	must not be added while files are prefetched.
+	\param filenames Names as they will be passed to createAndOpenFile(). */
+	virtual void prefetch(const core::array<path>& filenames) =0;
+
+	//! Writes files into a pack archive
+	/** Pack archives (.ipk) are made to be mapped into memory. Their
+	stored entries are aligned to 4096 bytes, and reading them from a
+	mapped pack only copies memory, while getMappedData() of the opened
+	files gives them without any copy. Packs of all sizes on disk are
+	mapped when they are added with addFileArchive() by name.
+	\param file File to write the archive to. Nothing must have been
+	written to it yet, as offsets in the pack are from the start of the
+	file.
+	\param filenames Files to pack, opened with createAndOpenFile().
+	Their names in the archive are these names with backslashes
+	replaced by slashes.
+	\param compress Deflate files which get clearly smaller by it.
+	Mapping doesn't help with those, as they have to be inflated.
+	\return True on success. */
+	virtual bool writePackArchive(IWriteFile* file, const core::array<path>& filenames, bool compress=false) =0;
+
+	//! Get the counters of file access and of loading
+	/** They count files opened per archive, bytes read from disk,
+	inflating of archive entries, the time spent in image and mesh
+	loaders, and lookups in the texture and mesh caches. The counters
+	are shared by all devices of the process.
+	\return The counters, valid as long as the process runs. Don't
+	delete them. */
+	virtual IIOStatistics* getStatistics() const =0;
 };
 
 
@@ -0,0 +1,61 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_IO_STATISTICS_H_INCLUDED__
+#define __I_IO_STATISTICS_H_INCLUDED__
+
+#include "path.h"
+
+namespace irr
+{
+namespace io
+{
+
+	//! Counters of file access and loading, see IFileSystem::getStatistics()
+	/** Useful to notice when loading got slower, e.g. by logging the JSON
+	dump after start-up. The counters are shared by all file systems of
+	the process and are updated from all threads. Times are in
+	microseconds. */
+	class IIOStatistics
+	{
+	public:
+		//! Get the number of files opened from an archive
+		/** \param archive Name of the archive as returned by
+		IFileArchive::getArchiveName(), or an empty name for files on disk. */
+		virtual u64 getFilesOpened(const path& archive) const = 0;
+
+		//! Get the number of bytes read from files on disk, mapped ones included
+		virtual u64 getBytesRead() const = 0;
+
+		//! Get the number of bytes inflated from compressed archive entries
+		virtual u64 getInflatedBytes() const = 0;
+
+		//! Get the time spent inflating archive entries
+		virtual u64 getInflateTime() const = 0;
+
+		//! Get the time spent in image or mesh loaders
+		/** \param name "image/" or "mesh/" followed by the lower case
+		extension of the loaded files, e.g. "image/png".
+		\param calls Receives the number of loader calls if not 0. */
+		virtual u64 getLoaderTime(const core::stringc& name, u32* calls = 0) const = 0;
+
+		//! Get the number of lookups of a cache
+		/** \param cache "texture" or "mesh"
+		\param hits True for the lookups which found the entry, false for
+		the others. */
+		virtual u64 getCacheLookups(const core::stringc& cache, bool hits) const = 0;
+
+		//! Sets all counters to 0
+		virtual void reset() = 0;
+
+		//! Returns all counters as JSON object
+		virtual core::stringc getJSON() const = 0;
+
+	protected:
+		virtual ~IIOStatistics() {}
+	};
+
+} // end namespace io
+} // end namespace irr
+
+#endif
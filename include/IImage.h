@@ -16,6 +16,22 @@ namespace irr
 namespace video
 {
 
+//! Filters for IImage::copyToScalingFiltered
+enum E_IMAGE_FILTER
+{
+	//! Takes the source pixel closest to the center of the target pixel
+	EIF_NEAREST = 0,
+
+	//! Linear interpolation, a tent filter when scaling down
+	EIF_BILINEAR,
+
+	//! Averages all source pixels covered by a target pixel
+	EIF_BOX,
+
+	//! Windowed sinc with 3 lobes, sharpest result but may ring on hard edges
+	EIF_LANCZOS3
+};
+
 //! Interface for software image data.
 /** Image loaders create these images from files. IVideoDrivers convert
 these images into their (hardware) textures.
@@ -247,6 +263,29 @@ public:
 		return 0;
 	}
 
+	//! Get the size of the mipmaps data in bytes.
+	/** All levels below level 0, down to 1x1. Returns the size needed by
+	setMipMapsData, even if the image has no mipmaps. */
+	u32 getMipMapsDataSize() const
+	{
+		u32 dataSize = 0;
+		u32 width = Size.Width;
+		u32 height = Size.Height;
+
+		while (width > 1 || height > 1)
+		{
+			if (width > 1)
+				width >>= 1;
+
+			if (height > 1)
+				height >>= 1;
+
+			dataSize += getDataSizeFromFormat(Format, width, height);
+		}
+
+		return dataSize;
+	}
+
 	//! Set mipmaps data.
 	/** This method allows you to put custom mipmaps data for
 	image.
@@ -254,9 +293,9 @@ public:
 	\param ownForeignMemory If true, the image will use the data
 	pointer directly and own it afterward. If false, the memory
 	will by copied internally.
-	\param deleteMemory Whether the memory is deallocated upon
-	destruction. */
-	void setMipMapsData(void* data, bool ownForeignMemory)
+	\param deleteMemory Whether the memory is deallocated with
+	delete[] upon destruction, if the image uses the data pointer. */
+	void setMipMapsData(void* data, bool ownForeignMemory, bool deleteMemory = false)
 	{
 		if (data != MipMapsData)
 		{
@@ -273,24 +312,11 @@ public:
 				{
 					MipMapsData = static_cast<u8*>(data);
 
-					DeleteMipMapsMemory = false;
+					DeleteMipMapsMemory = deleteMemory;
 				}
 				else
 				{
-					u32 dataSize = 0;
-					u32 width = Size.Width;
-					u32 height = Size.Height;
-
-					do
-					{
-						if (width > 1)
-							width >>= 1;
-
-						if (height > 1)
-							height >>= 1;
-
-						dataSize += getDataSizeFromFormat(Format, width, height);
-					} while (width != 1 || height != 1);
+					const u32 dataSize = getMipMapsDataSize();
 
 					MipMapsData = new u8[dataSize];
 					memcpy(MipMapsData, data, dataSize);
@@ -346,6 +372,32 @@ public:
 	/**	NOTE: mipmaps are ignored */
 	virtual void copyToScalingBoxFilter(IImage* target, s32 bias = 0, bool blend = false) = 0;
 
+	//! Copies the image into the target, scaling it with a separable filter
+	/**	Rows are converted once and filtered with precomputed weights, big
+	images are split into bands of rows which are scaled in parallel.
+	Colors are filtered with premultiplied alpha, so transparent pixels
+	don't bleed into their neighbours.
+	NOTE: mipmaps are ignored */
+	virtual void copyToScalingFiltered(IImage* target, E_IMAGE_FILTER filter = EIF_BILINEAR) = 0;
+
+	//! Builds all mipmap levels from the image data
+	/** Every level is a 2x2 box filter of the one above, computed with
+	vector instructions and split into bands of rows on worker threads
+	for big images. The result only depends on the pixels and the
+	parameters, so it can be stored with getMipMapsData and
+	getMipMapsDataSize and restored later with setMipMapsData instead of
+	being generated again. Call it before creating a texture from the
+	image, so the driver uploads the levels instead of generating them.
+	\param sRGB Average colors in linear space, for images with sRGB
+	encoded colors. Keeps the levels from getting darker.
+	\param alphaTestRef If greater than 0, the alpha of each level is
+	scaled so the same share of pixels has an alpha above this value
+	(0 to 1) as in level 0. Keeps alpha tested materials like foliage
+	from thinning out in the distance.
+	\param threads Maximum number of threads, 0 to use all cores.
+	\return False if the color format is not supported. */
+	virtual bool generateMipMaps(bool sRGB = false, f32 alphaTestRef = 0.f, u32 threads = 0) = 0;
+
 	//! fills the surface with given color
 	virtual void fill(const SColor &color) =0;
 
@@ -0,0 +1,32 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_MEMORY_WRITE_FILE_H_INCLUDED__
+#define __I_MEMORY_WRITE_FILE_H_INCLUDED__
+
+#include "IWriteFile.h"
+
+namespace irr
+{
+namespace io
+{
+
+	//! Write file which keeps its contents in memory growing as needed
+	/** Create it with IFileSystem::createGrowableMemoryWriteFile(). The
+	contents can be read back with IFileSystem::createMemoryReadFile(). */
+	class IMemoryWriteFile : public IWriteFile
+	{
+	public:
+		//! Get the contents of the file
+		/** \return Pointer to the contents, valid until the next write. */
+		virtual const void* getData() const = 0;
+
+		//! Get the size of the file
+		/** \return Number of bytes up to the furthest position written. */
+		virtual long getSize() const = 0;
+	};
+
+} // end namespace io
+} // end namespace irr
+
+#endif
@@ -8,6 +8,7 @@
 #include "IReferenceCounted.h"
 #include "SMaterial.h"
 #include "aabbox3d.h"
+#include "matrix4.h"
 #include "S3DVertex.h"
 #include "SVertexIndex.h"
 #include "EHardwareBufferFlags.h"
@@ -98,20 +99,54 @@ namespace scene
 		virtual const core::vector3df& getPosition(u32 i) const = 0;
 
 		//! returns position of vertex i
+		/** Writing to it only changes buffers which store full
+		precision vertices, use setPosition() for any buffer. */
 		virtual core::vector3df& getPosition(u32 i) = 0;
 
 		//! returns normal of vertex i
 		virtual const core::vector3df& getNormal(u32 i) const = 0;
 
 		//! returns normal of vertex i
+		/** Writing to it only changes buffers which store full
+		precision vertices, use setNormal() for any buffer. */
 		virtual core::vector3df& getNormal(u32 i) = 0;
 
 		//! returns texture coord of vertex i
 		virtual const core::vector2df& getTCoords(u32 i) const = 0;
 
 		//! returns texture coord of vertex i
+		/** Writing to it only changes buffers which store full
+		precision vertices, use setTCoords() for any buffer. */
 		virtual core::vector2df& getTCoords(u32 i) = 0;
 
+		//! sets position of vertex i
+		virtual void setPosition(u32 i, const core::vector3df& pos)
+		{
+			getPosition(i) = pos;
+		}
+
+		//! sets normal of vertex i
+		virtual void setNormal(u32 i, const core::vector3df& normal)
+		{
+			getNormal(i) = normal;
+		}
+
+		//! sets texture coord of vertex i
+		virtual void setTCoords(u32 i, const core::vector2df& tcoords)
+		{
+			getTCoords(i) = tcoords;
+		}
+
+		//! Get the transformation from stored vertex positions to object space
+		/** Buffers with quantized vertices (video::EVT_COMPACT) store
+		positions relative to a per-buffer scale and offset. The video
+		driver applies this matrix on top of the world transformation.
+		\return Identity matrix for buffers with full precision vertices. */
+		virtual core::matrix4 getVertexPositionTransform() const
+		{
+			return core::IdentityMatrix;
+		}
+
 		//! Append the vertices and indices to the current buffer
 		/** Only works for compatible vertex types.
 		\param vertices Pointer to a vertex array.
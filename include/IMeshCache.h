@@ -127,6 +127,34 @@ namespace scene
 		/** Warning: If you have pointers to meshes that were loaded with ISceneManager::getMesh()
 		and you did not grab them, then they may become invalid. */
 		virtual void clearUnusedMeshes() = 0;
+
+		//! Sets the maximum memory the cached meshes should use.
+		/** When the approximate memory of all cached meshes exceeds the
+		budget, the least recently used meshes which are not referenced
+		anywhere else are removed until the cache fits again. While adding
+		a mesh, that mesh itself is kept even if it does not fit. Lowering
+		the budget with this method applies it right away and may remove
+		any of them, including the mesh added last.
+		Warning: If you have pointers to meshes that were loaded with
+		ISceneManager::getMesh() and you did not grab them, then they may
+		become invalid when another mesh is loaded or the budget is set.
+		\param bytes Budget in bytes, 0 disables the limit (default). */
+		virtual void setMemoryBudget(u64 bytes) = 0;
+
+		//! Returns the memory budget in bytes, 0 if there is no limit.
+		virtual u64 getMemoryBudget() const = 0;
+
+		//! Returns the approximate memory used by all cached meshes.
+		/** Counts vertices, indices and animation data of the meshes at
+		the time they were added to the cache.
+		\return Memory in bytes. */
+		virtual u64 getMemoryUsage() const = 0;
+
+		//! Returns how often getMeshByName() found the requested mesh.
+		virtual u32 getHitCount() const = 0;
+
+		//! Returns how often getMeshByName() did not find the requested mesh.
+		virtual u32 getMissCount() const = 0;
 	};
 
 
@@ -69,6 +69,29 @@ namespace scene
 		IReferenceCounted::drop() for more information. */
 		virtual SMesh* createMeshCopy(IMesh* mesh) const = 0;
 
+		//! Creates a meshbuffer with quantized vertices from a full precision one.
+		/** The result is an SCompactMeshBuffer. Positions are quantized
+		relative to the bounding box of the buffer, normals are octahedral
+		encoded and texture coordinates get 16 bit precision. Second
+		texture coordinates, tangents and binormals are dropped.
+		Custom shaders have to decode the normals, see
+		video::S3DVertexCompact.
+		\param mb Buffer to convert.
+		\return New buffer, or 0 if the buffer has texture coordinates
+		outside of [0,1], 32 bit indices or is compact already. Tiled
+		texture coordinates are not rescaled, a warning is logged for
+		them and the buffer has to be kept at full precision. If you no
+		longer need the buffer, you should call IMeshBuffer::drop(). */
+		virtual IMeshBuffer* createCompactMeshBuffer(const IMeshBuffer* mb) const = 0;
+
+		//! Creates a copy of a mesh with quantized vertices.
+		/** Converts each meshbuffer with createCompactMeshBuffer(),
+		buffers which can't be converted are copied unchanged.
+		\param mesh Mesh to copy.
+		\return Converted mesh. If you no longer need the mesh, you
+		should call SMesh::drop(). */
+		virtual SMesh* createMeshWithCompactVertices(IMesh* mesh) const = 0;
+
 		//! Get amount of polygons in mesh.
 		/** \param mesh Input mesh
 		\return Number of polygons in mesh. */
@@ -141,6 +164,9 @@ protected:
 		{
 			if (!buffer)
 				return true;
+			// quantized vertices can't be passed to vertex manipulators
+			if (buffer->getVertexType() == video::EVT_COMPACT)
+				return false;
 
 			core::aabbox3df bufferbox;
 			for (u32 i=0; i<buffer->getVertexCount(); ++i)
@@ -165,6 +191,8 @@ protected:
 						func(verts[i]);
 					}
 					break;
+				default:
+					break;
 				}
 				if (boundingBoxUpdate)
 				{
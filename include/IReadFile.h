@@ -24,6 +24,27 @@ namespace io
 		\return How many bytes were read. */
 		virtual size_t read(void* buffer, size_t sizeToRead) = 0;
 
+		//! Reads an amount of bytes from a position in the file.
+		/** Does not use or change the read position. Files on disk,
+		memory mapped and memory files and files inside archives
+		implement it so several threads can read from the same file at
+		the same time, as long as nobody calls read() or seek()
+		meanwhile. The default implementation seeks, so it is not
+		thread safe.
+		\param buffer Pointer to buffer where read bytes are written to.
+		\param sizeToRead Amount of bytes to read from the file.
+		\param pos Position in the file to read from.
+		\return How many bytes were read. */
+		virtual size_t readAt(void* buffer, size_t sizeToRead, long pos)
+		{
+			const long oldPos = getPos();
+			if (!seek(pos))
+				return 0;
+			const size_t r = read(buffer, sizeToRead);
+			seek(oldPos);
+			return r;
+		}
+
 		//! Changes position in file
 		/** \param finalPos Destination position in the file.
 		\param relativeMovement If set to true, the position in the file is
@@ -49,6 +70,20 @@ namespace io
 		{
 			return EFIT_UNKNOWN;
 		}
+
+		//! Get direct access to the whole contents of the file
+		/** Files which are memory mapped or in memory anyway, like
+		memory read files and uncompressed entries of mapped archives,
+		return their data here, so loaders can parse it without
+		copying it into a buffer of their own first.
+		\return Pointer to getSize() bytes, independent of the read
+		position and valid as long as the file exists, or 0 if the file
+		has to be read with read(). The data is not followed by a
+		terminating zero. */
+		virtual const void* getMappedData() const
+		{
+			return 0;
+		}
 	};
 
 	//! Internal function, please do not use.
@@ -11,6 +11,7 @@
 #include "EDriverTypes.h"
 #include "path.h"
 #include "matrix4.h"
+#include "irrArray.h"
 
 namespace irr
 {
@@ -97,6 +98,17 @@ enum E_TEXTURE_CREATION_FLAG
 	  */
 	ETCF_AUTO_GENERATE_MIP_MAPS = 0x00000100,
 
+	//! Compress textures loaded from files on the CPU
+	/** Images are compressed to ECF_DXT1 or ECF_DXT5, or to ECF_ETC2_RGB
+	or ECF_ETC2_ARGB on drivers which only support ETC2, depending on their
+	alpha channel. Mipmaps are created on the CPU before, if enabled.
+	Only used for IVideoDriver::getTexture and getTexturesAsync with
+	drivers supporting one of the formats. DXT is only used for power of
+	two sizes. Results are cached on disk when a directory is set with
+	IVideoDriver::setCompressedTextureCacheDirectory.
+	Default is false. */
+	ETCF_COMPRESS_TEXTURES = 0x00000200,
+
 	/** This flag is never used, it only forces the compiler to compile
 	these enumeration values to 32 bit. */
 	ETCF_FORCE_32_BIT_DO_NOT_USE = 0x7fffffff
@@ -180,7 +192,8 @@ public:
 
 	//! constructor
 	ITexture(const io::path& name, E_TEXTURE_TYPE type) : NamedPath(name), DriverType(EDT_NULL), OriginalColorFormat(ECF_UNKNOWN),
-		ColorFormat(ECF_UNKNOWN), Pitch(0), HasMipMaps(false), IsRenderTarget(false), Source(ETS_UNKNOWN), Type(type)
+		ColorFormat(ECF_UNKNOWN), Pitch(0), HasMipMaps(false), IsRenderTarget(false), Source(ETS_UNKNOWN), Type(type),
+		Resident(true), LastUsedFrame(0)
 	{
 	}
 
@@ -311,6 +324,54 @@ public:
 	//! Returns the type of texture
 	E_TEXTURE_TYPE getType() const { return Type; }
 
+	//! Returns the video memory used by the texture, including all mip levels and faces
+	/** \return Estimated size in bytes, 0 while the texture is evicted. */
+	u32 getVideoMemorySize() const
+	{
+		if (!Resident)
+			return 0;
+
+		u32 size = 0;
+		u32 width = Size.Width;
+		u32 height = Size.Height;
+		while (true)
+		{
+			size += IImage::getDataSizeFromFormat(ColorFormat, width, height);
+			if (!HasMipMaps || (width == 1 && height == 1))
+				break;
+			if (width > 1)
+				width >>= 1;
+			if (height > 1)
+				height >>= 1;
+		}
+
+		return Type == ETT_CUBEMAP ? size * 6 : size;
+	}
+
+	//! Returns the system memory used by images the texture keeps, see ETCF_ALLOW_MEMORY_COPY
+	virtual u32 getImageMemorySize() const { return 0; }
+
+	//! Check whether the texture is currently in video memory
+	/** Textures can be evicted by IVideoDriver::setTextureMemoryBudget
+	and are uploaded again when they are used next. */
+	bool isResident() const { return Resident; }
+
+	//! Returns the number of the frame in which the texture was last used for rendering
+	u32 getLastUsedFrame() const { return LastUsedFrame; }
+
+	//! Used internally by the engine when a texture is bound.
+	void updateLastUsedFrame(u32 frame) const { LastUsedFrame = frame; }
+
+	//! Used internally by the engine to free the video memory of the texture.
+	/** \return False if the texture can not be evicted. */
+	virtual bool evict() { return false; }
+
+	//! Used internally by the engine to upload an evicted texture again.
+	/** \param images Images the texture was created from, empty if the
+	texture kept its own copy.
+	\return True if the texture is resident afterwards. */
+	virtual bool restore(const core::array<IImage*>& images) { return false; }
+
 protected:
 
 	//! Helper function, helps to get the desired texture creation format from the flags.
@@ -340,6 +401,8 @@ protected:
 	bool IsRenderTarget;
 	E_TEXTURE_SOURCE Source;
 	E_TEXTURE_TYPE Type;
+	bool Resident;
+	mutable u32 LastUsedFrame;
 };
 
 
@@ -0,0 +1,110 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_TEXTURE_ATLAS_H_INCLUDED__
+#define __I_TEXTURE_ATLAS_H_INCLUDED__
+
+#include "IReferenceCounted.h"
+#include "path.h"
+#include "rect.h"
+#include "vector2d.h"
+
+namespace irr
+{
+namespace scene
+{
+	class IMesh;
+	class IMeshBuffer;
+} // end namespace scene
+
+namespace video
+{
+	class IImage;
+	class ITexture;
+
+	//! Location of an image in a texture atlas
+	struct STextureAtlasEntry
+	{
+		//! Index of the page texture holding the image
+		u32 Page;
+
+		//! Pixels of the image on its page, without the padding
+		core::rect<s32> Rect;
+
+		//! Texture coordinates of Rect on the page texture
+		core::rect<f32> TCoords;
+	};
+
+	//! Packs many small images into a few big textures
+	/** Drawing lots of meshes which each use their own tiny texture
+	costs a texture bind per mesh. Packed into an atlas, the meshes
+	share a handful of page textures, so their materials become equal
+	and can be batched.
+
+	Add all images with addImage(), then call build() once. Images are
+	packed with a skyline bottom-left packer. Every image is surrounded
+	by padding pixels which repeat its border, so filtering does not
+	pick up the neighbours. When ETCF_CREATE_MIP_MAPS is set, the
+	mipmaps of the pages are built from the mipmaps of the single
+	images, with the padding extruded again on every level as long as
+	it is at least one pixel wide.
+
+	Texture coordinates outside [0,1], i.e. wrapping textures, can not
+	be remapped into an atlas. Create an atlas with
+	IVideoDriver::createTextureAtlas(). */
+	class ITextureAtlas : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Adds an image to the atlas
+		/** \param name Name of the image. remapMesh() matches it with
+		the names of the textures used by the mesh buffers, so use the
+		name the texture was loaded with.
+		\param image Image with a format convertible to ECF_A8R8G8B8.
+		It is grabbed until build() is called.
+		\return Handle of the image, or -1 if it can not be added or the
+		atlas is built already. Adding a name twice returns the handle
+		of the first image. */
+		virtual s32 addImage(const io::path& name, IImage* image) = 0;
+
+		//! Returns the handle of an image, or -1 if no image has this name
+		virtual s32 getHandle(const io::path& name) const = 0;
+
+		//! Packs all images and creates the page textures
+		/** Can only be called once.
+		\return False if an image was too big for a page, the other
+		images are packed anyway. */
+		virtual bool build() = 0;
+
+		//! Returns the number of page textures, 0 before build()
+		virtual u32 getPageCount() const = 0;
+
+		//! Returns a page texture
+		/** The textures are named after the atlas with "#" and the
+		page index appended. */
+		virtual ITexture* getPageTexture(u32 page) const = 0;
+
+		//! Returns where an image was packed
+		/** \return The entry, or 0 for invalid handles, before build()
+		and for images which did not fit into a page. */
+		virtual const STextureAtlasEntry* getEntry(s32 handle) const = 0;
+
+		//! Maps texture coordinates of an image into its page
+		virtual core::vector2df remapTCoords(s32 handle, const core::vector2df& tcoords) const = 0;
+
+		//! Remaps the first texture coordinates of a mesh buffer into the atlas
+		/** The texture of the first material layer is replaced by the
+		page texture and the vertices are marked as dirty.
+		\return False if the image is not in the atlas or texture
+		coordinates are outside [0,1], the buffer is not changed then. */
+		virtual bool remapMeshBuffer(scene::IMeshBuffer* buffer, s32 handle) const = 0;
+
+		//! Remaps all mesh buffers whose first texture was added by name
+		/** \return Number of remapped mesh buffers. */
+		virtual u32 remapMesh(scene::IMesh* mesh) const = 0;
+	};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
@@ -18,6 +18,7 @@
 #include "EDriverFeatures.h"
 #include "SExposedVideoData.h"
 #include "SOverrideMaterial.h"
+#include <functional>
 
 namespace irr
 {
@@ -45,6 +46,7 @@ namespace video
 	class IMaterialRenderer;
 	class IGPUProgrammingServices;
 	class IRenderTarget;
+	class ITextureAtlas;
 
 	//! enumeration for geometry transformation states
 	enum E_TRANSFORMATION_STATE
@@ -116,6 +118,39 @@ namespace video
 		0
 	};
 
+	//! Called for every texture requested with IVideoDriver::getTexturesAsync
+	/** \param filename The name the texture was requested with.
+	\param texture The texture, or 0 if it could not be loaded. This
+	pointer should not be dropped. */
+	typedef std::function<void(const io::path& filename, ITexture* texture)> TextureLoadedCallback;
+
+	//! Called for every image written with IVideoDriver::writeImageToFileAsync
+	/** \param filename Name of the written file.
+	\param written True if the image was written successfully. */
+	typedef std::function<void(const io::path& filename, bool written)> ImageWrittenCallback;
+
+	//! Memory used by the textures of a driver, see IVideoDriver::getTextureMemoryStats
+	struct STextureMemoryStats
+	{
+		//! Estimated video memory of all resident textures in bytes
+		u64 VideoMemory;
+
+		//! System memory of images kept by textures in bytes
+		u64 ImageMemory;
+
+		//! Number of textures in video memory
+		u32 ResidentTextures;
+
+		//! Number of textures which are currently evicted
+		u32 EvictedTextures;
+
+		//! Number of evictions since the driver was created
+		u32 Evictions;
+
+		//! Number of evicted textures which were uploaded again
+		u32 Reloads;
+	};
+
 	//! Interface to driver which is able to perform 2d and 3d graphics functions.
 	/** This interface is one of the most important interfaces of
 	the Irrlicht Engine: All rendering and texture manipulation is done with
@@ -246,6 +281,10 @@ namespace video
 		Texture loading can be influenced using the
 		setTextureCreationFlag() method. The texture can be in several
 		imageformats, such as BMP, JPG, TGA, PCX, PNG, and PSD.
+		Repeated calls with the same filename are answered from a
+		hash table without touching the file system, until a texture
+		is added or removed. So a relative filename keeps returning
+		its texture after the working directory changed.
 		\param filename Filename of the texture to be loaded.
 		\return Pointer to the texture, or 0 if the texture
 		could not be loaded. This pointer should not be dropped. See
@@ -264,10 +303,73 @@ namespace video
 		IReferenceCounted::drop() for more information. */
 		virtual ITexture* getTexture(io::IReadFile* file) =0;
 
+		//! Loads textures in the background
+		/** The files are read and decoded on worker threads, the
+		textures are created on the calling thread by
+		uploadAsyncTextures(), which beginScene() calls every frame.
+		Textures which are already loaded, and files which can not
+		be opened, are reported right away. The files are opened
+		on the calling thread, so file archives may be added or
+		removed while loads are pending.
+		\param filenames Filenames of the textures to be loaded.
+		\param callback Called on the rendering thread for every
+		texture, in the order the images finish decoding. */
+		virtual void getTexturesAsync(const core::array<io::path>& filenames,
+			const TextureLoadedCallback& callback) = 0;
+
+		//! Creates the textures for images decoded by getTexturesAsync()
+		/** Called by beginScene() with the default budget. Call it
+		with a bigger budget to load faster, e.g. behind a loading
+		screen.
+		\param timeBudgetMs Stop creating textures once this time is
+		used up. At least one texture is created per call if one is
+		ready.
+		\return Number of textures which are still loading. */
+		virtual u32 uploadAsyncTextures(u32 timeBudgetMs = 2) = 0;
+
+		//! Sets the directory for textures compressed with ETCF_COMPRESS_TEXTURES
+		/** Compressed images and their mipmaps are stored there, named
+		by a hash of the loaded image, and read instead of compressing
+		the same image again. Set it before loading textures.
+		\param directory An existing directory, or an empty path to
+		disable the cache, which is the default. */
+		virtual void setCompressedTextureCacheDirectory(const io::path& directory) = 0;
+
+		//! Creates an atlas which packs many small images into few textures
+		/** \param name Name of the atlas, the page textures are named
+		after it.
+		\param pageSize Maximal size of a page texture. Pages which are
+		not filled are shrunk to the next power of two.
+		\param padding Pixels around every image which repeat its
+		border. Use a power of two to keep more mip levels free of
+		bleeding.
+		\return The atlas. This pointer should be dropped. See
+		IReferenceCounted::drop() for more information. */
+		virtual ITextureAtlas* createTextureAtlas(const io::path& name,
+			const core::dimension2d<u32>& pageSize = core::dimension2d<u32>(2048, 2048), u32 padding = 2) = 0;
+
 		//! Returns amount of textures currently loaded
 		/** \return Amount of textures currently loaded */
 		virtual u32 getTextureCount() const = 0;
 
+		//! Limits the video memory used by textures
+		/** While the textures use more than the budget, beginScene()
+		evicts the least recently used ones from video memory. They
+		stay valid and are uploaded again the next time they are bound,
+		from their kept image (ETCF_ALLOW_MEMORY_COPY) or by reading
+		the file they were loaded from once more. Render targets and
+		textures created from images without a kept copy are never
+		evicted.
+		\param budget Budget in bytes, 0 disables eviction, which is
+		the default.
+		\param minUnusedFrames Only textures which were not bound for
+		this many frames are evicted, so textures of the current view
+		are not uploaded over and over. */
+		virtual void setTextureMemoryBudget(u64 budget, u32 minUnusedFrames = 60) = 0;
+
+		//! Returns the memory used by textures
+		virtual STextureMemoryStats getTextureMemoryStats() const = 0;
+
 		//! Creates an empty texture of specified size.
 		/** \param size: Size of the texture.
 		\param name A name for the texture. Later calls to
@@ -955,6 +1057,27 @@ namespace video
 		\return True on successful write. */
 		virtual bool writeImageToFile(IImage* image, io::IWriteFile* file, u32 param =0) =0;
 
+		//! Writes an image to a file on a worker thread
+		/** The image is copied, so it can be changed or dropped right
+		away, and encoding and writing don't block the calling thread.
+		Images are written in the order they are queued. Pending images
+		are still written when the driver is destroyed.
+		\param image Image to write.
+		\param filename Name of the file to write, the image writer is
+		chosen by its extension.
+		\param param Control parameter for the backend (e.g. compression
+		level).
+		\param callback Called on the rendering thread when the image is
+		written, by finishAsyncImageWrites(). */
+		virtual void writeImageToFileAsync(IImage* image, const io::path& filename, u32 param = 0,
+			const ImageWrittenCallback& callback = ImageWrittenCallback()) = 0;
+
+		//! Calls the callbacks of images written by writeImageToFileAsync()
+		/** Called by beginScene().
+		\param wait Wait until all pending images are written.
+		\return Number of images which are still pending. */
+		virtual u32 finishAsyncImageWrites(bool wait = false) = 0;
+
 		//! Creates a software image from a byte array.
 		/** No hardware texture will be created for this image. This
 		method is useful for example if you want to read a heightmap
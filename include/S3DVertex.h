@@ -28,7 +28,14 @@ enum E_VERTEX_TYPE
 	/** Usually used for tangent space normal mapping.
 		Usually tangent and binormal get send to shaders as texture coordinate sets 1 and 2.
 	*/
-	EVT_TANGENTS
+	EVT_TANGENTS,
+
+	//! Quantized vertex with 16 bit attributes, video::S3DVertexCompact.
+	/** Positions are relative to a per-buffer scale and offset, see
+	scene::SCompactMeshBuffer. The OpenGL 3 and OpenGL ES 2 drivers pass
+	them to shaders as they are, the fixed function drivers decode them
+	in IVideoDriver::drawMeshBuffer(). */
+	EVT_COMPACT
 };
 
 //! Array holding the built in vertex type names
@@ -37,6 +44,7 @@ const char* const sBuiltInVertexTypeNames[] =
 	"standard",
 	"2tcoords",
 	"tangents",
+	"compact",
 	0
 };
 
@@ -262,6 +270,157 @@ struct S3DVertexTangents : public S3DVertex
 };
 
 
+//! Vertex with quantized 16 bit attributes.
+/** Needs 20 bytes instead of the 36 bytes of S3DVertex. The position is a
+signed normalized value in [-1,1] on each axis, which the mesh buffer maps to
+object space with its own scale and offset. The normal is stored in
+octahedral encoding and the texture coordinates are unsigned normalized
+values, so they have to be within [0,1]. Buffers with tiled texture
+coordinates can't be converted.
+The attributes are passed to shaders as normalized values, so
+inVertexNormal only holds the two octahedral components in x and y and has to
+be decoded by the shader if it needs the normal. The fixed function drivers
+decode the whole vertex before drawing, so their lit materials get the real
+normal. They can only draw these vertices with IVideoDriver::drawMeshBuffer().
+*/
+struct S3DVertexCompact
+{
+	//! default constructor
+	S3DVertexCompact() : Color(0xffffffff)
+	{
+		Pos[0] = Pos[1] = Pos[2] = Pos[3] = 0;
+		Normal[0] = Normal[1] = 0;
+		TCoords[0] = TCoords[1] = 0;
+	}
+
+	//! constructor
+	/** \param pos Position in [-1,1] on each axis.
+	\param normal Normal vector, does not need to be normalized.
+	\param color Vertex color.
+	\param tcoords Texture coordinates in [0,1]. */
+	S3DVertexCompact(const core::vector3df& pos, const core::vector3df& normal,
+		SColor color, const core::vector2df& tcoords)
+		: Color(color)
+	{
+		setPosition(pos);
+		setNormal(normal);
+		setTCoords(tcoords);
+	}
+
+	//! Position, signed normalized. The fourth component is padding.
+	s16 Pos[4];
+
+	//! Octahedral encoded normal, signed normalized
+	s16 Normal[2];
+
+	//! Color
+	SColor Color;
+
+	//! Texture coordinates, unsigned normalized
+	u16 TCoords[2];
+
+	//! Set the position, values are clamped to [-1,1]
+	void setPosition(const core::vector3df& pos)
+	{
+		Pos[0] = packSNorm(pos.X);
+		Pos[1] = packSNorm(pos.Y);
+		Pos[2] = packSNorm(pos.Z);
+		Pos[3] = 0;
+	}
+
+	//! Get the position in [-1,1]
+	core::vector3df getPosition() const
+	{
+		return core::vector3df(unpackSNorm(Pos[0]), unpackSNorm(Pos[1]), unpackSNorm(Pos[2]));
+	}
+
+	//! Set the normal, stored in octahedral encoding
+	void setNormal(const core::vector3df& normal)
+	{
+		const f32 l1 = fabsf(normal.X) + fabsf(normal.Y) + fabsf(normal.Z);
+		if (core::iszero(l1))
+		{
+			Normal[0] = Normal[1] = 0;
+			return;
+		}
+		f32 x = normal.X / l1;
+		f32 y = normal.Y / l1;
+		if (normal.Z < 0.f)
+		{
+			const f32 fx = (1.f - fabsf(y)) * (x >= 0.f ? 1.f : -1.f);
+			const f32 fy = (1.f - fabsf(x)) * (y >= 0.f ? 1.f : -1.f);
+			x = fx;
+			y = fy;
+		}
+		Normal[0] = packSNorm(x);
+		Normal[1] = packSNorm(y);
+	}
+
+	//! Get the decoded, normalized normal
+	core::vector3df getNormal() const
+	{
+		f32 x = unpackSNorm(Normal[0]);
+		f32 y = unpackSNorm(Normal[1]);
+		const f32 z = 1.f - fabsf(x) - fabsf(y);
+		if (z < 0.f)
+		{
+			const f32 fx = (1.f - fabsf(y)) * (x >= 0.f ? 1.f : -1.f);
+			const f32 fy = (1.f - fabsf(x)) * (y >= 0.f ? 1.f : -1.f);
+			x = fx;
+			y = fy;
+		}
+		return core::vector3df(x, y, z).normalize();
+	}
+
+	//! Set the texture coordinates, values are clamped to [0,1]
+	void setTCoords(const core::vector2df& tcoords)
+	{
+		TCoords[0] = packUNorm(tcoords.X);
+		TCoords[1] = packUNorm(tcoords.Y);
+	}
+
+	//! Get the texture coordinates
+	core::vector2df getTCoords() const
+	{
+		return core::vector2df(TCoords[0] / 65535.f, TCoords[1] / 65535.f);
+	}
+
+	bool operator==(const S3DVertexCompact& other) const
+	{
+		return Pos[0] == other.Pos[0] && Pos[1] == other.Pos[1] && Pos[2] == other.Pos[2] &&
+			Normal[0] == other.Normal[0] && Normal[1] == other.Normal[1] &&
+			Color == other.Color &&
+			TCoords[0] == other.TCoords[0] && TCoords[1] == other.TCoords[1];
+	}
+
+	bool operator!=(const S3DVertexCompact& other) const
+	{
+		return !(*this == other);
+	}
+
+	//! Get type of the class
+	static E_VERTEX_TYPE getType()
+	{
+		return EVT_COMPACT;
+	}
+
+private:
+	static s16 packSNorm(f32 v)
+	{
+		return (s16)core::round32(core::clamp(v, -1.f, 1.f) * 32767.f);
+	}
+
+	static f32 unpackSNorm(s16 v)
+	{
+		return core::max_(v / 32767.f, -1.f);
+	}
+
+	static u16 packUNorm(f32 v)
+	{
+		return (u16)core::round32(core::clamp(v, 0.f, 1.f) * 65535.f);
+	}
+};
+
 
 inline u32 getVertexPitchFromType(E_VERTEX_TYPE vertexType)
 {
@@ -271,6 +430,8 @@ inline u32 getVertexPitchFromType(E_VERTEX_TYPE vertexType)
 		return sizeof(video::S3DVertex2TCoords);
 	case video::EVT_TANGENTS:
 		return sizeof(video::S3DVertexTangents);
+	case video::EVT_COMPACT:
+		return sizeof(video::S3DVertexCompact);
 	default:
 		return sizeof(video::S3DVertex);
 	}
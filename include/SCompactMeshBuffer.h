@@ -0,0 +1,399 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __S_COMPACT_MESH_BUFFER_H_INCLUDED__
+#define __S_COMPACT_MESH_BUFFER_H_INCLUDED__
+
+#include "irrArray.h"
+#include "IMeshBuffer.h"
+
+namespace irr
+{
+namespace scene
+{
+	//! Meshbuffer holding quantized vertices of type video::S3DVertexCompact
+	/** Vertex positions are stored in [-1,1] and mapped to object space
+	with PositionScale and PositionOffset. Usually the offset is the center
+	of the bounding box and the scale is half its extent.
+	The accessors getPosition(), getNormal() and getTCoords() return
+	decoded copies which stay valid until the next call of the same
+	accessor. Writing to them does not modify the buffer, use
+	setPosition(), setNormal() and setTCoords() instead.
+	*/
+	struct SCompactMeshBuffer : public IMeshBuffer
+	{
+		//! Default constructor for empty meshbuffer
+		SCompactMeshBuffer()
+			: ChangedID_Vertex(1), ChangedID_Index(1)
+			, MappingHint_Vertex(EHM_NEVER), MappingHint_Index(EHM_NEVER)
+			, HWBuffer(NULL)
+			, PositionScale(1.f, 1.f, 1.f)
+			, PrimitiveType(EPT_TRIANGLES)
+		{
+			#ifdef _DEBUG
+			setDebugName("SCompactMeshBuffer");
+			#endif
+		}
+
+		//! Get material of this meshbuffer
+		const video::SMaterial& getMaterial() const override
+		{
+			return Material;
+		}
+
+		//! Get material of this meshbuffer
+		video::SMaterial& getMaterial() override
+		{
+			return Material;
+		}
+
+		//! Get pointer to vertices
+		const void* getVertices() const override
+		{
+			return Vertices.const_pointer();
+		}
+
+		//! Get pointer to vertices
+		void* getVertices() override
+		{
+			return Vertices.pointer();
+		}
+
+		//! Get number of vertices
+		u32 getVertexCount() const override
+		{
+			return Vertices.size();
+		}
+
+		//! Get type of index data which is stored in this meshbuffer.
+		video::E_INDEX_TYPE getIndexType() const override
+		{
+			return video::EIT_16BIT;
+		}
+
+		//! Get pointer to indices
+		const u16* getIndices() const override
+		{
+			return Indices.const_pointer();
+		}
+
+		//! Get pointer to indices
+		u16* getIndices() override
+		{
+			return Indices.pointer();
+		}
+
+		//! Get number of indices
+		u32 getIndexCount() const override
+		{
+			return Indices.size();
+		}
+
+		//! Get the axis aligned bounding box
+		const core::aabbox3d<f32>& getBoundingBox() const override
+		{
+			return BoundingBox;
+		}
+
+		//! Set the axis aligned bounding box
+		void setBoundingBox(const core::aabbox3df& box) override
+		{
+			BoundingBox = box;
+		}
+
+		//! Recalculate the bounding box from the decoded positions.
+		void recalculateBoundingBox() override
+		{
+			if (!Vertices.empty())
+			{
+				BoundingBox.reset(decodePosition(Vertices[0]));
+				const u32 vsize = Vertices.size();
+				for (u32 i=1; i<vsize; ++i)
+					BoundingBox.addInternalPoint(decodePosition(Vertices[i]));
+			}
+			else
+				BoundingBox.reset(0,0,0);
+		}
+
+		//! Get type of vertex data stored in this buffer.
+		video::E_VERTEX_TYPE getVertexType() const override
+		{
+			return video::EVT_COMPACT;
+		}
+
+		//! Get the transformation from stored vertex positions to object space
+		core::matrix4 getVertexPositionTransform() const override
+		{
+			core::matrix4 mat;
+			mat.setScale(PositionScale);
+			mat.setTranslation(PositionOffset);
+			return mat;
+		}
+
+		//! Set the object space range of the quantized positions
+		/** Maps box to [-1,1], flat axes keep a unit scale. The
+		vertices of the buffer are quantized again for the new range. */
+		void setPositionRange(const core::aabbox3df& box)
+		{
+			const core::vector3df oldScale = PositionScale;
+			const core::vector3df oldOffset = PositionOffset;
+
+			PositionScale = box.getExtent() * 0.5f;
+			if (core::iszero(PositionScale.X))
+				PositionScale.X = 1.f;
+			if (core::iszero(PositionScale.Y))
+				PositionScale.Y = 1.f;
+			if (core::iszero(PositionScale.Z))
+				PositionScale.Z = 1.f;
+			PositionOffset = box.getCenter();
+
+			const u32 vsize = Vertices.size();
+			for (u32 i=0; i<vsize; ++i)
+				Vertices[i].setPosition(encodePosition(Vertices[i].getPosition() * oldScale + oldOffset));
+		}
+
+		//! Map a position in object space to the quantized range of this buffer
+		core::vector3df encodePosition(const core::vector3df& pos) const
+		{
+			return (pos - PositionOffset) / PositionScale;
+		}
+
+		//! Get the position of a vertex in object space
+		core::vector3df decodePosition(const video::S3DVertexCompact& vertex) const
+		{
+			return vertex.getPosition() * PositionScale + PositionOffset;
+		}
+
+		//! returns decoded position of vertex i
+		const core::vector3df& getPosition(u32 i) const override
+		{
+			DecodedPosition = decodePosition(Vertices[i]);
+			return DecodedPosition;
+		}
+
+		//! returns decoded position of vertex i
+		core::vector3df& getPosition(u32 i) override
+		{
+			DecodedPosition = decodePosition(Vertices[i]);
+			return DecodedPosition;
+		}
+
+		//! returns decoded normal of vertex i
+		const core::vector3df& getNormal(u32 i) const override
+		{
+			DecodedNormal = Vertices[i].getNormal();
+			return DecodedNormal;
+		}
+
+		//! returns decoded normal of vertex i
+		core::vector3df& getNormal(u32 i) override
+		{
+			DecodedNormal = Vertices[i].getNormal();
+			return DecodedNormal;
+		}
+
+		//! returns decoded texture coord of vertex i
+		const core::vector2df& getTCoords(u32 i) const override
+		{
+			DecodedTCoords = Vertices[i].getTCoords();
+			return DecodedTCoords;
+		}
+
+		//! returns decoded texture coord of vertex i
+		core::vector2df& getTCoords(u32 i) override
+		{
+			DecodedTCoords = Vertices[i].getTCoords();
+			return DecodedTCoords;
+		}
+
+		//! sets position of vertex i, clamped to the position range
+		void setPosition(u32 i, const core::vector3df& pos) override
+		{
+			Vertices[i].setPosition(encodePosition(pos));
+		}
+
+		//! sets normal of vertex i
+		void setNormal(u32 i, const core::vector3df& normal) override
+		{
+			Vertices[i].setNormal(normal);
+		}
+
+		//! sets texture coord of vertex i, clamped to [0,1]
+		void setTCoords(u32 i, const core::vector2df& tcoords) override
+		{
+			Vertices[i].setTCoords(tcoords);
+		}
+
+		//! Append the vertices and indices to the current buffer
+		/** The vertices must be of type video::S3DVertexCompact and use
+		the same scale and offset as this buffer. */
+		void append(const void* const vertices, u32 numVertices, const u16* const indices, u32 numIndices) override
+		{
+			if (vertices == getVertices())
+				return;
+
+			const u32 vertexCount = getVertexCount();
+			u32 i;
+
+			Vertices.reallocate(vertexCount+numVertices);
+			for (i=0; i<numVertices; ++i)
+			{
+				Vertices.push_back(static_cast<const video::S3DVertexCompact*>(vertices)[i]);
+				BoundingBox.addInternalPoint(decodePosition(Vertices.getLast()));
+			}
+
+			Indices.reallocate(getIndexCount()+numIndices);
+			for (i=0; i<numIndices; ++i)
+			{
+				Indices.push_back(indices[i]+vertexCount);
+			}
+		}
+
+		//! Append the meshbuffer to the current buffer
+		/** The vertices of other, which may be of any type, are decoded
+		and quantized again. The position range of this buffer grows to
+		hold them, texture coordinates are clamped to [0,1]. Nothing is
+		appended if the vertices would not fit 16 bit indices. */
+		void append(const IMeshBuffer* const other) override
+		{
+			const u32 vertexCount = getVertexCount();
+			const u32 otherCount = other->getVertexCount();
+			if (other == this || otherCount == 0)
+				return;
+			if (vertexCount + otherCount > 65536)
+			{
+				_IRR_DEBUG_BREAK_IF(true)
+				return;
+			}
+
+			core::aabbox3df box(other->getPosition(0));
+			for (u32 i=1; i<otherCount; ++i)
+				box.addInternalPoint(other->getPosition(i));
+			for (u32 i=0; i<vertexCount; ++i)
+				box.addInternalPoint(decodePosition(Vertices[i]));
+			setPositionRange(box);
+
+			// all full precision vertex types start with the members of S3DVertex
+			const video::E_VERTEX_TYPE otherType = other->getVertexType();
+			const u32 pitch = video::getVertexPitchFromType(otherType);
+			const u8* data = static_cast<const u8*>(other->getVertices());
+			Vertices.reallocate(vertexCount+otherCount);
+			for (u32 i=0; i<otherCount; ++i)
+			{
+				const video::SColor color = (otherType == video::EVT_COMPACT) ?
+					reinterpret_cast<const video::S3DVertexCompact*>(data + i * pitch)->Color :
+					reinterpret_cast<const video::S3DVertex*>(data + i * pitch)->Color;
+				Vertices.push_back(video::S3DVertexCompact(encodePosition(other->getPosition(i)),
+					other->getNormal(i), color, other->getTCoords(i)));
+			}
+
+			const u32 otherIndexCount = other->getIndexCount();
+			Indices.reallocate(getIndexCount()+otherIndexCount);
+			if (other->getIndexType() == video::EIT_16BIT)
+			{
+				const u16* indices = other->getIndices();
+				for (u32 i=0; i<otherIndexCount; ++i)
+					Indices.push_back((u16)(indices[i]+vertexCount));
+			}
+			else
+			{
+				const u32* indices = reinterpret_cast<const u32*>(other->getIndices());
+				for (u32 i=0; i<otherIndexCount; ++i)
+					Indices.push_back((u16)(indices[i]+vertexCount));
+			}
+
+			recalculateBoundingBox();
+		}
+
+		//! get the current hardware mapping hint
+		E_HARDWARE_MAPPING getHardwareMappingHint_Vertex() const override
+		{
+			return MappingHint_Vertex;
+		}
+
+		//! get the current hardware mapping hint
+		E_HARDWARE_MAPPING getHardwareMappingHint_Index() const override
+		{
+			return MappingHint_Index;
+		}
+
+		//! set the hardware mapping hint, for driver
+		void setHardwareMappingHint( E_HARDWARE_MAPPING NewMappingHint, E_BUFFER_TYPE Buffer=EBT_VERTEX_AND_INDEX ) override
+		{
+			if (Buffer==EBT_VERTEX_AND_INDEX || Buffer==EBT_VERTEX)
+				MappingHint_Vertex=NewMappingHint;
+			if (Buffer==EBT_VERTEX_AND_INDEX || Buffer==EBT_INDEX)
+				MappingHint_Index=NewMappingHint;
+		}
+
+		//! Describe what kind of primitive geometry is used by the meshbuffer
+		void setPrimitiveType(E_PRIMITIVE_TYPE type) override
+		{
+			PrimitiveType = type;
+		}
+
+		//! Get the kind of primitive geometry which is used by the meshbuffer
+		E_PRIMITIVE_TYPE getPrimitiveType() const override
+		{
+			return PrimitiveType;
+		}
+
+		//! flags the mesh as changed, reloads hardware buffers
+		void setDirty(E_BUFFER_TYPE Buffer=EBT_VERTEX_AND_INDEX) override
+		{
+			if (Buffer==EBT_VERTEX_AND_INDEX ||Buffer==EBT_VERTEX)
+				++ChangedID_Vertex;
+			if (Buffer==EBT_VERTEX_AND_INDEX || Buffer==EBT_INDEX)
+				++ChangedID_Index;
+		}
+
+		//! Get the currently used ID for identification of changes.
+		/** This shouldn't be used for anything outside the VideoDriver. */
+		u32 getChangedID_Vertex() const override {return ChangedID_Vertex;}
+
+		//! Get the currently used ID for identification of changes.
+		/** This shouldn't be used for anything outside the VideoDriver. */
+		u32 getChangedID_Index() const override {return ChangedID_Index;}
+
+		void setHWBuffer(void *ptr) const override {
+			HWBuffer = ptr;
+		}
+
+		void *getHWBuffer() const override {
+			return HWBuffer;
+		}
+
+
+		u32 ChangedID_Vertex;
+		u32 ChangedID_Index;
+
+		//! hardware mapping hint
+		E_HARDWARE_MAPPING MappingHint_Vertex;
+		E_HARDWARE_MAPPING MappingHint_Index;
+		mutable void *HWBuffer;
+
+		//! Material for this meshbuffer.
+		video::SMaterial Material;
+		//! Vertices of this buffer
+		core::array<video::S3DVertexCompact> Vertices;
+		//! Indices into the vertices of this buffer.
+		core::array<u16> Indices;
+		//! Bounding box of this meshbuffer.
+		core::aabbox3d<f32> BoundingBox;
+		//! Scale applied to the quantized positions
+		core::vector3df PositionScale;
+		//! Offset added to the scaled positions
+		core::vector3df PositionOffset;
+		//! Primitive type used for rendering (triangles, lines, ...)
+		E_PRIMITIVE_TYPE PrimitiveType;
+
+	private:
+		mutable core::vector3df DecodedPosition;
+		mutable core::vector3df DecodedNormal;
+		mutable core::vector2df DecodedTCoords;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
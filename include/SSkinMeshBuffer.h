@@ -182,6 +182,8 @@ struct SSkinMeshBuffer : public IMeshBuffer
 				}
 				break;
 			}
+			default:
+				break;
 		}
 	}
 
@@ -243,6 +245,58 @@ struct SSkinMeshBuffer : public IMeshBuffer
 		}
 	}
 
+	//! Convert to standard vertex type
+	/** Drops the second texture coordinates or the tangents. */
+	void convertToStandard()
+	{
+		if (VertexType==video::EVT_2TCOORDS)
+		{
+			Vertices_Standard.reallocate(Vertices_2TCoords.size());
+			for(u32 n=0;n<Vertices_2TCoords.size();++n)
+				Vertices_Standard.push_back(Vertices_2TCoords[n]);
+			Vertices_2TCoords.clear();
+			VertexType=video::EVT_STANDARD;
+		}
+		else if (VertexType==video::EVT_TANGENTS)
+		{
+			Vertices_Standard.reallocate(Vertices_Tangents.size());
+			for(u32 n=0;n<Vertices_Tangents.size();++n)
+				Vertices_Standard.push_back(Vertices_Tangents[n]);
+			Vertices_Tangents.clear();
+			VertexType=video::EVT_STANDARD;
+		}
+	}
+
+	//! Convert to the smallest vertex type holding the data and release unused memory
+	/** Tangents are unused when all of them and the binormals are zero.
+	\param narrowTCoords2 Also drop second texture coordinates identical
+	to the first ones. The drivers feed the first coordinates to the second
+	texture layer for standard vertices, so the built-in materials look the
+	same, but shaders reading the second set no longer get it. */
+	void compact(bool narrowTCoords2=false)
+	{
+		bool narrow=true;
+		if (VertexType==video::EVT_2TCOORDS)
+		{
+			narrow = narrowTCoords2;
+			for(u32 n=0;narrow && n<Vertices_2TCoords.size();++n)
+				narrow = Vertices_2TCoords[n].TCoords2==Vertices_2TCoords[n].TCoords;
+		}
+		else if (VertexType==video::EVT_TANGENTS)
+		{
+			const core::vector3df zero(0.f,0.f,0.f);
+			for(u32 n=0;narrow && n<Vertices_Tangents.size();++n)
+				narrow = Vertices_Tangents[n].Tangent==zero && Vertices_Tangents[n].Binormal==zero;
+		}
+		if (narrow)
+			convertToStandard();
+
+		Vertices_Standard.shrink_to_fit();
+		Vertices_2TCoords.shrink_to_fit();
+		Vertices_Tangents.shrink_to_fit();
+		Indices.shrink_to_fit();
+	}
+
 	//! returns position of vertex i
 	const core::vector3df& getPosition(u32 i) const override
 	{
@@ -76,7 +76,8 @@ inline io::path& deletePathFromFilename(io::path& filename)
 	if ( p != s )
 	{
 		++p;
-		filename = p;
+		// assigning p itself would shrink the string before copying it
+		filename = filename.subString((u32)(p - s), (s32)(filename.size() - (p - s)));
 	}
 	return filename;
 }
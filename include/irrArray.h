@@ -57,6 +57,14 @@ public:
 		}
 	}
 
+	//! Releases memory which is allocated but not used by the elements.
+	/** Useful after an array was filled with an overestimated
+	reallocate() and will not grow anymore. */
+	void shrink_to_fit()
+	{
+		m_data.shrink_to_fit();
+	}
+
 	//! Adds an element at back of array.
 	/** If the array is too small to add this new element it is made bigger.
 	\param element: Element to add at the back of the array. */
@@ -6,6 +6,7 @@
 
 #include "irrTypes.h"
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
@@ -293,6 +294,12 @@ public:
 		return str.c_str();
 	}
 
+	//! Returns a view of the characters, valid until the string is changed or destroyed
+	std::basic_string_view<T> view() const
+	{
+		return std::basic_string_view<T>(str.data(), str.size());
+	}
+
 
 	//! Makes the string lower case.
 	string<T>& make_lower()
@@ -89,6 +89,8 @@
 #include "IMeshManipulator.h"
 #include "IMeshSceneNode.h"
 #include "IMeshWriter.h"
+#include "IMemoryWriteFile.h"
+#include "IIOStatistics.h"
 #include "IOSOperator.h"
 #include "IReadFile.h"
 #include "IReferenceCounted.h"
@@ -105,6 +107,7 @@
 #include "IShaderConstantSetCallBack.h"
 #include "ISkinnedMesh.h"
 #include "ITexture.h"
+#include "ITextureAtlas.h"
 #include "ITimer.h"
 #include "IVertexBuffer.h"
 #include "IVideoDriver.h"
@@ -121,6 +124,7 @@
 #include "SAnimatedMesh.h"
 #include "SceneParameters.h"
 #include "SColor.h"
+#include "SCompactMeshBuffer.h"
 #include "SExposedVideoData.h"
 #include "SIrrCreationParameters.h"
 #include "SMaterial.h"
@@ -17,6 +17,9 @@ namespace io
 */
 typedef core::string<fschar_t> path;
 
+//! Type for looking at a part of a path without copying it
+typedef std::basic_string_view<fschar_t> path_view;
+
 //! Used in places where we identify objects by a filename, but don't actually work with the real filename
 /** Irrlicht is internally not case-sensitive when it comes to names.
     Also this class is a first step towards support for correctly serializing renamed objects.
@@ -0,0 +1,94 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CAsyncImageWriter.h"
+#include "CNullDriver.h"
+#include "IImage.h"
+
+namespace irr
+{
+namespace video
+{
+
+CAsyncImageWriter::CAsyncImageWriter(CNullDriver* driver)
+	: Driver(driver), Busy(0), Stop(false)
+{
+}
+
+
+CAsyncImageWriter::~CAsyncImageWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Stop = true;
+	}
+	Wake.notify_all();
+	if (Worker.joinable())
+		Worker.join();
+}
+
+
+void CAsyncImageWriter::add(IImage* image, const io::path& filename, u32 param, const ImageWrittenCallback& callback)
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Queue.push_back(SWrite{filename, image, param, callback, false});
+	}
+
+	if (!Worker.joinable())
+		Worker = std::thread(&CAsyncImageWriter::run, this);
+	Wake.notify_one();
+}
+
+
+bool CAsyncImageWriter::popWritten(SWrite& write, bool wait)
+{
+	std::unique_lock<std::mutex> lock(Mutex);
+	if (wait)
+		Finished.wait(lock, [this] { return !Written.empty() || (Queue.empty() && !Busy); });
+
+	if (Written.empty())
+		return false;
+
+	write = std::move(Written.front());
+	Written.pop_front();
+	return true;
+}
+
+
+u32 CAsyncImageWriter::getPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	return (u32)(Queue.size() + Written.size()) + Busy;
+}
+
+
+void CAsyncImageWriter::run()
+{
+	std::unique_lock<std::mutex> lock(Mutex);
+	while (true)
+	{
+		// queued images are still written when stopping
+		Wake.wait(lock, [this] { return Stop || !Queue.empty(); });
+		if (Queue.empty())
+			return;
+
+		SWrite write = std::move(Queue.front());
+		Queue.pop_front();
+		++Busy;
+
+		lock.unlock();
+		// not virtual, the driver may be destroyed down to CNullDriver already
+		write.Written = Driver->CNullDriver::writeImageToFile(write.Image, write.Filename, write.Param);
+		write.Image->drop();
+		write.Image = 0;
+		lock.lock();
+
+		--Busy;
+		Written.push_back(std::move(write));
+		Finished.notify_all();
+	}
+}
+
+} // end namespace video
+} // end namespace irr
@@ -0,0 +1,72 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IVideoDriver.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace irr
+{
+namespace video
+{
+
+class CNullDriver;
+
+//! Encodes and writes images for IVideoDriver::writeImageToFileAsync on a worker thread
+/** One thread is enough to keep the rendering thread free, and it
+writes the images in the order they were queued. */
+class CAsyncImageWriter
+{
+public:
+	//! A queued or finished write
+	struct SWrite
+	{
+		io::path Filename;
+		//! Copy of the image, owned by the writer
+		IImage* Image;
+		u32 Param;
+		ImageWrittenCallback Callback;
+		bool Written;
+	};
+
+	CAsyncImageWriter(CNullDriver* driver);
+
+	//! Writes all queued images, then stops the worker
+	/** Callbacks of writes which were not taken are not called. */
+	~CAsyncImageWriter();
+
+	//! Queues an image, starting the worker on first use
+	/** \param image Image to write, it is dropped once written. */
+	void add(IImage* image, const io::path& filename, u32 param, const ImageWrittenCallback& callback);
+
+	//! Takes the oldest finished write
+	/** \param wait Wait for a write to finish if none is finished yet
+	but some are pending.
+	\return False if there is none */
+	bool popWritten(SWrite& write, bool wait);
+
+	//! Writes which are queued, being written or finished but not taken yet
+	u32 getPendingCount() const;
+
+private:
+	void run();
+
+	CNullDriver* Driver;
+
+	mutable std::mutex Mutex;
+	std::condition_variable Wake;
+	//! Signalled when an image was written
+	std::condition_variable Finished;
+	std::deque<SWrite> Queue;
+	std::deque<SWrite> Written;
+	u32 Busy;
+	bool Stop;
+	std::thread Worker;
+};
+
+} // end namespace video
+} // end namespace irr
@@ -0,0 +1,123 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CAsyncTextureLoader.h"
+#include "CNullDriver.h"
+#include "IImage.h"
+
+namespace irr
+{
+namespace video
+{
+
+CAsyncTextureLoader::CAsyncTextureLoader(CNullDriver* driver)
+	: Driver(driver), Busy(0), Stop(false)
+{
+}
+
+
+CAsyncTextureLoader::~CAsyncTextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Stop = true;
+	}
+	Wake.notify_all();
+	for (std::thread& t : Workers)
+		t.join();
+
+	for (SDecoded& queued : Queue)
+		queued.File->drop();
+	for (SDecoded& decoded : Decoded)
+	{
+		decoded.File->drop();
+		if (decoded.Image)
+			decoded.Image->drop();
+	}
+}
+
+
+void CAsyncTextureLoader::add(const io::path& filename, io::IReadFile* file,
+	const std::shared_ptr<const TextureLoadedCallback>& callback, u32 flags)
+{
+	file->grab();
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Queue.push_back(SDecoded{filename, file, file->getFileName(), 0, callback, flags, os::CDeferredLog()});
+	}
+
+	if (Workers.empty())
+	{
+		// the rendering thread keeps one core for itself
+		const u32 cores = std::thread::hardware_concurrency();
+		const u32 count = cores > 2 ? cores - 1 : 1;
+		for (u32 i = 0; i < count; ++i)
+			Workers.emplace_back(&CAsyncTextureLoader::run, this);
+	}
+	Wake.notify_one();
+}
+
+
+bool CAsyncTextureLoader::popDecoded(SDecoded& decoded)
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	if (Decoded.empty())
+		return false;
+
+	decoded = std::move(Decoded.front());
+	Decoded.pop_front();
+	return true;
+}
+
+
+u32 CAsyncTextureLoader::getPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	return (u32)(Queue.size() + Decoded.size()) + Busy;
+}
+
+
+void CAsyncTextureLoader::run()
+{
+	std::unique_lock<std::mutex> lock(Mutex);
+	while (true)
+	{
+		Wake.wait(lock, [this] { return Stop || !Queue.empty(); });
+		if (Stop)
+			return;
+
+		SDecoded job = std::move(Queue.front());
+		Queue.pop_front();
+		++Busy;
+
+		lock.unlock();
+		os::Printer::setDeferredLog(&job.Log);
+		decode(job);
+		os::Printer::setDeferredLog(0);
+		lock.lock();
+
+		// dropped by the destructor when stopping meanwhile
+		--Busy;
+		Decoded.push_back(std::move(job));
+	}
+}
+
+
+void CAsyncTextureLoader::decode(SDecoded& job)
+{
+	// reading from archives is thread safe, so the workers don't wait for each other
+	job.Image = Driver->createImageFromFile(job.File);
+
+	if (!job.Image)
+		return;
+
+	if (job.Flags & ETCF_COMPRESS_TEXTURES)
+	{
+		IImage* compressed = Driver->compressTextureImage(job.Image, job.Flags);
+		job.Image->drop();
+		job.Image = compressed;
+	}
+}
+
+} // end namespace video
+} // end namespace irr
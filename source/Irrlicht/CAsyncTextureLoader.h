@@ -0,0 +1,86 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IVideoDriver.h"
+#include "IReadFile.h"
+#include "os.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace irr
+{
+namespace video
+{
+
+class CNullDriver;
+
+//! Reads and decodes images for IVideoDriver::getTexturesAsync on a pool of threads
+/** Files are opened by the caller, so the workers don't use the file
+system, and read and decoded in parallel on all workers. The workers don't
+log, messages are kept with the finished requests. */
+class CAsyncTextureLoader
+{
+public:
+	//! A finished request
+	struct SDecoded
+	{
+		//! Name the texture was requested with
+		io::path Name;
+		//! File to decode. Has to be dropped, on the calling thread as
+		//! reference counts of archive files are not atomic.
+		io::IReadFile* File;
+		//! Name of the opened file
+		io::path FileName;
+		//! Decoded image, 0 if loading failed. Has to be dropped.
+		IImage* Image;
+		std::shared_ptr<const TextureLoadedCallback> Callback;
+		//! Texture creation flags at the time of the request
+		u32 Flags;
+		//! What was logged while decoding, to be flushed on the main thread
+		os::CDeferredLog Log;
+	};
+
+	CAsyncTextureLoader(CNullDriver* driver);
+
+	//! Stops the workers, pending requests are dropped without callback
+	~CAsyncTextureLoader();
+
+	//! Queues a file, starting the workers on first use
+	/** \param filename Name the texture was requested with.
+	\param file Opened file, which is grabbed and read on a worker.
+	It is dropped with the finished request.
+	\param flags Texture creation flags, images are compressed on the
+	workers for ETCF_COMPRESS_TEXTURES. */
+	void add(const io::path& filename, io::IReadFile* file,
+		const std::shared_ptr<const TextureLoadedCallback>& callback, u32 flags);
+
+	//! Takes the oldest finished request, returns false if there is none
+	bool popDecoded(SDecoded& decoded);
+
+	//! Requests which are queued, decoding or finished but not taken yet
+	u32 getPendingCount() const;
+
+private:
+	void run();
+
+	void decode(SDecoded& job);
+
+	CNullDriver* Driver;
+
+	mutable std::mutex Mutex;
+	std::condition_variable Wake;
+	std::deque<SDecoded> Queue;
+	std::deque<SDecoded> Decoded;
+	u32 Busy;
+	bool Stop;
+	std::vector<std::thread> Workers;
+};
+
+} // end namespace video
+} // end namespace irr
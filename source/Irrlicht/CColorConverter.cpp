@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CColorConverter.h"
+#include "CColorConverterSIMD.h"
 #include "SColor.h"
 #include "os.h"
 #include "irrString.h"
@@ -12,6 +13,27 @@ namespace irr
 namespace video
 {
 
+static CColorConverter::E_SIMD_LEVEL detectSIMDLevel()
+{
+	for (s32 i = CColorConverter::ESL_COUNT - 1; i > CColorConverter::ESL_SCALAR; --i)
+	{
+		if (isColorConvertSIMDSupported((CColorConverter::E_SIMD_LEVEL)i))
+			return (CColorConverter::E_SIMD_LEVEL)i;
+	}
+	return CColorConverter::ESL_SCALAR;
+}
+
+// Until they are initialized the kernels are 0, which means the scalar loops
+static CColorConverter::E_SIMD_LEVEL SIMDLevel = detectSIMDLevel();
+static SColorConvertKernels Kernels = getColorConvertKernels(SIMDLevel);
+
+//! Runs the vectorized part of a conversion, returns the number of converted pixels
+static inline s32 convertSIMD(ColorConvertKernel kernel, const void* sP, s32 sN, void* dP)
+{
+	return kernel ? kernel(sP, sN, dP) : 0;
+}
+
+
 //! converts a monochrome bitmap to A1R5G5B5 data
 void CColorConverter::convert1BitTo16Bit(const u8* in, s16* out, s32 width, s32 height, s32 linepad, bool flip)
 {
@@ -372,10 +394,11 @@ void CColorConverter::convert_A1R5G5B5toR5G5B5A1(const void* sP, s32 sN, void* d
 
 void CColorConverter::convert_A1R5G5B5toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u16* sB = (u16*)sP;
-	u32* dB = (u32*)dP;
+	const s32 done = convertSIMD(Kernels.A1R5G5B5toA8R8G8B8, sP, sN, dP);
+	u16* sB = (u16*)sP + done;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = A1R5G5B5toA8R8G8B8(*sB++);
 }
 
@@ -395,10 +418,11 @@ void CColorConverter::convert_A1R5G5B5toR5G6B5(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_A8R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u8* sB = (u8*)sP;
-	u8* dB = (u8*)dP;
+	const s32 done = convertSIMD(Kernels.A8R8G8B8toR8G8B8, sP, sN, dP);
+	u8* sB = (u8*)sP + done*4;
+	u8* dB = (u8*)dP + done*3;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		// sB[3] is alpha
 		dB[0] = sB[2];
@@ -412,10 +436,11 @@ void CColorConverter::convert_A8R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_A8R8G8B8toB8G8R8(const void* sP, s32 sN, void* dP)
 {
-	u8* sB = (u8*)sP;
-	u8* dB = (u8*)dP;
+	const s32 done = convertSIMD(Kernels.A8R8G8B8toB8G8R8, sP, sN, dP);
+	u8* sB = (u8*)sP + done*4;
+	u8* dB = (u8*)dP + done*3;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		// sB[3] is alpha
 		dB[0] = sB[0];
@@ -434,10 +459,11 @@ void CColorConverter::convert_A8R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* d
 
 void CColorConverter::convert_A8R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP)
 {
-	u32* sB = (u32*)sP;
-	u16* dB = (u16*)dP;
+	const s32 done = convertSIMD(Kernels.A8R8G8B8toA1R5G5B5, sP, sN, dP);
+	u32* sB = (u32*)sP + done;
+	u16* dB = (u16*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = A8R8G8B8toA1R5G5B5(*sB++);
 }
 
@@ -462,10 +488,11 @@ void CColorConverter::convert_A8R8G8B8toA1B5G5R5(const void* sP, s32 sN, void* d
 
 void CColorConverter::convert_A8R8G8B8toR5G6B5(const void* sP, s32 sN, void* dP)
 {
-	u8 * sB = (u8 *)sP;
-	u16* dB = (u16*)dP;
+	const s32 done = convertSIMD(Kernels.A8R8G8B8toR5G6B5, sP, sN, dP);
+	u8 * sB = (u8 *)sP + done*4;
+	u16* dB = (u16*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		s32 r = sB[2] >> 3;
 		s32 g = sB[1] >> 2;
@@ -503,10 +530,11 @@ void CColorConverter::convert_R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u8*  sB = (u8* )sP;
-	u32* dB = (u32*)dP;
+	const s32 done = convertSIMD(Kernels.R8G8B8toA8R8G8B8, sP, sN, dP);
+	u8*  sB = (u8* )sP + done*3;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		*dB = 0xff000000 | (sB[0]<<16) | (sB[1]<<8) | sB[2];
 
@@ -535,10 +563,11 @@ void CColorConverter::convert_R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_B8G8R8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u8*  sB = (u8* )sP;
-	u32* dB = (u32*)dP;
+	const s32 done = convertSIMD(Kernels.B8G8R8toA8R8G8B8, sP, sN, dP);
+	u8*  sB = (u8* )sP + done*3;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		*dB = 0xff000000 | (sB[2]<<16) | (sB[1]<<8) | sB[0];
 
@@ -549,10 +578,11 @@ void CColorConverter::convert_B8G8R8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_A8R8G8B8toR8G8B8A8(const void* sP, s32 sN, void* dP)
 {
-	const u32* sB = (const u32*)sP;
-	u32* dB = (u32*)dP;
+	const s32 done = convertSIMD(Kernels.A8R8G8B8toR8G8B8A8, sP, sN, dP);
+	const u32* sB = (const u32*)sP + done;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		*dB++ = (*sB<<8) | (*sB>>24);
 		++sB;
@@ -561,10 +591,11 @@ void CColorConverter::convert_A8R8G8B8toR8G8B8A8(const void* sP, s32 sN, void* d
 
 void CColorConverter::convert_A8R8G8B8toA8B8G8R8(const void* sP, s32 sN, void* dP)
 {
-	const u32* sB = (const u32*)sP;
-	u32* dB = (u32*)dP;
+	const s32 done = convertSIMD(Kernels.A8R8G8B8toA8B8G8R8, sP, sN, dP);
+	const u32* sB = (const u32*)sP + done;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		*dB++ = (*sB&0xff00ff00)|((*sB&0x00ff0000)>>16)|((*sB&0x000000ff)<<16);
 		++sB;
@@ -573,10 +604,11 @@ void CColorConverter::convert_A8R8G8B8toA8B8G8R8(const void* sP, s32 sN, void* d
 
 void CColorConverter::convert_B8G8R8A8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u8* sB = (u8*)sP;
-	u8* dB = (u8*)dP;
+	const s32 done = convertSIMD(Kernels.B8G8R8A8toA8R8G8B8, sP, sN, dP);
+	u8* sB = (u8*)sP + done*4;
+	u8* dB = (u8*)dP + done*4;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		dB[0] = sB[3];
 		dB[1] = sB[2];
@@ -591,10 +623,11 @@ void CColorConverter::convert_B8G8R8A8toA8R8G8B8(const void* sP, s32 sN, void* d
 
 void CColorConverter::convert_R8G8B8toB8G8R8(const void* sP, s32 sN, void* dP)
 {
-	u8* sB = (u8*)sP;
-	u8* dB = (u8*)dP;
+	const s32 done = convertSIMD(Kernels.R8G8B8toB8G8R8, sP, sN, dP);
+	u8* sB = (u8*)sP + done*3;
+	u8* dB = (u8*)dP + done*3;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		dB[2] = sB[0];
 		dB[1] = sB[1];
@@ -662,10 +695,11 @@ void CColorConverter::convert_R5G6B5toB8G8R8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_R5G6B5toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u16* sB = (u16*)sP;
-	u32* dB = (u32*)dP;
+	const s32 done = convertSIMD(Kernels.R5G6B5toA8R8G8B8, sP, sN, dP);
+	u16* sB = (u16*)sP + done;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = R5G6B5toA8R8G8B8(*sB++);
 }
 
@@ -678,6 +712,38 @@ void CColorConverter::convert_R5G6B5toA1R5G5B5(const void* sP, s32 sN, void* dP)
 		*dB++ = R5G6B5toA1R5G5B5(*sB++);
 }
 
+CColorConverter::E_SIMD_LEVEL CColorConverter::getSIMDLevel()
+{
+	return SIMDLevel;
+}
+
+bool CColorConverter::setSIMDLevel(E_SIMD_LEVEL level)
+{
+	if (!isColorConvertSIMDSupported(level))
+		return false;
+
+	SIMDLevel = level;
+	Kernels = getColorConvertKernels(level);
+	return true;
+}
+
+const c8* CColorConverter::getSIMDLevelName(E_SIMD_LEVEL level)
+{
+	switch (level)
+	{
+		case ESL_SCALAR:
+			return "scalar";
+		case ESL_SSSE3:
+			return "SSSE3";
+		case ESL_AVX2:
+			return "AVX2";
+		case ESL_NEON:
+			return "NEON";
+		default:
+			return "unknown";
+	}
+}
+
 bool CColorConverter::canConvertFormat(ECOLOR_FORMAT sourceFormat, ECOLOR_FORMAT destFormat)
 {
 	switch (sourceFormat)
@@ -90,6 +90,31 @@ public:
 				void* dP, ECOLOR_FORMAT dF);
 	// Check if convert_viaFormat is usable
 	static bool canConvertFormat(ECOLOR_FORMAT sourceFormat, ECOLOR_FORMAT destFormat);
+
+	//! Instruction sets for the vectorized conversions
+	enum E_SIMD_LEVEL
+	{
+		ESL_SCALAR = 0,
+		ESL_SSSE3,
+		ESL_AVX2,
+		ESL_NEON,
+
+		ESL_COUNT
+	};
+
+	//! Returns the instruction set used by the convert_ functions.
+	/** The best one supported by the CPU is chosen at startup. */
+	static E_SIMD_LEVEL getSIMDLevel();
+
+	//! Selects the instruction set for the convert_ functions.
+	/** ESL_SCALAR selects the plain loops, which are the reference for
+	the other implementations. Meant for tests and benchmarks, must not be
+	called while other threads convert images.
+	\return false if the CPU or the build does not support it. */
+	static bool setSIMDLevel(E_SIMD_LEVEL level);
+
+	//! Returns the name of an instruction set
+	static const c8* getSIMDLevelName(E_SIMD_LEVEL level);
 };
 
 
@@ -0,0 +1,778 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// SSSE3, AVX2 and NEON versions of the CColorConverter loops. The x86 kernels
+// are compiled with function level target attributes and only called after
+// the CPU was checked, so no special compiler flags are needed.
+
+#include "CColorConverterSIMD.h"
+
+#if !defined(__BIG_ENDIAN__) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#define _IRR_COLOR_CONVERTER_X86_
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define IRR_TARGET_SSSE3
+#define IRR_TARGET_AVX2
+#else
+#define IRR_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define IRR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif !defined(__BIG_ENDIAN__) && (defined(__aarch64__) || defined(_M_ARM64))
+#define _IRR_COLOR_CONVERTER_NEON_
+#include <arm_neon.h>
+#endif
+
+namespace irr
+{
+namespace video
+{
+
+#ifdef _IRR_COLOR_CONVERTER_X86_
+
+// Shuffle masks, 0x80 clears the byte. Pixels are listed in memory order,
+// so A8R8G8B8 is B,G,R,A on these little endian CPUs.
+
+// R,G,B -> B,G,R,A
+alignas(16) static const u8 ShuffleRGBtoBGRA[16] = {2,1,0,0x80, 5,4,3,0x80, 8,7,6,0x80, 11,10,9,0x80};
+// B,G,R -> B,G,R,A
+alignas(16) static const u8 ShuffleBGRtoBGRA[16] = {0,1,2,0x80, 3,4,5,0x80, 6,7,8,0x80, 9,10,11,0x80};
+// B,G,R,A -> R,G,B
+alignas(16) static const u8 ShuffleBGRAtoRGB[16] = {2,1,0, 6,5,4, 10,9,8, 14,13,12, 0x80,0x80,0x80,0x80};
+// B,G,R,A -> B,G,R
+alignas(16) static const u8 ShuffleBGRAtoBGR[16] = {0,1,2, 4,5,6, 8,9,10, 12,13,14, 0x80,0x80,0x80,0x80};
+// R,G,B -> B,G,R
+alignas(16) static const u8 ShuffleRGBtoBGR[16] = {2,1,0, 5,4,3, 8,7,6, 11,10,9, 0x80,0x80,0x80,0x80};
+// B,G,R,A -> R,G,B,A
+alignas(16) static const u8 ShuffleBGRAtoRGBA[16] = {2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15};
+// B,G,R,A -> A,B,G,R
+alignas(16) static const u8 ShuffleBGRAtoABGR[16] = {3,0,1,2, 7,4,5,6, 11,8,9,10, 15,12,13,14};
+// A,R,G,B -> B,G,R,A
+alignas(16) static const u8 ShuffleARGBtoBGRA[16] = {3,2,1,0, 7,6,5,4, 11,10,9,8, 15,14,13,12};
+
+
+// ---------- SSSE3 ----------
+
+//! Splits 16 pixels of 3 bytes into four vectors with 4 pixels in the low 12 bytes each
+IRR_TARGET_SSSE3 static inline void load3x16(const u8* sB, __m128i* p)
+{
+	const __m128i a = _mm_loadu_si128((const __m128i*)sB);
+	const __m128i b = _mm_loadu_si128((const __m128i*)(sB + 16));
+	const __m128i c = _mm_loadu_si128((const __m128i*)(sB + 32));
+	p[0] = a;
+	p[1] = _mm_alignr_epi8(b, a, 12);
+	p[2] = _mm_alignr_epi8(c, b, 8);
+	p[3] = _mm_srli_si128(c, 4);
+}
+
+//! Joins four vectors with 4 pixels of 3 bytes each, the upper 4 bytes have to be 0
+IRR_TARGET_SSSE3 static inline void store3x16(u8* dB, const __m128i* p)
+{
+	_mm_storeu_si128((__m128i*)dB, _mm_or_si128(p[0], _mm_slli_si128(p[1], 12)));
+	_mm_storeu_si128((__m128i*)(dB + 16), _mm_or_si128(_mm_srli_si128(p[1], 4), _mm_slli_si128(p[2], 8)));
+	_mm_storeu_si128((__m128i*)(dB + 32), _mm_or_si128(_mm_srli_si128(p[2], 8), _mm_slli_si128(p[3], 4)));
+}
+
+IRR_TARGET_SSSE3 static s32 shuffle3to4_SSSE3(const void* sP, s32 sN, void* dP, const u8* shuffle)
+{
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	const __m128i mask = _mm_load_si128((const __m128i*)shuffle);
+	const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		__m128i p[4];
+		load3x16(sB, p);
+		for (u32 i = 0; i < 4; ++i)
+			_mm_storeu_si128((__m128i*)dB + i, _mm_or_si128(_mm_shuffle_epi8(p[i], mask), alpha));
+		sB += 48;
+		dB += 64;
+	}
+	return x;
+}
+
+IRR_TARGET_SSSE3 static s32 shuffle4to3_SSSE3(const void* sP, s32 sN, void* dP, const u8* shuffle)
+{
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	const __m128i mask = _mm_load_si128((const __m128i*)shuffle);
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		__m128i p[4];
+		for (u32 i = 0; i < 4; ++i)
+			p[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)sB + i), mask);
+		store3x16(dB, p);
+		sB += 64;
+		dB += 48;
+	}
+	return x;
+}
+
+IRR_TARGET_SSSE3 static s32 shuffle3to3_SSSE3(const void* sP, s32 sN, void* dP, const u8* shuffle)
+{
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	const __m128i mask = _mm_load_si128((const __m128i*)shuffle);
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		__m128i p[4];
+		load3x16(sB, p);
+		for (u32 i = 0; i < 4; ++i)
+			p[i] = _mm_shuffle_epi8(p[i], mask);
+		store3x16(dB, p);
+		sB += 48;
+		dB += 48;
+	}
+	return x;
+}
+
+IRR_TARGET_SSSE3 static s32 shuffle4to4_SSSE3(const void* sP, s32 sN, void* dP, const u8* shuffle)
+{
+	const __m128i* sB = (const __m128i*)sP;
+	__m128i* dB = (__m128i*)dP;
+	const __m128i mask = _mm_load_si128((const __m128i*)shuffle);
+
+	s32 x = 0;
+	for (; x + 4 <= sN; x += 4)
+		_mm_storeu_si128(dB++, _mm_shuffle_epi8(_mm_loadu_si128(sB++), mask));
+	return x;
+}
+
+IRR_TARGET_SSSE3 static s32 convert_A1R5G5B5toA8R8G8B8_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	const u16* sB = (const u16*)sP;
+	u32* dB = (u32*)dP;
+	const __m128i mask5 = _mm_set1_epi16(0x1f);
+
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)(sB + x));
+		__m128i r = _mm_and_si128(_mm_srli_epi16(c, 10), mask5);
+		__m128i g = _mm_and_si128(_mm_srli_epi16(c, 5), mask5);
+		__m128i b = _mm_and_si128(c, mask5);
+		// extend the lower bits with the high bits, like A1R5G5B5toA8R8G8B8()
+		r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+		g = _mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2));
+		b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+		const __m128i a = _mm_slli_epi16(_mm_srai_epi16(c, 15), 8);
+
+		const __m128i gb = _mm_or_si128(_mm_slli_epi16(g, 8), b);
+		const __m128i ar = _mm_or_si128(a, r);
+		_mm_storeu_si128((__m128i*)(dB + x), _mm_unpacklo_epi16(gb, ar));
+		_mm_storeu_si128((__m128i*)(dB + x + 4), _mm_unpackhi_epi16(gb, ar));
+	}
+	return x;
+}
+
+IRR_TARGET_SSSE3 static s32 convert_R5G6B5toA8R8G8B8_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	const u16* sB = (const u16*)sP;
+	u32* dB = (u32*)dP;
+
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)(sB + x));
+		const __m128i gb = _mm_or_si128(
+			_mm_and_si128(_mm_slli_epi16(c, 5), _mm_set1_epi16((short)0xfc00)),
+			_mm_and_si128(_mm_slli_epi16(c, 3), _mm_set1_epi16(0x00f8)));
+		const __m128i ar = _mm_or_si128(
+			_mm_and_si128(_mm_srli_epi16(c, 8), _mm_set1_epi16(0x00f8)),
+			_mm_set1_epi16((short)0xff00));
+		_mm_storeu_si128((__m128i*)(dB + x), _mm_unpacklo_epi16(gb, ar));
+		_mm_storeu_si128((__m128i*)(dB + x + 4), _mm_unpackhi_epi16(gb, ar));
+	}
+	return x;
+}
+
+//! Packs two vectors of 16 bit values in 32 bit lanes
+IRR_TARGET_SSSE3 static inline __m128i packLowWords(__m128i lo, __m128i hi)
+{
+	// sign extend, so the signed saturation of packs keeps the bits
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+//! A1R5G5B5 of four A8R8G8B8 pixels in the low words
+IRR_TARGET_SSSE3 static inline __m128i toA1R5G5B5_SSSE3(__m128i c)
+{
+	return _mm_or_si128(
+		_mm_or_si128(
+			_mm_and_si128(_mm_srli_epi32(c, 16), _mm_set1_epi32(0x8000)),
+			_mm_and_si128(_mm_srli_epi32(c, 9), _mm_set1_epi32(0x7c00))),
+		_mm_or_si128(
+			_mm_and_si128(_mm_srli_epi32(c, 6), _mm_set1_epi32(0x03e0)),
+			_mm_and_si128(_mm_srli_epi32(c, 3), _mm_set1_epi32(0x001f))));
+}
+
+//! R5G6B5 of four A8R8G8B8 pixels in the low words
+IRR_TARGET_SSSE3 static inline __m128i toR5G6B5_SSSE3(__m128i c)
+{
+	return _mm_or_si128(
+		_mm_and_si128(_mm_srli_epi32(c, 8), _mm_set1_epi32(0xf800)),
+		_mm_or_si128(
+			_mm_and_si128(_mm_srli_epi32(c, 5), _mm_set1_epi32(0x07e0)),
+			_mm_and_si128(_mm_srli_epi32(c, 3), _mm_set1_epi32(0x001f))));
+}
+
+IRR_TARGET_SSSE3 static s32 convert_A8R8G8B8toA1R5G5B5_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	const u32* sB = (const u32*)sP;
+	u16* dB = (u16*)dP;
+
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8)
+	{
+		const __m128i lo = toA1R5G5B5_SSSE3(_mm_loadu_si128((const __m128i*)(sB + x)));
+		const __m128i hi = toA1R5G5B5_SSSE3(_mm_loadu_si128((const __m128i*)(sB + x + 4)));
+		_mm_storeu_si128((__m128i*)(dB + x), packLowWords(lo, hi));
+	}
+	return x;
+}
+
+IRR_TARGET_SSSE3 static s32 convert_A8R8G8B8toR5G6B5_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	const u32* sB = (const u32*)sP;
+	u16* dB = (u16*)dP;
+
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8)
+	{
+		const __m128i lo = toR5G6B5_SSSE3(_mm_loadu_si128((const __m128i*)(sB + x)));
+		const __m128i hi = toR5G6B5_SSSE3(_mm_loadu_si128((const __m128i*)(sB + x + 4)));
+		_mm_storeu_si128((__m128i*)(dB + x), packLowWords(lo, hi));
+	}
+	return x;
+}
+
+IRR_TARGET_SSSE3 static s32 convert_A8R8G8B8toR8G8B8_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	return shuffle4to3_SSSE3(sP, sN, dP, ShuffleBGRAtoRGB);
+}
+
+IRR_TARGET_SSSE3 static s32 convert_A8R8G8B8toB8G8R8_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	return shuffle4to3_SSSE3(sP, sN, dP, ShuffleBGRAtoBGR);
+}
+
+IRR_TARGET_SSSE3 static s32 convert_R8G8B8toA8R8G8B8_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	return shuffle3to4_SSSE3(sP, sN, dP, ShuffleRGBtoBGRA);
+}
+
+IRR_TARGET_SSSE3 static s32 convert_B8G8R8toA8R8G8B8_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	return shuffle3to4_SSSE3(sP, sN, dP, ShuffleBGRtoBGRA);
+}
+
+IRR_TARGET_SSSE3 static s32 convert_R8G8B8toB8G8R8_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	return shuffle3to3_SSSE3(sP, sN, dP, ShuffleRGBtoBGR);
+}
+
+IRR_TARGET_SSSE3 static s32 convert_A8R8G8B8toA8B8G8R8_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	return shuffle4to4_SSSE3(sP, sN, dP, ShuffleBGRAtoRGBA);
+}
+
+IRR_TARGET_SSSE3 static s32 convert_A8R8G8B8toR8G8B8A8_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	return shuffle4to4_SSSE3(sP, sN, dP, ShuffleBGRAtoABGR);
+}
+
+IRR_TARGET_SSSE3 static s32 convert_B8G8R8A8toA8R8G8B8_SSSE3(const void* sP, s32 sN, void* dP)
+{
+	return shuffle4to4_SSSE3(sP, sN, dP, ShuffleARGBtoBGRA);
+}
+
+
+// ---------- AVX2 ----------
+// _mm256_shuffle_epi8 works within 128 bit lanes, so the 3 byte formats
+// without a 4 byte side are left to SSSE3.
+
+IRR_TARGET_AVX2 static s32 shuffle3to4_AVX2(const void* sP, s32 sN, void* dP, const u8* shuffle)
+{
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+	// the upper lane is loaded 8 bytes further, its pixels start at byte 4
+	const __m128i mask = _mm_load_si128((const __m128i*)shuffle);
+	const __m256i masks = _mm256_inserti128_si256(_mm256_castsi128_si256(mask),
+		_mm_add_epi8(mask, _mm_set1_epi8(4)), 1);
+	const __m256i alpha = _mm256_set1_epi32((int)0xff000000);
+
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8)
+	{
+		const __m128i lo = _mm_loadu_si128((const __m128i*)sB);
+		const __m128i hi = _mm_loadu_si128((const __m128i*)(sB + 8));
+		const __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+		_mm256_storeu_si256((__m256i*)dB, _mm256_or_si256(_mm256_shuffle_epi8(v, masks), alpha));
+		sB += 24;
+		dB += 32;
+	}
+	return x;
+}
+
+IRR_TARGET_AVX2 static s32 shuffle4to4_AVX2(const void* sP, s32 sN, void* dP, const u8* shuffle)
+{
+	const __m256i* sB = (const __m256i*)sP;
+	__m256i* dB = (__m256i*)dP;
+	const __m256i mask = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)shuffle));
+
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8)
+		_mm256_storeu_si256(dB++, _mm256_shuffle_epi8(_mm256_loadu_si256(sB++), mask));
+	return x;
+}
+
+//! Interleaves the words of gb and ar to 16 pixels of A8R8G8B8
+IRR_TARGET_AVX2 static inline void storeA8R8G8B8_AVX2(u32* dB, __m256i gb, __m256i ar)
+{
+	// unpack works per lane, swap the middle quarters so the pixels stay in order
+	gb = _mm256_permute4x64_epi64(gb, 0xd8);
+	ar = _mm256_permute4x64_epi64(ar, 0xd8);
+	_mm256_storeu_si256((__m256i*)dB, _mm256_unpacklo_epi16(gb, ar));
+	_mm256_storeu_si256((__m256i*)(dB + 8), _mm256_unpackhi_epi16(gb, ar));
+}
+
+IRR_TARGET_AVX2 static s32 convert_A1R5G5B5toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	const u16* sB = (const u16*)sP;
+	u32* dB = (u32*)dP;
+	const __m256i mask5 = _mm256_set1_epi16(0x1f);
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		const __m256i c = _mm256_loadu_si256((const __m256i*)(sB + x));
+		__m256i r = _mm256_and_si256(_mm256_srli_epi16(c, 10), mask5);
+		__m256i g = _mm256_and_si256(_mm256_srli_epi16(c, 5), mask5);
+		__m256i b = _mm256_and_si256(c, mask5);
+		r = _mm256_or_si256(_mm256_slli_epi16(r, 3), _mm256_srli_epi16(r, 2));
+		g = _mm256_or_si256(_mm256_slli_epi16(g, 3), _mm256_srli_epi16(g, 2));
+		b = _mm256_or_si256(_mm256_slli_epi16(b, 3), _mm256_srli_epi16(b, 2));
+		const __m256i a = _mm256_slli_epi16(_mm256_srai_epi16(c, 15), 8);
+
+		storeA8R8G8B8_AVX2(dB + x, _mm256_or_si256(_mm256_slli_epi16(g, 8), b), _mm256_or_si256(a, r));
+	}
+	return x;
+}
+
+IRR_TARGET_AVX2 static s32 convert_R5G6B5toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	const u16* sB = (const u16*)sP;
+	u32* dB = (u32*)dP;
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		const __m256i c = _mm256_loadu_si256((const __m256i*)(sB + x));
+		const __m256i gb = _mm256_or_si256(
+			_mm256_and_si256(_mm256_slli_epi16(c, 5), _mm256_set1_epi16((short)0xfc00)),
+			_mm256_and_si256(_mm256_slli_epi16(c, 3), _mm256_set1_epi16(0x00f8)));
+		const __m256i ar = _mm256_or_si256(
+			_mm256_and_si256(_mm256_srli_epi16(c, 8), _mm256_set1_epi16(0x00f8)),
+			_mm256_set1_epi16((short)0xff00));
+		storeA8R8G8B8_AVX2(dB + x, gb, ar);
+	}
+	return x;
+}
+
+IRR_TARGET_AVX2 static s32 convert_A8R8G8B8toA1R5G5B5_AVX2(const void* sP, s32 sN, void* dP)
+{
+	const u32* sB = (const u32*)sP;
+	u16* dB = (u16*)dP;
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		__m256i v[2];
+		for (u32 i = 0; i < 2; ++i)
+		{
+			const __m256i c = _mm256_loadu_si256((const __m256i*)(sB + x + i * 8));
+			v[i] = _mm256_or_si256(
+				_mm256_or_si256(
+					_mm256_and_si256(_mm256_srli_epi32(c, 16), _mm256_set1_epi32(0x8000)),
+					_mm256_and_si256(_mm256_srli_epi32(c, 9), _mm256_set1_epi32(0x7c00))),
+				_mm256_or_si256(
+					_mm256_and_si256(_mm256_srli_epi32(c, 6), _mm256_set1_epi32(0x03e0)),
+					_mm256_and_si256(_mm256_srli_epi32(c, 3), _mm256_set1_epi32(0x001f))));
+		}
+		// the values fit into 16 bit, so saturation never happens
+		const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(v[0], v[1]), 0xd8);
+		_mm256_storeu_si256((__m256i*)(dB + x), packed);
+	}
+	return x;
+}
+
+IRR_TARGET_AVX2 static s32 convert_A8R8G8B8toR5G6B5_AVX2(const void* sP, s32 sN, void* dP)
+{
+	const u32* sB = (const u32*)sP;
+	u16* dB = (u16*)dP;
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		__m256i v[2];
+		for (u32 i = 0; i < 2; ++i)
+		{
+			const __m256i c = _mm256_loadu_si256((const __m256i*)(sB + x + i * 8));
+			v[i] = _mm256_or_si256(
+				_mm256_and_si256(_mm256_srli_epi32(c, 8), _mm256_set1_epi32(0xf800)),
+				_mm256_or_si256(
+					_mm256_and_si256(_mm256_srli_epi32(c, 5), _mm256_set1_epi32(0x07e0)),
+					_mm256_and_si256(_mm256_srli_epi32(c, 3), _mm256_set1_epi32(0x001f))));
+		}
+		const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(v[0], v[1]), 0xd8);
+		_mm256_storeu_si256((__m256i*)(dB + x), packed);
+	}
+	return x;
+}
+
+IRR_TARGET_AVX2 static s32 convert_R8G8B8toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	return shuffle3to4_AVX2(sP, sN, dP, ShuffleRGBtoBGRA);
+}
+
+IRR_TARGET_AVX2 static s32 convert_B8G8R8toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	return shuffle3to4_AVX2(sP, sN, dP, ShuffleBGRtoBGRA);
+}
+
+IRR_TARGET_AVX2 static s32 convert_A8R8G8B8toA8B8G8R8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	return shuffle4to4_AVX2(sP, sN, dP, ShuffleBGRAtoRGBA);
+}
+
+IRR_TARGET_AVX2 static s32 convert_A8R8G8B8toR8G8B8A8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	return shuffle4to4_AVX2(sP, sN, dP, ShuffleBGRAtoABGR);
+}
+
+IRR_TARGET_AVX2 static s32 convert_B8G8R8A8toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	return shuffle4to4_AVX2(sP, sN, dP, ShuffleARGBtoBGRA);
+}
+
+
+static bool cpuHasSSSE3()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 9)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+static bool cpuHasAVX2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 1);
+	// the OS has to save the ymm registers
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	if (!osxsave || (_xgetbv(0) & 6) != 6)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // _IRR_COLOR_CONVERTER_X86_
+
+
+#ifdef _IRR_COLOR_CONVERTER_NEON_
+
+// ---------- NEON ----------
+// The structured loads and stores split and join the channels, so the
+// kernels only reorder registers. Memory order of A8R8G8B8 is B,G,R,A.
+
+static s32 convert_A1R5G5B5toA8R8G8B8_NEON(const void* sP, s32 sN, void* dP)
+{
+	const u16* sB = (const u16*)sP;
+	u8* dB = (u8*)dP;
+	const uint16x8_t mask5 = vdupq_n_u16(0x1f);
+
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8)
+	{
+		const uint16x8_t c = vld1q_u16(sB + x);
+		const uint16x8_t r = vandq_u16(vshrq_n_u16(c, 10), mask5);
+		const uint16x8_t g = vandq_u16(vshrq_n_u16(c, 5), mask5);
+		const uint16x8_t b = vandq_u16(c, mask5);
+
+		uint8x8x4_t out;
+		out.val[0] = vmovn_u16(vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2)));
+		out.val[1] = vmovn_u16(vorrq_u16(vshlq_n_u16(g, 3), vshrq_n_u16(g, 2)));
+		out.val[2] = vmovn_u16(vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2)));
+		out.val[3] = vmovn_u16(vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(c), 15)));
+		vst4_u8(dB + x * 4, out);
+	}
+	return x;
+}
+
+static s32 convert_R5G6B5toA8R8G8B8_NEON(const void* sP, s32 sN, void* dP)
+{
+	const u16* sB = (const u16*)sP;
+	u8* dB = (u8*)dP;
+
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8)
+	{
+		const uint16x8_t c = vld1q_u16(sB + x);
+
+		uint8x8x4_t out;
+		out.val[0] = vshl_n_u8(vmovn_u16(c), 3);
+		out.val[1] = vand_u8(vshrn_n_u16(c, 3), vdup_n_u8(0xfc));
+		out.val[2] = vand_u8(vshrn_n_u16(c, 8), vdup_n_u8(0xf8));
+		out.val[3] = vdup_n_u8(0xff);
+		vst4_u8(dB + x * 4, out);
+	}
+	return x;
+}
+
+static s32 convert_A8R8G8B8toA1R5G5B5_NEON(const void* sP, s32 sN, void* dP)
+{
+	const u8* sB = (const u8*)sP;
+	u16* dB = (u16*)dP;
+
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8)
+	{
+		const uint8x8x4_t c = vld4_u8(sB + x * 4);
+		uint16x8_t v = vshlq_n_u16(vmovl_u8(vshr_n_u8(c.val[3], 7)), 15);
+		v = vorrq_u16(v, vshlq_n_u16(vmovl_u8(vshr_n_u8(c.val[2], 3)), 10));
+		v = vorrq_u16(v, vshlq_n_u16(vmovl_u8(vshr_n_u8(c.val[1], 3)), 5));
+		v = vorrq_u16(v, vmovl_u8(vshr_n_u8(c.val[0], 3)));
+		vst1q_u16(dB + x, v);
+	}
+	return x;
+}
+
+static s32 convert_A8R8G8B8toR5G6B5_NEON(const void* sP, s32 sN, void* dP)
+{
+	const u8* sB = (const u8*)sP;
+	u16* dB = (u16*)dP;
+
+	s32 x = 0;
+	for (; x + 8 <= sN; x += 8)
+	{
+		const uint8x8x4_t c = vld4_u8(sB + x * 4);
+		uint16x8_t v = vshlq_n_u16(vmovl_u8(vshr_n_u8(c.val[2], 3)), 11);
+		v = vorrq_u16(v, vshlq_n_u16(vmovl_u8(vshr_n_u8(c.val[1], 2)), 5));
+		v = vorrq_u16(v, vmovl_u8(vshr_n_u8(c.val[0], 3)));
+		vst1q_u16(dB + x, v);
+	}
+	return x;
+}
+
+static s32 convert_A8R8G8B8toR8G8B8_NEON(const void* sP, s32 sN, void* dP)
+{
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		const uint8x16x4_t c = vld4q_u8(sB + x * 4);
+		uint8x16x3_t out;
+		out.val[0] = c.val[2];
+		out.val[1] = c.val[1];
+		out.val[2] = c.val[0];
+		vst3q_u8(dB + x * 3, out);
+	}
+	return x;
+}
+
+static s32 convert_A8R8G8B8toB8G8R8_NEON(const void* sP, s32 sN, void* dP)
+{
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		const uint8x16x4_t c = vld4q_u8(sB + x * 4);
+		uint8x16x3_t out;
+		out.val[0] = c.val[0];
+		out.val[1] = c.val[1];
+		out.val[2] = c.val[2];
+		vst3q_u8(dB + x * 3, out);
+	}
+	return x;
+}
+
+static s32 convert_R8G8B8toA8R8G8B8_NEON(const void* sP, s32 sN, void* dP)
+{
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		const uint8x16x3_t c = vld3q_u8(sB + x * 3);
+		uint8x16x4_t out;
+		out.val[0] = c.val[2];
+		out.val[1] = c.val[1];
+		out.val[2] = c.val[0];
+		out.val[3] = vdupq_n_u8(0xff);
+		vst4q_u8(dB + x * 4, out);
+	}
+	return x;
+}
+
+static s32 convert_B8G8R8toA8R8G8B8_NEON(const void* sP, s32 sN, void* dP)
+{
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		const uint8x16x3_t c = vld3q_u8(sB + x * 3);
+		uint8x16x4_t out;
+		out.val[0] = c.val[0];
+		out.val[1] = c.val[1];
+		out.val[2] = c.val[2];
+		out.val[3] = vdupq_n_u8(0xff);
+		vst4q_u8(dB + x * 4, out);
+	}
+	return x;
+}
+
+static s32 convert_R8G8B8toB8G8R8_NEON(const void* sP, s32 sN, void* dP)
+{
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		uint8x16x3_t c = vld3q_u8(sB + x * 3);
+		const uint8x16_t r = c.val[0];
+		c.val[0] = c.val[2];
+		c.val[2] = r;
+		vst3q_u8(dB + x * 3, c);
+	}
+	return x;
+}
+
+//! Reorders the 4 byte channels, out channel i is taken from in channel order[i]
+template <u32 A, u32 B, u32 C, u32 D>
+static s32 shuffle4to4_NEON(const void* sP, s32 sN, void* dP)
+{
+	const u8* sB = (const u8*)sP;
+	u8* dB = (u8*)dP;
+
+	s32 x = 0;
+	for (; x + 16 <= sN; x += 16)
+	{
+		const uint8x16x4_t c = vld4q_u8(sB + x * 4);
+		uint8x16x4_t out;
+		out.val[0] = c.val[A];
+		out.val[1] = c.val[B];
+		out.val[2] = c.val[C];
+		out.val[3] = c.val[D];
+		vst4q_u8(dB + x * 4, out);
+	}
+	return x;
+}
+
+#endif // _IRR_COLOR_CONVERTER_NEON_
+
+
+bool isColorConvertSIMDSupported(CColorConverter::E_SIMD_LEVEL level)
+{
+	switch (level)
+	{
+	case CColorConverter::ESL_SCALAR:
+		return true;
+#ifdef _IRR_COLOR_CONVERTER_X86_
+	case CColorConverter::ESL_SSSE3:
+		return cpuHasSSSE3();
+	case CColorConverter::ESL_AVX2:
+		return cpuHasSSSE3() && cpuHasAVX2();
+#endif
+#ifdef _IRR_COLOR_CONVERTER_NEON_
+	case CColorConverter::ESL_NEON:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+
+SColorConvertKernels getColorConvertKernels(CColorConverter::E_SIMD_LEVEL level)
+{
+	SColorConvertKernels k = {};
+
+#ifdef _IRR_COLOR_CONVERTER_X86_
+	if (level == CColorConverter::ESL_SSSE3 || level == CColorConverter::ESL_AVX2)
+	{
+		k.A1R5G5B5toA8R8G8B8 = convert_A1R5G5B5toA8R8G8B8_SSSE3;
+		k.R5G6B5toA8R8G8B8 = convert_R5G6B5toA8R8G8B8_SSSE3;
+		k.A8R8G8B8toA1R5G5B5 = convert_A8R8G8B8toA1R5G5B5_SSSE3;
+		k.A8R8G8B8toR5G6B5 = convert_A8R8G8B8toR5G6B5_SSSE3;
+		k.A8R8G8B8toR8G8B8 = convert_A8R8G8B8toR8G8B8_SSSE3;
+		k.A8R8G8B8toB8G8R8 = convert_A8R8G8B8toB8G8R8_SSSE3;
+		k.R8G8B8toA8R8G8B8 = convert_R8G8B8toA8R8G8B8_SSSE3;
+		k.B8G8R8toA8R8G8B8 = convert_B8G8R8toA8R8G8B8_SSSE3;
+		k.R8G8B8toB8G8R8 = convert_R8G8B8toB8G8R8_SSSE3;
+		k.A8R8G8B8toA8B8G8R8 = convert_A8R8G8B8toA8B8G8R8_SSSE3;
+		k.A8R8G8B8toR8G8B8A8 = convert_A8R8G8B8toR8G8B8A8_SSSE3;
+		k.B8G8R8A8toA8R8G8B8 = convert_B8G8R8A8toA8R8G8B8_SSSE3;
+	}
+	if (level == CColorConverter::ESL_AVX2)
+	{
+		k.A1R5G5B5toA8R8G8B8 = convert_A1R5G5B5toA8R8G8B8_AVX2;
+		k.R5G6B5toA8R8G8B8 = convert_R5G6B5toA8R8G8B8_AVX2;
+		k.A8R8G8B8toA1R5G5B5 = convert_A8R8G8B8toA1R5G5B5_AVX2;
+		k.A8R8G8B8toR5G6B5 = convert_A8R8G8B8toR5G6B5_AVX2;
+		k.R8G8B8toA8R8G8B8 = convert_R8G8B8toA8R8G8B8_AVX2;
+		k.B8G8R8toA8R8G8B8 = convert_B8G8R8toA8R8G8B8_AVX2;
+		k.A8R8G8B8toA8B8G8R8 = convert_A8R8G8B8toA8B8G8R8_AVX2;
+		k.A8R8G8B8toR8G8B8A8 = convert_A8R8G8B8toR8G8B8A8_AVX2;
+		k.B8G8R8A8toA8R8G8B8 = convert_B8G8R8A8toA8R8G8B8_AVX2;
+	}
+#endif
+
+#ifdef _IRR_COLOR_CONVERTER_NEON_
+	if (level == CColorConverter::ESL_NEON)
+	{
+		k.A1R5G5B5toA8R8G8B8 = convert_A1R5G5B5toA8R8G8B8_NEON;
+		k.R5G6B5toA8R8G8B8 = convert_R5G6B5toA8R8G8B8_NEON;
+		k.A8R8G8B8toA1R5G5B5 = convert_A8R8G8B8toA1R5G5B5_NEON;
+		k.A8R8G8B8toR5G6B5 = convert_A8R8G8B8toR5G6B5_NEON;
+		k.A8R8G8B8toR8G8B8 = convert_A8R8G8B8toR8G8B8_NEON;
+		k.A8R8G8B8toB8G8R8 = convert_A8R8G8B8toB8G8R8_NEON;
+		k.R8G8B8toA8R8G8B8 = convert_R8G8B8toA8R8G8B8_NEON;
+		k.B8G8R8toA8R8G8B8 = convert_B8G8R8toA8R8G8B8_NEON;
+		k.R8G8B8toB8G8R8 = convert_R8G8B8toB8G8R8_NEON;
+		// memory order B,G,R,A to R,G,B,A / A,B,G,R and A,R,G,B to B,G,R,A
+		k.A8R8G8B8toA8B8G8R8 = shuffle4to4_NEON<2,1,0,3>;
+		k.A8R8G8B8toR8G8B8A8 = shuffle4to4_NEON<3,0,1,2>;
+		k.B8G8R8A8toA8R8G8B8 = shuffle4to4_NEON<3,2,1,0>;
+	}
+#endif
+
+	(void)level;
+	return k;
+}
+
+} // end namespace video
+} // end namespace irr
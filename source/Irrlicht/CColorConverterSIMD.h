@@ -0,0 +1,42 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "CColorConverter.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Vectorized part of a conversion
+/** Converts as many pixels from the start as fit into whole vectors and
+returns their number, the scalar loop in CColorConverter does the rest. */
+typedef s32 (*ColorConvertKernel)(const void* sP, s32 sN, void* dP);
+
+//! Kernels of one instruction set, 0 where it has none
+struct SColorConvertKernels
+{
+	ColorConvertKernel A1R5G5B5toA8R8G8B8;
+	ColorConvertKernel R5G6B5toA8R8G8B8;
+	ColorConvertKernel A8R8G8B8toA1R5G5B5;
+	ColorConvertKernel A8R8G8B8toR5G6B5;
+	ColorConvertKernel A8R8G8B8toR8G8B8;
+	ColorConvertKernel A8R8G8B8toB8G8R8;
+	ColorConvertKernel R8G8B8toA8R8G8B8;
+	ColorConvertKernel B8G8R8toA8R8G8B8;
+	ColorConvertKernel R8G8B8toB8G8R8;
+	ColorConvertKernel A8R8G8B8toA8B8G8R8;
+	ColorConvertKernel A8R8G8B8toR8G8B8A8;
+	ColorConvertKernel B8G8R8A8toA8R8G8B8;
+};
+
+//! Returns true if the CPU and this build support the instruction set
+bool isColorConvertSIMDSupported(CColorConverter::E_SIMD_LEVEL level);
+
+//! Returns the kernels for an instruction set, all 0 for ESL_SCALAR
+SColorConvertKernels getColorConvertKernels(CColorConverter::E_SIMD_LEVEL level);
+
+} // end namespace video
+} // end namespace irr
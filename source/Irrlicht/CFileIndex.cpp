@@ -0,0 +1,167 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CFileIndex.h"
+#include "IFileList.h"
+
+namespace irr
+{
+namespace io
+{
+
+//! Longest name looked up in the index, longer ones are searched in the archives
+static const u32 MAX_INDEXED_NAME = 1024;
+
+
+CFileIndex::CFileIndex()
+	: UsedRules(0), Complete(true)
+{
+}
+
+
+//! Indexes an archive with less priority than the ones added before
+void CFileIndex::addArchive(const IFileArchive* archive)
+{
+	const u32 archiveIndex = Lists.size();
+	const IFileList* list = archive->getFileList();
+	Lists.push_back(list);
+
+	// CFileList compares names ignoring the case in any case, ignoreCase
+	// only tells if they are stored in lower case
+	bool ignoreCase, ignorePaths;
+	if (!list || !list->getNameRules(ignoreCase, ignorePaths))
+	{
+		Complete = false;
+		return;
+	}
+
+	const u32 rules = ignorePaths ? ER_IGNORE_PATHS : 0;
+	UsedRules |= 1 << rules;
+
+	const u32 count = list->getFileCount();
+	Entries.reserve(Entries.size() + count);
+	io::path name;
+	for (u32 i = 0; i < count; ++i)
+	{
+		name = list->getFullFileName(i);
+		if (!ignoreCase)
+			name.make_lower();
+		const u32 entryRules = rules | (list->isDirectory(i) ? ER_DIRECTORY : 0);
+
+		// archives added before hide the same name
+		if (find(name.c_str(), name.size(), entryRules))
+			continue;
+
+		Entries.emplace(hash(name.c_str(), name.size(), entryRules), SEntry{archiveIndex, i, entryRules});
+	}
+}
+
+
+//! Indexes all archives again, the first has the highest priority
+void CFileIndex::rebuild(const core::array<IFileArchive*>& archives)
+{
+	Entries.clear();
+	Lists.clear();
+	UsedRules = 0;
+	Complete = true;
+
+	for (u32 i = 0; i < archives.size(); ++i)
+		addArchive(archives[i]);
+}
+
+
+//! Looks up a file like IFileList::findFile() would in every archive
+CFileIndex::E_LOOKUP CFileIndex::findFile(const io::path& filename, bool isDirectory, u32& archive, u32& file) const
+{
+	if (!Complete || filename.size() >= MAX_INDEXED_NAME)
+		return EL_UNKNOWN;
+	if (Lists.empty())
+		return EL_MISSING;
+
+	// same normalization as CFileList::findFile, with the case of
+	// SFileListEntry's comparison
+	fschar_t name[MAX_INDEXED_NAME];
+	u32 length = filename.size();
+	for (u32 i = 0; i < length; ++i)
+		name[i] = filename[i] == '\\' ? '/' : (fschar_t)core::locale_lower(filename[i]);
+
+	if (length && name[length-1] == '/')
+	{
+		isDirectory = true;
+		--length;
+	}
+
+	// a separator at the start is not removed by deletePathFromFilename
+	u32 nameStart = length;
+	while (nameStart > 0 && name[nameStart-1] != '/')
+		--nameStart;
+	if (nameStart == 1)
+		nameStart = 0;
+
+	const SEntry* best = 0;
+	for (u32 rules = 0; rules <= ER_IGNORE_PATHS; rules += ER_IGNORE_PATHS)
+	{
+		if (!(UsedRules & (1 << rules)))
+			continue;
+
+		const fschar_t* s = name;
+		u32 l = length;
+		if (rules & ER_IGNORE_PATHS)
+		{
+			s += nameStart;
+			l -= nameStart;
+		}
+
+		const SEntry* entry = find(s, l, rules | (isDirectory ? ER_DIRECTORY : 0));
+		if (entry && (!best || entry->Archive < best->Archive))
+			best = entry;
+	}
+
+	if (!best)
+		return EL_MISSING;
+
+	archive = best->Archive;
+	file = best->File;
+	return EL_FOUND;
+}
+
+
+u64 CFileIndex::hash(const fschar_t* name, u32 length, u32 rules)
+{
+	// FNV-1a
+	u64 h = 14695981039346656037ULL ^ rules;
+	for (u32 i = 0; i < length; ++i)
+	{
+		h ^= (u64)name[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+
+//! Returns the entry of a normalized name, or 0
+const CFileIndex::SEntry* CFileIndex::find(const fschar_t* name, u32 length, u32 rules) const
+{
+	auto range = Entries.equal_range(hash(name, length, rules));
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		const SEntry& entry = it->second;
+		if (entry.Rules != rules)
+			continue;
+
+		const io::path& other = Lists[entry.Archive]->getFullFileName(entry.File);
+		if (other.size() != length)
+			continue;
+
+		u32 i = 0;
+		while (i < length && (fschar_t)core::locale_lower(other[i]) == name[i])
+			++i;
+		if (i == length)
+			return &entry;
+	}
+	return 0;
+}
+
+
+} // end namespace io
+} // end namespace irr
@@ -0,0 +1,81 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IFileArchive.h"
+#include "irrArray.h"
+#include <unordered_map>
+
+namespace irr
+{
+namespace io
+{
+
+	//! Hash index of the files in all archives of a file system
+	/** Maps the lower case names in the file lists of the archives to
+	the first archive containing them. A lookup normalizes and hashes
+	the name once, or twice when some archives ignore paths, instead of
+	searching each archive, and allocates nothing. The file lists must
+	not change while their archives are indexed. */
+	class CFileIndex
+	{
+	public:
+
+		//! Result of a lookup
+		enum E_LOOKUP
+		{
+			//! An archive contains the file
+			EL_FOUND,
+			//! No archive contains the file
+			EL_MISSING,
+			//! The archives have to be searched one by one
+			EL_UNKNOWN
+		};
+
+		CFileIndex();
+
+		//! Indexes an archive with less priority than the ones added before
+		void addArchive(const IFileArchive* archive);
+
+		//! Indexes all archives again, the first has the highest priority
+		void rebuild(const core::array<IFileArchive*>& archives);
+
+		//! Looks up a file like IFileList::findFile() would in every archive
+		/** \param archive Receives the index of the archive on EL_FOUND
+		\param file Receives the index of the file in its list on EL_FOUND */
+		E_LOOKUP findFile(const io::path& filename, bool isDirectory, u32& archive, u32& file) const;
+
+	private:
+
+		struct SEntry
+		{
+			u32 Archive;
+			u32 File;
+			//! If the list ignores paths, and if the entry is a directory
+			u32 Rules;
+		};
+
+		//! Rule bits of SEntry
+		enum E_RULES
+		{
+			ER_IGNORE_PATHS = 1,
+			ER_DIRECTORY = 2
+		};
+
+		static u64 hash(const fschar_t* name, u32 length, u32 rules);
+
+		//! Returns the entry of a normalized name, or 0
+		const SEntry* find(const fschar_t* name, u32 length, u32 rules) const;
+
+		std::unordered_multimap<u64, SEntry> Entries;
+		//! File lists of the indexed archives
+		core::array<const IFileList*> Lists;
+		//! Bit mask of the rules without ER_DIRECTORY used by the lists
+		u32 UsedRules;
+		//! False if a list does not tell its name rules
+		bool Complete;
+	};
+
+} // end namespace io
+} // end namespace irr
@@ -16,7 +16,7 @@ namespace io
 static const io::path emptyFileListEntry;
 
 CFileList::CFileList(const io::path& path, bool ignoreCase, bool ignorePaths)
- : IgnorePaths(ignorePaths), IgnoreCase(ignoreCase), Path(path)
+ : IgnorePaths(ignorePaths), IgnoreCase(ignoreCase), Path(path), Sorted(true)
 {
 	#ifdef _DEBUG
 	setDebugName("CFileList");
@@ -38,6 +38,7 @@ u32 CFileList::getFileCount() const
 void CFileList::sort()
 {
 	Files.sort();
+	Sorted = true;
 }
 
 const io::path& CFileList::getFileName(u32 index) const
@@ -90,6 +91,7 @@ u32 CFileList::addItem(const io::path& fullPath, u32 offset, u32 size, bool isDi
 	//os::Printer::log(Path.c_str(), entry.FullName);
 
 	Files.push_back(entry);
+	Sorted = false;
 
 	return Files.size() - 1;
 }
@@ -121,32 +123,80 @@ u32 CFileList::getFileOffset(u32 index) const
 }
 
 
+//! Compares a name like SFileListEntry::operator< does, with backslashes read as slashes
+static s32 compareFileName(const io::path& entryName, io::path_view name)
+{
+	const u32 count = core::min_(entryName.size(), (u32)name.size());
+	for (u32 i = 0; i < count; ++i)
+	{
+		const fschar_t c = name[i] == '\\' ? '/' : name[i];
+		const s32 diff = (s32) core::locale_lower(entryName[i]) - (s32) core::locale_lower(c);
+		if (diff)
+			return diff;
+	}
+	return (s32)entryName.size() - (s32)name.size();
+}
+
+
 //! Searches for a file or folder within the list, returns the index
 s32 CFileList::findFile(const io::path& filename, bool isDirectory = false) const
 {
-	SFileListEntry entry;
-	// we only need FullName to be set for the search
-	entry.FullName = filename;
-	entry.IsDirectory = isDirectory;
-
-	// exchange
-	entry.FullName.replace('\\', '/');
+	// The name is looked at in place instead of building an entry to
+	// search for, as this runs for each file opened. Case doesn't matter
+	// for the order of the entries, so the name isn't made lower case.
+	io::path_view name = filename.view();
 
 	// remove trailing slash
-	if (entry.FullName.lastChar() == '/')
+	if (!name.empty() && (name.back() == '/' || name.back() == '\\'))
 	{
-		entry.IsDirectory = true;
-		entry.FullName[entry.FullName.size()-1] = 0;
-		entry.FullName.validate();
+		isDirectory = true;
+		name.remove_suffix(1);
 	}
 
-	if (IgnoreCase)
-		entry.FullName.make_lower();
-
 	if (IgnorePaths)
-		core::deletePathFromFilename(entry.FullName);
+	{
+		const size_t lastSlash = name.find_last_of(_IRR_TEXT("/\\"));
+		if (lastSlash != io::path_view::npos)
+			name.remove_prefix(lastSlash + 1);
+	}
+
+	if (!Sorted)
+	{
+		for (u32 i = 0; i < Files.size(); ++i)
+		{
+			if (Files[i].IsDirectory == isDirectory && !compareFileName(Files[i].FullName, name))
+				return i;
+		}
+		return -1;
+	}
+
+	// first entry which isn't smaller, like core::array::binary_search()
+	u32 first = 0;
+	u32 count = Files.size();
+	while (count)
+	{
+		const u32 step = count / 2;
+		const SFileListEntry& entry = Files[first + step];
+
+		bool less;
+		if (entry.IsDirectory != isDirectory)
+			less = entry.IsDirectory;
+		else
+			less = compareFileName(entry.FullName, name) < 0;
+
+		if (less)
+		{
+			first += step + 1;
+			count -= step + 1;
+		}
+		else
+			count = step;
+	}
 
-	return Files.binary_search(entry);
+	if (first < Files.size() && Files[first].IsDirectory == isDirectory &&
+			!compareFileName(Files[first].FullName, name))
+		return first;
+	return -1;
 }
 
 
@@ -157,6 +207,15 @@ const io::path& CFileList::getPath() const
 }
 
 
+//! Tells how findFile() compares names
+bool CFileList::getNameRules(bool& ignoreCase, bool& ignorePaths) const
+{
+	ignoreCase = IgnoreCase;
+	ignorePaths = IgnorePaths;
+	return true;
+}
+
+
 } // end namespace irr
 } // end namespace io
 
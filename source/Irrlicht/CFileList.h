@@ -113,6 +113,9 @@ public:
 	//! Returns the base path of the file list
 	const io::path& getPath() const override;
 
+	//! Tells how findFile() compares names
+	bool getNameRules(bool& ignoreCase, bool& ignorePaths) const override;
+
 protected:
 
 	//! Ignore paths when adding or searching for files
@@ -126,6 +129,9 @@ protected:
 
 	//! List of files
 	core::array<SFileListEntry> Files;
+
+	//! False if files were added after the last sort()
+	bool Sorted;
 };
 
 
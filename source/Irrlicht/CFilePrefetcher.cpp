@@ -0,0 +1,244 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CFilePrefetcher.h"
+#include "CReadFile.h"
+#include "IReadFile.h"
+
+#if (defined(_IRR_POSIX_API_) || defined(_IRR_OSX_PLATFORM_) || defined(_IRR_ANDROID_PLATFORM_))
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace irr
+{
+namespace io
+{
+
+CFilePrefetcher::CFilePrefetcher(u64 cacheSize)
+	: CacheSize(0), CacheLimit(cacheSize), Busy(0), Stop(false)
+{
+}
+
+
+CFilePrefetcher::~CFilePrefetcher()
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Stop = true;
+	}
+	Wake.notify_all();
+	for (std::thread& t : Workers)
+		t.join();
+
+	for (auto& it : Entries)
+		delete [] it.second.Data;
+}
+
+
+void CFilePrefetcher::addArchiveFile(IFileArchive* archive, u32 archiveIndex, u32 fileIndex)
+{
+	add(SJob{io::path(), archive, fileIndex, getKey(archiveIndex, fileIndex)});
+}
+
+
+void CFilePrefetcher::addFile(const io::path& absolutePath)
+{
+	add(SJob{absolutePath, 0, 0, 0});
+}
+
+
+void CFilePrefetcher::add(SJob&& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		if (job.Archive)
+		{
+			// already queued or cached, cached ones are kept longer now
+			auto it = Entries.emplace(job.Key, SEntry{0, 0, false, Ages.end()});
+			if (!it.second)
+			{
+				if (it.first->second.Data)
+					Ages.splice(Ages.end(), Ages, it.first->second.Age);
+				return;
+			}
+		}
+		Queue.push_back(std::move(job));
+	}
+
+	if (Workers.empty())
+	{
+		// reading mostly waits for the disk, so be generous
+		const u32 cores = std::thread::hardware_concurrency();
+		const u32 count = cores > 2 ? cores - 1 : 2;
+		for (u32 i = 0; i < count; ++i)
+			Workers.emplace_back(&CFilePrefetcher::run, this);
+	}
+	Wake.notify_one();
+}
+
+
+c8* CFilePrefetcher::take(u32 archiveIndex, u32 fileIndex, long& size)
+{
+	std::unique_lock<std::mutex> lock(Mutex);
+	const u64 key = getKey(archiveIndex, fileIndex);
+
+	auto it = Entries.find(key);
+	while (it != Entries.end() && it->second.Loading)
+	{
+		Finished.wait(lock);
+		it = Entries.find(key);
+	}
+	if (it == Entries.end())
+		return 0;
+
+	// entries which are still queued have no data yet, the worker
+	// skips them once they are erased
+	c8* data = it->second.Data;
+	size = it->second.Size;
+	CacheSize -= size;
+	if (data)
+		Ages.erase(it->second.Age);
+	Entries.erase(it);
+	return data;
+}
+
+
+void CFilePrefetcher::wait()
+{
+	std::unique_lock<std::mutex> lock(Mutex);
+	Finished.wait(lock, [this] { return Queue.empty() && Busy == 0; });
+}
+
+
+void CFilePrefetcher::clear()
+{
+	std::unique_lock<std::mutex> lock(Mutex);
+	Queue.clear();
+	Finished.wait(lock, [this] { return Busy == 0; });
+
+	for (auto& it : Entries)
+		delete [] it.second.Data;
+	Entries.clear();
+	Ages.clear();
+	CacheSize = 0;
+}
+
+
+void CFilePrefetcher::run()
+{
+	std::unique_lock<std::mutex> lock(Mutex);
+	while (true)
+	{
+		Wake.wait(lock, [this] { return Stop || !Queue.empty(); });
+		if (Stop)
+			return;
+
+		SJob job = std::move(Queue.front());
+		Queue.pop_front();
+		if (job.Archive)
+		{
+			auto it = Entries.find(job.Key);
+			if (it == Entries.end())
+			{
+				Finished.notify_all();
+				continue;
+			}
+			it->second.Loading = true;
+		}
+		++Busy;
+
+		lock.unlock();
+		if (job.Archive)
+			readArchiveFile(job);
+		else
+			readAhead(job.Path);
+		lock.lock();
+
+		--Busy;
+		Finished.notify_all();
+	}
+}
+
+
+void CFilePrefetcher::readArchiveFile(const SJob& job)
+{
+	IReadFile* file = job.Archive->createAndOpenFile(job.FileIndex);
+	const long size = file ? file->getSize() : 0;
+
+	bool fits = false;
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		if (file && (u64)size <= CacheLimit)
+		{
+			// make room by dropping what wasn't taken for longest
+			while (CacheSize + size > CacheLimit && !Ages.empty())
+			{
+				auto oldest = Entries.find(Ages.front());
+				delete [] oldest->second.Data;
+				CacheSize -= oldest->second.Size;
+				Entries.erase(oldest);
+				Ages.pop_front();
+			}
+			if (CacheSize + size <= CacheLimit)
+			{
+				CacheSize += size;
+				fits = true;
+			}
+		}
+	}
+
+	c8* data = 0;
+	if (fits)
+	{
+		data = new c8[size];
+		if (file->read(data, size) != (size_t)size)
+		{
+			delete [] data;
+			data = 0;
+		}
+	}
+	if (file)
+		file->drop();
+
+	std::lock_guard<std::mutex> lock(Mutex);
+	SEntry& entry = Entries[job.Key];
+	if (data)
+	{
+		entry.Data = data;
+		entry.Size = size;
+		entry.Loading = false;
+		entry.Age = Ages.insert(Ages.end(), job.Key);
+	}
+	else
+	{
+		// opened normally then
+		if (fits)
+			CacheSize -= size;
+		Entries.erase(job.Key);
+	}
+}
+
+
+void CFilePrefetcher::readAhead(const io::path& absolutePath)
+{
+#if defined(POSIX_FADV_WILLNEED)
+	const int fd = open(absolutePath.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+	posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+	close(fd);
+#else
+	// pull the file into the cache of the operating system
+	IReadFile* file = CReadFile::createReadFile(absolutePath);
+	if (!file)
+		return;
+	c8 buffer[16 * 1024];
+	while (file->read(buffer, sizeof(buffer)) == sizeof(buffer))
+		;
+	file->drop();
+#endif
+}
+
+} // end namespace io
+} // end namespace irr
@@ -0,0 +1,106 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IFileArchive.h"
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace irr
+{
+namespace io
+{
+
+//! Reads files for IFileSystem::prefetch on a pool of threads
+/** Archive entries are read, and inflated, into a cache of limited
+size, which hands each of them out once. When it is full, the entries
+which were prefetched longest ago are dropped for new ones. Files on
+disk are only read ahead by the operating system. */
+class CFilePrefetcher
+{
+public:
+	//! \param cacheSize Limit for the memory of the cached entries
+	CFilePrefetcher(u64 cacheSize = 64 * 1024 * 1024);
+
+	//! Stops the workers and frees the cache
+	~CFilePrefetcher();
+
+	//! Queues an archive entry, starting the workers on first use
+	/** Entries which are cached already count as prefetched just now.
+	\param archiveIndex Position of the archive in the file system
+	\param fileIndex Index of the entry in the file list of the archive */
+	void addArchiveFile(IFileArchive* archive, u32 archiveIndex, u32 fileIndex);
+
+	//! Queues a file on disk, starting the workers on first use
+	void addFile(const io::path& absolutePath);
+
+	//! Takes an archive entry out of the cache
+	/** Waits if the entry is being read right now, and cancels it if
+	it is still queued.
+	\return Contents allocated with new[], or 0 if not cached */
+	c8* take(u32 archiveIndex, u32 fileIndex, long& size);
+
+	//! Waits until all queued files are read
+	void wait();
+
+	//! Cancels all queued files and empties the cache
+	/** Waits for the files which are being read. Call it before the
+	archives change. */
+	void clear();
+
+private:
+	struct SJob
+	{
+		io::path Path;
+		IFileArchive* Archive;
+		u32 FileIndex;
+		u64 Key;
+	};
+
+	struct SEntry
+	{
+		c8* Data;
+		long Size;
+		bool Loading;
+		//! Place in Ages, only valid once Data is set
+		std::list<u64>::iterator Age;
+	};
+
+	static u64 getKey(u32 archiveIndex, u32 fileIndex)
+	{
+		return ((u64)archiveIndex << 32) | fileIndex;
+	}
+
+	void add(SJob&& job);
+
+	void run();
+
+	void readArchiveFile(const SJob& job);
+
+	static void readAhead(const io::path& absolutePath);
+
+	std::mutex Mutex;
+	std::condition_variable Wake;
+	//! Signalled when an entry was read
+	std::condition_variable Finished;
+	std::deque<SJob> Queue;
+	//! Queued, loading and cached archive entries
+	std::unordered_map<u64, SEntry> Entries;
+	//! Keys of the cached entries, the one prefetched longest ago first
+	std::list<u64> Ages;
+	//! Memory of cached entries and of those being read
+	u64 CacheSize;
+	const u64 CacheLimit;
+	u32 Busy;
+	bool Stop;
+	std::vector<std::thread> Workers;
+};
+
+} // end namespace io
+} // end namespace irr
@@ -7,13 +7,16 @@
 #include "IReadFile.h"
 #include "IWriteFile.h"
 #include "CZipReader.h"
+#include "CPackReader.h"
 #include "CFileList.h"
 #include "stdio.h"
 #include "os.h"
 #include "CReadFile.h"
 #include "CMemoryFile.h"
 #include "CLimitReadFile.h"
+#include "CMappedReadFile.h"
 #include "CWriteFile.h"
+#include "CIOStatistics.h"
 #include <list>
 
 #if defined (__STRICT_ANSI__)
@@ -54,6 +57,7 @@ CFileSystem::CFileSystem()
 	getWorkingDirectory();
 
 	ArchiveLoader.push_back(new CArchiveLoaderZIP(this));
+	ArchiveLoader.push_back(new CArchiveLoaderPack(this));
 
 }
 
@@ -63,6 +67,9 @@ CFileSystem::~CFileSystem()
 {
 	u32 i;
 
+	// workers may still read from the archives
+	Prefetcher.clear();
+
 	for ( i=0; i < FileArchives.size(); ++i)
 	{
 		FileArchives[i]->drop();
@@ -82,18 +89,57 @@ IReadFile* CFileSystem::createAndOpenFile(const io::path& filename)
 		return 0;
 
 	IReadFile* file = 0;
-	u32 i;
+	u32 archive, index;
+
+	// archives searched by name, those before it had no usable entry
+	u32 firstArchive = FileArchives.size();
+	switch (FileIndex.findFile(filename, false, archive, index))
+	{
+	case CFileIndex::EL_FOUND:
+		{
+			long size;
+			c8* data = Prefetcher.take(archive, index, size);
+			if (data)
+				file = new CMemoryReadFile(data, size, FileArchives[archive]->getFileList()->getFullFileName(index), true);
+		}
+		if (!file)
+			file = FileArchives[archive]->createAndOpenFile(index);
+		if (file)
+		{
+			getIOStatistics().addFileOpened(FileArchives[archive]->getArchiveName());
+			return file;
+		}
+		// the entry could not be opened, try archives with less priority
+		firstArchive = archive + 1;
+		break;
+	case CFileIndex::EL_UNKNOWN:
+		firstArchive = 0;
+		break;
+	default:
+		break;
+	}
 
-	for (i=0; i< FileArchives.size(); ++i)
+	for (u32 i=firstArchive; i < FileArchives.size(); ++i)
 	{
 		file = FileArchives[i]->createAndOpenFile(filename);
 		if (file)
+		{
+			getIOStatistics().addFileOpened(FileArchives[i]->getArchiveName());
 			return file;
+		}
 	}
 
 	// Create the file using an absolute path so that it matches
 	// the scheme used by CNullDriver::getTexture().
-	return CReadFile::createReadFile(getAbsolutePath(filename));
+	const io::path absolutePath = getCachedAbsolutePath(filename);
+
+	// Mapping costs more than reading small files
+	file = CMappedReadFile::createMappedReadFile(absolutePath, 64 * 1024);
+	if (!file)
+		file = CReadFile::createReadFile(absolutePath);
+	if (file)
+		getIOStatistics().addFileOpened(io::path());
+	return file;
 }
 
 
@@ -130,6 +176,13 @@ IWriteFile* CFileSystem::createMemoryWriteFile(void* memory, s32 len,
 }
 
 
+//! Creates an IWriteFile which writes into memory growing as needed
+IMemoryWriteFile* CFileSystem::createGrowableMemoryWriteFile(const io::path& fileName)
+{
+	return new CGrowableMemoryWriteFile(fileName);
+}
+
+
 //! Opens a file for write access.
 IWriteFile* CFileSystem::createAndWriteFile(const io::path& filename, bool append)
 {
@@ -181,6 +234,11 @@ bool CFileSystem::moveFileArchive(u32 sourceIndex, s32 relative)
 		FileArchives[s] = t;
 		r = true;
 	}
+	if (r)
+	{
+		Prefetcher.clear();
+		FileIndex.rebuild(FileArchives);
+	}
 	return r;
 }
 
@@ -276,6 +334,7 @@ bool CFileSystem::addFileArchive(const io::path& filename, bool ignoreCase,
 	if (archive)
 	{
 		FileArchives.push_back(archive);
+		FileIndex.addArchive(archive);
 		if (password.size())
 			archive->Password=password;
 		if (retArchive)
@@ -355,6 +414,7 @@ bool CFileSystem::addFileArchive(IReadFile* file, bool ignoreCase,
 		if (archive)
 		{
 			FileArchives.push_back(archive);
+			FileIndex.addArchive(archive);
 			if (password.size())
 				archive->Password=password;
 			if (retArchive)
@@ -384,6 +444,7 @@ bool CFileSystem::addFileArchive(IFileArchive* archive)
 			}
 		}
 		FileArchives.push_back(archive);
+		FileIndex.addArchive(archive);
 		archive->grab();
 
 		return true;
@@ -399,8 +460,10 @@ bool CFileSystem::removeFileArchive(u32 index)
 	bool ret = false;
 	if (index < FileArchives.size())
 	{
+		Prefetcher.clear();
 		FileArchives[index]->drop();
 		FileArchives.erase(index);
+		FileIndex.rebuild(FileArchives);
 		ret = true;
 	}
 	return ret;
@@ -516,21 +579,49 @@ bool CFileSystem::changeWorkingDirectoryTo(const io::path& newDirectory)
 #endif
 	}
 
+	if (success)
+	{
+		// relative names point elsewhere now
+		++WorkingDirectoryChanges;
+		std::lock_guard<std::mutex> lock(AbsolutePathMutex);
+		AbsolutePaths.clear();
+	}
+
 	return success;
 }
 
 
+//! Returns how often the working directory was changed
+u32 CFileSystem::getWorkingDirectoryChanges() const
+{
+	return WorkingDirectoryChanges;
+}
+
+
 io::path CFileSystem::getAbsolutePath(const io::path& filename) const
+{
+	io::path absolutePath;
+	resolveAbsolutePath(filename, absolutePath);
+	return absolutePath;
+}
+
+
+//! Sets absolutePath to the absolute path of filename, returns false if that is just a guess
+bool CFileSystem::resolveAbsolutePath(const io::path& filename, io::path& absolutePath) const
 {
 	if ( filename.empty() )
-		return filename;
+	{
+		absolutePath = filename;
+		return true;
+	}
 #if defined(_IRR_WINDOWS_API_)
 	fschar_t *p=0;
 	fschar_t fpath[_MAX_PATH];
 		p = _fullpath(fpath, filename.c_str(), _MAX_PATH);
 		core::stringc tmp(p);
 		tmp.replace('\\', '/');
-	return tmp;
+	absolutePath = tmp;
+	return p != 0;
 #elif (defined(_IRR_POSIX_API_) || defined(_IRR_OSX_PLATFORM_))
 	c8* p=0;
 	c8 fpath[4096];
@@ -541,34 +632,70 @@ io::path CFileSystem::getAbsolutePath(const io::path& filename) const
 		// content in fpath is unclear at this point
 		if (!fpath[0]) // seems like fpath wasn't altered, use our best guess
 		{
-			io::path tmp(filename);
-			return flattenFilename(tmp);
+			absolutePath = filename;
+			flattenFilename(absolutePath);
 		}
 		else
-			return io::path(fpath);
+			absolutePath = fpath;
+		// the file might be created later, and its path then differ
+		return false;
 	}
+	absolutePath = p;
 	if (filename[filename.size()-1]=='/')
-		return io::path(p)+_IRR_TEXT("/");
-	else
-		return io::path(p);
+		absolutePath.append('/');
+	return true;
 #else
-	return io::path(filename);
+	absolutePath = filename;
+	return true;
 #endif
 }
 
 
+//! Like getAbsolutePath(), but keeps the result for the next calls with the same name
+io::path CFileSystem::getCachedAbsolutePath(const io::path& filename) const
+{
+	{
+		// copied under the lock, changeWorkingDirectoryTo() may clear the cache
+		std::lock_guard<std::mutex> lock(AbsolutePathMutex);
+		const auto it = AbsolutePaths.find(filename);
+		if (it != AbsolutePaths.end() && it->second.Resolved)
+			return it->second.Path;
+	}
+
+	// asking the operating system takes a while, other threads may look up meanwhile
+	io::path absolutePath;
+	const bool resolved = resolveAbsolutePath(filename, absolutePath);
+
+	// guesses for missing files are asked for again, and replaced
+	std::lock_guard<std::mutex> lock(AbsolutePathMutex);
+	SCachedPath& cached = AbsolutePaths[filename];
+	if (!cached.Resolved)
+	{
+		cached.Path = absolutePath;
+		cached.Resolved = resolved;
+	}
+	return cached.Path;
+}
+
+
 //! returns the directory part of a filename, i.e. all until the first
 //! slash or backslash, excluding it. If no directory path is prefixed, a '.'
 //! is returned.
 io::path CFileSystem::getFileDir(const io::path& filename) const
+{
+	const path_view dir = getFileDirView(filename.view());
+	return io::path(dir.data(), (u32)dir.size());
+}
+
+
+//! Like getFileDir(), but returns a part of filename instead of a new string
+path_view CFileSystem::getFileDirView(path_view filename) const
 {
 	// find last forward or backslash
-	s32 lastSlash = filename.findLast('/');
-	const s32 lastBackSlash = filename.findLast('\\');
-	lastSlash = lastSlash > lastBackSlash ? lastSlash : lastBackSlash;
+	const size_t lastSlash = filename.find_last_of(_IRR_TEXT("/\\"));
 
-	if ((u32)lastSlash < filename.size())
-		return filename.subString(0, lastSlash);
+	if (lastSlash != path_view::npos)
+		return filename.substr(0, lastSlash);
 	else
 		return _IRR_TEXT(".");
 }
@@ -577,31 +704,30 @@ io::path CFileSystem::getFileDir(const io::path& filename) const
 //! returns the base part of a filename, i.e. all except for the directory
 //! part. If no directory path is prefixed, the full name is returned.
 io::path CFileSystem::getFileBasename(const io::path& filename, bool keepExtension) const
+{
+	const path_view base = getFileBasenameView(filename.view(), keepExtension);
+	return io::path(base.data(), (u32)base.size());
+}
+
+
+//! Like getFileBasename(), but returns a part of filename instead of a new string
+path_view CFileSystem::getFileBasenameView(path_view filename, bool keepExtension) const
 {
 	// find last forward or backslash
-	s32 lastSlash = filename.findLast('/');
-	const s32 lastBackSlash = filename.findLast('\\');
-	lastSlash = core::max_(lastSlash, lastBackSlash);
+	const size_t lastSlash = filename.find_last_of(_IRR_TEXT("/\\"));
+	const size_t begin = lastSlash != path_view::npos ? lastSlash + 1 : 0;
 
-	// get number of chars after last dot
-	s32 end = 0;
+	size_t end = filename.size();
 	if (!keepExtension)
 	{
 		// take care to search only after last slash to check only for
 		// dots in the filename
-		end = filename.findLast('.');
-		if (end == -1 || end < lastSlash)
-			end=0;
-		else
-			end = filename.size()-end;
+		const size_t dot = filename.find_last_of(_IRR_TEXT('.'));
+		if (dot != path_view::npos && dot >= begin)
+			end = dot;
 	}
 
-	if ((u32)lastSlash < filename.size())
-		return filename.subString(lastSlash+1, filename.size()-lastSlash-1-end);
-	else if (end != 0)
-		return filename.subString(0, filename.size()-end);
-	else
-		return filename;
+	return filename.substr(begin, end - begin);
 }
 
 
@@ -612,16 +738,17 @@ io::path& CFileSystem::flattenFilename(io::path& directory, const io::path& root
 	if (directory.lastChar() != '/')
 		directory.append('/');
 
+	// the parts are looked at in place instead of copying each
 	io::path dir;
-	io::path subdir;
+	const path_view all = directory.view();
 
-	s32 lastpos = 0;
-	s32 pos = 0;
+	size_t lastpos = 0;
+	size_t pos = 0;
 	bool lastWasRealDir=false;
 
-	while ((pos = directory.findNext('/', lastpos)) >= 0)
+	while ((pos = all.find('/', lastpos)) != path_view::npos)
 	{
-		subdir = directory.subString(lastpos, pos - lastpos + 1);
+		const path_view subdir = all.substr(lastpos, pos - lastpos + 1);
 
 		if (subdir == _IRR_TEXT("../"))
 		{
@@ -632,7 +759,7 @@ io::path& CFileSystem::flattenFilename(io::path& directory, const io::path& root
 			}
 			else
 			{
-				dir.append(subdir);
+				dir.append(subdir.data(), (u32)subdir.size());
 				lastWasRealDir=false;
 			}
 		}
@@ -642,7 +769,7 @@ io::path& CFileSystem::flattenFilename(io::path& directory, const io::path& root
 		}
 		else if (subdir != _IRR_TEXT("./"))
 		{
-			dir.append(subdir);
+			dir.append(subdir.data(), (u32)subdir.size());
 			lastWasRealDir=true;
 		}
 
@@ -855,9 +982,19 @@ IFileList* CFileSystem::createEmptyFileList(const io::path& path, bool ignoreCas
 //! determines if a file exists and would be able to be opened.
 bool CFileSystem::existFile(const io::path& filename) const
 {
-	for (u32 i=0; i < FileArchives.size(); ++i)
-		if (FileArchives[i]->getFileList()->findFile(filename)!=-1)
-			return true;
+	u32 archive, index;
+	switch (FileIndex.findFile(filename, false, archive, index))
+	{
+	case CFileIndex::EL_FOUND:
+		return true;
+	case CFileIndex::EL_UNKNOWN:
+		for (u32 i=0; i < FileArchives.size(); ++i)
+			if (FileArchives[i]->getFileList()->findFile(filename)!=-1)
+				return true;
+		break;
+	default:
+		break;
+	}
 
 #if defined(_MSC_VER)
 		return (_access(filename.c_str(), 0) != -1);
@@ -869,6 +1006,39 @@ bool CFileSystem::existFile(const io::path& filename) const
 }
 
 
+//! Starts reading files in the background which will be opened soon
+void CFileSystem::prefetch(const core::array<io::path>& filenames)
+{
+	for (u32 i=0; i < filenames.size(); ++i)
+	{
+		if (filenames[i].empty())
+			continue;
+
+		// same lookup as createAndOpenFile, archives whose file lists
+		// don't support the index are not prefetched from
+		u32 archive, index;
+		if (FileIndex.findFile(filenames[i], false, archive, index) == CFileIndex::EL_FOUND)
+			Prefetcher.addArchiveFile(FileArchives[archive], archive, index);
+		else
+			Prefetcher.addFile(getAbsolutePath(filenames[i]));
+	}
+}
+
+
+//! Writes files into a pack archive
+bool CFileSystem::writePackArchive(IWriteFile* file, const core::array<io::path>& filenames, bool compress)
+{
+	return io::writePackArchive(this, file, filenames, compress);
+}
+
+
+//! Get the counters of file access and of loading
+IIOStatistics* CFileSystem::getStatistics() const
+{
+	return &getIOStatistics();
+}
+
+
 //! creates a filesystem which is able to open files from the ordinary file system,
 //! and out of zipfiles, which are able to be added to the filesystem.
 IFileSystem* createFileSystem()
@@ -6,6 +6,11 @@
 
 #include "IFileSystem.h"
 #include "irrArray.h"
+#include "CFileIndex.h"
+#include "CFilePrefetcher.h"
+#include "irrStringHash.h"
+#include <mutex>
+#include <unordered_map>
 
 namespace irr
 {
@@ -39,6 +44,9 @@ public:
 	//! Creates an IWriteFile interface for accessing memory like a file.
 	IWriteFile* createMemoryWriteFile(void* memory, s32 len, const io::path& fileName, bool deleteMemoryWhenDropped=false) override;
 
+	//! Creates an IWriteFile which writes into memory growing as needed
+	IMemoryWriteFile* createGrowableMemoryWriteFile(const io::path& fileName) override;
+
 	//! Opens a file for write access.
 	IWriteFile* createAndWriteFile(const io::path& filename, bool append=false) override;
 
@@ -97,15 +105,27 @@ public:
 	//! Converts a relative path to an absolute (unique) path, resolving symbolic links
 	io::path getAbsolutePath(const io::path& filename) const override;
 
+	//! Like getAbsolutePath(), but keeps the result for the next calls with the same name
+	io::path getCachedAbsolutePath(const io::path& filename) const override;
+
+	//! Returns how often the working directory was changed
+	u32 getWorkingDirectoryChanges() const override;
+
 	//! Returns the directory a file is located in.
 	/** \param filename: The file to get the directory from */
 	io::path getFileDir(const io::path& filename) const override;
 
+	//! Like getFileDir(), but returns a part of filename instead of a new string
+	path_view getFileDirView(path_view filename) const override;
+
 	//! Returns the base part of a filename, i.e. the name without the directory
 	//! part. If no directory is prefixed, the full name is returned.
 	/** \param filename: The file to get the basename from */
 	io::path getFileBasename(const io::path& filename, bool keepExtension=true) const override;
 
+	//! Like getFileBasename(), but returns a part of filename instead of a new string
+	path_view getFileBasenameView(path_view filename, bool keepExtension=true) const override;
+
 	//! flatten a path and file name for example: "/you/me/../." becomes "/you"
 	io::path& flattenFilename( io::path& directory, const io::path& root = "/" ) const override;
 
@@ -124,16 +144,46 @@ public:
 	//! determines if a file exists and would be able to be opened.
 	bool existFile(const io::path& filename) const override;
 
+	//! Starts reading files in the background which will be opened soon
+	void prefetch(const core::array<io::path>& filenames) override;
+
+	//! Writes files into a pack archive
+	bool writePackArchive(IWriteFile* file, const core::array<io::path>& filenames, bool compress=false) override;
+
+	//! Get the counters of file access and of loading
+	IIOStatistics* getStatistics() const override;
+
 private:
 
+	//! Sets absolutePath to the absolute path of filename, returns false if that is just a guess
+	bool resolveAbsolutePath(const io::path& filename, io::path& absolutePath) const;
+
 	//! Currently used FileSystemType
 	EFileSystemType FileSystemType;
 	//! WorkingDirectory for Native and Virtual filesystems
 	io::path WorkingDirectory [2];
+	//! Successful calls of changeWorkingDirectoryTo()
+	u32 WorkingDirectoryChanges = 0;
 	//! currently attached ArchiveLoaders
 	core::array<IArchiveLoader*> ArchiveLoader;
 	//! currently attached Archives
 	core::array<IFileArchive*> FileArchives;
+	//! Hash index of the files in FileArchives
+	CFileIndex FileIndex;
+	//! Reads files for prefetch()
+	CFilePrefetcher Prefetcher;
+
+	//! Guards the cached absolute paths
+	mutable std::mutex AbsolutePathMutex;
+	struct SCachedPath
+	{
+		io::path Path;
+		//! False if the file didn't exist, so Path is just a guess
+		bool Resolved = false;
+	};
+
+	//! Absolute paths of the names given to getCachedAbsolutePath()
+	mutable std::unordered_map<io::path, SCachedPath> AbsolutePaths;
 };
 
 
@@ -0,0 +1,1370 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CGLTFMeshFileLoader.h"
+
+#include "IReadFile.h"
+#include "SAnimatedMesh.h"
+#include "SMeshBuffer.h"
+#include "fast_atof.h"
+#include "coreutil.h"
+#include "os.h"
+
+#include <cstring>
+#include <deque>
+#include <vector>
+
+namespace irr
+{
+namespace scene
+{
+
+//! Animation time in seconds is converted to frames with this rate
+static const f32 GLTF_FRAMES_PER_SECOND = 30.f;
+
+//! Nesting limit for JSON values and the node hierarchy
+static const u32 GLTF_MAX_DEPTH = 64;
+
+enum E_GLTF_COMPONENT_TYPE
+{
+	EGCT_BYTE = 5120,
+	EGCT_UNSIGNED_BYTE = 5121,
+	EGCT_SHORT = 5122,
+	EGCT_UNSIGNED_SHORT = 5123,
+	EGCT_UNSIGNED_INT = 5125,
+	EGCT_FLOAT = 5126
+};
+
+//! A parsed JSON value
+struct SJsonValue
+{
+	enum E_TYPE
+	{
+		EJT_NULL,
+		EJT_BOOL,
+		EJT_NUMBER,
+		EJT_STRING,
+		EJT_ARRAY,
+		EJT_OBJECT
+	};
+
+	SJsonValue() : Type(EJT_NULL), Number(0.0), Bool(false) {}
+
+	//! Member of an object, a null value if there is none
+	const SJsonValue& operator[](const char* key) const
+	{
+		for (u32 i=0; i<Keys.size(); ++i)
+		{
+			if (Keys[i] == key)
+				return Elements[i];
+		}
+		return null();
+	}
+
+	//! Element of an array, a null value if out of range
+	const SJsonValue& operator[](s32 index) const
+	{
+		if (Type != EJT_ARRAY || index < 0 || (u32)index >= Elements.size())
+			return null();
+		return Elements[index];
+	}
+
+	//! Number of array elements
+	u32 size() const
+	{
+		return Type == EJT_ARRAY ? (u32)Elements.size() : 0;
+	}
+
+	bool isNull() const { return Type == EJT_NULL; }
+
+	//! Integer value, or def if this is no number
+	s32 asInt(s32 def=-1) const
+	{
+		return Type == EJT_NUMBER ? (s32)Number : def;
+	}
+
+	//! Float value, or def if this is no number
+	f32 asFloat(f32 def=0.f) const
+	{
+		return Type == EJT_NUMBER ? (f32)Number : def;
+	}
+
+	static const SJsonValue& null()
+	{
+		static const SJsonValue value;
+		return value;
+	}
+
+	E_TYPE Type;
+	f64 Number;
+	bool Bool;
+	core::stringc String;
+	//! Array elements, or object members with their names in Keys
+	std::vector<SJsonValue> Elements;
+	std::vector<core::stringc> Keys;
+};
+
+//! Minimal JSON reader, enough for glTF
+class CJsonParser
+{
+public:
+	CJsonParser(const c8* text, u32 size) : Pos(text), End(text + size) {}
+
+	bool parse(SJsonValue& value)
+	{
+		if (!parseValue(value, 0))
+			return false;
+		skipWhitespace();
+		return Pos == End || *Pos == 0;
+	}
+
+private:
+	void skipWhitespace()
+	{
+		while (Pos < End && (*Pos == ' ' || *Pos == '\t' || *Pos == '\n' || *Pos == '\r'))
+			++Pos;
+	}
+
+	bool expect(const c8* word)
+	{
+		const u32 len = (u32)strlen(word);
+		if ((u32)(End - Pos) < len || strncmp(Pos, word, len) != 0)
+			return false;
+		Pos += len;
+		return true;
+	}
+
+	static void appendUTF8(core::stringc& str, u32 c)
+	{
+		if (c < 0x80)
+			str.append((c8)c);
+		else if (c < 0x800)
+		{
+			str.append((c8)(0xC0 | (c >> 6)));
+			str.append((c8)(0x80 | (c & 0x3F)));
+		}
+		else if (c < 0x10000)
+		{
+			str.append((c8)(0xE0 | (c >> 12)));
+			str.append((c8)(0x80 | ((c >> 6) & 0x3F)));
+			str.append((c8)(0x80 | (c & 0x3F)));
+		}
+		else
+		{
+			str.append((c8)(0xF0 | (c >> 18)));
+			str.append((c8)(0x80 | ((c >> 12) & 0x3F)));
+			str.append((c8)(0x80 | ((c >> 6) & 0x3F)));
+			str.append((c8)(0x80 | (c & 0x3F)));
+		}
+	}
+
+	bool parseHex4(u32& c)
+	{
+		if (End - Pos < 4)
+			return false;
+		c = 0;
+		for (u32 i=0; i<4; ++i, ++Pos)
+		{
+			c <<= 4;
+			if (*Pos >= '0' && *Pos <= '9')
+				c |= *Pos - '0';
+			else if (*Pos >= 'a' && *Pos <= 'f')
+				c |= *Pos - 'a' + 10;
+			else if (*Pos >= 'A' && *Pos <= 'F')
+				c |= *Pos - 'A' + 10;
+			else
+				return false;
+		}
+		return true;
+	}
+
+	bool parseString(core::stringc& str)
+	{
+		// skip the opening quote
+		++Pos;
+		const c8* start = Pos;
+		while (Pos < End && *Pos != '"' && *Pos != '\\')
+			++Pos;
+		str = core::stringc(start, (u32)(Pos - start));
+
+		while (Pos < End && *Pos != '"')
+		{
+			if (*Pos != '\\')
+			{
+				str.append(*Pos++);
+				continue;
+			}
+			if (++Pos == End)
+				return false;
+			switch (*Pos++)
+			{
+			case '"': str.append('"'); break;
+			case '\\': str.append('\\'); break;
+			case '/': str.append('/'); break;
+			case 'b': str.append('\b'); break;
+			case 'f': str.append('\f'); break;
+			case 'n': str.append('\n'); break;
+			case 'r': str.append('\r'); break;
+			case 't': str.append('\t'); break;
+			case 'u':
+			{
+				u32 c;
+				if (!parseHex4(c))
+					return false;
+				// combine surrogate pairs
+				if (c >= 0xD800 && c < 0xDC00 && End - Pos >= 6 && Pos[0] == '\\' && Pos[1] == 'u')
+				{
+					Pos += 2;
+					u32 low;
+					if (!parseHex4(low))
+						return false;
+					c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+				}
+				appendUTF8(str, c);
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+		if (Pos == End)
+			return false;
+		++Pos;
+		return true;
+	}
+
+	bool parseNumber(f64& number)
+	{
+		const c8* start = Pos;
+		bool isInteger = true;
+		if (Pos < End && *Pos == '-')
+			++Pos;
+		while (Pos < End && ((*Pos >= '0' && *Pos <= '9') || *Pos == '.' || *Pos == 'e' ||
+				*Pos == 'E' || *Pos == '+' || *Pos == '-'))
+		{
+			if (*Pos < '0' || *Pos > '9')
+				isInteger = false;
+			++Pos;
+		}
+		if (Pos == start)
+			return false;
+
+		// integers are exact, they are used for byte offsets
+		const core::stringc text(start, (u32)(Pos - start));
+		if (isInteger)
+			number = (f64)core::strtol10(text.c_str());
+		else
+		{
+			f32 f;
+			core::fast_atof_move(text.c_str(), f);
+			number = f;
+		}
+		return true;
+	}
+
+	bool parseValue(SJsonValue& value, u32 depth)
+	{
+		if (depth > GLTF_MAX_DEPTH)
+			return false;
+
+		skipWhitespace();
+		if (Pos == End)
+			return false;
+
+		switch (*Pos)
+		{
+		case '{':
+		{
+			value.Type = SJsonValue::EJT_OBJECT;
+			++Pos;
+			skipWhitespace();
+			if (Pos < End && *Pos == '}')
+			{
+				++Pos;
+				return true;
+			}
+			while (true)
+			{
+				skipWhitespace();
+				if (Pos == End || *Pos != '"')
+					return false;
+				value.Keys.push_back(core::stringc());
+				if (!parseString(value.Keys.back()))
+					return false;
+				skipWhitespace();
+				if (Pos == End || *Pos++ != ':')
+					return false;
+				value.Elements.push_back(SJsonValue());
+				if (!parseValue(value.Elements.back(), depth + 1))
+					return false;
+				skipWhitespace();
+				if (Pos == End)
+					return false;
+				if (*Pos == ',')
+					++Pos;
+				else if (*Pos++ == '}')
+					return true;
+				else
+					return false;
+			}
+		}
+		case '[':
+		{
+			value.Type = SJsonValue::EJT_ARRAY;
+			++Pos;
+			skipWhitespace();
+			if (Pos < End && *Pos == ']')
+			{
+				++Pos;
+				return true;
+			}
+			while (true)
+			{
+				value.Elements.push_back(SJsonValue());
+				if (!parseValue(value.Elements.back(), depth + 1))
+					return false;
+				skipWhitespace();
+				if (Pos == End)
+					return false;
+				if (*Pos == ',')
+					++Pos;
+				else if (*Pos++ == ']')
+					return true;
+				else
+					return false;
+			}
+		}
+		case '"':
+			value.Type = SJsonValue::EJT_STRING;
+			return parseString(value.String);
+		case 't':
+			value.Type = SJsonValue::EJT_BOOL;
+			value.Bool = true;
+			return expect("true");
+		case 'f':
+			value.Type = SJsonValue::EJT_BOOL;
+			value.Bool = false;
+			return expect("false");
+		case 'n':
+			value.Type = SJsonValue::EJT_NULL;
+			return expect("null");
+		default:
+			value.Type = SJsonValue::EJT_NUMBER;
+			return parseNumber(value.Number);
+		}
+	}
+
+	const c8* Pos;
+	const c8* End;
+};
+
+//! Parsed file with resolved buffers
+struct SGLTFDocument
+{
+	SJsonValue Json;
+	//! Directory of the file, for external buffers
+	io::path Directory;
+	//! Whole .glb file or decoded external and embedded buffers,
+	//! a deque keeps them in place when more are added
+	std::deque<core::array<u8> > Storage;
+	//! Binary chunk of a .glb file, points into Storage
+	const u8* BinaryChunk;
+	u32 BinaryChunkSize;
+	//! Start and size of each buffer, pointing into Storage
+	core::array<const u8*> BufferData;
+	core::array<u32> BufferSize;
+
+	SGLTFDocument() : BinaryChunk(0), BinaryChunkSize(0) {}
+};
+
+//! Resolved accessor, elements can be read directly from the buffer
+struct SGLTFAccessor
+{
+	const u8* Data;
+	u32 Count;
+	//! Distance between elements in bytes
+	u32 Stride;
+	u32 ComponentType;
+	u32 ComponentSize;
+	u32 Components;
+	bool Normalized;
+
+	SGLTFAccessor() : Data(0), Count(0), Stride(0), ComponentType(0),
+		ComponentSize(0), Components(0), Normalized(false) {}
+
+	//! True if the elements are tightly packed values of this layout
+	bool isPacked(u32 componentType, u32 components) const
+	{
+		return ComponentType == componentType && Components == components &&
+			Stride == ComponentSize * Components;
+	}
+
+	//! Read a component as unsigned integer
+	u32 readUInt(u32 index, u32 component) const
+	{
+		const u8* p = Data + index * Stride + component * ComponentSize;
+		switch (ComponentType)
+		{
+		case EGCT_UNSIGNED_BYTE:
+			return *p;
+		case EGCT_UNSIGNED_SHORT:
+		{
+			u16 v;
+			memcpy(&v, p, sizeof(v));
+#ifdef __BIG_ENDIAN__
+			v = os::Byteswap::byteswap(v);
+#endif
+			return v;
+		}
+		case EGCT_UNSIGNED_INT:
+		{
+			u32 v;
+			memcpy(&v, p, sizeof(v));
+#ifdef __BIG_ENDIAN__
+			v = os::Byteswap::byteswap(v);
+#endif
+			return v;
+		}
+		default:
+			return (u32)readFloat(index, component);
+		}
+	}
+
+	//! Read a component as float, normalized integers are mapped to [0,1] or [-1,1]
+	f32 readFloat(u32 index, u32 component) const
+	{
+		const u8* p = Data + index * Stride + component * ComponentSize;
+		switch (ComponentType)
+		{
+		case EGCT_FLOAT:
+		{
+			f32 v;
+			memcpy(&v, p, sizeof(v));
+#ifdef __BIG_ENDIAN__
+			v = os::Byteswap::byteswap(v);
+#endif
+			return v;
+		}
+		case EGCT_BYTE:
+		{
+			const f32 v = (f32)(s8)*p;
+			return Normalized ? core::max_(v / 127.f, -1.f) : v;
+		}
+		case EGCT_SHORT:
+		{
+			s16 v;
+			memcpy(&v, p, sizeof(v));
+#ifdef __BIG_ENDIAN__
+			v = os::Byteswap::byteswap(v);
+#endif
+			return Normalized ? core::max_((f32)v / 32767.f, -1.f) : (f32)v;
+		}
+		case EGCT_UNSIGNED_BYTE:
+			return Normalized ? *p / 255.f : (f32)*p;
+		case EGCT_UNSIGNED_SHORT:
+			return Normalized ? readUInt(index, component) / 65535.f : (f32)readUInt(index, component);
+		case EGCT_UNSIGNED_INT:
+			return (f32)readUInt(index, component);
+		default:
+			return 0.f;
+		}
+	}
+
+	//! Read a vector, converted to the left handed coordinate system
+	core::vector3df readVector(u32 index) const
+	{
+		return core::vector3df(readFloat(index, 0), readFloat(index, 1), -readFloat(index, 2));
+	}
+};
+
+//! Convert a right handed matrix to the left handed system by mirroring z
+static void convertMatrix(core::matrix4& mat)
+{
+	mat[2] = -mat[2];
+	mat[6] = -mat[6];
+	mat[8] = -mat[8];
+	mat[9] = -mat[9];
+	mat[11] = -mat[11];
+	mat[14] = -mat[14];
+}
+
+//! Convert a right handed glTF rotation for CSkinnedMesh
+/** The mirrored rotation is (-x,-y,z,w). CSkinnedMesh builds matrices with
+getMatrix_transposed(), so the conjugate of it is stored. */
+static core::quaternion convertRotation(f32 x, f32 y, f32 z, f32 w)
+{
+	core::quaternion rot(x, y, -z, w);
+	rot.normalize();
+	return rot;
+}
+
+//! Read a node transformation, already converted to the left handed system
+static core::matrix4 readNodeTransform(const SJsonValue& node, core::vector3df& position,
+	core::quaternion& rotation, core::vector3df& scale)
+{
+	position.set(0.f, 0.f, 0.f);
+	rotation.makeIdentity();
+	scale.set(1.f, 1.f, 1.f);
+
+	const SJsonValue& matrix = node["matrix"];
+	if (matrix.size() == 16)
+	{
+		core::matrix4 mat;
+		for (u32 i=0; i<16; ++i)
+			mat[i] = matrix[i].asFloat();
+		convertMatrix(mat);
+		position = mat.getTranslation();
+		scale = mat.getScale();
+		return mat;
+	}
+
+	const SJsonValue& t = node["translation"];
+	if (t.size() == 3)
+		position.set(t[0].asFloat(), t[1].asFloat(), -t[2].asFloat());
+	const SJsonValue& r = node["rotation"];
+	if (r.size() == 4)
+		rotation = convertRotation(r[0].asFloat(), r[1].asFloat(), r[2].asFloat(), r[3].asFloat(1.f));
+	const SJsonValue& s = node["scale"];
+	if (s.size() == 3)
+		scale.set(s[0].asFloat(1.f), s[1].asFloat(1.f), s[2].asFloat(1.f));
+
+	// same composition as CSkinnedMesh uses for joints
+	core::matrix4 positionMatrix;
+	positionMatrix.setTranslation(position);
+	core::matrix4 rotationMatrix;
+	rotation.getMatrix_transposed(rotationMatrix);
+	core::matrix4 scaleMatrix;
+	scaleMatrix.setScale(scale);
+	return positionMatrix * rotationMatrix * scaleMatrix;
+}
+
+//! Value of a hexadecimal digit, -1 for other characters
+static s32 hexDigitValue(c8 c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+//! Decode the %XX escapes of a relative URI into a file name
+static io::path decodeUri(const core::stringc& uri)
+{
+	io::path name;
+	name.reserve(uri.size() + 1);
+	for (u32 i=0; i<uri.size(); ++i)
+	{
+		const s32 high = (uri[i] == '%' && i + 2 < uri.size()) ? hexDigitValue(uri[i+1]) : -1;
+		const s32 low = (high != -1) ? hexDigitValue(uri[i+2]) : -1;
+		if (low != -1)
+		{
+			name.append((c8)(high * 16 + low));
+			i += 2;
+		}
+		else
+			name.append(uri[i]);
+	}
+	return name;
+}
+
+//! Decode base64 data, returns false on invalid characters
+static bool decodeBase64(const c8* in, u32 size, core::array<u8>& out)
+{
+	out.reallocate(size / 4 * 3);
+	u32 bits = 0;
+	u32 value = 0;
+	for (u32 i=0; i<size; ++i)
+	{
+		const c8 c = in[i];
+		u32 v;
+		if (c >= 'A' && c <= 'Z')
+			v = c - 'A';
+		else if (c >= 'a' && c <= 'z')
+			v = c - 'a' + 26;
+		else if (c >= '0' && c <= '9')
+			v = c - '0' + 52;
+		else if (c == '+' || c == '-')
+			v = 62;
+		else if (c == '/' || c == '_')
+			v = 63;
+		else if (c == '=')
+			break;
+		else
+			return false;
+
+		value = (value << 6) | v;
+		bits += 6;
+		if (bits >= 8)
+		{
+			bits -= 8;
+			out.push_back((u8)(value >> bits));
+		}
+	}
+	return true;
+}
+
+//! Convert a glTF sampler wrap mode
+static video::E_TEXTURE_CLAMP getTextureClamp(s32 wrap)
+{
+	switch (wrap)
+	{
+	case 33071: // CLAMP_TO_EDGE
+		return video::ETC_CLAMP_TO_EDGE;
+	case 33648: // MIRRORED_REPEAT
+		return video::ETC_MIRROR;
+	default: // REPEAT
+		return video::ETC_REPEAT;
+	}
+}
+
+static u32 getComponentSize(u32 componentType)
+{
+	switch (componentType)
+	{
+	case EGCT_BYTE:
+	case EGCT_UNSIGNED_BYTE:
+		return 1;
+	case EGCT_SHORT:
+	case EGCT_UNSIGNED_SHORT:
+		return 2;
+	case EGCT_UNSIGNED_INT:
+	case EGCT_FLOAT:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+static u32 getComponentCount(const core::stringc& type)
+{
+	if (type == "SCALAR")
+		return 1;
+	if (type == "VEC2")
+		return 2;
+	if (type == "VEC3")
+		return 3;
+	if (type == "VEC4")
+		return 4;
+	if (type == "MAT4")
+		return 16;
+	return 0;
+}
+
+
+//! Constructor
+CGLTFMeshFileLoader::CGLTFMeshFileLoader(scene::ISceneManager* smgr, io::IFileSystem* fs)
+	: FileSystem(fs)
+{
+	#ifdef _DEBUG
+	setDebugName("CGLTFMeshFileLoader");
+	#endif
+
+	if (FileSystem)
+		FileSystem->grab();
+}
+
+
+CGLTFMeshFileLoader::~CGLTFMeshFileLoader()
+{
+	if (FileSystem)
+		FileSystem->drop();
+}
+
+
+//! returns true if the file maybe is able to be loaded by this class
+//! based on the file extension (e.g. ".glb")
+bool CGLTFMeshFileLoader::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension(filename, "gltf", "glb");
+}
+
+
+//! creates/loads an animated mesh from the file.
+IAnimatedMesh* CGLTFMeshFileLoader::createMesh(io::IReadFile* file)
+{
+	if (!file)
+		return 0;
+
+	SGLTFDocument doc;
+	if (!readDocument(file, doc) || !readBuffers(doc))
+		return 0;
+
+	const core::stringc& version = doc.Json["asset"]["version"].String;
+	if (version.size() < 2 || version[0] != '2' || version[1] != '.')
+	{
+		os::Printer::log("glTF: Unsupported version", version.c_str(), ELL_ERROR);
+		return 0;
+	}
+
+	if (doc.Json["skins"].size() || doc.Json["animations"].size())
+		return createSkinnedMesh(doc);
+	return createStaticMesh(doc);
+}
+
+
+bool CGLTFMeshFileLoader::readDocument(io::IReadFile* file, SGLTFDocument& doc)
+{
+	const long size = file->getSize();
+	if (size <= 0)
+		return false;
+
+	doc.Storage.push_back(core::array<u8>());
+	core::array<u8>& data = doc.Storage.back();
+	data.set_used((u32)size);
+	if (file->read(data.pointer(), size) != (size_t)size)
+	{
+		os::Printer::log("glTF: Could not read file", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	const io::path& filename = file->getFileName();
+	const s32 slash = core::max_(filename.findLast('/'), filename.findLast('\\'));
+	if (slash != -1)
+		doc.Directory = filename.subString(0, slash + 1);
+
+	const c8* json = (const c8*)data.const_pointer();
+	u32 jsonSize = (u32)size;
+
+	if (size >= 12 && memcmp(json, "glTF", 4) == 0)
+	{
+		// binary container: header, then a JSON chunk and an optional BIN chunk
+		u32 header[3];
+		memcpy(header, data.const_pointer(), sizeof(header));
+#ifdef __BIG_ENDIAN__
+		for (u32 i=0; i<3; ++i)
+			header[i] = os::Byteswap::byteswap(header[i]);
+#endif
+		if (header[1] != 2)
+		{
+			os::Printer::log("glTF: Unsupported binary container version", file->getFileName(), ELL_ERROR);
+			return false;
+		}
+
+		const u32 length = core::min_(header[2], (u32)size);
+		u32 offset = 12;
+		jsonSize = 0;
+		while (offset + 8 <= length)
+		{
+			u32 chunk[2];
+			memcpy(chunk, data.const_pointer() + offset, sizeof(chunk));
+#ifdef __BIG_ENDIAN__
+			chunk[0] = os::Byteswap::byteswap(chunk[0]);
+			chunk[1] = os::Byteswap::byteswap(chunk[1]);
+#endif
+			offset += 8;
+			if (chunk[0] > length - offset)
+				break;
+
+			if (chunk[1] == 0x4E4F534A && !jsonSize) // "JSON"
+			{
+				json = (const c8*)data.const_pointer() + offset;
+				jsonSize = chunk[0];
+			}
+			else if (chunk[1] == 0x004E4942 && !doc.BinaryChunk) // "BIN\0"
+			{
+				doc.BinaryChunk = data.const_pointer() + offset;
+				doc.BinaryChunkSize = chunk[0];
+			}
+			offset += (chunk[0] + 3) & ~3u;
+		}
+
+		if (!jsonSize)
+		{
+			os::Printer::log("glTF: No JSON chunk found", file->getFileName(), ELL_ERROR);
+			return false;
+		}
+	}
+
+	CJsonParser parser(json, jsonSize);
+	if (!parser.parse(doc.Json) || doc.Json.Type != SJsonValue::EJT_OBJECT)
+	{
+		os::Printer::log("glTF: Invalid JSON", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+	return true;
+}
+
+
+bool CGLTFMeshFileLoader::readBuffers(SGLTFDocument& doc)
+{
+	const SJsonValue& buffers = doc.Json["buffers"];
+	for (u32 i=0; i<buffers.size(); ++i)
+	{
+		const SJsonValue& uri = buffers[i]["uri"];
+		const u32 byteLength = (u32)buffers[i]["byteLength"].asInt(0);
+
+		const u8* data = 0;
+		u32 size = 0;
+		if (uri.isNull())
+		{
+			// the binary chunk of a .glb file
+			if (i == 0 && doc.BinaryChunk)
+			{
+				data = doc.BinaryChunk;
+				size = doc.BinaryChunkSize;
+			}
+		}
+		else if (uri.String.equalsn("data:", 5))
+		{
+			const s32 comma = uri.String.findFirst(',');
+			if (comma != -1 && uri.String.find(";base64") != -1)
+			{
+				doc.Storage.push_back(core::array<u8>());
+				if (decodeBase64(uri.String.c_str() + comma + 1, uri.String.size() - comma - 1, doc.Storage.back()))
+				{
+					data = doc.Storage.back().const_pointer();
+					size = doc.Storage.back().size();
+				}
+			}
+		}
+		else
+		{
+			io::IReadFile* file = FileSystem ?
+				FileSystem->createAndOpenFile(doc.Directory + decodeUri(uri.String)) : 0;
+			if (file)
+			{
+				doc.Storage.push_back(core::array<u8>());
+				core::array<u8>& storage = doc.Storage.back();
+				storage.set_used((u32)file->getSize());
+				if (file->read(storage.pointer(), storage.size()) == storage.size())
+				{
+					data = storage.const_pointer();
+					size = storage.size();
+				}
+				file->drop();
+			}
+		}
+
+		if (!data || size < byteLength)
+		{
+			os::Printer::log("glTF: Could not read buffer", uri.String.c_str(), ELL_ERROR);
+			return false;
+		}
+
+		doc.BufferData.push_back(data);
+		doc.BufferSize.push_back(byteLength);
+	}
+	return true;
+}
+
+
+bool CGLTFMeshFileLoader::getAccessor(const SGLTFDocument& doc, s32 index, SGLTFAccessor& accessor) const
+{
+	const SJsonValue& acc = doc.Json["accessors"][index];
+	if (index < 0 || acc.isNull())
+		return false;
+
+	if (!acc["sparse"].isNull())
+	{
+		os::Printer::log("glTF: Sparse accessors are not supported", ELL_WARNING);
+		return false;
+	}
+
+	accessor.ComponentType = (u32)acc["componentType"].asInt(0);
+	accessor.ComponentSize = getComponentSize(accessor.ComponentType);
+	accessor.Components = getComponentCount(acc["type"].String);
+	accessor.Count = (u32)acc["count"].asInt(0);
+	accessor.Normalized = acc["normalized"].Bool;
+	if (!accessor.ComponentSize || !accessor.Components)
+		return false;
+
+	const u32 elementSize = accessor.ComponentSize * accessor.Components;
+	const SJsonValue& view = doc.Json["bufferViews"][acc["bufferView"].asInt()];
+	const s32 buffer = view["buffer"].asInt();
+	if (view.isNull() || buffer < 0 || (u32)buffer >= doc.BufferData.size())
+		return false;
+
+	const u64 viewOffset = (u64)view["byteOffset"].asInt(0);
+	const u64 viewLength = (u64)view["byteLength"].asInt(0);
+	const u64 offset = (u64)acc["byteOffset"].asInt(0);
+	accessor.Stride = (u32)view["byteStride"].asInt(elementSize);
+	if (accessor.Stride < elementSize)
+		return false;
+
+	// the last element has to be inside of the view, the view inside of the buffer
+	const u64 end = offset + (accessor.Count ? (u64)accessor.Stride * (accessor.Count - 1) + elementSize : 0);
+	if (end > viewLength || viewOffset + viewLength > doc.BufferSize[buffer])
+	{
+		os::Printer::log("glTF: Accessor exceeds its buffer", ELL_ERROR);
+		return false;
+	}
+
+	accessor.Data = doc.BufferData[buffer] + viewOffset + offset;
+	return true;
+}
+
+
+video::SColorf CGLTFMeshFileLoader::readMaterial(const SGLTFDocument& doc, s32 index, video::SMaterial& material) const
+{
+	video::SColorf baseColor(1.f, 1.f, 1.f, 1.f);
+	const SJsonValue& mat = doc.Json["materials"][index];
+	if (index < 0 || mat.isNull())
+		return baseColor;
+
+	const SJsonValue& pbr = mat["pbrMetallicRoughness"];
+	const SJsonValue& factor = pbr["baseColorFactor"];
+	if (factor.size() == 4)
+		baseColor.set(factor[3].asFloat(1.f), factor[0].asFloat(1.f), factor[1].asFloat(1.f), factor[2].asFloat(1.f));
+	material.DiffuseColor = baseColor.toSColor();
+
+	material.BackfaceCulling = !mat["doubleSided"].Bool;
+
+	const core::stringc& alphaMode = mat["alphaMode"].String;
+	if (alphaMode == "BLEND")
+		material.MaterialType = video::EMT_TRANSPARENT_ALPHA_CHANNEL;
+	else if (alphaMode == "MASK")
+	{
+		material.MaterialType = video::EMT_TRANSPARENT_ALPHA_CHANNEL_REF;
+		material.MaterialTypeParam = mat["alphaCutoff"].asFloat(0.5f);
+	}
+
+	// the texture is set by the application, but keep the sampler settings
+	const SJsonValue& texture = doc.Json["textures"][pbr["baseColorTexture"]["index"].asInt()];
+	const SJsonValue& sampler = doc.Json["samplers"][texture["sampler"].asInt()];
+	material.TextureLayers[0].TextureWrapU = getTextureClamp(sampler["wrapS"].asInt(10497));
+	material.TextureLayers[0].TextureWrapV = getTextureClamp(sampler["wrapT"].asInt(10497));
+
+	return baseColor;
+}
+
+
+bool CGLTFMeshFileLoader::readPrimitive(const SGLTFDocument& doc, const SJsonValue& primitive,
+	core::array<video::S3DVertex>& vertices, core::array<u16>& indices,
+	video::SMaterial& material) const
+{
+	if (primitive["mode"].asInt(4) != 4)
+	{
+		os::Printer::log("glTF: Only triangle primitives are supported", ELL_WARNING);
+		return false;
+	}
+
+	const SJsonValue& attributes = primitive["attributes"];
+	SGLTFAccessor position;
+	if (!getAccessor(doc, attributes["POSITION"].asInt(), position) || position.Components != 3)
+		return false;
+
+	const u32 vertexCount = position.Count;
+	if (vertexCount == 0 || vertexCount > 65536)
+	{
+		os::Printer::log("glTF: Primitive needs 32 bit indices, skipped", core::stringc(vertexCount).c_str(), ELL_WARNING);
+		return false;
+	}
+
+	const video::SColorf baseColor = readMaterial(doc, primitive["material"].asInt(), material);
+	vertices.set_used(vertexCount);
+
+	// positions and normals are copied straight out of the buffer when packed as floats
+	u32 i;
+#ifndef __BIG_ENDIAN__
+	if (position.ComponentType == EGCT_FLOAT)
+	{
+		for (i=0; i<vertexCount; ++i)
+		{
+			memcpy(&vertices[i].Pos, position.Data + i * position.Stride, sizeof(core::vector3df));
+			vertices[i].Pos.Z = -vertices[i].Pos.Z;
+		}
+	}
+	else
+#endif
+	{
+		for (i=0; i<vertexCount; ++i)
+			vertices[i].Pos = position.readVector(i);
+	}
+
+	SGLTFAccessor normal;
+	if (getAccessor(doc, attributes["NORMAL"].asInt(), normal) && normal.Count == vertexCount && normal.Components == 3)
+	{
+#ifndef __BIG_ENDIAN__
+		if (normal.ComponentType == EGCT_FLOAT)
+		{
+			for (i=0; i<vertexCount; ++i)
+			{
+				memcpy(&vertices[i].Normal, normal.Data + i * normal.Stride, sizeof(core::vector3df));
+				vertices[i].Normal.Z = -vertices[i].Normal.Z;
+			}
+		}
+		else
+#endif
+		{
+			for (i=0; i<vertexCount; ++i)
+				vertices[i].Normal = normal.readVector(i);
+		}
+	}
+	else
+	{
+		for (i=0; i<vertexCount; ++i)
+			vertices[i].Normal.set(0.f, 1.f, 0.f);
+	}
+
+	SGLTFAccessor tcoords;
+	if (getAccessor(doc, attributes["TEXCOORD_0"].asInt(), tcoords) && tcoords.Count == vertexCount && tcoords.Components == 2)
+	{
+#ifndef __BIG_ENDIAN__
+		if (tcoords.ComponentType == EGCT_FLOAT)
+		{
+			for (i=0; i<vertexCount; ++i)
+				memcpy(&vertices[i].TCoords, tcoords.Data + i * tcoords.Stride, sizeof(core::vector2df));
+		}
+		else
+#endif
+		{
+			for (i=0; i<vertexCount; ++i)
+				vertices[i].TCoords.set(tcoords.readFloat(i, 0), tcoords.readFloat(i, 1));
+		}
+	}
+	else
+	{
+		for (i=0; i<vertexCount; ++i)
+			vertices[i].TCoords.set(0.f, 0.f);
+	}
+
+	SGLTFAccessor color;
+	if (getAccessor(doc, attributes["COLOR_0"].asInt(), color) && color.Count == vertexCount && color.Components >= 3)
+	{
+		// integer colors are always normalized
+		color.Normalized = true;
+		for (i=0; i<vertexCount; ++i)
+		{
+			const f32 a = color.Components == 4 ? color.readFloat(i, 3) : 1.f;
+			const video::SColorf c(color.readFloat(i, 0) * baseColor.r, color.readFloat(i, 1) * baseColor.g,
+				color.readFloat(i, 2) * baseColor.b, a * baseColor.a);
+			vertices[i].Color = c.toSColor();
+		}
+	}
+	else
+	{
+		const video::SColor c = baseColor.toSColor();
+		for (i=0; i<vertexCount; ++i)
+			vertices[i].Color = c;
+	}
+
+	SGLTFAccessor index;
+	if (!primitive["indices"].isNull())
+	{
+		if (!getAccessor(doc, primitive["indices"].asInt(), index) || index.Components != 1 || index.Count % 3)
+			return false;
+
+		// 32 bit indices are narrowed, the vertex count is checked above
+		bool valid = true;
+		indices.set_used(index.Count);
+#ifndef __BIG_ENDIAN__
+		if (index.isPacked(EGCT_UNSIGNED_SHORT, 1))
+		{
+			memcpy(indices.pointer(), index.Data, index.Count * sizeof(u16));
+			for (i=0; i<index.Count; ++i)
+				valid &= indices[i] < vertexCount;
+		}
+		else
+#endif
+		{
+			for (i=0; i<index.Count; ++i)
+			{
+				const u32 v = index.readUInt(i, 0);
+				valid &= v < vertexCount;
+				indices[i] = (u16)v;
+			}
+		}
+
+		if (!valid)
+		{
+			os::Printer::log("glTF: Illegal vertex index found", ELL_ERROR);
+			return false;
+		}
+	}
+	else
+	{
+		if (vertexCount % 3)
+			return false;
+		indices.set_used(vertexCount);
+		for (i=0; i<vertexCount; ++i)
+			indices[i] = (u16)i;
+	}
+
+	return true;
+}
+
+
+IAnimatedMesh* CGLTFMeshFileLoader::createStaticMesh(const SGLTFDocument& doc)
+{
+	SMesh* mesh = new SMesh();
+
+	const SJsonValue& scene = doc.Json["scenes"][doc.Json["scene"].asInt(0)];
+	const SJsonValue& roots = scene["nodes"];
+	for (u32 i=0; i<roots.size(); ++i)
+		addStaticNode(doc, roots[i].asInt(), core::IdentityMatrix, mesh, 0);
+
+	if (mesh->getMeshBufferCount() == 0)
+	{
+		os::Printer::log("glTF: No meshes found", ELL_ERROR);
+		mesh->drop();
+		return 0;
+	}
+
+	mesh->recalculateBoundingBox();
+	SAnimatedMesh* animMesh = new SAnimatedMesh(mesh, EAMT_STATIC);
+	mesh->drop();
+	animMesh->recalculateBoundingBox();
+	return animMesh;
+}
+
+
+void CGLTFMeshFileLoader::addStaticNode(const SGLTFDocument& doc, s32 index, const core::matrix4& parent,
+	SMesh* mesh, u32 depth)
+{
+	const SJsonValue& node = doc.Json["nodes"][index];
+	if (index < 0 || node.isNull() || depth > GLTF_MAX_DEPTH)
+		return;
+
+	core::vector3df position, scale;
+	core::quaternion rotation;
+	const core::matrix4 transform = parent * readNodeTransform(node, position, rotation, scale);
+
+	const SJsonValue& primitives = doc.Json["meshes"][node["mesh"].asInt()]["primitives"];
+	if (primitives.size())
+	{
+		core::matrix4 normalTransform;
+		transform.getInverse(normalTransform);
+		normalTransform = normalTransform.getTransposed();
+
+		// a mirroring transformation flips the winding order
+		const f32* m = transform.pointer();
+		const f32 det = m[0] * (m[5] * m[10] - m[6] * m[9]) -
+			m[4] * (m[1] * m[10] - m[2] * m[9]) +
+			m[8] * (m[1] * m[6] - m[2] * m[5]);
+
+		for (u32 i=0; i<primitives.size(); ++i)
+		{
+			SMeshBuffer* buffer = new SMeshBuffer();
+			if (readPrimitive(doc, primitives[i], buffer->Vertices, buffer->Indices, buffer->Material))
+			{
+				for (u32 v=0; v<buffer->Vertices.size(); ++v)
+				{
+					video::S3DVertex& vertex = buffer->Vertices[v];
+					transform.transformVect(vertex.Pos);
+					normalTransform.rotateVect(vertex.Normal);
+					vertex.Normal.normalize();
+				}
+				if (det < 0.f)
+				{
+					for (u32 t=0; t<buffer->Indices.size(); t+=3)
+						core::swap(buffer->Indices[t+1], buffer->Indices[t+2]);
+				}
+				buffer->recalculateBoundingBox();
+				mesh->addMeshBuffer(buffer);
+			}
+			buffer->drop();
+		}
+	}
+
+	const SJsonValue& children = node["children"];
+	for (u32 i=0; i<children.size(); ++i)
+		addStaticNode(doc, children[i].asInt(), transform, mesh, depth + 1);
+}
+
+
+IAnimatedMesh* CGLTFMeshFileLoader::createSkinnedMesh(const SGLTFDocument& doc)
+{
+	CSkinnedMesh* mesh = new CSkinnedMesh();
+
+	// one joint per node, nodes outside of the default scene stay 0
+	core::array<CSkinnedMesh::SJoint*> joints;
+	joints.set_used(doc.Json["nodes"].size());
+	for (u32 i=0; i<joints.size(); ++i)
+		joints[i] = 0;
+
+	const SJsonValue& scene = doc.Json["scenes"][doc.Json["scene"].asInt(0)];
+	const SJsonValue& roots = scene["nodes"];
+	for (u32 i=0; i<roots.size(); ++i)
+		addJoint(doc, roots[i].asInt(), 0, mesh, joints, 0);
+
+	addSkinnedMeshBuffers(doc, mesh, joints);
+	if (mesh->getMeshBufferCount() == 0)
+	{
+		os::Printer::log("glTF: No meshes found", ELL_ERROR);
+		mesh->drop();
+		return 0;
+	}
+
+	readAnimation(doc, mesh, joints);
+
+	mesh->setAnimationSpeed(GLTF_FRAMES_PER_SECOND);
+	mesh->finalize();
+	return mesh;
+}
+
+
+void CGLTFMeshFileLoader::addJoint(const SGLTFDocument& doc, s32 index, CSkinnedMesh::SJoint* parent,
+	CSkinnedMesh* mesh, core::array<CSkinnedMesh::SJoint*>& joints, u32 depth)
+{
+	const SJsonValue& node = doc.Json["nodes"][index];
+	if (index < 0 || node.isNull() || joints[index] || depth > GLTF_MAX_DEPTH)
+		return;
+
+	CSkinnedMesh::SJoint* joint = mesh->addJoint(parent);
+	joints[index] = joint;
+	joint->Name = node["name"].String;
+	joint->LocalMatrix = readNodeTransform(node, joint->Animatedposition,
+		joint->Animatedrotation, joint->Animatedscale);
+	if (parent)
+		joint->GlobalMatrix = parent->GlobalMatrix * joint->LocalMatrix;
+	else
+		joint->GlobalMatrix = joint->LocalMatrix;
+
+	const SJsonValue& children = node["children"];
+	for (u32 i=0; i<children.size(); ++i)
+		addJoint(doc, children[i].asInt(), joint, mesh, joints, depth + 1);
+}
+
+
+void CGLTFMeshFileLoader::addSkinnedMeshBuffers(const SGLTFDocument& doc, CSkinnedMesh* mesh,
+	const core::array<CSkinnedMesh::SJoint*>& joints)
+{
+	const SJsonValue& nodes = doc.Json["nodes"];
+	for (u32 n=0; n<joints.size(); ++n)
+	{
+		const SJsonValue& node = nodes[n];
+		const SJsonValue& primitives = doc.Json["meshes"][node["mesh"].asInt()]["primitives"];
+		if (!joints[n] || !primitives.size())
+			continue;
+
+		// joints of the skin, and their inverse bind matrices
+		const SJsonValue& skin = doc.Json["skins"][node["skin"].asInt()];
+		const SJsonValue& skinJoints = skin["joints"];
+		SGLTFAccessor inverseBind;
+		if (getAccessor(doc, skin["inverseBindMatrices"].asInt(), inverseBind) &&
+			inverseBind.Components == 16 && inverseBind.Count >= skinJoints.size())
+		{
+			for (u32 j=0; j<skinJoints.size(); ++j)
+			{
+				const s32 jointNode = skinJoints[j].asInt();
+				if (jointNode < 0 || (u32)jointNode >= joints.size() || !joints[jointNode])
+					continue;
+				core::matrix4& mat = joints[jointNode]->GlobalInversedMatrix;
+				for (u32 k=0; k<16; ++k)
+					mat[k] = inverseBind.readFloat(j, k);
+				convertMatrix(mat);
+			}
+		}
+
+		for (u32 p=0; p<primitives.size(); ++p)
+		{
+			const u32 bufferIndex = mesh->getMeshBufferCount();
+			SSkinMeshBuffer* buffer = mesh->addMeshBuffer();
+			if (!readPrimitive(doc, primitives[p], buffer->Vertices_Standard, buffer->Indices, buffer->Material))
+			{
+				// keep the buffer, weights of other buffers refer to the indices
+				buffer->Vertices_Standard.clear();
+				buffer->Indices.clear();
+				continue;
+			}
+
+			const SJsonValue& attributes = primitives[p]["attributes"];
+			SGLTFAccessor jointIds, weights;
+			if (skin.isNull() ||
+				!getAccessor(doc, attributes["JOINTS_0"].asInt(), jointIds) ||
+				!getAccessor(doc, attributes["WEIGHTS_0"].asInt(), weights) ||
+				jointIds.Components != 4 || weights.Components != 4 ||
+				jointIds.Count != buffer->Vertices_Standard.size() || weights.Count != jointIds.Count)
+			{
+				// not skinned, moves rigidly with its node
+				joints[n]->AttachedMeshes.push_back(bufferIndex);
+				continue;
+			}
+
+			// integer weights are always normalized
+			weights.Normalized = true;
+			for (u32 v=0; v<jointIds.Count; ++v)
+			{
+				for (u32 c=0; c<4; ++c)
+				{
+					const f32 strength = weights.readFloat(v, c);
+					const s32 jointNode = skinJoints[jointIds.readUInt(v, c)].asInt();
+					if (strength <= 0.f || jointNode < 0 || (u32)jointNode >= joints.size() || !joints[jointNode])
+						continue;
+
+					CSkinnedMesh::SWeight* weight = mesh->addWeight(joints[jointNode]);
+					weight->buffer_id = (u16)bufferIndex;
+					weight->vertex_id = v;
+					weight->strength = strength;
+				}
+			}
+		}
+	}
+}
+
+
+void CGLTFMeshFileLoader::readAnimation(const SGLTFDocument& doc, CSkinnedMesh* mesh,
+	const core::array<CSkinnedMesh::SJoint*>& joints)
+{
+	const SJsonValue& animations = doc.Json["animations"];
+	if (!animations.size())
+		return;
+	if (animations.size() > 1)
+		os::Printer::log("glTF: Only the first animation is loaded", ELL_INFORMATION);
+
+	const SJsonValue& channels = animations[0]["channels"];
+	const SJsonValue& samplers = animations[0]["samplers"];
+	for (u32 i=0; i<channels.size(); ++i)
+	{
+		const SJsonValue& target = channels[i]["target"];
+		const s32 node = target["node"].asInt();
+		if (node < 0 || (u32)node >= joints.size() || !joints[node])
+			continue;
+		CSkinnedMesh::SJoint* joint = joints[node];
+
+		const SJsonValue& sampler = samplers[channels[i]["sampler"].asInt()];
+		SGLTFAccessor input, output;
+		if (!getAccessor(doc, sampler["input"].asInt(), input) || input.Components != 1 ||
+			!getAccessor(doc, sampler["output"].asInt(), output))
+			continue;
+
+		// cubic splines store in-tangent, value and out-tangent per key, only the value is used
+		const core::stringc& interpolation = sampler["interpolation"].String;
+		const bool cubic = interpolation == "CUBICSPLINE";
+		const bool step = interpolation == "STEP";
+		const u32 outputStride = cubic ? 3 : 1;
+		const u32 outputOffset = cubic ? 1 : 0;
+		if (output.Count < input.Count * outputStride)
+			continue;
+
+		const core::stringc& path = target["path"].String;
+		for (u32 k=0; k<input.Count; ++k)
+		{
+			const f32 frame = input.readFloat(k, 0) * GLTF_FRAMES_PER_SECOND;
+			const u32 o = k * outputStride + outputOffset;
+
+			// a key just before the next one holds the value for step interpolation
+			const u32 copies = (step && k + 1 < input.Count) ? 2 : 1;
+			for (u32 c=0; c<copies; ++c)
+			{
+				const f32 keyFrame = c ? input.readFloat(k + 1, 0) * GLTF_FRAMES_PER_SECOND - 0.001f : frame;
+				if (path == "translation" && output.Components == 3)
+				{
+					CSkinnedMesh::SPositionKey* key = mesh->addPositionKey(joint);
+					key->frame = keyFrame;
+					key->position = output.readVector(o);
+				}
+				else if (path == "rotation" && output.Components == 4)
+				{
+					CSkinnedMesh::SRotationKey* key = mesh->addRotationKey(joint);
+					key->frame = keyFrame;
+					key->rotation = convertRotation(output.readFloat(o, 0), output.readFloat(o, 1),
+						output.readFloat(o, 2), output.readFloat(o, 3));
+				}
+				else if (path == "scale" && output.Components == 3)
+				{
+					CSkinnedMesh::SScaleKey* key = mesh->addScaleKey(joint);
+					key->frame = keyFrame;
+					key->scale.set(output.readFloat(o, 0), output.readFloat(o, 1), output.readFloat(o, 2));
+				}
+			}
+		}
+	}
+}
+
+
+} // end namespace scene
+} // end namespace irr
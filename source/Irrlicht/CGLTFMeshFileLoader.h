@@ -0,0 +1,94 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// glTF 2.0 mesh loader, reads .gltf (embedded or external buffers) and .glb files.
+// Specification: https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html
+
+#pragma once
+
+#include "IMeshLoader.h"
+#include "ISceneManager.h"
+#include "IFileSystem.h"
+#include "CSkinnedMesh.h"
+#include "SMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+
+struct SGLTFDocument;
+struct SGLTFAccessor;
+struct SJsonValue;
+
+//! Meshloader for glTF 2.0 files
+/** Models without skins and animations are loaded as static meshes with the
+node transformations applied to the vertices, all others as CSkinnedMesh with
+one joint per node. Textures are not loaded, like in the other mesh loaders. */
+class CGLTFMeshFileLoader : public IMeshLoader
+{
+public:
+
+	//! Constructor
+	CGLTFMeshFileLoader(scene::ISceneManager* smgr, io::IFileSystem* fs);
+
+	//! destructor
+	virtual ~CGLTFMeshFileLoader();
+
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".glb")
+	bool isALoadableFileExtension(const io::path& filename) const override;
+
+	//! creates/loads an animated mesh from the file.
+	//! \return Pointer to the created mesh. Returns 0 if loading failed.
+	//! If you no longer need the mesh, you should call IAnimatedMesh::drop().
+	//! See IReferenceCounted::drop() for more information.
+	IAnimatedMesh* createMesh(io::IReadFile* file) override;
+
+private:
+
+	//! Reads the JSON and the buffers of a .gltf or .glb file
+	bool readDocument(io::IReadFile* file, SGLTFDocument& doc);
+
+	//! Resolves the buffers of the document, loads external and embedded ones
+	bool readBuffers(SGLTFDocument& doc);
+
+	//! Resolves an accessor and checks it against its buffer
+	bool getAccessor(const SGLTFDocument& doc, s32 index, SGLTFAccessor& accessor) const;
+
+	//! Reads one triangle primitive into vertices and indices
+	bool readPrimitive(const SGLTFDocument& doc, const SJsonValue& primitive,
+		core::array<video::S3DVertex>& vertices, core::array<u16>& indices,
+		video::SMaterial& material) const;
+
+	//! Sets up a material from the glTF material with the given index
+	video::SColorf readMaterial(const SGLTFDocument& doc, s32 index, video::SMaterial& material) const;
+
+	//! Builds a static mesh, node transformations are applied to the vertices
+	IAnimatedMesh* createStaticMesh(const SGLTFDocument& doc);
+
+	//! Builds a skinned mesh with joints for all nodes
+	IAnimatedMesh* createSkinnedMesh(const SGLTFDocument& doc);
+
+	//! Adds the nodes of the default scene to the static mesh
+	void addStaticNode(const SGLTFDocument& doc, s32 index, const core::matrix4& parent,
+		SMesh* mesh, u32 depth);
+
+	//! Creates joints for a node and its children
+	void addJoint(const SGLTFDocument& doc, s32 index, CSkinnedMesh::SJoint* parent,
+		CSkinnedMesh* mesh, core::array<CSkinnedMesh::SJoint*>& joints, u32 depth);
+
+	//! Adds the meshbuffers and weights of all nodes which have a mesh
+	void addSkinnedMeshBuffers(const SGLTFDocument& doc, CSkinnedMesh* mesh,
+		const core::array<CSkinnedMesh::SJoint*>& joints);
+
+	//! Converts the first animation to joint keyframes
+	void readAnimation(const SGLTFDocument& doc, CSkinnedMesh* mesh,
+		const core::array<CSkinnedMesh::SJoint*>& joints);
+
+	//! Opens external buffers, also from archives
+	io::IFileSystem* FileSystem;
+};
+
+} // end namespace scene
+} // end namespace irr
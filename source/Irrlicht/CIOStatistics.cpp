@@ -0,0 +1,223 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CIOStatistics.h"
+#include <chrono>
+#include <stdio.h>
+
+namespace irr
+{
+namespace io
+{
+
+CIOStatistics& getIOStatistics()
+{
+	static CIOStatistics statistics;
+	return statistics;
+}
+
+
+//! Names of the caches in E_IO_CACHE order
+static const c8* const CacheNames[EIOC_COUNT] = {"texture", "mesh"};
+
+
+CIOStatistics::CIOStatistics()
+	: BytesRead(0), InflatedBytes(0), InflateTime(0)
+{
+	for (u32 i = 0; i < EIOC_COUNT; ++i)
+	{
+		CacheHits[i] = 0;
+		CacheMisses[i] = 0;
+	}
+}
+
+
+void CIOStatistics::addFileOpened(const path& archive)
+{
+	const core::stringc name(archive);
+	std::lock_guard<std::mutex> lock(Mutex);
+	++FilesOpened[name.c_str()];
+}
+
+
+void CIOStatistics::addLoaderTime(const c8* kind, const path& filename, u64 nanoseconds)
+{
+	// loaders have no names, so they are told apart by what they load
+	core::stringc extension;
+	const s32 dot = filename.findLast('.');
+	if (dot >= 0 && dot > filename.findLast('/'))
+		extension = core::stringc(filename.subString(dot + 1, filename.size() - dot - 1));
+	extension.make_lower();
+
+	core::stringc name(kind);
+	name += '/';
+	name += extension;
+
+	std::lock_guard<std::mutex> lock(Mutex);
+	SLoader& loader = Loaders.emplace(name.c_str(), SLoader{0, 0}).first->second;
+	loader.Time += nanoseconds;
+	++loader.Calls;
+}
+
+
+u64 CIOStatistics::getTime()
+{
+	return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+u64 CIOStatistics::getFilesOpened(const path& archive) const
+{
+	const core::stringc name(archive);
+	std::lock_guard<std::mutex> lock(Mutex);
+	const auto it = FilesOpened.find(name.c_str());
+	return it != FilesOpened.end() ? it->second : 0;
+}
+
+
+u64 CIOStatistics::getBytesRead() const
+{
+	return BytesRead.load(std::memory_order_relaxed);
+}
+
+
+u64 CIOStatistics::getInflatedBytes() const
+{
+	return InflatedBytes.load(std::memory_order_relaxed);
+}
+
+
+u64 CIOStatistics::getInflateTime() const
+{
+	return InflateTime.load(std::memory_order_relaxed) / 1000;
+}
+
+
+u64 CIOStatistics::getLoaderTime(const core::stringc& name, u32* calls) const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	const auto it = Loaders.find(name.c_str());
+	if (calls)
+		*calls = it != Loaders.end() ? it->second.Calls : 0;
+	return it != Loaders.end() ? it->second.Time / 1000 : 0;
+}
+
+
+u64 CIOStatistics::getCacheLookups(const core::stringc& cache, bool hits) const
+{
+	for (u32 i = 0; i < EIOC_COUNT; ++i)
+	{
+		if (cache == CacheNames[i])
+			return (hits ? CacheHits : CacheMisses)[i].load(std::memory_order_relaxed);
+	}
+	return 0;
+}
+
+
+void CIOStatistics::reset()
+{
+	BytesRead = 0;
+	InflatedBytes = 0;
+	InflateTime = 0;
+	for (u32 i = 0; i < EIOC_COUNT; ++i)
+	{
+		CacheHits[i] = 0;
+		CacheMisses[i] = 0;
+	}
+
+	std::lock_guard<std::mutex> lock(Mutex);
+	FilesOpened.clear();
+	Loaders.clear();
+}
+
+
+//! appends text as JSON string
+static void appendJSONString(core::stringc& json, const std::string& text)
+{
+	json += '"';
+	for (const char c : text)
+	{
+		if (c == '"' || c == '\\')
+		{
+			json += '\\';
+			json += c;
+		}
+		else if ((u8)c < 0x20)
+		{
+			c8 escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", (u32)(u8)c);
+			json += escaped;
+		}
+		else
+			json += c;
+	}
+	json += '"';
+}
+
+
+static void appendJSONNumber(core::stringc& json, u64 number)
+{
+	c8 text[32];
+	snprintf(text, sizeof(text), "%llu", (unsigned long long)number);
+	json += text;
+}
+
+
+core::stringc CIOStatistics::getJSON() const
+{
+	core::stringc json("{\"bytesRead\":");
+	appendJSONNumber(json, getBytesRead());
+	json += ",\"inflatedBytes\":";
+	appendJSONNumber(json, getInflatedBytes());
+	json += ",\"inflateTimeUs\":";
+	appendJSONNumber(json, getInflateTime());
+
+	std::lock_guard<std::mutex> lock(Mutex);
+
+	// files on disk are counted under the empty name
+	json += ",\"filesOpened\":{";
+	bool first = true;
+	for (const auto& it : FilesOpened)
+	{
+		if (!first)
+			json += ',';
+		first = false;
+		appendJSONString(json, it.first);
+		json += ':';
+		appendJSONNumber(json, it.second);
+	}
+
+	json += "},\"loaders\":{";
+	first = true;
+	for (const auto& it : Loaders)
+	{
+		if (!first)
+			json += ',';
+		first = false;
+		appendJSONString(json, it.first);
+		json += ":{\"calls\":";
+		appendJSONNumber(json, it.second.Calls);
+		json += ",\"timeUs\":";
+		appendJSONNumber(json, it.second.Time / 1000);
+		json += '}';
+	}
+
+	json += "},\"caches\":{";
+	for (u32 i = 0; i < EIOC_COUNT; ++i)
+	{
+		if (i)
+			json += ',';
+		appendJSONString(json, CacheNames[i]);
+		json += ":{\"hits\":";
+		appendJSONNumber(json, CacheHits[i].load(std::memory_order_relaxed));
+		json += ",\"misses\":";
+		appendJSONNumber(json, CacheMisses[i].load(std::memory_order_relaxed));
+		json += '}';
+	}
+	json += "}}";
+	return json;
+}
+
+} // end namespace io
+} // end namespace irr
@@ -0,0 +1,110 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IIOStatistics.h"
+#include "IReadFile.h"
+#include "irrString.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace irr
+{
+namespace io
+{
+
+	//! Caches whose lookups are counted
+	enum E_IO_CACHE
+	{
+		EIOC_TEXTURE = 0,
+		EIOC_MESH,
+		EIOC_COUNT
+	};
+
+	//! Implementation of IIOStatistics, one for the process
+	class CIOStatistics : public IIOStatistics
+	{
+	public:
+
+		CIOStatistics();
+
+		//! counts a file opened from an archive, or from disk for an empty name
+		void addFileOpened(const path& archive);
+
+		void addBytesRead(u64 bytes)
+		{
+			BytesRead.fetch_add(bytes, std::memory_order_relaxed);
+		}
+
+		void addInflated(u64 bytes, u64 nanoseconds)
+		{
+			InflatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+			InflateTime.fetch_add(nanoseconds, std::memory_order_relaxed);
+		}
+
+		//! adds the time of a loader call
+		/** \param kind "image" or "mesh"
+		\param filename Name of the loaded file, the loader is named after its extension */
+		void addLoaderTime(const c8* kind, const path& filename, u64 nanoseconds);
+
+		//! counts a cache lookup, cheap enough for the fast paths of the caches
+		void addCacheLookup(E_IO_CACHE cache, bool hit)
+		{
+			(hit ? CacheHits : CacheMisses)[cache].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		//! returns a time stamp in nanoseconds for measuring durations
+		static u64 getTime();
+
+		u64 getFilesOpened(const path& archive) const override;
+
+		u64 getBytesRead() const override;
+
+		u64 getInflatedBytes() const override;
+
+		u64 getInflateTime() const override;
+
+		u64 getLoaderTime(const core::stringc& name, u32* calls = 0) const override;
+
+		u64 getCacheLookups(const core::stringc& cache, bool hits) const override;
+
+		void reset() override;
+
+		core::stringc getJSON() const override;
+
+	private:
+
+		struct SLoader
+		{
+			u64 Time;
+			u32 Calls;
+		};
+
+		std::atomic<u64> BytesRead;
+		std::atomic<u64> InflatedBytes;
+		std::atomic<u64> InflateTime;
+		std::atomic<u64> CacheHits[EIOC_COUNT];
+		std::atomic<u64> CacheMisses[EIOC_COUNT];
+
+		//! guards the maps
+		mutable std::mutex Mutex;
+		std::map<std::string, u64> FilesOpened;
+		std::map<std::string, SLoader> Loaders;
+	};
+
+	//! returns the statistics of the process
+	CIOStatistics& getIOStatistics();
+
+	//! counts bytes parsed through IReadFile::getMappedData() like read() would
+	/** Memory read files are not counted, their read() doesn't either. */
+	inline void addBytesMapped(const IReadFile* file, u64 bytes)
+	{
+		if (file->getType() != ERFT_MEMORY_READ_FILE)
+			getIOStatistics().addBytesRead(bytes);
+	}
+
+} // end namespace io
+} // end namespace irr
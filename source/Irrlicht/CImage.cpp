@@ -6,6 +6,7 @@
 #include "irrString.h"
 #include "CColorConverter.h"
 #include "CBlit.h"
+#include "CImageResampler.h"
 #include "os.h"
 #include "SoftwareDriver2_helper.h"
 
@@ -218,7 +219,6 @@ bool CImage::copyToNoScaling(void *target, u32 width, u32 height, ECOLOR_FORMAT
 
 
 //! copies this surface into another, scaling it to the target image size
-// note: this is very very slow.
 void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT format, u32 pitch)
 {
 	if (IImage::isCompressedFormat(Format))
@@ -263,15 +263,53 @@ void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT fo
 		sourceYStart = 0.5f;	// for rounding to nearest pixel
 	}
 
-	s32 yval=0, syval=0;
+	// source offsets of the target columns are the same for every row
+	core::array<u32> columns(width);
+	columns.set_used(width);
+	f32 sx = sourceXStart;
+	for (u32 x=0; x<width; ++x)
+	{
+		columns[x] = ((s32)sx)*BytesPerPixel;
+		sx+=sourceXStep;
+	}
+
+	// pixels are gathered in the source format and converted a row at a time
+	core::array<u8> gathered;
+	if (Format != format)
+		gathered.set_used(width*BytesPerPixel);
+
+	s32 yval=0, syval=0, lastSyval=-1;
 	f32 sy = sourceYStart;
 	for (u32 y=0; y<height; ++y)
 	{
-		f32 sx = sourceXStart;
-		for (u32 x=0; x<width; ++x)
+		u8* dst = ((u8*)target) + yval;
+		if (syval == lastSyval)
+		{
+			// repeated source row when scaling up
+			memcpy(dst, dst - pitch, width*bpp);
+		}
+		else
 		{
-			CColorConverter::convert_viaFormat(Data+ syval + ((s32)sx)*BytesPerPixel, Format, 1, ((u8*)target)+ yval + (x*bpp), format);
-			sx+=sourceXStep;
+			const u8* src = Data + syval;
+			u8* row = (Format == format) ? dst : gathered.pointer();
+			switch (BytesPerPixel)
+			{
+				case 2:
+					for (u32 x=0; x<width; ++x)
+						((u16*)row)[x] = *(const u16*)(src + columns[x]);
+				break;
+				case 4:
+					for (u32 x=0; x<width; ++x)
+						((u32*)row)[x] = *(const u32*)(src + columns[x]);
+				break;
+				default:
+					for (u32 x=0; x<width; ++x)
+						memcpy(row + x*BytesPerPixel, src + columns[x], BytesPerPixel);
+				break;
+			}
+			if (Format != format)
+				CColorConverter::convert_viaFormat(row, Format, width, dst, format);
+			lastSyval = syval;
 		}
 		sy+=sourceYStep;
 		syval=(s32)(sy)*Pitch;
@@ -281,7 +319,6 @@ void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT fo
 
 
 //! copies this surface into another, scaling it to the target image size
-// note: this is very very slow.
 void CImage::copyToScaling(IImage* target)
 {
 	if (IImage::isCompressedFormat(Format))
@@ -314,31 +351,146 @@ void CImage::copyToScalingBoxFilter(IImage* target, s32 bias, bool blend)
 		return;
 	}
 
+	if (!target || !Size.Width || !Size.Height)
+		return;
+
+	if (!CColorConverter::canConvertFormat(Format, ECF_A8R8G8B8))
+	{
+		os::Printer::log("IImage::copyToScalingBoxFilter unknown format.", ELL_WARNING);
+		return;
+	}
+
 	const core::dimension2d<u32> destSize = target->getDimension();
 
 	const f32 sourceXStep = (f32) Size.Width / (f32) destSize.Width;
 	const f32 sourceYStep = (f32) Size.Height / (f32) destSize.Height;
 
-	s32 fx = core::ceil32( sourceXStep );
-	s32 fy = core::ceil32( sourceYStep );
-	f32 sx;
-	f32 sy;
+	const s32 fx = core::ceil32( sourceXStep );
+	const s32 fy = core::ceil32( sourceYStep );
+	const s32 sdiv = s32_log2_s32(fx * fy);
+
+	// convert the source once instead of calling getPixel for every sample
+	const u32* argb = (const u32*)Data;
+	core::array<u32> converted;
+	if (Format != ECF_A8R8G8B8)
+	{
+		converted.set_used(Size.Width * Size.Height);
+		CColorConverter::convert_viaFormat(Data, Format, Size.Width * Size.Height, converted.pointer(), ECF_A8R8G8B8);
+		argb = converted.const_pointer();
+	}
+
+	core::array<s32> columns(destSize.Width);
+	columns.set_used(destSize.Width);
+	f32 sx = 0.f;
+	for ( u32 x = 0; x != destSize.Width; ++x )
+	{
+		columns[x] = core::floor32(sx);
+		sx += sourceXStep;
+	}
+
+	// whole rows are converted to the target format, blending needs setPixel
+	const ECOLOR_FORMAT destFormat = target->getColorFormat();
+	const bool convertRows = !blend && CColorConverter::canConvertFormat(ECF_A8R8G8B8, destFormat);
+	core::array<u32> row(destSize.Width);
+	row.set_used(destSize.Width);
 
-	sy = 0.f;
+	f32 sy = 0.f;
 	for ( u32 y = 0; y != destSize.Height; ++y )
 	{
-		sx = 0.f;
+		const s32 y0 = core::floor32(sy);
 		for ( u32 x = 0; x != destSize.Width; ++x )
 		{
-			target->setPixel( x, y,
-				getPixelBox( core::floor32(sx), core::floor32(sy), fx, fy, bias ), blend );
-			sx += sourceXStep;
+			s32 a = 0, r = 0, g = 0, b = 0;
+			for ( s32 dx = 0; dx != fx; ++dx )
+			{
+				const s32 px = core::s32_min ( columns[x] + dx, Size.Width - 1 );
+				for ( s32 dy = 0; dy != fy; ++dy )
+				{
+					const u32 c = argb[core::s32_min ( y0 + dy, Size.Height - 1 ) * Size.Width + px];
+					a += c >> 24;
+					r += (c >> 16) & 0xff;
+					g += (c >> 8) & 0xff;
+					b += c & 0xff;
+				}
+			}
+
+			a = core::s32_clamp( ( a >> sdiv ) + bias, 0, 255 );
+			r = core::s32_clamp( ( r >> sdiv ) + bias, 0, 255 );
+			g = core::s32_clamp( ( g >> sdiv ) + bias, 0, 255 );
+			b = core::s32_clamp( ( b >> sdiv ) + bias, 0, 255 );
+			row[x] = SColor(a, r, g, b).color;
+		}
+
+		if (convertRows)
+		{
+			CColorConverter::convert_viaFormat(row.const_pointer(), ECF_A8R8G8B8, destSize.Width,
+				(u8*)target->getData() + y * target->getPitch(), destFormat);
+		}
+		else
+		{
+			for ( u32 x = 0; x != destSize.Width; ++x )
+				target->setPixel( x, y, SColor(row[x]), blend );
 		}
 		sy += sourceYStep;
 	}
 }
 
 
+//! copies this surface into another, scaling it with a separable filter
+void CImage::copyToScalingFiltered(IImage* target, E_IMAGE_FILTER filter)
+{
+	if (IImage::isCompressedFormat(Format))
+	{
+		os::Printer::log("IImage::copyToScalingFiltered method doesn't work with compressed images.", ELL_WARNING);
+		return;
+	}
+
+	if (!target)
+		return;
+
+	const ECOLOR_FORMAT destFormat = target->getColorFormat();
+	if (!CColorConverter::canConvertFormat(Format, ECF_A8R8G8B8) ||
+		!CColorConverter::canConvertFormat(ECF_A8R8G8B8, destFormat))
+	{
+		os::Printer::log("IImage::copyToScalingFiltered unknown format.", ELL_WARNING);
+		return;
+	}
+
+	if (target->getDimension() == Size)
+	{
+		copyTo(target);
+		return;
+	}
+
+	resampleImage(Data, Format, Size, Pitch, (u8*)target->getData(), destFormat,
+		target->getDimension(), target->getPitch(), filter);
+}
+
+
+//! builds all mipmap levels with a box filter
+bool CImage::generateMipMaps(bool sRGB, f32 alphaTestRef, u32 threads)
+{
+	if (IImage::isCompressedFormat(Format) ||
+		!CColorConverter::canConvertFormat(Format, ECF_A8R8G8B8) ||
+		!CColorConverter::canConvertFormat(ECF_A8R8G8B8, Format))
+	{
+		os::Printer::log("IImage::generateMipMaps unsupported format.", ELL_WARNING);
+		return false;
+	}
+
+	// a 1x1 image has no further levels
+	const u32 dataSize = getMipMapsDataSize();
+	if (!dataSize)
+		return true;
+
+	u8* data = new u8[dataSize];
+	buildMipMaps(Data, Format, Size, Pitch, data, sRGB, alphaTestRef, threads);
+
+	setMipMapsData(data, true, true);
+	return true;
+}
+
+
 //! fills the surface with given color
 void CImage::fill(const SColor &color)
 {
@@ -383,46 +535,5 @@ void CImage::fill(const SColor &color)
 }
 
 
-//! get a filtered pixel
-inline SColor CImage::getPixelBox( s32 x, s32 y, s32 fx, s32 fy, s32 bias ) const
-{
-	if (IImage::isCompressedFormat(Format))
-	{
-		os::Printer::log("IImage::getPixelBox method doesn't work with compressed images.", ELL_WARNING);
-		return SColor(0);
-	}
-
-	SColor c;
-	s32 a = 0, r = 0, g = 0, b = 0;
-
-	for ( s32 dx = 0; dx != fx; ++dx )
-	{
-		for ( s32 dy = 0; dy != fy; ++dy )
-		{
-			c = getPixel(	core::s32_min ( x + dx, Size.Width - 1 ) ,
-							core::s32_min ( y + dy, Size.Height - 1 )
-						);
-
-			a += c.getAlpha();
-			r += c.getRed();
-			g += c.getGreen();
-			b += c.getBlue();
-		}
-
-	}
-
-	s32 sdiv = s32_log2_s32(fx * fy);
-
-	a = core::s32_clamp( ( a >> sdiv ) + bias, 0, 255 );
-	r = core::s32_clamp( ( r >> sdiv ) + bias, 0, 255 );
-	g = core::s32_clamp( ( g >> sdiv ) + bias, 0, 255 );
-	b = core::s32_clamp( ( b >> sdiv ) + bias, 0, 255 );
-
-	c.set( a, r, g, b );
-	return c;
-}
-
-
-
 } // end namespace video
 } // end namespace irr
@@ -64,11 +64,14 @@ public:
 	//! copies this surface into another, scaling it to fit, applying a box filter
 	void copyToScalingBoxFilter(IImage* target, s32 bias = 0, bool blend = false) override;
 
+	//! copies this surface into another, scaling it with a separable filter
+	void copyToScalingFiltered(IImage* target, E_IMAGE_FILTER filter = EIF_BILINEAR) override;
+
+	//! builds all mipmap levels with a box filter
+	bool generateMipMaps(bool sRGB = false, f32 alphaTestRef = 0.f, u32 threads = 0) override;
+
 	//! fills the surface with given color
 	void fill(const SColor &color) override;
-
-private:
-	inline SColor getPixelBox ( s32 x, s32 y, s32 fx, s32 fy, s32 bias ) const;
 };
 
 } // end namespace video
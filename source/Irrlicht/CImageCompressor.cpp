@@ -0,0 +1,802 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageCompressor.h"
+#include "CColorConverter.h"
+#include "CImage.h"
+#include "CImageResampler.h"
+#include "CReadFile.h"
+#include "CWriteFile.h"
+#include "irrMath.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+
+//! Pixels of a 4x4 block as A8R8G8B8, row by row
+typedef u32 SBlock[16];
+
+inline s32 red(u32 c) { return (c >> 16) & 0xff; }
+inline s32 green(u32 c) { return (c >> 8) & 0xff; }
+inline s32 blue(u32 c) { return c & 0xff; }
+
+inline s32 clamp255(s32 v)
+{
+	return core::clamp(v, 0, 255);
+}
+
+inline s32 colorError(s32 r0, s32 g0, s32 b0, s32 r1, s32 g1, s32 b1)
+{
+	return (r0 - r1) * (r0 - r1) + (g0 - g1) * (g0 - g1) + (b0 - b1) * (b0 - b1);
+}
+
+//! Copies a block, repeating the border for blocks reaching over the image
+void fetchBlock(const u32* pixels, u32 width, u32 height, u32 bx, u32 by, SBlock block)
+{
+	for (u32 y = 0; y < 4; ++y)
+	{
+		const u32* row = pixels + (size_t)core::min_(by * 4 + y, height - 1) * width;
+		for (u32 x = 0; x < 4; ++x)
+			block[y * 4 + x] = row[core::min_(bx * 4 + x, width - 1)];
+	}
+}
+
+inline u16 to565(f32 r, f32 g, f32 b)
+{
+	const u32 r5 = (u32)core::clamp(r * (31.f / 255.f) + 0.5f, 0.f, 31.f);
+	const u32 g6 = (u32)core::clamp(g * (63.f / 255.f) + 0.5f, 0.f, 63.f);
+	const u32 b5 = (u32)core::clamp(b * (31.f / 255.f) + 0.5f, 0.f, 31.f);
+	return (u16)((r5 << 11) | (g6 << 5) | b5);
+}
+
+inline void from565(u16 c, s32* rgb)
+{
+	const s32 r = (c >> 11) & 0x1f;
+	const s32 g = (c >> 5) & 0x3f;
+	const s32 b = c & 0x1f;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+//! Chooses the palette entry of every pixel, returns the summed error
+u32 findColorIndices(const SBlock block, u16 c0, u16 c1, u32& indices)
+{
+	s32 palette[4][3];
+	from565(c0, palette[0]);
+	from565(c1, palette[1]);
+	for (u32 c = 0; c < 3; ++c)
+	{
+		palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+		palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+	}
+
+	u32 error = 0;
+	indices = 0;
+	for (u32 i = 0; i < 16; ++i)
+	{
+		const s32 r = red(block[i]), g = green(block[i]), b = blue(block[i]);
+		u32 best = 0;
+		s32 bestError = 0x7fffffff;
+		for (u32 p = 0; p < 4; ++p)
+		{
+			const s32 e = colorError(r, g, b, palette[p][0], palette[p][1], palette[p][2]);
+			if (e < bestError)
+			{
+				bestError = e;
+				best = p;
+			}
+		}
+		indices |= best << (i * 2);
+		error += bestError;
+	}
+	return error;
+}
+
+//! Endpoints in 4 color mode, c0 has to be bigger than c1
+void orderEndpoints(u16& c0, u16& c1)
+{
+	if (c0 < c1)
+		core::swap(c0, c1);
+}
+
+//! Encodes the colors of a block into 8 bytes of DXT1 data
+/** The endpoints are the extremes along the principal axis of the colors,
+refined once by least squares for the chosen indices. */
+void compressColorBlock(const SBlock block, u8* out)
+{
+	f32 mean[3] = {0.f, 0.f, 0.f};
+	for (u32 i = 0; i < 16; ++i)
+	{
+		mean[0] += red(block[i]);
+		mean[1] += green(block[i]);
+		mean[2] += blue(block[i]);
+	}
+	for (u32 c = 0; c < 3; ++c)
+		mean[c] /= 16.f;
+
+	f32 cov[6] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+	for (u32 i = 0; i < 16; ++i)
+	{
+		const f32 r = red(block[i]) - mean[0];
+		const f32 g = green(block[i]) - mean[1];
+		const f32 b = blue(block[i]) - mean[2];
+		cov[0] += r * r;
+		cov[1] += r * g;
+		cov[2] += r * b;
+		cov[3] += g * g;
+		cov[4] += g * b;
+		cov[5] += b * b;
+	}
+
+	// power iteration for the principal axis
+	f32 axis[3] = {1.f, 1.f, 1.f};
+	for (u32 k = 0; k < 4; ++k)
+	{
+		const f32 x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+		const f32 y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+		const f32 z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+		const f32 length = core::max_(fabsf(x), core::max_(fabsf(y), fabsf(z)));
+		if (length < 1e-6f)
+			break;
+		axis[0] = x / length;
+		axis[1] = y / length;
+		axis[2] = z / length;
+	}
+
+	u32 minIndex = 0, maxIndex = 0;
+	f32 minDot = 1e30f, maxDot = -1e30f;
+	for (u32 i = 0; i < 16; ++i)
+	{
+		const f32 d = red(block[i]) * axis[0] + green(block[i]) * axis[1] + blue(block[i]) * axis[2];
+		if (d < minDot)
+		{
+			minDot = d;
+			minIndex = i;
+		}
+		if (d > maxDot)
+		{
+			maxDot = d;
+			maxIndex = i;
+		}
+	}
+
+	// move the endpoints inwards a little, the extremes are rarely hit exactly
+	f32 hi[3] = {(f32)red(block[maxIndex]), (f32)green(block[maxIndex]), (f32)blue(block[maxIndex])};
+	f32 lo[3] = {(f32)red(block[minIndex]), (f32)green(block[minIndex]), (f32)blue(block[minIndex])};
+	for (u32 c = 0; c < 3; ++c)
+	{
+		const f32 inset = (hi[c] - lo[c]) / 16.f;
+		hi[c] -= inset;
+		lo[c] += inset;
+	}
+
+	u16 c0 = to565(hi[0], hi[1], hi[2]);
+	u16 c1 = to565(lo[0], lo[1], lo[2]);
+	orderEndpoints(c0, c1);
+
+	u32 indices = 0;
+	u32 error = 0;
+	if (c0 != c1)
+	{
+		error = findColorIndices(block, c0, c1, indices);
+
+		// least squares endpoints for the chosen indices
+		static const f32 weights[4] = {1.f, 0.f, 2.f / 3.f, 1.f / 3.f};
+		f32 aa = 0.f, ab = 0.f, bb = 0.f;
+		f32 ap[3] = {0.f, 0.f, 0.f}, bp[3] = {0.f, 0.f, 0.f};
+		for (u32 i = 0; i < 16; ++i)
+		{
+			const f32 a = weights[(indices >> (i * 2)) & 3];
+			const f32 b = 1.f - a;
+			const f32 p[3] = {(f32)red(block[i]), (f32)green(block[i]), (f32)blue(block[i])};
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			for (u32 c = 0; c < 3; ++c)
+			{
+				ap[c] += a * p[c];
+				bp[c] += b * p[c];
+			}
+		}
+
+		const f32 det = aa * bb - ab * ab;
+		if (fabsf(det) > 1e-6f)
+		{
+			f32 e0[3], e1[3];
+			for (u32 c = 0; c < 3; ++c)
+			{
+				e0[c] = (ap[c] * bb - bp[c] * ab) / det;
+				e1[c] = (bp[c] * aa - ap[c] * ab) / det;
+			}
+			u16 r0 = to565(e0[0], e0[1], e0[2]);
+			u16 r1 = to565(e1[0], e1[1], e1[2]);
+			orderEndpoints(r0, r1);
+			if (r0 != r1)
+			{
+				u32 refinedIndices;
+				const u32 refinedError = findColorIndices(block, r0, r1, refinedIndices);
+				if (refinedError < error)
+				{
+					c0 = r0;
+					c1 = r1;
+					indices = refinedIndices;
+				}
+			}
+		}
+	}
+
+	out[0] = (u8)c0;
+	out[1] = (u8)(c0 >> 8);
+	out[2] = (u8)c1;
+	out[3] = (u8)(c1 >> 8);
+	for (u32 i = 0; i < 4; ++i)
+		out[4 + i] = (u8)(indices >> (i * 8));
+}
+
+//! Encodes the alpha of a block into 8 bytes of DXT5 data
+void compressAlphaBlock(const SBlock block, u8* out)
+{
+	s32 a0 = 0, a1 = 255;
+	for (u32 i = 0; i < 16; ++i)
+	{
+		const s32 a = block[i] >> 24;
+		a0 = core::max_(a0, a);
+		a1 = core::min_(a1, a);
+	}
+
+	// 8 value mode, a0 > a1
+	u64 indices = 0;
+	if (a0 != a1)
+	{
+		s32 palette[8] = {a0, a1};
+		for (s32 i = 1; i < 7; ++i)
+			palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+
+		for (u32 i = 0; i < 16; ++i)
+		{
+			const s32 a = block[i] >> 24;
+			u32 best = 0;
+			for (u32 p = 1; p < 8; ++p)
+			{
+				if (abs(palette[p] - a) < abs(palette[best] - a))
+					best = p;
+			}
+			indices |= (u64)best << (i * 3);
+		}
+	}
+
+	out[0] = (u8)a0;
+	out[1] = (u8)a1;
+	for (u32 i = 0; i < 6; ++i)
+		out[2 + i] = (u8)(indices >> (i * 8));
+}
+
+const s32 ETCModifiers[8][2] = {
+	{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}
+};
+
+//! Best table and pixel indices for one half of a block with a base color
+struct SETCSubBlock
+{
+	u32 Table;
+	u32 Error;
+	//! Indices 0 to 3 of the 8 pixels
+	u32 Indices[8];
+};
+
+//! Pixel positions of the two halves, as x * 4 + y
+void getSubBlockPixels(bool flip, u32 half, u32* positions)
+{
+	for (u32 i = 0; i < 8; ++i)
+	{
+		// flipped halves are 4x2 above each other, otherwise 2x4 side by side
+		const u32 x = flip ? i % 4 : half * 2 + i / 4;
+		const u32 y = flip ? half * 2 + i / 4 : i % 4;
+		positions[i] = x * 4 + y;
+	}
+}
+
+SETCSubBlock fitSubBlock(const SBlock block, const u32* positions, const s32* base)
+{
+	SETCSubBlock best;
+	best.Error = 0xffffffff;
+	for (u32 t = 0; t < 8; ++t)
+	{
+		const s32 modifiers[4] = {ETCModifiers[t][0], ETCModifiers[t][1], -ETCModifiers[t][0], -ETCModifiers[t][1]};
+		SETCSubBlock fit;
+		fit.Table = t;
+		fit.Error = 0;
+		for (u32 i = 0; i < 8; ++i)
+		{
+			// positions are column major, the block is row major
+			const u32 c = block[(positions[i] % 4) * 4 + positions[i] / 4];
+			s32 bestError = 0x7fffffff;
+			for (u32 m = 0; m < 4; ++m)
+			{
+				const s32 e = colorError(red(c), green(c), blue(c), clamp255(base[0] + modifiers[m]),
+					clamp255(base[1] + modifiers[m]), clamp255(base[2] + modifiers[m]));
+				if (e < bestError)
+				{
+					bestError = e;
+					fit.Indices[i] = m;
+				}
+			}
+			fit.Error += bestError;
+			if (fit.Error >= best.Error)
+				break;
+		}
+		if (fit.Error < best.Error)
+			best = fit;
+	}
+	return best;
+}
+
+//! Encodes the colors of a block into 8 bytes of ETC1 data, which ETC2 decodes the same way
+void compressETCBlock(const SBlock block, u8* out)
+{
+	u64 bestBits = 0;
+	u32 bestError = 0xffffffff;
+
+	for (u32 flip = 0; flip < 2; ++flip)
+	{
+		u32 positions[2][8];
+		f32 average[2][3];
+		for (u32 half = 0; half < 2; ++half)
+		{
+			getSubBlockPixels(flip != 0, half, positions[half]);
+			average[half][0] = average[half][1] = average[half][2] = 0.f;
+			for (u32 i = 0; i < 8; ++i)
+			{
+				const u32 c = block[(positions[half][i] % 4) * 4 + positions[half][i] / 4];
+				average[half][0] += red(c) / 8.f;
+				average[half][1] += green(c) / 8.f;
+				average[half][2] += blue(c) / 8.f;
+			}
+		}
+
+		for (u32 differential = 0; differential < 2; ++differential)
+		{
+			s32 quantized[2][3];
+			s32 base[2][3];
+			bool valid = true;
+			for (u32 half = 0; half < 2; ++half)
+			{
+				for (u32 c = 0; c < 3; ++c)
+				{
+					if (differential)
+					{
+						quantized[half][c] = (s32)(average[half][c] * (31.f / 255.f) + 0.5f);
+						base[half][c] = (quantized[half][c] << 3) | (quantized[half][c] >> 2);
+					}
+					else
+					{
+						quantized[half][c] = (s32)(average[half][c] * (15.f / 255.f) + 0.5f);
+						base[half][c] = quantized[half][c] * 17;
+					}
+				}
+			}
+
+			// the second color is stored as a 3 bit difference
+			for (u32 c = 0; c < 3 && differential; ++c)
+			{
+				const s32 delta = quantized[1][c] - quantized[0][c];
+				valid &= delta >= -4 && delta <= 3;
+			}
+			if (!valid)
+				continue;
+
+			const SETCSubBlock first = fitSubBlock(block, positions[0], base[0]);
+			const SETCSubBlock second = fitSubBlock(block, positions[1], base[1]);
+			if (first.Error + second.Error >= bestError)
+				continue;
+			bestError = first.Error + second.Error;
+
+			u64 bits = 0;
+			for (u32 c = 0; c < 3; ++c)
+			{
+				const u32 shift = 56 - c * 8;
+				if (differential)
+					bits |= (u64)((quantized[0][c] << 3) | ((quantized[1][c] - quantized[0][c]) & 7)) << shift;
+				else
+					bits |= (u64)((quantized[0][c] << 4) | quantized[1][c]) << shift;
+			}
+			bits |= (u64)first.Table << 37;
+			bits |= (u64)second.Table << 34;
+			bits |= (u64)differential << 33;
+			bits |= (u64)flip << 32;
+
+			// index bits are split into a plane of high and a plane of low bits
+			for (u32 i = 0; i < 8; ++i)
+			{
+				const u32 a = first.Indices[i];
+				const u32 b = second.Indices[i];
+				bits |= (u64)(a >> 1) << (16 + positions[0][i]) | (u64)(a & 1) << positions[0][i];
+				bits |= (u64)(b >> 1) << (16 + positions[1][i]) | (u64)(b & 1) << positions[1][i];
+			}
+			bestBits = bits;
+		}
+	}
+
+	for (u32 i = 0; i < 8; ++i)
+		out[i] = (u8)(bestBits >> (56 - i * 8));
+}
+
+const s32 EACModifiers[16][8] = {
+	{-3, -6, -9, -15, 2, 5, 8, 14},
+	{-3, -7, -10, -13, 2, 6, 9, 12},
+	{-2, -5, -8, -13, 1, 4, 7, 12},
+	{-2, -4, -6, -13, 1, 3, 5, 12},
+	{-3, -6, -8, -12, 2, 5, 7, 11},
+	{-3, -7, -9, -11, 2, 6, 8, 10},
+	{-4, -7, -8, -11, 3, 6, 7, 10},
+	{-3, -5, -8, -11, 2, 4, 7, 10},
+	{-2, -6, -8, -10, 1, 5, 7, 9},
+	{-2, -5, -8, -10, 1, 4, 7, 9},
+	{-2, -4, -8, -10, 1, 3, 7, 9},
+	{-2, -5, -7, -10, 1, 4, 6, 9},
+	{-3, -4, -7, -10, 2, 3, 6, 9},
+	{-1, -2, -3, -10, 0, 1, 2, 9},
+	{-4, -6, -8, -9, 3, 5, 7, 8},
+	{-3, -5, -7, -9, 2, 4, 6, 8}
+};
+
+//! Encodes the alpha of a block into 8 bytes of ETC2 EAC data
+void compressEACBlock(const SBlock block, u8* out)
+{
+	s32 alpha[16];
+	s32 lo = 255, hi = 0;
+	for (u32 i = 0; i < 16; ++i)
+	{
+		// stored column major
+		alpha[i] = block[(i % 4) * 4 + i / 4] >> 24;
+		lo = core::min_(lo, alpha[i]);
+		hi = core::max_(hi, alpha[i]);
+	}
+
+	// table 13 can store the base itself
+	u32 bestBase = lo, bestMultiplier = 1, bestTable = 13;
+	u64 bestIndices = 0;
+	for (u32 i = 0; i < 16; ++i)
+		bestIndices |= (u64)4 << (45 - i * 3);
+
+	if (lo != hi)
+	{
+		u32 bestError = 0xffffffff;
+		for (u32 t = 0; t < 16; ++t)
+		{
+			const s32* modifiers = EACModifiers[t];
+			const s32 span = modifiers[7] - modifiers[3];
+			const s32 multiplier = core::clamp((hi - lo + span / 2) / span, 1, 15);
+			for (s32 m = core::max_(multiplier - 1, 1); m <= core::min_(multiplier + 1, 15); ++m)
+			{
+				const s32 center = (lo + hi + 1) / 2 - (modifiers[7] + modifiers[3]) * m / 2;
+				for (s32 base = center - 1; base <= center + 1; ++base)
+				{
+					if (base < 0 || base > 255)
+						continue;
+
+					u32 error = 0;
+					u64 indices = 0;
+					for (u32 i = 0; i < 16 && error < bestError; ++i)
+					{
+						u32 best = 0;
+						s32 bestDiff = 0x7fffffff;
+						for (u32 k = 0; k < 8; ++k)
+						{
+							const s32 diff = abs(clamp255(base + modifiers[k] * m) - alpha[i]);
+							if (diff < bestDiff)
+							{
+								bestDiff = diff;
+								best = k;
+							}
+						}
+						error += bestDiff * bestDiff;
+						indices |= (u64)best << (45 - i * 3);
+					}
+
+					if (error < bestError)
+					{
+						bestError = error;
+						bestBase = base;
+						bestMultiplier = m;
+						bestTable = t;
+						bestIndices = indices;
+					}
+				}
+			}
+		}
+	}
+
+	out[0] = (u8)bestBase;
+	out[1] = (u8)((bestMultiplier << 4) | bestTable);
+	for (u32 i = 0; i < 6; ++i)
+		out[2 + i] = (u8)(bestIndices >> (40 - i * 8));
+}
+
+void compressBlock(const SBlock block, ECOLOR_FORMAT format, u8* out)
+{
+	switch (format)
+	{
+	case ECF_DXT1:
+		compressColorBlock(block, out);
+		break;
+	case ECF_DXT5:
+		compressAlphaBlock(block, out);
+		compressColorBlock(block, out + 8);
+		break;
+	case ECF_ETC2_RGB:
+		compressETCBlock(block, out);
+		break;
+	case ECF_ETC2_ARGB:
+		compressEACBlock(block, out);
+		compressETCBlock(block, out + 8);
+		break;
+	default:
+		break;
+	}
+}
+
+//! Compresses one level, src has pitch bytes per row
+void compressLevel(const u8* src, ECOLOR_FORMAT srcFormat, const core::dimension2d<u32>& size, u32 pitch,
+	u8* dst, ECOLOR_FORMAT format, u32 threads)
+{
+	std::vector<u32> converted;
+	const u32* pixels = (const u32*)src;
+	if (srcFormat != ECF_A8R8G8B8 || pitch != size.Width * 4)
+	{
+		converted.resize((size_t)size.Width * size.Height);
+		for (u32 y = 0; y < size.Height; ++y)
+			CColorConverter::convert_viaFormat(src + (size_t)y * pitch, srcFormat, size.Width,
+				&converted[(size_t)y * size.Width], ECF_A8R8G8B8);
+		pixels = converted.data();
+	}
+
+	const u32 blockBytes = (format == ECF_DXT1 || format == ECF_ETC2_RGB) ? 8 : 16;
+	const u32 blocksX = (size.Width + 3) / 4;
+	const u32 blocksY = (size.Height + 3) / 4;
+	const u32 bands = core::min_(getImageBandCount(size, threads), blocksY);
+
+	processImageBands(blocksY, bands, [&](u32 y0, u32 y1) {
+		SBlock block;
+		for (u32 by = y0; by < y1; ++by)
+		{
+			u8* out = dst + (size_t)by * blocksX * blockBytes;
+			for (u32 bx = 0; bx < blocksX; ++bx)
+			{
+				fetchBlock(pixels, size.Width, size.Height, bx, by, block);
+				compressBlock(block, format, out + bx * blockBytes);
+			}
+		}
+	});
+}
+
+inline u64 mixHash(u64 h, u64 value)
+{
+	h = (h ^ value) * 0x9e3779b97f4a7c15ULL;
+	return h ^ (h >> 32);
+}
+
+u64 hashBytes(u64 h, const u8* data, size_t size)
+{
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8)
+	{
+		u64 word;
+		memcpy(&word, data + i, 8);
+		h = mixHash(h, word);
+	}
+	u64 tail = size;
+	for (; i < size; ++i)
+		tail = (tail << 8) | data[i];
+	return mixHash(h, tail);
+}
+
+// byte-align structures
+#include "irrpack.h"
+
+struct SCompressedCacheHeader
+{
+	u32 Magic;
+	u32 Format;
+	u32 Width;
+	u32 Height;
+	u32 DataSize;
+	u32 MipMapsDataSize;
+} PACK_STRUCT;
+
+// Default alignment
+#include "irrunpack.h"
+
+const u32 COMPRESSED_CACHE_MAGIC = 0x31435449; // "ITC1"
+
+} // end anonymous namespace
+
+
+bool canCompressImageTo(ECOLOR_FORMAT format)
+{
+	return format == ECF_DXT1 || format == ECF_DXT5 || format == ECF_ETC2_RGB || format == ECF_ETC2_ARGB;
+}
+
+
+bool hasTransparentPixels(const IImage* image)
+{
+	const core::dimension2d<u32>& size = image->getDimension();
+	for (u32 y = 0; y < size.Height; ++y)
+	{
+		const u8* row = (const u8*)image->getData() + (size_t)y * image->getPitch();
+		switch (image->getColorFormat())
+		{
+		case ECF_A8R8G8B8:
+			for (u32 x = 0; x < size.Width; ++x)
+			{
+				if ((((const u32*)row)[x] >> 24) != 0xff)
+					return true;
+			}
+			break;
+		case ECF_A1R5G5B5:
+			for (u32 x = 0; x < size.Width; ++x)
+			{
+				if (!(((const u16*)row)[x] & 0x8000))
+					return true;
+			}
+			break;
+		default:
+			return false;
+		}
+	}
+	return false;
+}
+
+
+IImage* compressImage(const IImage* image, ECOLOR_FORMAT format, u32 threads)
+{
+	const ECOLOR_FORMAT srcFormat = image->getColorFormat();
+	if (!canCompressImageTo(format) || !CColorConverter::canConvertFormat(srcFormat, ECF_A8R8G8B8))
+		return 0;
+
+	const core::dimension2d<u32>& size = image->getDimension();
+	CImage* result = new CImage(format, size);
+	compressLevel((const u8*)image->getData(), srcFormat, size, image->getPitch(),
+		(u8*)result->getData(), format, threads);
+
+	if (image->getMipMapsData())
+	{
+		u8* mipMaps = new u8[result->getMipMapsDataSize()];
+		const u8* src = (const u8*)image->getMipMapsData();
+		u8* dst = mipMaps;
+		core::dimension2d<u32> levelSize(size);
+		while (levelSize.Width > 1 || levelSize.Height > 1)
+		{
+			levelSize.Width = core::max_(levelSize.Width >> 1, 1u);
+			levelSize.Height = core::max_(levelSize.Height >> 1, 1u);
+
+			const u32 pitch = IImage::getBitsPerPixelFromFormat(srcFormat) / 8 * levelSize.Width;
+			compressLevel(src, srcFormat, levelSize, pitch, dst, format, threads);
+			src += IImage::getDataSizeFromFormat(srcFormat, levelSize.Width, levelSize.Height);
+			dst += IImage::getDataSizeFromFormat(format, levelSize.Width, levelSize.Height);
+		}
+		result->setMipMapsData(mipMaps, true, true);
+	}
+
+	return result;
+}
+
+
+u64 hashImage(const IImage* image, u64 seed)
+{
+	const core::dimension2d<u32>& size = image->getDimension();
+	u64 h = mixHash(mixHash(mixHash(seed, image->getColorFormat()), size.Width), size.Height);
+
+	const u32 rowBytes = IImage::getDataSizeFromFormat(image->getColorFormat(), size.Width, 1);
+	if (image->getPitch() == rowBytes || IImage::isCompressedFormat(image->getColorFormat()))
+	{
+		h = hashBytes(h, (const u8*)image->getData(), image->getImageDataSizeInBytes());
+	}
+	else
+	{
+		for (u32 y = 0; y < size.Height; ++y)
+			h = hashBytes(h, (const u8*)image->getData() + (size_t)y * image->getPitch(), rowBytes);
+	}
+
+	if (image->getMipMapsData())
+		h = hashBytes(h, (const u8*)image->getMipMapsData(), image->getMipMapsDataSize());
+	return h;
+}
+
+
+bool writeCompressedImageCache(const io::path& filename, const IImage* image)
+{
+	// written under a name of its own and renamed when complete, so
+	// readers never see half of it, even if the writer crashes
+	static std::atomic<u32> counter(0);
+	c8 suffix[48];
+	snprintf_irr(suffix, sizeof(suffix), ".%x.%x.tmp", (u32)std::hash<std::thread::id>()(std::this_thread::get_id()),
+		counter.fetch_add(1, std::memory_order_relaxed));
+	const io::path tempName = filename + suffix;
+
+	io::IWriteFile* file = io::CWriteFile::createWriteFile(tempName, false);
+	if (!file)
+		return false;
+
+	SCompressedCacheHeader header;
+	header.Magic = COMPRESSED_CACHE_MAGIC;
+	header.Format = image->getColorFormat();
+	header.Width = image->getDimension().Width;
+	header.Height = image->getDimension().Height;
+	header.DataSize = image->getImageDataSizeInBytes();
+	header.MipMapsDataSize = image->getMipMapsData() ? image->getMipMapsDataSize() : 0;
+
+	bool written = file->write(&header, sizeof(header)) == sizeof(header) &&
+		file->write(image->getData(), header.DataSize) == header.DataSize;
+	if (written && header.MipMapsDataSize)
+		written = file->write(image->getMipMapsData(), header.MipMapsDataSize) == header.MipMapsDataSize;
+	file->drop();
+
+	if (written && rename(tempName.c_str(), filename.c_str()) == 0)
+		return true;
+	remove(tempName.c_str());
+	if (!written)
+		return false;
+
+	// where rename doesn't replace files it fails if another thread
+	// stored the same entry meanwhile, which is fine
+	io::IReadFile* existing = io::CReadFile::createReadFile(filename);
+	if (existing)
+		existing->drop();
+	return existing != 0;
+}
+
+
+IImage* readCompressedImageCache(const io::path& filename)
+{
+	io::IReadFile* file = io::CReadFile::createReadFile(filename);
+	if (!file)
+		return 0;
+
+	SCompressedCacheHeader header;
+	IImage* image = 0;
+	if (file->read(&header, sizeof(header)) == sizeof(header) && header.Magic == COMPRESSED_CACHE_MAGIC &&
+		canCompressImageTo((ECOLOR_FORMAT)header.Format) && checkImageDimensions(header.Width, header.Height) &&
+		header.Width && header.Height &&
+		header.DataSize == IImage::getDataSizeFromFormat((ECOLOR_FORMAT)header.Format, header.Width, header.Height))
+	{
+		image = new CImage((ECOLOR_FORMAT)header.Format, core::dimension2d<u32>(header.Width, header.Height));
+
+		bool valid = file->read(image->getData(), header.DataSize) == header.DataSize;
+		if (valid && header.MipMapsDataSize)
+		{
+			valid = header.MipMapsDataSize == image->getMipMapsDataSize();
+			if (valid)
+			{
+				u8* mipMaps = new u8[header.MipMapsDataSize];
+				valid = file->read(mipMaps, header.MipMapsDataSize) == header.MipMapsDataSize;
+				image->setMipMapsData(mipMaps, true, true);
+			}
+		}
+
+		if (!valid)
+		{
+			image->drop();
+			image = 0;
+		}
+	}
+
+	file->drop();
+	return image;
+}
+
+} // end namespace video
+} // end namespace irr
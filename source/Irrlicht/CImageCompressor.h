@@ -0,0 +1,43 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IImage.h"
+#include "path.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Returns true if compressImage can create images of this format
+/** These are ECF_DXT1, ECF_DXT5, ECF_ETC2_RGB and ECF_ETC2_ARGB. */
+bool canCompressImageTo(ECOLOR_FORMAT format);
+
+//! Returns true if any pixel of the image is not fully opaque
+bool hasTransparentPixels(const IImage* image);
+
+//! Block compresses an image and its mipmaps
+/** The image format has to be convertible to A8R8G8B8. ECF_DXT1 and
+ECF_ETC2_RGB drop the alpha channel. Big images are split into bands of
+blocks which are compressed in parallel.
+\param threads Maximum number of threads, 0 to use all cores.
+\return The new image, or 0 if a format is not supported. */
+IImage* compressImage(const IImage* image, ECOLOR_FORMAT format, u32 threads = 0);
+
+//! 64 bit hash of the format, size, pixels and mipmaps of an image
+/** \param seed Mixed into the hash, for everything else the result depends on. */
+u64 hashImage(const IImage* image, u64 seed = 0);
+
+//! Writes a compressed image with its mipmaps into a cache file
+/** The file appears complete or not at all, also when several threads
+write the same entry. */
+bool writeCompressedImageCache(const io::path& filename, const IImage* image);
+
+//! Reads a file written by writeCompressedImageCache
+/** \return The image, or 0 if the file does not exist or is invalid. */
+IImage* readCompressedImageCache(const io::path& filename);
+
+} // end namespace video
+} // end namespace irr
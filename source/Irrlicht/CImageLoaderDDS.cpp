@@ -0,0 +1,316 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageLoaderDDS.h"
+
+#include "IReadFile.h"
+#include "os.h"
+#include "CImage.h"
+#include "irrString.h"
+
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+
+const u32 DDS_MAGIC = 0x20534444; // "DDS "
+
+// SDDSPixelFormat::Flags
+const u32 DDPF_ALPHAPIXELS = 0x1;
+const u32 DDPF_FOURCC = 0x4;
+const u32 DDPF_RGB = 0x40;
+
+// SDDSHeader::Caps2
+const u32 DDSCAPS2_CUBEMAP = 0x200;
+const u32 DDSCAPS2_VOLUME = 0x200000;
+
+// SDDSHeaderDX10
+const u32 DDS_DIMENSION_TEXTURE2D = 3;
+const u32 DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+constexpr u32 makeFourCC(c8 a, c8 b, c8 c, c8 d)
+{
+	return (u32)(u8)a | ((u32)(u8)b << 8) | ((u32)(u8)c << 16) | ((u32)(u8)d << 24);
+}
+
+//! How the stored pixels are turned into an Irrlicht format
+enum E_DDS_CONVERSION
+{
+	EDC_NONE = 0,
+	//! swap red and blue
+	EDC_SWAP_RB,
+	//! set the unused alpha bits
+	EDC_OPAQUE
+};
+
+//! Finds the format of the pixel data, ECF_UNKNOWN if not supported
+ECOLOR_FORMAT getFormat(const SDDSPixelFormat& pf, E_DDS_CONVERSION& conversion)
+{
+	conversion = EDC_NONE;
+
+	if (pf.Flags & DDPF_FOURCC)
+	{
+		switch (pf.FourCC)
+		{
+		case makeFourCC('D', 'X', 'T', '1'):
+			return ECF_DXT1;
+		case makeFourCC('D', 'X', 'T', '2'):
+			return ECF_DXT2;
+		case makeFourCC('D', 'X', 'T', '3'):
+			return ECF_DXT3;
+		case makeFourCC('D', 'X', 'T', '4'):
+			return ECF_DXT4;
+		case makeFourCC('D', 'X', 'T', '5'):
+			return ECF_DXT5;
+		default:
+			return ECF_UNKNOWN;
+		}
+	}
+
+	if (!(pf.Flags & DDPF_RGB))
+		return ECF_UNKNOWN;
+
+	const u32 alphaMask = (pf.Flags & DDPF_ALPHAPIXELS) ? pf.ABitMask : 0;
+	switch (pf.RGBBitCount)
+	{
+	case 32:
+		if (pf.RBitMask == 0x00ff0000 && pf.GBitMask == 0x0000ff00 && pf.BBitMask == 0x000000ff)
+		{
+			conversion = alphaMask ? EDC_NONE : EDC_OPAQUE;
+			return ECF_A8R8G8B8;
+		}
+		if (pf.RBitMask == 0x000000ff && pf.GBitMask == 0x0000ff00 && pf.BBitMask == 0x00ff0000 && alphaMask)
+		{
+			conversion = EDC_SWAP_RB;
+			return ECF_A8R8G8B8;
+		}
+		break;
+	case 24:
+		if (pf.RBitMask == 0xff0000 && pf.GBitMask == 0x00ff00 && pf.BBitMask == 0x0000ff)
+		{
+			// stored as B, G, R
+			conversion = EDC_SWAP_RB;
+			return ECF_R8G8B8;
+		}
+		if (pf.RBitMask == 0x0000ff && pf.GBitMask == 0x00ff00 && pf.BBitMask == 0xff0000)
+			return ECF_R8G8B8;
+		break;
+	case 16:
+		if (pf.RBitMask == 0xf800 && pf.GBitMask == 0x07e0 && pf.BBitMask == 0x001f)
+			return ECF_R5G6B5;
+		if (pf.RBitMask == 0x7c00 && pf.GBitMask == 0x03e0 && pf.BBitMask == 0x001f)
+		{
+			conversion = alphaMask == 0x8000 ? EDC_NONE : EDC_OPAQUE;
+			return ECF_A1R5G5B5;
+		}
+		break;
+	}
+	return ECF_UNKNOWN;
+}
+
+//! Format of a DX10 header, ECF_UNKNOWN if not supported
+ECOLOR_FORMAT getFormatDX10(u32 dxgiFormat, E_DDS_CONVERSION& conversion)
+{
+	conversion = EDC_NONE;
+
+	// sRGB formats are loaded like their linear counterparts
+	switch (dxgiFormat)
+	{
+	case 28: // DXGI_FORMAT_R8G8B8A8_UNORM
+	case 29: // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+		conversion = EDC_SWAP_RB;
+		return ECF_A8R8G8B8;
+	case 71: // DXGI_FORMAT_BC1_UNORM
+	case 72: // DXGI_FORMAT_BC1_UNORM_SRGB
+		return ECF_DXT1;
+	case 74: // DXGI_FORMAT_BC2_UNORM
+	case 75: // DXGI_FORMAT_BC2_UNORM_SRGB
+		return ECF_DXT3;
+	case 77: // DXGI_FORMAT_BC3_UNORM
+	case 78: // DXGI_FORMAT_BC3_UNORM_SRGB
+		return ECF_DXT5;
+	case 85: // DXGI_FORMAT_B5G6R5_UNORM
+		return ECF_R5G6B5;
+	case 86: // DXGI_FORMAT_B5G5R5A1_UNORM
+		return ECF_A1R5G5B5;
+	case 87: // DXGI_FORMAT_B8G8R8A8_UNORM
+	case 91: // DXGI_FORMAT_B8G8R8A8_UNORM_SRGB
+		return ECF_A8R8G8B8;
+	case 88: // DXGI_FORMAT_B8G8R8X8_UNORM
+	case 93: // DXGI_FORMAT_B8G8R8X8_UNORM_SRGB
+		conversion = EDC_OPAQUE;
+		return ECF_A8R8G8B8;
+	default:
+		return ECF_UNKNOWN;
+	}
+}
+
+void convertPixels(u8* data, u32 size, ECOLOR_FORMAT format, E_DDS_CONVERSION conversion)
+{
+	const u32 bytesPerPixel = IImage::getBitsPerPixelFromFormat(format) / 8;
+	const u32 count = size / bytesPerPixel;
+	switch (conversion)
+	{
+	case EDC_SWAP_RB:
+		for (u32 i = 0; i < count; ++i)
+			core::swap(data[i * bytesPerPixel], data[i * bytesPerPixel + 2]);
+		break;
+	case EDC_OPAQUE:
+		if (format == ECF_A8R8G8B8)
+		{
+			for (u32 i = 0; i < count; ++i)
+				((u32*)data)[i] |= 0xff000000;
+		}
+		else
+		{
+			for (u32 i = 0; i < count; ++i)
+				((u16*)data)[i] |= 0x8000;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+} // end anonymous namespace
+
+
+//! returns true if the file maybe is able to be loaded by this class
+//! based on the file extension (e.g. ".dds")
+bool CImageLoaderDDS::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension(filename, "dds");
+}
+
+
+//! returns true if the file maybe is able to be loaded by this class
+bool CImageLoaderDDS::isALoadableFileFormat(io::IReadFile* file) const
+{
+	u32 magic = 0;
+	if (file->read(&magic, sizeof(u32)) != sizeof(u32))
+		return false;
+#ifdef __BIG_ENDIAN__
+	magic = os::Byteswap::byteswap(magic);
+#endif
+	return magic == DDS_MAGIC;
+}
+
+
+//! creates a surface from the file
+IImage* CImageLoaderDDS::loadImage(io::IReadFile* file) const
+{
+	u32 magic = 0;
+	SDDSHeader header;
+	if (file->read(&magic, sizeof(u32)) != sizeof(u32) ||
+		file->read(&header, sizeof(header)) != sizeof(header))
+		return 0;
+
+#ifdef __BIG_ENDIAN__
+	magic = os::Byteswap::byteswap(magic);
+	for (u32 i = 0; i < sizeof(header) / sizeof(u32); ++i)
+		((u32*)&header)[i] = os::Byteswap::byteswap(((u32*)&header)[i]);
+#endif
+
+	if (magic != DDS_MAGIC || header.Size != sizeof(SDDSHeader) || header.PixelFormat.Size != sizeof(SDDSPixelFormat))
+	{
+		os::Printer::log("Invalid DDS header", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if (header.Caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME))
+	{
+		os::Printer::log("DDS cube maps and volume textures are not supported", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	E_DDS_CONVERSION conversion;
+	ECOLOR_FORMAT format;
+	if ((header.PixelFormat.Flags & DDPF_FOURCC) && header.PixelFormat.FourCC == makeFourCC('D', 'X', '1', '0'))
+	{
+		SDDSHeaderDX10 dx10;
+		if (file->read(&dx10, sizeof(dx10)) != sizeof(dx10))
+			return 0;
+#ifdef __BIG_ENDIAN__
+		for (u32 i = 0; i < sizeof(dx10) / sizeof(u32); ++i)
+			((u32*)&dx10)[i] = os::Byteswap::byteswap(((u32*)&dx10)[i]);
+#endif
+		if (dx10.ResourceDimension != DDS_DIMENSION_TEXTURE2D || dx10.ArraySize > 1 ||
+			(dx10.MiscFlag & DDS_RESOURCE_MISC_TEXTURECUBE))
+		{
+			os::Printer::log("Only 2D DDS textures are supported", file->getFileName(), ELL_ERROR);
+			return 0;
+		}
+		format = getFormatDX10(dx10.DXGIFormat, conversion);
+	}
+	else
+	{
+		format = getFormat(header.PixelFormat, conversion);
+	}
+
+	if (format == ECF_UNKNOWN)
+	{
+		os::Printer::log("Unsupported DDS pixel format", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if (!checkImageDimensions(header.Width, header.Height) || !header.Width || !header.Height)
+	{
+		os::Printer::log("Invalid DDS image size", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const core::dimension2d<u32> size(header.Width, header.Height);
+	const u32 dataSize = IImage::getDataSizeFromFormat(format, size.Width, size.Height);
+	u8* data = new u8[dataSize];
+	if (file->read(data, dataSize) != dataSize)
+	{
+		os::Printer::log("DDS file is too short", file->getFileName(), ELL_ERROR);
+		delete [] data;
+		return 0;
+	}
+	convertPixels(data, dataSize, format, conversion);
+
+	IImage* image = new CImage(format, size, data);
+
+	// images keep all levels down to 1x1 or none
+	u32 levels = 1;
+	for (u32 longest = core::max_(size.Width, size.Height); longest > 1; longest >>= 1)
+		++levels;
+
+	if (header.MipMapCount == levels)
+	{
+		const u32 mipMapsSize = image->getMipMapsDataSize();
+		u8* mipMaps = new u8[mipMapsSize];
+		if (file->read(mipMaps, mipMapsSize) == mipMapsSize)
+		{
+			convertPixels(mipMaps, mipMapsSize, format, conversion);
+			image->setMipMapsData(mipMaps, true, true);
+		}
+		else
+		{
+			os::Printer::log("DDS file is too short for its mipmaps", file->getFileName(), ELL_WARNING);
+			delete [] mipMaps;
+		}
+	}
+	else if (header.MipMapCount > 1)
+	{
+		os::Printer::log("Ignoring incomplete DDS mipmap chain", file->getFileName(), ELL_DEBUG);
+	}
+
+	return image;
+}
+
+
+//! creates a loader which is able to load DirectDraw surfaces
+IImageLoader* createImageLoaderDDS()
+{
+	return new CImageLoaderDDS();
+}
+
+
+} // end namespace video
+} // end namespace irr
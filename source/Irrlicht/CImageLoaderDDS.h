@@ -0,0 +1,83 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IImageLoader.h"
+
+
+namespace irr
+{
+namespace video
+{
+
+// byte-align structures
+#include "irrpack.h"
+
+	struct SDDSPixelFormat
+	{
+		u32 Size;
+		u32 Flags;
+		u32 FourCC;
+		u32 RGBBitCount;
+		u32 RBitMask;
+		u32 GBitMask;
+		u32 BBitMask;
+		u32 ABitMask;
+	} PACK_STRUCT;
+
+	//! Follows the "DDS " magic
+	struct SDDSHeader
+	{
+		u32 Size;
+		u32 Flags;
+		u32 Height;
+		u32 Width;
+		u32 PitchOrLinearSize;
+		u32 Depth;
+		u32 MipMapCount;
+		u32 Reserved1[11];
+		SDDSPixelFormat PixelFormat;
+		u32 Caps;
+		u32 Caps2;
+		u32 Caps3;
+		u32 Caps4;
+		u32 Reserved2;
+	} PACK_STRUCT;
+
+	//! Follows the header if the FourCC is "DX10"
+	struct SDDSHeaderDX10
+	{
+		u32 DXGIFormat;
+		u32 ResourceDimension;
+		u32 MiscFlag;
+		u32 ArraySize;
+		u32 MiscFlags2;
+	} PACK_STRUCT;
+
+// Default alignment
+#include "irrunpack.h"
+
+/*!
+	Surface Loader for DirectDraw surfaces
+
+	Loads 2D textures with DXT1 to DXT5 (BC1 to BC3) compression or
+	uncompressed 16, 24 and 32 bit RGB data, including their mipmaps.
+*/
+class CImageLoaderDDS : public IImageLoader
+{
+public:
+
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".dds")
+	bool isALoadableFileExtension(const io::path& filename) const override;
+
+	//! returns true if the file maybe is able to be loaded by this class
+	bool isALoadableFileFormat(io::IReadFile* file) const override;
+
+	//! creates a surface from the file
+	IImage* loadImage(io::IReadFile* file) const override;
+};
+
+} // end namespace video
+} // end namespace irr
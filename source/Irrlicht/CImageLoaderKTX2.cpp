@@ -0,0 +1,237 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageLoaderKTX2.h"
+
+#include "IReadFile.h"
+#include "os.h"
+#include "CImage.h"
+#include "irrString.h"
+#include <cstring>
+#include <vector>
+
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+
+const u8 KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+//! Format of the vkFormat value, ECF_UNKNOWN if not supported
+/** sRGB formats are loaded like their linear counterparts.
+\param swapRB Set if red and blue are stored the other way round. */
+ECOLOR_FORMAT getFormat(u32 vkFormat, bool& swapRB)
+{
+	swapRB = false;
+	switch (vkFormat)
+	{
+	case 23: // VK_FORMAT_R8G8B8_UNORM
+	case 29: // VK_FORMAT_R8G8B8_SRGB
+		return ECF_R8G8B8;
+	case 30: // VK_FORMAT_B8G8R8_UNORM
+	case 36: // VK_FORMAT_B8G8R8_SRGB
+		swapRB = true;
+		return ECF_R8G8B8;
+	case 37: // VK_FORMAT_R8G8B8A8_UNORM
+	case 43: // VK_FORMAT_R8G8B8A8_SRGB
+		swapRB = true;
+		return ECF_A8R8G8B8;
+	case 44: // VK_FORMAT_B8G8R8A8_UNORM
+	case 50: // VK_FORMAT_B8G8R8A8_SRGB
+		return ECF_A8R8G8B8;
+	case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+	case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+	case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+	case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+		return ECF_DXT1;
+	case 135: // VK_FORMAT_BC2_UNORM_BLOCK
+	case 136: // VK_FORMAT_BC2_SRGB_BLOCK
+		return ECF_DXT3;
+	case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+	case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+		return ECF_DXT5;
+	case 147: // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+	case 148: // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+		return ECF_ETC2_RGB;
+	case 151: // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+	case 152: // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+		return ECF_ETC2_ARGB;
+	case 1000054000: // VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG
+	case 1000054004: // VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG
+		return ECF_PVRTC_ARGB2;
+	case 1000054001: // VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG
+	case 1000054005: // VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG
+		return ECF_PVRTC_ARGB4;
+	case 1000054002: // VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG
+	case 1000054006: // VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG
+		return ECF_PVRTC2_ARGB2;
+	case 1000054003: // VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG
+	case 1000054007: // VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG
+		return ECF_PVRTC2_ARGB4;
+	default:
+		return ECF_UNKNOWN;
+	}
+}
+
+//! Reads one level, which has to have exactly the size Irrlicht expects
+bool readLevel(io::IReadFile* file, const SKTX2Level& level, u8* data, u32 size, ECOLOR_FORMAT format, bool swapRB)
+{
+	if (level.ByteLength != size || !file->seek((long)level.ByteOffset) || file->read(data, size) != size)
+		return false;
+
+	if (swapRB)
+	{
+		const u32 bytesPerPixel = IImage::getBitsPerPixelFromFormat(format) / 8;
+		for (u32 i = 0; i < size; i += bytesPerPixel)
+			core::swap(data[i], data[i + 2]);
+	}
+	return true;
+}
+
+} // end anonymous namespace
+
+
+//! returns true if the file maybe is able to be loaded by this class
+//! based on the file extension (e.g. ".ktx2")
+bool CImageLoaderKTX2::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension(filename, "ktx2");
+}
+
+
+//! returns true if the file maybe is able to be loaded by this class
+bool CImageLoaderKTX2::isALoadableFileFormat(io::IReadFile* file) const
+{
+	u8 identifier[sizeof(KTX2_IDENTIFIER)];
+	return file->read(identifier, sizeof(identifier)) == sizeof(identifier) &&
+		memcmp(identifier, KTX2_IDENTIFIER, sizeof(identifier)) == 0;
+}
+
+
+//! creates a surface from the file
+IImage* CImageLoaderKTX2::loadImage(io::IReadFile* file) const
+{
+	u8 identifier[sizeof(KTX2_IDENTIFIER)];
+	SKTX2Header header;
+	if (file->read(identifier, sizeof(identifier)) != sizeof(identifier) ||
+		memcmp(identifier, KTX2_IDENTIFIER, sizeof(identifier)) != 0 ||
+		file->read(&header, sizeof(header)) != sizeof(header))
+	{
+		os::Printer::log("Invalid KTX2 header", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+#ifdef __BIG_ENDIAN__
+	for (u32 i = 0; i < 13; ++i)
+		((u32*)&header)[i] = os::Byteswap::byteswap(((u32*)&header)[i]);
+	header.SgdByteOffset = os::Byteswap::byteswap(header.SgdByteOffset);
+	header.SgdByteLength = os::Byteswap::byteswap(header.SgdByteLength);
+#endif
+
+	if (header.PixelDepth > 1 || header.LayerCount > 1 || header.FaceCount != 1)
+	{
+		os::Printer::log("Only 2D KTX2 textures are supported", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if (header.SupercompressionScheme != 0)
+	{
+		os::Printer::log("Supercompressed KTX2 textures are not supported", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	bool swapRB;
+	const ECOLOR_FORMAT format = getFormat(header.VkFormat, swapRB);
+	if (format == ECF_UNKNOWN)
+	{
+		os::Printer::log("Unsupported KTX2 vkFormat", core::stringc(header.VkFormat).c_str(), ELL_ERROR);
+		return 0;
+	}
+
+	if (!checkImageDimensions(header.PixelWidth, header.PixelHeight) || !header.PixelWidth || !header.PixelHeight)
+	{
+		os::Printer::log("Invalid KTX2 image size", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	// 0 levels asks the loader to generate the mipmaps
+	const u32 levelCount = core::max_(header.LevelCount, 1u);
+	u32 levels = 1;
+	const core::dimension2d<u32> size(header.PixelWidth, header.PixelHeight);
+	for (u32 longest = core::max_(size.Width, size.Height); longest > 1; longest >>= 1)
+		++levels;
+	if (levelCount > levels)
+	{
+		os::Printer::log("Invalid KTX2 level count", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	std::vector<SKTX2Level> index(levelCount);
+	if (file->read(index.data(), levelCount * sizeof(SKTX2Level)) != levelCount * sizeof(SKTX2Level))
+		return 0;
+#ifdef __BIG_ENDIAN__
+	for (SKTX2Level& level : index)
+	{
+		level.ByteOffset = os::Byteswap::byteswap(level.ByteOffset);
+		level.ByteLength = os::Byteswap::byteswap(level.ByteLength);
+		level.UncompressedByteLength = os::Byteswap::byteswap(level.UncompressedByteLength);
+	}
+#endif
+
+	const u32 dataSize = IImage::getDataSizeFromFormat(format, size.Width, size.Height);
+	u8* data = new u8[dataSize];
+	if (!readLevel(file, index[0], data, dataSize, format, swapRB))
+	{
+		os::Printer::log("Invalid KTX2 level data", file->getFileName(), ELL_ERROR);
+		delete [] data;
+		return 0;
+	}
+
+	IImage* image = new CImage(format, size, data);
+
+	// images keep all levels down to 1x1 or none
+	if (levelCount == levels && levels > 1)
+	{
+		u8* mipMaps = new u8[image->getMipMapsDataSize()];
+		u8* target = mipMaps;
+		bool valid = true;
+		for (u32 i = 1; i < levels && valid; ++i)
+		{
+			const core::dimension2du levelSize = image->getMipMapsSize(i);
+			const u32 levelBytes = IImage::getDataSizeFromFormat(format, levelSize.Width, levelSize.Height);
+			valid = readLevel(file, index[i], target, levelBytes, format, swapRB);
+			target += levelBytes;
+		}
+
+		if (valid)
+		{
+			image->setMipMapsData(mipMaps, true, true);
+		}
+		else
+		{
+			os::Printer::log("Invalid KTX2 mipmap data", file->getFileName(), ELL_WARNING);
+			delete [] mipMaps;
+		}
+	}
+	else if (levelCount > 1)
+	{
+		os::Printer::log("Ignoring incomplete KTX2 mipmap chain", file->getFileName(), ELL_DEBUG);
+	}
+
+	return image;
+}
+
+
+//! creates a loader which is able to load KTX 2.0 textures
+IImageLoader* createImageLoaderKTX2()
+{
+	return new CImageLoaderKTX2();
+}
+
+
+} // end namespace video
+} // end namespace irr
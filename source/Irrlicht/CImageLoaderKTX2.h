@@ -0,0 +1,71 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IImageLoader.h"
+
+
+namespace irr
+{
+namespace video
+{
+
+// byte-align structures
+#include "irrpack.h"
+
+	//! Follows the 12 byte identifier
+	struct SKTX2Header
+	{
+		u32 VkFormat;
+		u32 TypeSize;
+		u32 PixelWidth;
+		u32 PixelHeight;
+		u32 PixelDepth;
+		u32 LayerCount;
+		u32 FaceCount;
+		u32 LevelCount;
+		u32 SupercompressionScheme;
+		u32 DfdByteOffset;
+		u32 DfdByteLength;
+		u32 KvdByteOffset;
+		u32 KvdByteLength;
+		u64 SgdByteOffset;
+		u64 SgdByteLength;
+	} PACK_STRUCT;
+
+	//! One per mip level, level 0 first
+	struct SKTX2Level
+	{
+		u64 ByteOffset;
+		u64 ByteLength;
+		u64 UncompressedByteLength;
+	} PACK_STRUCT;
+
+// Default alignment
+#include "irrunpack.h"
+
+/*!
+	Surface Loader for KTX 2.0 textures
+
+	Loads 2D textures with BC1 to BC3, ETC2 or PVRTC compression or
+	uncompressed 8 bit RGB(A) data, including their mipmaps. Supercompressed
+	files (Basis Universal, Zstandard) are not supported.
+*/
+class CImageLoaderKTX2 : public IImageLoader
+{
+public:
+
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".ktx2")
+	bool isALoadableFileExtension(const io::path& filename) const override;
+
+	//! returns true if the file maybe is able to be loaded by this class
+	bool isALoadableFileFormat(io::IReadFile* file) const override;
+
+	//! creates a surface from the file
+	IImage* loadImage(io::IReadFile* file) const override;
+};
+
+} // end namespace video
+} // end namespace irr
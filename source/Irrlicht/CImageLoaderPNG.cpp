@@ -8,7 +8,10 @@
 
 #include "CImage.h"
 #include "CReadFile.h"
+#include "CIOStatistics.h"
 #include "os.h"
+#include <cmath>
+#include <cstring>
 
 namespace irr
 {
@@ -28,14 +31,33 @@ static void png_cpexcept_warn(png_structp png_ptr, png_const_charp msg)
 	os::Printer::log("PNG warning", msg, ELL_WARNING);
 }
 
+//! Where libpng reads the file from
+struct SPngSource
+{
+	io::IReadFile* File;
+	//! Contents of mapped and memory files, read without going through the file
+	const u8* Data;
+	size_t Size;
+	size_t Pos;
+};
+
 // PNG function for file reading
 void PNGAPI user_read_data_fcn(png_structp png_ptr, png_bytep data, png_size_t length)
 {
-	png_size_t check;
+	SPngSource* source = (SPngSource*)png_get_io_ptr(png_ptr);
+
+	if (source->Data)
+	{
+		if (length > source->Size - source->Pos)
+			png_error(png_ptr, "Read Error");
+
+		memcpy(data, source->Data + source->Pos, length);
+		source->Pos += length;
+		return;
+	}
 
 	// changed by zola {
-	io::IReadFile* file=(io::IReadFile*)png_get_io_ptr(png_ptr);
-	check=(png_size_t) file->read((void*)data, length);
+	const png_size_t check = (png_size_t) source->File->read((void*)data, length);
 	// }
 
 	if (check != length)
@@ -73,9 +95,6 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 	if (!file)
 		return 0;
 
-	//Used to point to image rows
-	u8** RowPointers = 0;
-
 	png_byte buffer[8];
 	// Read the first few bytes of the PNG file
 	if( file->read(buffer, 8) != 8 )
@@ -113,12 +132,18 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 	if (setjmp(png_jmpbuf(png_ptr)))
 	{
 		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-		delete [] RowPointers;
 		return 0;
 	}
 
+	SPngSource source = {file, (const u8*)file->getMappedData(), 0, 0};
+	if (source.Data)
+	{
+		source.Size = file->getSize();
+		source.Pos = file->getPos();
+	}
+
 	// changed by zola so we don't need to have public FILE pointers
-	png_set_read_fn(png_ptr, file, user_read_data_fcn);
+	png_set_read_fn(png_ptr, &source, user_read_data_fcn);
 
 	png_set_sig_bytes(png_ptr, 8); // Tell png that we read the signature
 
@@ -166,19 +191,18 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 	if (ColorType==PNG_COLOR_TYPE_GRAY || ColorType==PNG_COLOR_TYPE_GRAY_ALPHA)
 		png_set_gray_to_rgb(png_ptr);
 
+	// Images are assumed to be encoded for a screen gamma of 2.2, only
+	// files which say otherwise need the per pixel gamma transform
 	int intent;
 	const double screen_gamma = 2.2;
+	double image_gamma;
 
-	if (png_get_sRGB(png_ptr, info_ptr, &intent))
-		png_set_gamma(png_ptr, screen_gamma, 0.45455);
-	else
-	{
-		double image_gamma;
-		if (png_get_gAMA(png_ptr, info_ptr, &image_gamma))
-			png_set_gamma(png_ptr, screen_gamma, image_gamma);
-		else
-			png_set_gamma(png_ptr, screen_gamma, 0.45455);
-	}
+	if (!png_get_sRGB(png_ptr, info_ptr, &intent) && png_get_gAMA(png_ptr, info_ptr, &image_gamma) &&
+		fabs(screen_gamma * image_gamma - 1.0) > 0.05)
+		png_set_gamma(png_ptr, screen_gamma, image_gamma);
+
+	// Interlaced images are decoded in several passes over the rows
+	const int passes = png_set_interlace_handling(png_ptr);
 
 	// Update the changes in between, as we need to get the new color type
 	// for proper processing of the RGBA type
@@ -217,40 +241,32 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 		return 0;
 	}
 
-	// Create array of pointers to rows in image data
-	RowPointers = new png_bytep[Height];
-	if (!RowPointers)
-	{
-		os::Printer::log("LOAD PNG: Internal PNG create row pointers failure", file->getFileName(), ELL_ERROR);
-		png_destroy_read_struct(&png_ptr, NULL, NULL);
-		delete image;
-		return 0;
-	}
-
-	// Fill array of pointers to rows in image data
-	unsigned char* data = (unsigned char*)image->getData();
-	for (u32 i=0; i<Height; ++i)
-	{
-		RowPointers[i]=data;
-		data += image->getPitch();
-	}
-
 	// for proper error handling
 	if (setjmp(png_jmpbuf(png_ptr)))
 	{
 		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-		delete [] RowPointers;
-		delete image;
+		image->drop();
 		return 0;
 	}
 
-	// Read data using the library function that handles all transformations including interlacing
-	png_read_image(png_ptr, RowPointers);
+	// Decode the rows straight into the image data
+	u8* const data = (u8*)image->getData();
+	const u32 pitch = image->getPitch();
+	for (int pass = 0; pass < passes; ++pass)
+	{
+		for (u32 i=0; i<Height; ++i)
+			png_read_row(png_ptr, data + (size_t)i * pitch, NULL);
+	}
 
 	png_read_end(png_ptr, NULL);
-	delete [] RowPointers;
 	png_destroy_read_struct(&png_ptr,&info_ptr, 0); // Clean up memory
 
+	if (source.Data)
+	{
+		io::addBytesMapped(file, source.Pos - file->getPos());
+		file->seek((long)source.Pos);
+	}
+
 	return image;
 }
 
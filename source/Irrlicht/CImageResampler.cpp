@@ -0,0 +1,712 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageResampler.h"
+#include "CColorConverter.h"
+#include "irrMath.h"
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define _IRR_RESAMPLER_SSE2_
+#endif
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+
+//! Source pixels contributing to each target column (or row)
+struct SFilterWeights
+{
+	std::vector<s32> Start;
+	std::vector<u32> Count;
+	//! Count weights per target pixel, Stride apart
+	std::vector<f32> Weights;
+	u32 Stride;
+};
+
+struct SResampleJob
+{
+	const u8* Src;
+	ECOLOR_FORMAT SrcFormat;
+	u32 SrcWidth;
+	u32 SrcPitch;
+	u8* Dst;
+	ECOLOR_FORMAT DstFormat;
+	u32 DstWidth;
+	u32 DstPitch;
+	E_IMAGE_FILTER Filter;
+	SFilterWeights Columns;
+	SFilterWeights Rows;
+};
+
+
+f32 getFilterSupport(E_IMAGE_FILTER filter)
+{
+	switch (filter)
+	{
+	case EIF_BILINEAR:
+		return 1.f;
+	case EIF_LANCZOS3:
+		return 3.f;
+	default:
+		return 0.5f;
+	}
+}
+
+f32 getFilterValue(E_IMAGE_FILTER filter, f32 t)
+{
+	t = fabsf(t);
+	switch (filter)
+	{
+	case EIF_BILINEAR:
+		return t < 1.f ? 1.f - t : 0.f;
+	case EIF_LANCZOS3:
+	{
+		if (t < 1e-5f)
+			return 1.f;
+		if (t >= 3.f)
+			return 0.f;
+		const f32 x = core::PI * t;
+		return 3.f * sinf(x) * sinf(x / 3.f) / (x * x);
+	}
+	default:
+		// pixels exactly between two target pixels count for both
+		return t <= 0.5f ? 1.f : 0.f;
+	}
+}
+
+//! Computes the normalized weights for scaling srcLength pixels to dstLength
+void computeWeights(u32 srcLength, u32 dstLength, E_IMAGE_FILTER filter, SFilterWeights& out)
+{
+	const f32 scale = (f32)srcLength / (f32)dstLength;
+	// widen the filter when scaling down, so every source pixel contributes
+	const f32 width = core::max_(scale, 1.f);
+	const f32 support = getFilterSupport(filter) * width;
+
+	out.Stride = (filter == EIF_NEAREST) ? 1 : (u32)ceilf(support * 2.f) + 3;
+	out.Start.resize(dstLength);
+	out.Count.resize(dstLength);
+	out.Weights.assign((size_t)dstLength * out.Stride, 0.f);
+
+	const s32 srcLast = (s32)srcLength - 1;
+	for (u32 i = 0; i < dstLength; ++i)
+	{
+		f32* weights = &out.Weights[(size_t)i * out.Stride];
+
+		if (filter == EIF_NEAREST)
+		{
+			out.Start[i] = core::min_((s32)((i + 0.5f) * scale), srcLast);
+			out.Count[i] = 1;
+			weights[0] = 1.f;
+			continue;
+		}
+
+		// centers of the pixels are at +0.5
+		const f32 center = (i + 0.5f) * scale - 0.5f;
+		const s32 lo = (s32)floorf(center - support);
+		const s32 hi = (s32)ceilf(center + support);
+		const s32 first = core::clamp(lo, 0, srcLast);
+		const s32 last = core::clamp(hi, 0, srcLast);
+
+		// pixels outside of the image repeat the border
+		f32 sum = 0.f;
+		for (s32 j = lo; j <= hi; ++j)
+		{
+			const f32 w = getFilterValue(filter, (j - center) / width);
+			if (w == 0.f)
+				continue;
+			weights[core::clamp(j, first, last) - first] += w;
+			sum += w;
+		}
+
+		out.Start[i] = first;
+		out.Count[i] = (u32)(last - first + 1);
+		if (sum != 0.f)
+		{
+			for (u32 k = 0; k < out.Count[i]; ++k)
+				weights[k] /= sum;
+		}
+	}
+}
+
+//! Returns source row y as A8R8G8B8, converted into buffer if necessary
+const u32* getSourceRow(const SResampleJob& job, s32 y, std::vector<u32>& buffer)
+{
+	const u8* row = job.Src + (size_t)y * job.SrcPitch;
+	if (job.SrcFormat == ECF_A8R8G8B8)
+		return (const u32*)row;
+
+	CColorConverter::convert_viaFormat(row, job.SrcFormat, job.SrcWidth, buffer.data(), ECF_A8R8G8B8);
+	return buffer.data();
+}
+
+void storeRow(const SResampleJob& job, u32 y, const u32* row)
+{
+	u8* target = job.Dst + (size_t)y * job.DstPitch;
+	if (job.DstFormat == ECF_A8R8G8B8)
+		memcpy(target, row, job.DstWidth * 4);
+	else
+		CColorConverter::convert_viaFormat(row, ECF_A8R8G8B8, job.DstWidth, target, job.DstFormat);
+}
+
+//! A8R8G8B8 to B,G,R,A floats with premultiplied alpha
+void toFloat(const u32* in, f32* out, u32 count)
+{
+	for (u32 i = 0; i < count; ++i)
+	{
+		const u32 c = in[i];
+		const f32 a = (f32)(c >> 24);
+		const f32 f = a * (1.f / 255.f);
+		out[0] = (f32)(c & 0xff) * f;
+		out[1] = (f32)((c >> 8) & 0xff) * f;
+		out[2] = (f32)((c >> 16) & 0xff) * f;
+		out[3] = a;
+		out += 4;
+	}
+}
+
+inline u32 toChannel(f32 v)
+{
+	return (u32)core::clamp(v + 0.5f, 0.f, 255.f);
+}
+
+void fromFloat(const f32* in, u32* out, u32 count)
+{
+	for (u32 i = 0; i < count; ++i)
+	{
+		const f32 a = in[3];
+		const f32 f = a > 0.f ? 255.f / a : 0.f;
+		out[i] = (toChannel(a) << 24) | (toChannel(in[2] * f) << 16) |
+			(toChannel(in[1] * f) << 8) | toChannel(in[0] * f);
+		in += 4;
+	}
+}
+
+//! Horizontal pass, every target pixel sums its source pixels
+void filterColumns(const SFilterWeights& fw, const f32* in, f32* out, u32 dstWidth)
+{
+	for (u32 x = 0; x < dstWidth; ++x)
+	{
+		const f32* p = in + (size_t)fw.Start[x] * 4;
+		const f32* w = &fw.Weights[(size_t)x * fw.Stride];
+		const u32 count = fw.Count[x];
+#ifdef _IRR_RESAMPLER_SSE2_
+		__m128 acc = _mm_setzero_ps();
+		for (u32 k = 0; k < count; ++k)
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(p + k * 4), _mm_set1_ps(w[k])));
+		_mm_storeu_ps(out + x * 4, acc);
+#else
+		f32 acc[4] = {0.f, 0.f, 0.f, 0.f};
+		for (u32 k = 0; k < count; ++k)
+		{
+			for (u32 c = 0; c < 4; ++c)
+				acc[c] += p[k * 4 + c] * w[k];
+		}
+		memcpy(out + x * 4, acc, sizeof(acc));
+#endif
+	}
+}
+
+//! Vertical pass, adds whole weighted rows
+void filterRows(const f32* const* rows, const f32* w, u32 count, f32* out, u32 floats)
+{
+	u32 i = 0;
+#ifdef _IRR_RESAMPLER_SSE2_
+	for (; i + 4 <= floats; i += 4)
+	{
+		__m128 acc = _mm_setzero_ps();
+		for (u32 k = 0; k < count; ++k)
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(rows[k] + i), _mm_set1_ps(w[k])));
+		_mm_storeu_ps(out + i, acc);
+	}
+#endif
+	for (; i < floats; ++i)
+	{
+		f32 acc = 0.f;
+		for (u32 k = 0; k < count; ++k)
+			acc += rows[k][i] * w[k];
+		out[i] = acc;
+	}
+}
+
+//! Scales the target rows [y0, y1)
+void resampleBand(const SResampleJob& job, u32 y0, u32 y1)
+{
+	std::vector<u32> srcRow(job.SrcWidth);
+	std::vector<u32> dstRow(job.DstWidth);
+
+	if (job.Filter == EIF_NEAREST)
+	{
+		s32 lastY = -1;
+		for (u32 y = y0; y < y1; ++y)
+		{
+			// rows repeated when scaling up only need to be stored again
+			const s32 sy = job.Rows.Start[y];
+			if (sy != lastY)
+			{
+				const u32* row = getSourceRow(job, sy, srcRow);
+				for (u32 x = 0; x < job.DstWidth; ++x)
+					dstRow[x] = row[job.Columns.Start[x]];
+				lastY = sy;
+			}
+			storeRow(job, y, dstRow.data());
+		}
+		return;
+	}
+
+	// horizontally filter all source rows the band needs once
+	const s32 first = job.Rows.Start[y0];
+	s32 last = first;
+	for (u32 y = y0; y < y1; ++y)
+		last = core::max_(last, job.Rows.Start[y] + (s32)job.Rows.Count[y] - 1);
+
+	const u32 floats = job.DstWidth * 4;
+	std::vector<f32> srcLine((size_t)job.SrcWidth * 4);
+	std::vector<f32> lines((size_t)(last - first + 1) * floats);
+	for (s32 sy = first; sy <= last; ++sy)
+	{
+		toFloat(getSourceRow(job, sy, srcRow), srcLine.data(), job.SrcWidth);
+		filterColumns(job.Columns, srcLine.data(), &lines[(size_t)(sy - first) * floats], job.DstWidth);
+	}
+
+	std::vector<const f32*> rows(job.Rows.Stride);
+	std::vector<f32> dstLine(floats);
+	for (u32 y = y0; y < y1; ++y)
+	{
+		const u32 count = job.Rows.Count[y];
+		for (u32 k = 0; k < count; ++k)
+			rows[k] = &lines[(size_t)(job.Rows.Start[y] + k - first) * floats];
+
+		filterRows(rows.data(), &job.Rows.Weights[(size_t)y * job.Rows.Stride], count, dstLine.data(), floats);
+		fromFloat(dstLine.data(), dstRow.data(), job.DstWidth);
+		storeRow(job, y, dstRow.data());
+	}
+}
+
+//! Averages the 2x2 blocks of two source rows, r0 and r1 are the same for a single row
+void averageRows(const u32* r0, const u32* r1, u32 srcWidth, u32* out, u32 width)
+{
+	u32 x = 0;
+#ifdef _IRR_RESAMPLER_SSE2_
+	if (srcWidth > 1)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i two = _mm_set1_epi16(2);
+		for (; x + 4 <= width; x += 4)
+		{
+			const __m128i a0 = _mm_loadu_si128((const __m128i*)(r0 + x * 2));
+			const __m128i a1 = _mm_loadu_si128((const __m128i*)(r0 + x * 2 + 4));
+			const __m128i b0 = _mm_loadu_si128((const __m128i*)(r1 + x * 2));
+			const __m128i b1 = _mm_loadu_si128((const __m128i*)(r1 + x * 2 + 4));
+
+			// vertical sums with 16 bit channels, two pixels per register
+			const __m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+			const __m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+			const __m128i s45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+			const __m128i s67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+			// add the neighbouring pixels
+			const __m128i h0 = _mm_unpacklo_epi64(_mm_add_epi16(s01, _mm_srli_si128(s01, 8)),
+				_mm_add_epi16(s23, _mm_srli_si128(s23, 8)));
+			const __m128i h1 = _mm_unpacklo_epi64(_mm_add_epi16(s45, _mm_srli_si128(s45, 8)),
+				_mm_add_epi16(s67, _mm_srli_si128(s67, 8)));
+
+			const __m128i result = _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(h0, two), 2),
+				_mm_srli_epi16(_mm_add_epi16(h1, two), 2));
+			_mm_storeu_si128((__m128i*)(out + x), result);
+		}
+	}
+#endif
+
+	const u32 step = srcWidth > 1 ? 1 : 0;
+	for (; x < width; ++x)
+	{
+		const u32* p0 = r0 + x * 2;
+		const u32* p1 = r1 + x * 2;
+		u32 result = 0;
+		for (u32 shift = 0; shift < 32; shift += 8)
+		{
+			const u32 sum = ((p0[0] >> shift) & 0xff) + ((p0[step] >> shift) & 0xff) +
+				((p1[0] >> shift) & 0xff) + ((p1[step] >> shift) & 0xff);
+			result |= ((sum + 2) >> 2) << shift;
+		}
+		out[x] = result;
+	}
+}
+
+struct SSRGBTables
+{
+	f32 ToLinear[256];
+	//! Indexed by linear values scaled to 0..4095
+	u8 FromLinear[4096];
+};
+
+const SSRGBTables& getSRGBTables()
+{
+	static const SSRGBTables tables = [] {
+		SSRGBTables t;
+		for (u32 i = 0; i < 256; ++i)
+		{
+			const f32 c = i / 255.f;
+			t.ToLinear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+		}
+		for (u32 i = 0; i < 4096; ++i)
+		{
+			const f32 l = i / 4095.f;
+			const f32 c = l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.f / 2.4f) - 0.055f;
+			t.FromLinear[i] = (u8)toChannel(c * 255.f);
+		}
+		return t;
+	}();
+	return tables;
+}
+
+//! averageRows for sRGB colors, which are averaged in linear space
+void averageRowsSRGB(const u32* r0, const u32* r1, u32 srcWidth, u32* out, u32 width)
+{
+	const SSRGBTables& tables = getSRGBTables();
+	const u32 step = srcWidth > 1 ? 1 : 0;
+	for (u32 x = 0; x < width; ++x)
+	{
+		const u32 p[4] = { r0[x * 2], r0[x * 2 + step], r1[x * 2], r1[x * 2 + step] };
+
+		// alpha is linear already
+		u32 alpha = 2;
+		for (u32 i = 0; i < 4; ++i)
+			alpha += p[i] >> 24;
+		u32 result = (alpha >> 2) << 24;
+
+		for (u32 shift = 0; shift < 24; shift += 8)
+		{
+			f32 sum = 0.f;
+			for (u32 i = 0; i < 4; ++i)
+				sum += tables.ToLinear[(p[i] >> shift) & 0xff];
+			result |= (u32)tables.FromLinear[(u32)(sum * (4095.f / 4.f) + 0.5f)] << shift;
+		}
+		out[x] = result;
+	}
+}
+
+inline u32 scaleAlpha(u32 alpha, f32 scale)
+{
+	return (u32)core::min_(alpha * scale + 0.5f, 255.f);
+}
+
+//! Number of pixels with an alpha above ref after scaling
+u32 countAlphaAbove(const u32* histogram, f32 scale, f32 ref)
+{
+	u32 count = 0;
+	for (u32 a = 0; a < 256; ++a)
+	{
+		if ((f32)scaleAlpha(a, scale) > ref)
+			count += histogram[a];
+	}
+	return count;
+}
+
+void buildAlphaHistogram(const u32* pixels, u32 count, u32* histogram)
+{
+	memset(histogram, 0, 256 * sizeof(u32));
+	for (u32 i = 0; i < count; ++i)
+		++histogram[pixels[i] >> 24];
+}
+
+//! Scales the alpha of a level so the share coverage of its pixels passes an alpha test against ref
+void preserveAlphaCoverage(u32* pixels, u32 count, f64 coverage, f32 ref)
+{
+	u32 histogram[256];
+	buildAlphaHistogram(pixels, count, histogram);
+
+	const u32 target = (u32)(coverage * count + 0.5);
+	if (countAlphaAbove(histogram, 1.f, ref) == target)
+		return;
+
+	// smallest scale which reaches the target, coverage only grows with the scale
+	f32 lo = 0.f;
+	f32 hi = 255.f;
+	for (u32 i = 0; i < 24; ++i)
+	{
+		const f32 mid = (lo + hi) * 0.5f;
+		if (countAlphaAbove(histogram, mid, ref) < target)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	// the coverage is stepwise, the scale below may be closer
+	const s64 over = (s64)countAlphaAbove(histogram, hi, ref) - target;
+	const s64 under = (s64)target - countAlphaAbove(histogram, lo, ref);
+	const f32 scale = under < over ? lo : hi;
+
+	for (u32 i = 0; i < count; ++i)
+		pixels[i] = (pixels[i] & 0x00ffffff) | (scaleAlpha(pixels[i] >> 24, scale) << 24);
+}
+
+//! Threads kept for processImageBands, starting threads per image costs
+//! more than small images take
+class CBandWorkers
+{
+public:
+	static CBandWorkers& get()
+	{
+		// the threads are joined when the library is unloaded
+		static CBandWorkers workers;
+		return workers;
+	}
+
+	~CBandWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			Stop = true;
+		}
+		Wake.notify_all();
+		for (std::thread& thread : Threads)
+			thread.join();
+	}
+
+	void run(u32 rows, u32 bands, const std::function<void(u32, u32)>& process)
+	{
+		SBatch batch{&process, 0};
+		const u32 rowsPerBand = (rows + bands - 1) / bands;
+		u32 last = 0;
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			for (u32 y = 0; y < rows; y += rowsPerBand)
+			{
+				const u32 y1 = core::min_(y + rowsPerBand, rows);
+				if (y1 == rows)
+					last = y;
+				else
+				{
+					Queue.push_back(STask{&batch, y, y1});
+					++batch.Pending;
+				}
+			}
+		}
+		Wake.notify_all();
+
+		// the last band runs on the calling thread, which then helps with
+		// the queue until its bands are done
+		process(last, rows);
+
+		std::unique_lock<std::mutex> lock(Mutex);
+		while (batch.Pending)
+		{
+			if (Queue.empty())
+				Done.wait(lock);
+			else
+				runTask(lock);
+		}
+	}
+
+private:
+	struct SBatch
+	{
+		const std::function<void(u32, u32)>* Process;
+		//! Bands not done yet
+		u32 Pending;
+	};
+
+	struct STask
+	{
+		SBatch* Batch;
+		u32 Y0;
+		u32 Y1;
+	};
+
+	CBandWorkers() : Stop(false)
+	{
+		const u32 cores = std::thread::hardware_concurrency();
+		const u32 count = cores > 2 ? cores - 1 : 1;
+		for (u32 i = 0; i < count; ++i)
+			Threads.emplace_back(&CBandWorkers::work, this);
+	}
+
+	void work()
+	{
+		std::unique_lock<std::mutex> lock(Mutex);
+		while (true)
+		{
+			Wake.wait(lock, [this] { return Stop || !Queue.empty(); });
+			if (Queue.empty())
+				return;
+			runTask(lock);
+		}
+	}
+
+	//! Runs the first queued band, lock is held before and after
+	void runTask(std::unique_lock<std::mutex>& lock)
+	{
+		const STask task = Queue.front();
+		Queue.pop_front();
+
+		lock.unlock();
+		(*task.Batch->Process)(task.Y0, task.Y1);
+		lock.lock();
+
+		if (--task.Batch->Pending == 0)
+			Done.notify_all();
+	}
+
+	std::mutex Mutex;
+	std::condition_variable Wake;
+	//! Signalled when the last band of a call is done
+	std::condition_variable Done;
+	std::deque<STask> Queue;
+	bool Stop;
+	std::vector<std::thread> Threads;
+};
+
+} // end anonymous namespace
+
+
+//! Number of bands of rows worth handing to other threads
+u32 getImageBandCount(const core::dimension2d<u32>& size, u32 threads)
+{
+	// small images are not worth splitting
+	const u32 minBandRows = 32;
+	if ((u64)size.Width * size.Height < 256 * 256)
+		return 1;
+
+	if (!threads)
+		threads = core::max_(std::thread::hardware_concurrency(), 1u);
+	return core::min_(threads, size.Height / minBandRows);
+}
+
+
+//! Calls process for the rows [y0, y1) of each band, bands in parallel
+void processImageBands(u32 rows, u32 bands, const std::function<void(u32, u32)>& process)
+{
+	if (bands < 2)
+	{
+		process(0, rows);
+		return;
+	}
+
+	CBandWorkers::get().run(rows, bands, process);
+}
+
+
+void resampleImage(const u8* src, ECOLOR_FORMAT srcFormat, const core::dimension2d<u32>& srcSize, u32 srcPitch,
+	u8* dst, ECOLOR_FORMAT dstFormat, const core::dimension2d<u32>& dstSize, u32 dstPitch,
+	E_IMAGE_FILTER filter, u32 threads)
+{
+	if (!src || !dst || !srcSize.Width || !srcSize.Height || !dstSize.Width || !dstSize.Height)
+		return;
+
+	SResampleJob job;
+	job.Src = src;
+	job.SrcFormat = srcFormat;
+	job.SrcWidth = srcSize.Width;
+	job.SrcPitch = srcPitch;
+	job.Dst = dst;
+	job.DstFormat = dstFormat;
+	job.DstWidth = dstSize.Width;
+	job.DstPitch = dstPitch;
+	job.Filter = filter;
+	computeWeights(srcSize.Width, dstSize.Width, filter, job.Columns);
+	computeWeights(srcSize.Height, dstSize.Height, filter, job.Rows);
+
+	processImageBands(dstSize.Height, getImageBandCount(dstSize, threads), [&job](u32 y0, u32 y1) {
+		resampleBand(job, y0, y1);
+	});
+}
+
+
+void buildMipMaps(const u8* src, ECOLOR_FORMAT format, const core::dimension2d<u32>& size, u32 pitch,
+	u8* dst, bool sRGB, f32 alphaTestRef, u32 threads)
+{
+	if (!src || !dst || !size.Width || !size.Height)
+		return;
+
+	// level 0 as A8R8G8B8, every further level is made from the one above
+	std::vector<u32> level0;
+	const u32* upper = (const u32*)src;
+	u32 upperPitch = pitch / 4;
+	if (format != ECF_A8R8G8B8 || pitch % 4)
+	{
+		level0.resize((size_t)size.Width * size.Height);
+		for (u32 y = 0; y < size.Height; ++y)
+			CColorConverter::convert_viaFormat(src + (size_t)y * pitch, format, size.Width,
+				&level0[(size_t)y * size.Width], ECF_A8R8G8B8);
+		upper = level0.data();
+		upperPitch = size.Width;
+	}
+
+	// levels are filtered with their unscaled alpha, only the stored copy is scaled
+	const f32 alphaRef = alphaTestRef * 255.f;
+	f64 coverage = 0.0;
+	if (alphaTestRef > 0.f)
+	{
+		u32 histogram[256] = {};
+		for (u32 y = 0; y < size.Height; ++y)
+		{
+			const u32* row = upper + (size_t)y * upperPitch;
+			for (u32 x = 0; x < size.Width; ++x)
+				++histogram[row[x] >> 24];
+		}
+		coverage = (f64)countAlphaAbove(histogram, 1.f, alphaRef) / ((f64)size.Width * size.Height);
+	}
+
+	core::dimension2d<u32> upperSize(size);
+	std::vector<u32> levels[2];
+	std::vector<u32> scaled;
+	u32 current = 0;
+	while (upperSize.Width > 1 || upperSize.Height > 1)
+	{
+		const core::dimension2d<u32> levelSize(core::max_(upperSize.Width >> 1, 1u),
+			core::max_(upperSize.Height >> 1, 1u));
+		const u32 count = levelSize.Width * levelSize.Height;
+		std::vector<u32>& level = levels[current];
+		level.resize(count);
+
+		processImageBands(levelSize.Height, getImageBandCount(levelSize, threads), [&](u32 y0, u32 y1) {
+			for (u32 y = y0; y < y1; ++y)
+			{
+				const u32* r0 = upper + (size_t)y * 2 * upperPitch;
+				const u32* r1 = upperSize.Height > 1 ? r0 + upperPitch : r0;
+				u32* out = &level[(size_t)y * levelSize.Width];
+				if (sRGB)
+					averageRowsSRGB(r0, r1, upperSize.Width, out, levelSize.Width);
+				else
+					averageRows(r0, r1, upperSize.Width, out, levelSize.Width);
+			}
+		});
+
+		const u32* stored = level.data();
+		if (alphaTestRef > 0.f)
+		{
+			scaled = level;
+			preserveAlphaCoverage(scaled.data(), count, coverage, alphaRef);
+			stored = scaled.data();
+		}
+
+		// levels are packed without padding
+		if (format == ECF_A8R8G8B8)
+			memcpy(dst, stored, count * 4);
+		else
+			CColorConverter::convert_viaFormat(stored, ECF_A8R8G8B8, count, dst, format);
+		dst += IImage::getDataSizeFromFormat(format, levelSize.Width, levelSize.Height);
+
+		upper = level.data();
+		upperPitch = levelSize.Width;
+		upperSize = levelSize;
+		current ^= 1;
+	}
+}
+
+} // end namespace video
+} // end namespace irr
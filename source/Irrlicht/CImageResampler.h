@@ -0,0 +1,51 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IImage.h"
+#include <functional>
+
+namespace irr
+{
+namespace video
+{
+
+//! Number of bands of rows an image should be split into for processImageBands
+/** 1 for small images, which are not worth splitting.
+\param threads Maximum number of threads, 0 to use all cores. Each band
+runs on one thread, so capping the bands caps the threads working on an
+image, even though the shared workers are started for all cores. */
+u32 getImageBandCount(const core::dimension2d<u32>& size, u32 threads);
+
+//! Calls process for the rows [y0, y1) of each band, bands in parallel
+/** The bands run on threads which are started once and joined when the
+library is unloaded, and on the calling thread, which returns once all
+bands are done. At most bands threads work on one call. Several threads
+may call it at the same time. */
+void processImageBands(u32 rows, u32 bands, const std::function<void(u32, u32)>& process);
+
+//! Scales an image with a separable filter
+/** Source rows are converted to A8R8G8B8 once, filtered horizontally and
+then vertically with weights computed once per column and row. Both formats
+have to be convertible from and to A8R8G8B8 by CColorConverter.
+\param src Source pixels, srcPitch bytes per row.
+\param dst Target pixels, dstPitch bytes per row.
+\param threads Maximum number of threads, 0 to use all cores. */
+void resampleImage(const u8* src, ECOLOR_FORMAT srcFormat, const core::dimension2d<u32>& srcSize, u32 srcPitch,
+	u8* dst, ECOLOR_FORMAT dstFormat, const core::dimension2d<u32>& dstSize, u32 dstPitch,
+	E_IMAGE_FILTER filter, u32 threads = 0);
+
+//! Builds the mipmap chain of an image with a 2x2 box filter
+/** Writes all levels below level 0 behind each other into dst, in the
+layout of IImage::getMipMapsData. The format has to be convertible from
+and to A8R8G8B8 by CColorConverter.
+\param sRGB Average the colors in linear space.
+\param alphaTestRef Scale the alpha of each level to keep the coverage
+of an alpha test against this value (0 to 1), 0 to disable.
+\param threads Maximum number of threads, 0 to use all cores. */
+void buildMipMaps(const u8* src, ECOLOR_FORMAT format, const core::dimension2d<u32>& size, u32 pitch,
+	u8* dst, bool sRGB, f32 alphaTestRef, u32 threads = 0);
+
+} // end namespace video
+} // end namespace irr
@@ -0,0 +1,176 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CInflateReadFile.h"
+#include "CIOStatistics.h"
+#include "irrMath.h"
+#include "os.h"
+
+namespace irr
+{
+namespace io
+{
+
+//! Size of the window of compressed data
+static const u32 INFLATE_WINDOW_SIZE = 16 * 1024;
+
+
+CInflateReadFile::CInflateReadFile(IReadFile* compressed, long uncompressedSize,
+		const io::path& name, s32 windowBits)
+	: Filename(name), Source(compressed), SourcePos(0), Size(uncompressedSize),
+	Pos(0), Window(0), Finished(false), Failed(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CInflateReadFile");
+	#endif
+
+	if (Source)
+		Source->grab();
+
+	Stream.next_in = 0;
+	Stream.avail_in = 0;
+	Stream.zalloc = (alloc_func)0;
+	Stream.zfree = (free_func)0;
+	Stream.opaque = 0;
+
+	if (!Source || inflateInit2(&Stream, windowBits) != Z_OK)
+	{
+		os::Printer::log("Could not initialize decompression of", Filename, ELL_ERROR);
+		Failed = true;
+		return;
+	}
+
+	Window = new u8[INFLATE_WINDOW_SIZE];
+}
+
+
+CInflateReadFile::~CInflateReadFile()
+{
+	if (Window)
+		inflateEnd(&Stream);
+	delete [] Window;
+
+	if (Source)
+		Source->drop();
+}
+
+
+//! returns how much was read
+size_t CInflateReadFile::read(void* buffer, size_t sizeToRead)
+{
+	return inflateTo(buffer, core::min_(sizeToRead, (size_t)(Size - Pos)));
+}
+
+
+//! changes position in file, returns true if successful
+bool CInflateReadFile::seek(long finalPos, bool relativeMovement)
+{
+	if (relativeMovement)
+		finalPos += Pos;
+
+	if (finalPos < 0 || finalPos > Size)
+		return false;
+
+	if (finalPos < Pos)
+		rewind();
+
+	// skip by inflating into a scratch buffer
+	u8 scratch[4096];
+	while (Pos < finalPos)
+	{
+		if (!inflateTo(scratch, core::min_((size_t)(finalPos - Pos), sizeof(scratch))))
+			return false;
+	}
+	return true;
+}
+
+
+//! returns size of file
+long CInflateReadFile::getSize() const
+{
+	return Size;
+}
+
+
+//! returns where in the file we are.
+long CInflateReadFile::getPos() const
+{
+	return Pos;
+}
+
+
+//! returns name of file
+const io::path& CInflateReadFile::getFileName() const
+{
+	return Filename;
+}
+
+
+//! starts inflating from the begin of the compressed data again
+void CInflateReadFile::rewind()
+{
+	if (!Window)
+		return;
+
+	inflateReset(&Stream);
+	Stream.next_in = 0;
+	Stream.avail_in = 0;
+	SourcePos = 0;
+	Pos = 0;
+	Finished = false;
+	Failed = false;
+}
+
+
+//! inflates the next bytes into buffer, returns how many
+size_t CInflateReadFile::inflateTo(void* buffer, size_t size)
+{
+	if (Failed || Finished || !size)
+		return 0;
+
+	// reading the compressed data is not counted as time for inflating
+	u64 time = 0;
+	Stream.next_out = (Bytef*)buffer;
+	Stream.avail_out = (uInt)size;
+
+	while (Stream.avail_out)
+	{
+		if (!Stream.avail_in)
+		{
+			const size_t count = Source->readAt(Window, INFLATE_WINDOW_SIZE, SourcePos);
+			if (!count)
+			{
+				os::Printer::log("Unexpected end of compressed data in", Filename, ELL_ERROR);
+				Failed = true;
+				break;
+			}
+			SourcePos += (long)count;
+			Stream.next_in = Window;
+			Stream.avail_in = (uInt)count;
+		}
+
+		const u64 start = CIOStatistics::getTime();
+		const int err = inflate(&Stream, Z_NO_FLUSH);
+		time += CIOStatistics::getTime() - start;
+		if (err == Z_STREAM_END)
+		{
+			Finished = true;
+			break;
+		}
+		if (err != Z_OK)
+		{
+			os::Printer::log("Error decompressing", Filename, ELL_ERROR);
+			Failed = true;
+			break;
+		}
+	}
+
+	const size_t done = size - Stream.avail_out;
+	Pos += (long)done;
+	getIOStatistics().addInflated(done, time);
+	return done;
+}
+
+
+} // end namespace io
+} // end namespace irr
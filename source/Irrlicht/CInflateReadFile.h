@@ -0,0 +1,77 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IReadFile.h"
+#include "irrString.h"
+#include <zlib.h> // use system lib
+
+namespace irr
+{
+namespace io
+{
+
+	//! Read file which inflates deflated data while it is read
+	/** Only a window of the compressed data and the state of zlib are
+	kept in memory, so big entries don't need a buffer of their full
+	size. Reading and seeking forward are cheap, seeking backwards
+	inflates again from the start. The compressed data is read from
+	the source with readAt(), so several of these files can share one
+	source on different threads. */
+	class CInflateReadFile : public IReadFile
+	{
+	public:
+
+		//! \param compressed File holding just the compressed data, it is grabbed
+		//! \param windowBits Passed to inflateInit2(), -MAX_WBITS for raw deflate data
+		CInflateReadFile(IReadFile* compressed, long uncompressedSize,
+			const io::path& name, s32 windowBits = -MAX_WBITS);
+
+		virtual ~CInflateReadFile();
+
+		//! returns how much was read
+		size_t read(void* buffer, size_t sizeToRead) override;
+
+		//! changes position in file, returns true if successful
+		bool seek(long finalPos, bool relativeMovement = false) override;
+
+		//! returns size of file
+		long getSize() const override;
+
+		//! returns where in the file we are.
+		long getPos() const override;
+
+		//! returns name of file
+		const io::path& getFileName() const override;
+
+		//! Get the type of the class implementing this interface
+		EREAD_FILE_TYPE getType() const override
+		{
+			return ERFT_INFLATE_READ_FILE;
+		}
+
+	private:
+
+		//! starts inflating from the begin of the compressed data again
+		void rewind();
+
+		//! inflates the next bytes into buffer, returns how many
+		size_t inflateTo(void* buffer, size_t size);
+
+		io::path Filename;
+		IReadFile* Source;
+		//! Read position in the compressed data
+		long SourcePos;
+		long Size;
+		long Pos;
+
+		z_stream Stream;
+		//! Window of the compressed data given to zlib
+		u8* Window;
+		bool Finished;
+		bool Failed;
+	};
+
+} // end namespace io
+} // end namespace irr
@@ -23,7 +23,8 @@ namespace irr
 
 	namespace scene
 	{
-		ISceneManager* createSceneManager(video::IVideoDriver* driver, gui::ICursorControl* cc);
+		ISceneManager* createSceneManager(video::IVideoDriver* driver,
+			io::IFileSystem* fs, gui::ICursorControl* cc);
 	}
 
 	namespace io
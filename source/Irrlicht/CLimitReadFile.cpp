@@ -5,12 +5,17 @@
 #include "CLimitReadFile.h"
 #include "irrMath.h"
 #include "irrString.h"
+#include <mutex>
 
 namespace irr
 {
 namespace io
 {
 
+//! Guards the reference count of the files limited files share
+/** Entries of one archive are opened and dropped on several threads. */
+static std::mutex SharedFileMutex;
+
 
 CLimitReadFile::CLimitReadFile(IReadFile* alreadyOpenedFile, long pos,
 		long areaSize, const io::path& name)
@@ -23,7 +28,10 @@ CLimitReadFile::CLimitReadFile(IReadFile* alreadyOpenedFile, long pos,
 
 	if (File)
 	{
-		File->grab();
+		{
+			std::lock_guard<std::mutex> lock(SharedFileMutex);
+			File->grab();
+		}
 		AreaStart = pos;
 		AreaEnd = AreaStart + areaSize;
 	}
@@ -33,7 +41,10 @@ CLimitReadFile::CLimitReadFile(IReadFile* alreadyOpenedFile, long pos,
 CLimitReadFile::~CLimitReadFile()
 {
 	if (File)
+	{
+		std::lock_guard<std::mutex> lock(SharedFileMutex);
 		File->drop();
+	}
 }
 
 
@@ -48,8 +59,9 @@ size_t CLimitReadFile::read(void* buffer, size_t sizeToRead)
 	long toRead = core::min_(AreaEnd, r + (long)sizeToRead) - core::max_(AreaStart, r);
 	if (toRead < 0)
 		return 0;
-	File->seek(r);
-	r = (long)File->read(buffer, toRead);
+
+	// the shared file is read without its read position
+	r = (long)File->readAt(buffer, toRead, r);
 	Pos += r;
 	return r;
 #else
@@ -66,6 +78,25 @@ size_t CLimitReadFile::read(void* buffer, size_t sizeToRead)
 }
 
 
+//! reads from a position of the area, thread safe if the file is
+size_t CLimitReadFile::readAt(void* buffer, size_t sizeToRead, long pos)
+{
+	if (0 == File || pos < 0 || pos >= AreaEnd - AreaStart)
+		return 0;
+
+	const size_t toRead = core::min_(sizeToRead, (size_t)(AreaEnd - AreaStart - pos));
+	return File->readAt(buffer, toRead, AreaStart + pos);
+}
+
+
+//! returns the area of the file if that is mapped
+const void* CLimitReadFile::getMappedData() const
+{
+	const c8* data = File ? (const c8*)File->getMappedData() : 0;
+	return data ? data + AreaStart : 0;
+}
+
+
 //! changes position in file, returns true if successful
 bool CLimitReadFile::seek(long finalPos, bool relativeMovement)
 {
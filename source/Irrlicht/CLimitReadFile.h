@@ -31,6 +31,9 @@ namespace io
 		//! returns how much was read
 		size_t read(void* buffer, size_t sizeToRead) override;
 
+		//! reads from a position of the area, thread safe if the file is
+		size_t readAt(void* buffer, size_t sizeToRead, long pos) override;
+
 		//! changes position in file, returns true if successful
 		//! if relativeMovement==true, the pos is changed relative to current pos,
 		//! otherwise from begin of file
@@ -51,6 +54,9 @@ namespace io
 			return ERFT_LIMIT_READ_FILE;
 		}
 
+		//! returns the area of the file if that is mapped
+		const void* getMappedData() const override;
+
 	private:
 
 		io::path Filename;
@@ -0,0 +1,155 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CMappedReadFile.h"
+#include "CIOStatistics.h"
+#include "irrMath.h"
+#include <string.h>
+
+#if defined(_IRR_WINDOWS_API_)
+	#include <windows.h>
+	#define _IRR_HAS_FILE_MAPPING_
+#elif (defined(_IRR_POSIX_API_) || defined(_IRR_OSX_PLATFORM_) || defined(_IRR_ANDROID_PLATFORM_))
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define _IRR_HAS_FILE_MAPPING_
+#endif
+
+namespace irr
+{
+namespace io
+{
+
+
+CMappedReadFile::CMappedReadFile(const io::path& fileName, const c8* data, long size, void* mapping)
+: Filename(fileName), Data(data), Size(size), Pos(0), Mapping(mapping)
+{
+	#ifdef _DEBUG
+	setDebugName("CMappedReadFile");
+	#endif
+}
+
+
+CMappedReadFile::~CMappedReadFile()
+{
+#if defined(_IRR_WINDOWS_API_)
+	UnmapViewOfFile(Data);
+	CloseHandle((HANDLE)Mapping);
+#elif defined(_IRR_HAS_FILE_MAPPING_)
+	munmap((void*)Data, Size);
+#endif
+}
+
+
+//! returns how much was read
+size_t CMappedReadFile::read(void* buffer, size_t sizeToRead)
+{
+	const size_t amount = core::min_(sizeToRead, (size_t)(Size - Pos));
+	memcpy(buffer, Data + Pos, amount);
+	Pos += (long)amount;
+	getIOStatistics().addBytesRead(amount);
+	return amount;
+}
+
+
+//! reads from a position, thread safe
+size_t CMappedReadFile::readAt(void* buffer, size_t sizeToRead, long pos)
+{
+	if (pos < 0 || pos >= Size)
+		return 0;
+
+	const size_t amount = core::min_(sizeToRead, (size_t)(Size - pos));
+	memcpy(buffer, Data + pos, amount);
+	getIOStatistics().addBytesRead(amount);
+	return amount;
+}
+
+
+//! changes position in file, returns true if successful
+bool CMappedReadFile::seek(long finalPos, bool relativeMovement)
+{
+	if (relativeMovement)
+		finalPos += Pos;
+
+	if (finalPos < 0 || finalPos > Size)
+		return false;
+
+	Pos = finalPos;
+	return true;
+}
+
+
+//! returns size of file
+long CMappedReadFile::getSize() const
+{
+	return Size;
+}
+
+
+//! returns where in the file we are.
+long CMappedReadFile::getPos() const
+{
+	return Pos;
+}
+
+
+//! returns name of file
+const io::path& CMappedReadFile::getFileName() const
+{
+	return Filename;
+}
+
+
+IReadFile* CMappedReadFile::createMappedReadFile(const io::path& fileName, long minSize)
+{
+	if (fileName.size() == 0)
+		return 0;
+
+#if defined(_IRR_WINDOWS_API_)
+	HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (file == INVALID_HANDLE_VALUE)
+		return 0;
+
+	LARGE_INTEGER size;
+	HANDLE mapping = 0;
+	const void* data = 0;
+	if (GetFileSizeEx(file, &size) && size.QuadPart >= minSize && size.QuadPart > 0 && size.QuadPart <= 0x7fffffff)
+	{
+		mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+		if (mapping)
+			data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (mapping && !data)
+			CloseHandle(mapping);
+	}
+	// the mapping keeps the file open
+	CloseHandle(file);
+
+	if (!data)
+		return 0;
+	return new CMappedReadFile(fileName, (const c8*)data, (long)size.QuadPart, mapping);
+#elif defined(_IRR_HAS_FILE_MAPPING_)
+	const int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0)
+		return 0;
+
+	struct stat info;
+	void* data = MAP_FAILED;
+	if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size >= minSize &&
+		info.st_size > 0 && info.st_size <= 0x7fffffff)
+		data = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping keeps the file open
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return 0;
+	return new CMappedReadFile(fileName, (const c8*)data, (long)info.st_size, 0);
+#else
+	return 0;
+#endif
+}
+
+
+} // end namespace io
+} // end namespace irr
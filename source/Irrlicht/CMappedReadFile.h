@@ -0,0 +1,72 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IReadFile.h"
+#include "irrString.h"
+
+namespace irr
+{
+namespace io
+{
+
+	//! Read file which maps a file on disk into memory
+	/** read() and seek() only move a position in the mapping, and
+	getMappedData() gives loaders the whole contents without a copy. The
+	file must not be truncated by others while it is mapped. */
+	class CMappedReadFile : public IReadFile
+	{
+	public:
+
+		virtual ~CMappedReadFile();
+
+		//! returns how much was read
+		size_t read(void* buffer, size_t sizeToRead) override;
+
+		//! reads from a position, thread safe
+		size_t readAt(void* buffer, size_t sizeToRead, long pos) override;
+
+		//! changes position in file, returns true if successful
+		bool seek(long finalPos, bool relativeMovement = false) override;
+
+		//! returns size of file
+		long getSize() const override;
+
+		//! returns where in the file we are.
+		long getPos() const override;
+
+		//! returns name of file
+		const io::path& getFileName() const override;
+
+		//! Get the type of the class implementing this interface
+		EREAD_FILE_TYPE getType() const override
+		{
+			return ERFT_MAPPED_READ_FILE;
+		}
+
+		//! returns the mapped contents
+		const void* getMappedData() const override
+		{
+			return Data;
+		}
+
+		//! maps a file on disk
+		/** \return The file, or 0 if it can not be mapped, is smaller
+		than minSize or mapping is not supported on this platform. */
+		static IReadFile* createMappedReadFile(const io::path& fileName, long minSize);
+
+	private:
+
+		CMappedReadFile(const io::path& fileName, const c8* data, long size, void* mapping);
+
+		io::path Filename;
+		const c8* Data;
+		long Size;
+		long Pos;
+		//! Handle of the file mapping object on Windows
+		void* Mapping;
+	};
+
+} // end namespace io
+} // end namespace irr
@@ -4,6 +4,7 @@
 
 #include "CMemoryFile.h"
 #include "irrString.h"
+#include "irrMath.h"
 
 namespace irr
 {
@@ -45,6 +46,17 @@ size_t CMemoryReadFile::read(void* buffer, size_t sizeToRead)
 	return static_cast<size_t>(amount);
 }
 
+//! reads from a position, thread safe
+size_t CMemoryReadFile::readAt(void* buffer, size_t sizeToRead, long pos)
+{
+	if (pos < 0 || pos >= Len)
+		return 0;
+
+	const size_t amount = core::min_(sizeToRead, (size_t)(Len - pos));
+	memcpy(buffer, (const c8*)Buffer + pos, amount);
+	return amount;
+}
+
 //! changes position in file, returns true if successful
 //! if relativeMovement==true, the pos is changed relative to current pos,
 //! otherwise from begin of file
@@ -168,6 +180,79 @@ bool CMemoryWriteFile::flush()
 	return true; // no buffering, so nothing to do
 }
 
+
+CGrowableMemoryWriteFile::CGrowableMemoryWriteFile(const io::path& fileName)
+: Pos(0), Filename(fileName)
+{
+	#ifdef _DEBUG
+	setDebugName("CGrowableMemoryWriteFile");
+	#endif
+}
+
+
+//! returns how much was written
+size_t CGrowableMemoryWriteFile::write(const void* buffer, size_t sizeToWrite)
+{
+	if (!sizeToWrite)
+		return 0;
+
+	if (Pos + sizeToWrite > Buffer.size())
+		Buffer.set_used((u32)(Pos + sizeToWrite));
+
+	memcpy(Buffer.pointer() + Pos, buffer, sizeToWrite);
+	Pos += (long)sizeToWrite;
+
+	return sizeToWrite;
+}
+
+
+//! changes position in file, returns true if successful
+bool CGrowableMemoryWriteFile::seek(long finalPos, bool relativeMovement)
+{
+	if (relativeMovement)
+		finalPos += Pos;
+
+	if (finalPos < 0 || finalPos > (long)Buffer.size())
+		return false;
+
+	Pos = finalPos;
+	return true;
+}
+
+
+//! returns where in the file we are.
+long CGrowableMemoryWriteFile::getPos() const
+{
+	return Pos;
+}
+
+
+//! returns name of file
+const io::path& CGrowableMemoryWriteFile::getFileName() const
+{
+	return Filename;
+}
+
+
+bool CGrowableMemoryWriteFile::flush()
+{
+	return true; // no buffering, so nothing to do
+}
+
+
+//! returns the contents
+const void* CGrowableMemoryWriteFile::getData() const
+{
+	return Buffer.const_pointer();
+}
+
+
+//! returns the size of the contents
+long CGrowableMemoryWriteFile::getSize() const
+{
+	return (long)Buffer.size();
+}
+
 IReadFile* createMemoryReadFile(const void* memory, long size, const io::path& fileName, bool deleteMemoryWhenDropped)
 {
 	CMemoryReadFile* file = new CMemoryReadFile(memory, size, fileName, deleteMemoryWhenDropped);
@@ -6,6 +6,8 @@
 
 #include "IMemoryReadFile.h"
 #include "IWriteFile.h"
+#include "IMemoryWriteFile.h"
+#include "irrArray.h"
 #include "irrString.h"
 
 namespace irr
@@ -30,6 +32,9 @@ namespace io
 		//! returns how much was read
 		size_t read(void* buffer, size_t sizeToRead) override;
 
+		//! reads from a position, thread safe
+		size_t readAt(void* buffer, size_t sizeToRead, long pos) override;
+
 		//! changes position in file, returns true if successful
 		bool seek(long finalPos, bool relativeMovement = false) override;
 
@@ -54,6 +59,12 @@ namespace io
 			return Buffer;
 		}
 
+		//! The buffer is the whole file
+		const void* getMappedData() const override
+		{
+			return Buffer;
+		}
+
 	private:
 
 		const void *Buffer;
@@ -99,5 +110,42 @@ namespace io
 		bool deleteMemoryWhenDropped;
 	};
 
+	/*!
+		Class for writing to memory which grows as needed.
+	*/
+	class CGrowableMemoryWriteFile : public IMemoryWriteFile
+	{
+	public:
+
+		//! Constructor
+		CGrowableMemoryWriteFile(const io::path& fileName);
+
+		//! returns how much was written
+		size_t write(const void* buffer, size_t sizeToWrite) override;
+
+		//! changes position in file, returns true if successful
+		bool seek(long finalPos, bool relativeMovement = false) override;
+
+		//! returns where in the file we are.
+		long getPos() const override;
+
+		//! returns name of file
+		const io::path& getFileName() const override;
+
+		bool flush() override;
+
+		//! returns the contents
+		const void* getData() const override;
+
+		//! returns the size of the contents
+		long getSize() const override;
+
+	private:
+
+		core::array<u8> Buffer;
+		long Pos;
+		io::path Filename;
+	};
+
 } // end namespace io
 } // end namespace irr
@@ -4,7 +4,10 @@
 
 #include "CMeshCache.h"
 #include "IAnimatedMesh.h"
+#include "ISkinnedMesh.h"
 #include "IMesh.h"
+#include "IMeshBuffer.h"
+#include "CIOStatistics.h"
 
 namespace irr
 {
@@ -14,6 +17,41 @@ namespace scene
 static const io::SNamedPath emptyNamedPath;
 
 
+//! Approximate memory used by vertices, indices and animation data of a mesh
+static u64 getMeshMemory(IAnimatedMesh* mesh)
+{
+	u64 bytes = 0;
+
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+		bytes += (u64)mb->getVertexCount() * video::getVertexPitchFromType(mb->getVertexType());
+		bytes += (u64)mb->getIndexCount() * (mb->getIndexType() == video::EIT_16BIT ? sizeof(u16) : sizeof(u32));
+	}
+
+	if (mesh->getMeshType() == EAMT_SKINNED)
+	{
+		const core::array<ISkinnedMesh::SJoint*>& joints = static_cast<ISkinnedMesh*>(mesh)->getAllJoints();
+		for (u32 i=0; i<joints.size(); ++i)
+		{
+			bytes += sizeof(ISkinnedMesh::SJoint);
+			bytes += joints[i]->PositionKeys.size() * sizeof(ISkinnedMesh::SPositionKey);
+			bytes += joints[i]->ScaleKeys.size() * sizeof(ISkinnedMesh::SScaleKey);
+			bytes += joints[i]->RotationKeys.size() * sizeof(ISkinnedMesh::SRotationKey);
+			bytes += joints[i]->Weights.size() * sizeof(ISkinnedMesh::SWeight);
+		}
+	}
+
+	return bytes;
+}
+
+
+CMeshCache::CMeshCache()
+	: MemoryBudget(0), MemoryUsage(0), HitCount(0), MissCount(0)
+{
+}
+
+
 CMeshCache::~CMeshCache()
 {
 	clear();
@@ -25,27 +63,33 @@ void CMeshCache::addMesh(const io::path& filename, IAnimatedMesh* mesh)
 {
 	mesh->grab();
 
-	MeshEntry e ( filename );
+	MeshEntry e;
+	e.NamedPath.setPath(filename);
 	e.Mesh = mesh;
+	// skinned meshes return themselves, but would be animated by getMesh()
+	e.FirstFrame = (mesh->getMeshType() == EAMT_SKINNED) ? mesh : mesh->getMesh(0);
+	e.Memory = getMeshMemory(mesh);
+
+	// a mesh added with an existing name replaces the old one
+	const s32 old = findName(e.NamedPath.getInternalName());
+	if (old != -1)
+		removeEntry((u32)old);
 
+	e.Age = Ages.insert(Ages.end(), Meshes.size());
 	Meshes.push_back(e);
+	indexEntry(Meshes.size()-1);
+	MemoryUsage += e.Memory;
+
+	enforceBudget(mesh);
 }
 
 
 //! Removes a mesh from the cache.
 void CMeshCache::removeMesh(const IMesh* const mesh)
 {
-	if ( !mesh )
-		return;
-	for (u32 i=0; i<Meshes.size(); ++i)
-	{
-		if (Meshes[i].Mesh == mesh || (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh))
-		{
-			Meshes[i].Mesh->drop();
-			Meshes.erase(i);
-			return;
-		}
-	}
+	const s32 index = getMeshIndex(mesh);
+	if (index != -1)
+		removeEntry((u32)index);
 }
 
 
@@ -59,13 +103,11 @@ u32 CMeshCache::getMeshCount() const
 //! Returns current number of the mesh
 s32 CMeshCache::getMeshIndex(const IMesh* const mesh) const
 {
-	for (u32 i=0; i<Meshes.size(); ++i)
-	{
-		if (Meshes[i].Mesh == mesh || (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh))
-			return (s32)i;
-	}
+	if (!mesh)
+		return -1;
 
-	return -1;
+	auto it = MeshIndex.find(mesh);
+	return (it != MeshIndex.end()) ? (s32)it->second : -1;
 }
 
 
@@ -82,9 +124,19 @@ IAnimatedMesh* CMeshCache::getMeshByIndex(u32 number)
 //! Returns a mesh based on its name.
 IAnimatedMesh* CMeshCache::getMeshByName(const io::path& name)
 {
-	MeshEntry e ( name );
-	s32 id = Meshes.binary_search(e);
-	return (id != -1) ? Meshes[id].Mesh : 0;
+	const io::SNamedPath namedPath(name);
+	const s32 id = findName(namedPath.getInternalName());
+	if (id == -1)
+	{
+		++MissCount;
+		io::getIOStatistics().addCacheLookup(io::EIOC_MESH, false);
+		return 0;
+	}
+
+	++HitCount;
+	io::getIOStatistics().addCacheLookup(io::EIOC_MESH, true);
+	Ages.splice(Ages.end(), Ages, Meshes[id].Age);
+	return Meshes[id].Mesh;
 }
 
 
@@ -101,16 +153,11 @@ const io::SNamedPath& CMeshCache::getMeshName(u32 index) const
 //! Get the name of a loaded mesh, if there is any.
 const io::SNamedPath& CMeshCache::getMeshName(const IMesh* const mesh) const
 {
-	if (!mesh)
+	const s32 index = getMeshIndex(mesh);
+	if (index == -1)
 		return emptyNamedPath;
 
-	for (u32 i=0; i<Meshes.size(); ++i)
-	{
-		if (Meshes[i].Mesh == mesh || (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh))
-			return Meshes[i].NamedPath;
-	}
-
-	return emptyNamedPath;
+	return Meshes[index].NamedPath;
 }
 
 //! Renames a loaded mesh.
@@ -119,8 +166,14 @@ bool CMeshCache::renameMesh(u32 index, const io::path& name)
 	if (index >= Meshes.size())
 		return false;
 
-	Meshes[index].NamedPath.setPath(name);
-	Meshes.sort();
+	const io::SNamedPath namedPath(name);
+	const s32 other = findName(namedPath.getInternalName());
+	if (other != -1 && (u32)other != index)
+		return false;
+
+	NameIndex.erase(Meshes[index].NamedPath.getInternalName());
+	Meshes[index].NamedPath = namedPath;
+	NameIndex[namedPath.getInternalName()] = index;
 	return true;
 }
 
@@ -128,24 +181,19 @@ bool CMeshCache::renameMesh(u32 index, const io::path& name)
 //! Renames a loaded mesh.
 bool CMeshCache::renameMesh(const IMesh* const mesh, const io::path& name)
 {
-	for (u32 i=0; i<Meshes.size(); ++i)
-	{
-		if (Meshes[i].Mesh == mesh || (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh))
-		{
-			Meshes[i].NamedPath.setPath(name);
-			Meshes.sort();
-			return true;
-		}
-	}
+	const s32 index = getMeshIndex(mesh);
+	if (index == -1)
+		return false;
 
-	return false;
+	return renameMesh((u32)index, name);
 }
 
 
 //! returns if a mesh already was loaded
 bool CMeshCache::isMeshLoaded(const io::path& name)
 {
-	return getMeshByName(name) != 0;
+	const io::SNamedPath namedPath(name);
+	return findName(namedPath.getInternalName()) != -1;
 }
 
 
@@ -156,23 +204,143 @@ void CMeshCache::clear()
 		Meshes[i].Mesh->drop();
 
 	Meshes.clear();
+	NameIndex.clear();
+	MeshIndex.clear();
+	Ages.clear();
+	MemoryUsage = 0;
 }
 
 //! Clears all meshes that are held in the mesh cache but not used anywhere else.
 void CMeshCache::clearUnusedMeshes()
 {
-	for (u32 i=0; i<Meshes.size(); ++i)
+	// removeEntry() moves the last entry, so walk backwards
+	for (u32 i=Meshes.size(); i>0; --i)
+	{
+		if (Meshes[i-1].Mesh->getReferenceCount() == 1)
+			removeEntry(i-1);
+	}
+}
+
+
+//! Sets the maximum memory the cached meshes should use.
+void CMeshCache::setMemoryBudget(u64 bytes)
+{
+	MemoryBudget = bytes;
+	enforceBudget(0);
+}
+
+
+//! Returns the memory budget in bytes, 0 if there is no limit.
+u64 CMeshCache::getMemoryBudget() const
+{
+	return MemoryBudget;
+}
+
+
+//! Returns the approximate memory used by all cached meshes.
+u64 CMeshCache::getMemoryUsage() const
+{
+	return MemoryUsage;
+}
+
+
+//! Returns how often getMeshByName() found the requested mesh.
+u32 CMeshCache::getHitCount() const
+{
+	return HitCount;
+}
+
+
+//! Returns how often getMeshByName() did not find the requested mesh.
+u32 CMeshCache::getMissCount() const
+{
+	return MissCount;
+}
+
+
+s32 CMeshCache::findName(const io::path& internalName) const
+{
+	auto it = NameIndex.find(internalName);
+	return (it != NameIndex.end()) ? (s32)it->second : -1;
+}
+
+
+void CMeshCache::indexEntry(u32 index)
+{
+	const MeshEntry& e = Meshes[index];
+	NameIndex[e.NamedPath.getInternalName()] = index;
+	// the same mesh may be cached under several names, keep the first
+	MeshIndex.emplace(e.Mesh, index);
+	if (e.FirstFrame)
+		MeshIndex.emplace(e.FirstFrame, index);
+}
+
+
+void CMeshCache::unindexEntry(u32 index)
+{
+	const MeshEntry& e = Meshes[index];
+
+	auto name = NameIndex.find(e.NamedPath.getInternalName());
+	if (name != NameIndex.end() && name->second == index)
+		NameIndex.erase(name);
+
+	auto mesh = MeshIndex.find(e.Mesh);
+	if (mesh != MeshIndex.end() && mesh->second == index)
+		MeshIndex.erase(mesh);
+
+	auto frame = MeshIndex.find(e.FirstFrame);
+	if (frame != MeshIndex.end() && frame->second == index)
+		MeshIndex.erase(frame);
+}
+
+
+void CMeshCache::removeEntry(u32 index)
+{
+	IAnimatedMesh* mesh = Meshes[index].Mesh;
+	MemoryUsage -= Meshes[index].Memory;
+	unindexEntry(index);
+	Ages.erase(Meshes[index].Age);
+
+	const u32 last = Meshes.size()-1;
+	if (index != last)
+	{
+		unindexEntry(last);
+		Meshes[index] = Meshes[last];
+		*Meshes[index].Age = index;
+		indexEntry(index);
+	}
+	Meshes.erase(last);
+
+	// an entry for the same mesh under another name becomes findable again
+	if (mesh->getReferenceCount() > 1)
 	{
-		if (Meshes[i].Mesh->getReferenceCount() == 1)
+		for (u32 i=0; i<Meshes.size(); ++i)
 		{
-			Meshes[i].Mesh->drop();
-			Meshes.erase(i);
-			--i;
+			if (Meshes[i].Mesh == mesh)
+			{
+				indexEntry(i);
+				break;
+			}
 		}
 	}
+
+	mesh->drop();
+}
+
+
+void CMeshCache::enforceBudget(const IAnimatedMesh* keep)
+{
+	// removeEntry() only erases the node of the removed entry
+	auto it = Ages.begin();
+	while (MemoryBudget && MemoryUsage > MemoryBudget && it != Ages.end())
+	{
+		const u32 index = *it++;
+		const MeshEntry& e = Meshes[index];
+		if (e.Mesh != keep && e.Mesh->getReferenceCount() == 1)
+			removeEntry(index);
+	}
 }
 
 
 } // end namespace scene
 } // end namespace irr
-
@@ -6,6 +6,9 @@
 
 #include "IMeshCache.h"
 #include "irrArray.h"
+#include "irrStringHash.h"
+#include <list>
+#include <unordered_map>
 
 namespace irr
 {
@@ -16,6 +19,8 @@ namespace scene
 	{
 	public:
 
+		CMeshCache();
+
 		virtual ~CMeshCache();
 
 		//! Adds a mesh to the internal list of loaded meshes.
@@ -93,25 +98,66 @@ namespace scene
 		//! Clears all meshes that are held in the mesh cache but not used anywhere else.
 		void clearUnusedMeshes() override;
 
+		//! Sets the maximum memory the cached meshes should use.
+		void setMemoryBudget(u64 bytes) override;
+
+		//! Returns the memory budget in bytes, 0 if there is no limit.
+		u64 getMemoryBudget() const override;
+
+		//! Returns the approximate memory used by all cached meshes.
+		u64 getMemoryUsage() const override;
+
+		//! Returns how often getMeshByName() found the requested mesh.
+		u32 getHitCount() const override;
+
+		//! Returns how often getMeshByName() did not find the requested mesh.
+		u32 getMissCount() const override;
+
 	protected:
 
 		struct MeshEntry
 		{
-			MeshEntry ( const io::path& name )
-				: NamedPath ( name )
-			{
-			}
 			io::SNamedPath NamedPath;
 			IAnimatedMesh* Mesh;
-
-			bool operator < (const MeshEntry& other) const
-			{
-				return (NamedPath < other.NamedPath);
-			}
+			//! First frame, also accepted by the functions taking an IMesh
+			const IMesh* FirstFrame;
+			//! Approximate memory used by the mesh
+			u64 Memory;
+			//! Node of this entry in Ages
+			std::list<u32>::iterator Age;
 		};
 
-		//! loaded meshes
+		//! Returns index of the mesh with this internal name or -1
+		s32 findName(const io::path& internalName) const;
+
+		//! Adds the lookup entries for Meshes[index]
+		void indexEntry(u32 index);
+
+		//! Removes the lookup entries pointing to Meshes[index]
+		void unindexEntry(u32 index);
+
+		//! Drops the mesh and removes the entry, moves the last entry to its place
+		void removeEntry(u32 index);
+
+		//! Removes least recently used meshes until the budget is met
+		void enforceBudget(const IAnimatedMesh* keep);
+
+		//! loaded meshes, in no particular order
 		core::array<MeshEntry> Meshes;
+
+		//! maps internal names to indices in Meshes
+		std::unordered_map<io::path, u32> NameIndex;
+
+		//! maps meshes and their first frames to indices in Meshes
+		std::unordered_map<const IMesh*, u32> MeshIndex;
+
+		//! indices in Meshes, least recently added or found first
+		std::list<u32> Ages;
+
+		u64 MemoryBudget;
+		u64 MemoryUsage;
+		u32 HitCount;
+		u32 MissCount;
 	};
 
 
@@ -6,6 +6,7 @@
 #include "ISkinnedMesh.h"
 #include "SMesh.h"
 #include "CMeshBuffer.h"
+#include "SCompactMeshBuffer.h"
 #include "SAnimatedMesh.h"
 #include "os.h"
 #include "triangle3d.h"
@@ -45,44 +46,47 @@ void recalculateNormalsT(IMeshBuffer* buffer, bool smooth, bool angleWeighted)
 	const u32 idxcnt = buffer->getIndexCount();
 	const T* idx = reinterpret_cast<T*>(buffer->getIndices());
 
+	// positions are copied, buffers may return the same decoded vector for each
 	if (!smooth)
 	{
 		for (u32 i=0; i<idxcnt; i+=3)
 		{
-			const core::vector3df& v1 = buffer->getPosition(idx[i+0]);
-			const core::vector3df& v2 = buffer->getPosition(idx[i+1]);
-			const core::vector3df& v3 = buffer->getPosition(idx[i+2]);
+			const core::vector3df v1 = buffer->getPosition(idx[i+0]);
+			const core::vector3df v2 = buffer->getPosition(idx[i+1]);
+			const core::vector3df v3 = buffer->getPosition(idx[i+2]);
 			const core::vector3df normal = core::plane3d<f32>(v1, v2, v3).Normal;
-			buffer->getNormal(idx[i+0]) = normal;
-			buffer->getNormal(idx[i+1]) = normal;
-			buffer->getNormal(idx[i+2]) = normal;
+			buffer->setNormal(idx[i+0], normal);
+			buffer->setNormal(idx[i+1], normal);
+			buffer->setNormal(idx[i+2], normal);
 		}
 	}
 	else
 	{
 		u32 i;
 
+		core::array<core::vector3df> normals;
+		normals.set_used(vtxcnt);
 		for ( i = 0; i!= vtxcnt; ++i )
-			buffer->getNormal(i).set(0.f, 0.f, 0.f);
+			normals[i].set(0.f, 0.f, 0.f);
 
 		for ( i=0; i<idxcnt; i+=3)
 		{
-			const core::vector3df& v1 = buffer->getPosition(idx[i+0]);
-			const core::vector3df& v2 = buffer->getPosition(idx[i+1]);
-			const core::vector3df& v3 = buffer->getPosition(idx[i+2]);
+			const core::vector3df v1 = buffer->getPosition(idx[i+0]);
+			const core::vector3df v2 = buffer->getPosition(idx[i+1]);
+			const core::vector3df v3 = buffer->getPosition(idx[i+2]);
 			const core::vector3df normal = core::plane3d<f32>(v1, v2, v3).Normal;
 
 			core::vector3df weight(1.f,1.f,1.f);
 			if (angleWeighted)
 				weight = irr::scene::getAngleWeight(v1,v2,v3); // writing irr::scene:: necessary for borland
 
-			buffer->getNormal(idx[i+0]) += weight.X*normal;
-			buffer->getNormal(idx[i+1]) += weight.Y*normal;
-			buffer->getNormal(idx[i+2]) += weight.Z*normal;
+			normals[idx[i+0]] += weight.X*normal;
+			normals[idx[i+1]] += weight.Y*normal;
+			normals[idx[i+2]] += weight.Z*normal;
 		}
 
 		for ( i = 0; i!= vtxcnt; ++i )
-			buffer->getNormal(i).normalize();
+			buffer->setNormal(i, normals[i].normalize());
 	}
 }
 }
@@ -127,6 +131,28 @@ void CMeshManipulator::recalculateNormals(scene::IMesh* mesh, bool smooth, bool
 }
 
 
+namespace
+{
+template <typename TBuffer, typename TVertex>
+IMeshBuffer* cloneMeshBuffer(const IMeshBuffer* mb)
+{
+	TBuffer* buffer = new TBuffer();
+	buffer->Material = mb->getMaterial();
+	const u32 vcount = mb->getVertexCount();
+	buffer->Vertices.reallocate(vcount);
+	const TVertex* vertices = (const TVertex*)mb->getVertices();
+	for (u32 i=0; i < vcount; ++i)
+		buffer->Vertices.push_back(vertices[i]);
+	const u32 icount = mb->getIndexCount();
+	buffer->Indices.reallocate(icount);
+	const u16* indices = mb->getIndices();
+	for (u32 i=0; i < icount; ++i)
+		buffer->Indices.push_back(indices[i]);
+	return buffer;
+}
+}
+
+
 //! Clones a static IMesh into a modifyable SMesh.
 // not yet 32bit
 SMesh* CMeshManipulator::createMeshCopy(scene::IMesh* mesh) const
@@ -141,64 +167,34 @@ SMesh* CMeshManipulator::createMeshCopy(scene::IMesh* mesh) const
 	for ( u32 b=0; b<meshBufferCount; ++b)
 	{
 		const IMeshBuffer* const mb = mesh->getMeshBuffer(b);
+		IMeshBuffer* buffer = 0;
 		switch(mb->getVertexType())
 		{
 		case video::EVT_STANDARD:
-			{
-				SMeshBuffer* buffer = new SMeshBuffer();
-				buffer->Material = mb->getMaterial();
-				const u32 vcount = mb->getVertexCount();
-				buffer->Vertices.reallocate(vcount);
-				video::S3DVertex* vertices = (video::S3DVertex*)mb->getVertices();
-				for (u32 i=0; i < vcount; ++i)
-					buffer->Vertices.push_back(vertices[i]);
-				const u32 icount = mb->getIndexCount();
-				buffer->Indices.reallocate(icount);
-				const u16* indices = mb->getIndices();
-				for (u32 i=0; i < icount; ++i)
-					buffer->Indices.push_back(indices[i]);
-				clone->addMeshBuffer(buffer);
-				buffer->drop();
-			}
+			buffer = cloneMeshBuffer<SMeshBuffer, video::S3DVertex>(mb);
 			break;
 		case video::EVT_2TCOORDS:
-			{
-				SMeshBufferLightMap* buffer = new SMeshBufferLightMap();
-				buffer->Material = mb->getMaterial();
-				const u32 vcount = mb->getVertexCount();
-				buffer->Vertices.reallocate(vcount);
-				video::S3DVertex2TCoords* vertices = (video::S3DVertex2TCoords*)mb->getVertices();
-				for (u32 i=0; i < vcount; ++i)
-					buffer->Vertices.push_back(vertices[i]);
-				const u32 icount = mb->getIndexCount();
-				buffer->Indices.reallocate(icount);
-				const u16* indices = mb->getIndices();
-				for (u32 i=0; i < icount; ++i)
-					buffer->Indices.push_back(indices[i]);
-				clone->addMeshBuffer(buffer);
-				buffer->drop();
-			}
+			buffer = cloneMeshBuffer<SMeshBufferLightMap, video::S3DVertex2TCoords>(mb);
 			break;
 		case video::EVT_TANGENTS:
+			buffer = cloneMeshBuffer<SMeshBufferTangents, video::S3DVertexTangents>(mb);
+			break;
+		case video::EVT_COMPACT:
 			{
-				SMeshBufferTangents* buffer = new SMeshBufferTangents();
-				buffer->Material = mb->getMaterial();
-				const u32 vcount = mb->getVertexCount();
-				buffer->Vertices.reallocate(vcount);
-				video::S3DVertexTangents* vertices = (video::S3DVertexTangents*)mb->getVertices();
-				for (u32 i=0; i < vcount; ++i)
-					buffer->Vertices.push_back(vertices[i]);
-				const u32 icount = mb->getIndexCount();
-				buffer->Indices.reallocate(icount);
-				const u16* indices = mb->getIndices();
-				for (u32 i=0; i < icount; ++i)
-					buffer->Indices.push_back(indices[i]);
-				clone->addMeshBuffer(buffer);
-				buffer->drop();
+				SCompactMeshBuffer* compact = static_cast<SCompactMeshBuffer*>(
+					cloneMeshBuffer<SCompactMeshBuffer, video::S3DVertexCompact>(mb));
+				const core::matrix4 transform = mb->getVertexPositionTransform();
+				compact->PositionScale = transform.getScale();
+				compact->PositionOffset = transform.getTranslation();
+				compact->BoundingBox = mb->getBoundingBox();
+				buffer = compact;
 			}
 			break;
 		}// end switch
 
+		clone->addMeshBuffer(buffer);
+		buffer->drop();
+
 	}// end for all mesh buffers
 
 	clone->BoundingBox = mesh->getBoundingBox();
@@ -206,6 +202,83 @@ SMesh* CMeshManipulator::createMeshCopy(scene::IMesh* mesh) const
 }
 
 
+//! Creates a meshbuffer with quantized vertices from a full precision one.
+IMeshBuffer* CMeshManipulator::createCompactMeshBuffer(const IMeshBuffer* mb) const
+{
+	if (!mb || mb->getVertexType() == video::EVT_COMPACT ||
+			mb->getIndexType() != video::EIT_16BIT)
+		return 0;
+
+	const u32 vcount = mb->getVertexCount();
+	core::aabbox3df box;
+	for (u32 i=0; i < vcount; ++i)
+	{
+		const core::vector2df& tc = mb->getTCoords(i);
+		if (tc.X < 0.f || tc.X > 1.f || tc.Y < 0.f || tc.Y > 1.f)
+		{
+			// would need a texture matrix to undo a per-buffer uv scale
+			os::Printer::log("Could not create compact mesh buffer, texture coordinates outside of [0,1]", ELL_WARNING);
+			return 0;
+		}
+		if (i == 0)
+			box.reset(mb->getPosition(i));
+		else
+			box.addInternalPoint(mb->getPosition(i));
+	}
+
+	SCompactMeshBuffer* buffer = new SCompactMeshBuffer();
+	buffer->Material = mb->getMaterial();
+	buffer->setHardwareMappingHint(mb->getHardwareMappingHint_Vertex(), EBT_VERTEX);
+	buffer->setHardwareMappingHint(mb->getHardwareMappingHint_Index(), EBT_INDEX);
+	buffer->setPrimitiveType(mb->getPrimitiveType());
+
+	buffer->setPositionRange(box);
+
+	// all full precision vertex types start with the members of S3DVertex
+	const u32 pitch = video::getVertexPitchFromType(mb->getVertexType());
+	const u8* data = static_cast<const u8*>(mb->getVertices());
+	buffer->Vertices.reallocate(vcount);
+	for (u32 i=0; i < vcount; ++i)
+	{
+		const video::S3DVertex& v = *reinterpret_cast<const video::S3DVertex*>(data + i * pitch);
+		buffer->Vertices.push_back(video::S3DVertexCompact(
+			buffer->encodePosition(v.Pos), v.Normal, v.Color, v.TCoords));
+	}
+
+	const u32 icount = mb->getIndexCount();
+	buffer->Indices.reallocate(icount);
+	const u16* indices = mb->getIndices();
+	for (u32 i=0; i < icount; ++i)
+		buffer->Indices.push_back(indices[i]);
+
+	buffer->recalculateBoundingBox();
+	return buffer;
+}
+
+
+//! Creates a copy of the mesh with quantized vertices.
+SMesh* CMeshManipulator::createMeshWithCompactVertices(scene::IMesh* mesh) const
+{
+	if (!mesh)
+		return 0;
+
+	SMesh* clone = createMeshCopy(mesh);
+
+	const u32 meshBufferCount = clone->getMeshBufferCount();
+	for (u32 b=0; b<meshBufferCount; ++b)
+	{
+		IMeshBuffer* buffer = createCompactMeshBuffer(clone->MeshBuffers[b]);
+		if (!buffer)
+			continue;
+		clone->MeshBuffers[b]->drop();
+		clone->MeshBuffers[b] = buffer;
+	}
+
+	clone->recalculateBoundingBox();
+	return clone;
+}
+
+
 //! Returns amount of polygons in mesh.
 s32 CMeshManipulator::getPolyCount(scene::IMesh* mesh) const
 {
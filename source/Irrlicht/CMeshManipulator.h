@@ -32,6 +32,12 @@ public:
 	//! Clones a static IMesh into a modifiable SMesh.
 	SMesh* createMeshCopy(scene::IMesh* mesh) const override;
 
+	//! Creates a meshbuffer with quantized vertices from a full precision one.
+	IMeshBuffer* createCompactMeshBuffer(const IMeshBuffer* mb) const override;
+
+	//! Creates a copy of the mesh with quantized vertices.
+	SMesh* createMeshWithCompactVertices(scene::IMesh* mesh) const override;
+
 	//! Returns amount of polygons in mesh.
 	s32 getPolyCount(scene::IMesh* mesh) const override;
 
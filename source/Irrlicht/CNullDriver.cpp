@@ -16,6 +16,13 @@
 #include "CColorConverter.h"
 #include "IReferenceCounted.h"
 #include "IRenderTarget.h"
+#include "CAsyncTextureLoader.h"
+#include "CAsyncImageWriter.h"
+#include "CImageCompressor.h"
+#include "CTextureAtlas.h"
+#include "CIOStatistics.h"
+#include <algorithm>
+#include <chrono>
 
 
 namespace irr
@@ -35,6 +42,12 @@ IImageLoader* createImageLoaderTGA();
 //! creates a loader which is able to load png images
 IImageLoader* createImageLoaderPNG();
 
+//! creates a loader which is able to load DirectDraw surfaces
+IImageLoader* createImageLoaderDDS();
+
+//! creates a loader which is able to load KTX 2.0 textures
+IImageLoader* createImageLoaderKTX2();
+
 //! creates a writer which is able to save jpg images
 IImageWriter* createImageWriterJPG();
 
@@ -44,7 +57,8 @@ IImageWriter* createImageWriterPNG();
 
 //! constructor
 CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& screenSize)
-	: SharedRenderTarget(0), CurrentRenderTarget(0), CurrentRenderTargetSize(0, 0), FileSystem(io), MeshManipulator(0),
+	: TextureAliasesDirectoryChanges(0), TextureMemoryBudget(0), TextureEvictionFrames(60), TextureEvictions(0), TextureReloads(0), FrameNumber(0),
+	SharedRenderTarget(0), CurrentRenderTarget(0), CurrentRenderTargetSize(0, 0), FileSystem(io), AsyncTextures(0), AsyncImageWriter(0), MeshManipulator(0), CompactVerticesLogged(false),
 	ViewPort(0, 0, 0, 0), ScreenSize(screenSize), PrimitivesDrawn(0), MinVertexCountForVBO(500),
 	TextureCreationFlags(0), OverrideMaterial2DEnabled(false), AllowZWriteOnTransparent(false)
 {
@@ -87,6 +101,8 @@ CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& scre
 	SurfaceLoader.push_back(video::createImageLoaderPNG());
 	SurfaceLoader.push_back(video::createImageLoaderJPG());
 	SurfaceLoader.push_back(video::createImageLoaderBMP());
+	SurfaceLoader.push_back(video::createImageLoaderDDS());
+	SurfaceLoader.push_back(video::createImageLoaderKTX2());
 
 	SurfaceWriter.push_back(video::createImageWriterJPG());
 	SurfaceWriter.push_back(video::createImageWriterPNG());
@@ -118,6 +134,10 @@ CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& scre
 //! destructor
 CNullDriver::~CNullDriver()
 {
+	// the workers use the file system and the image loaders and writers
+	delete AsyncTextures;
+	delete AsyncImageWriter;
+
 	if (DriverAttributes)
 		DriverAttributes->drop();
 
@@ -215,9 +235,12 @@ void CNullDriver::deleteAllTextures()
 	// remove textures.
 
 	for (u32 i=0; i<Textures.size(); ++i)
-		Textures[i].Surface->drop();
+		Textures[i]->drop();
 
 	Textures.clear();
+	TextureNames.clear();
+	TextureAliases.clear();
+	TextureSources.clear();
 
 	SharedDepthTextures.clear();
 }
@@ -225,6 +248,11 @@ void CNullDriver::deleteAllTextures()
 bool CNullDriver::beginScene(u16 clearFlag, SColor clearColor, f32 clearDepth, u8 clearStencil, const SExposedVideoData& videoData, core::rect<s32>* sourceRect)
 {
 	PrimitivesDrawn = 0;
+	++FrameNumber;
+	uploadAsyncTextures();
+	finishAsyncImageWrites();
+	if (TextureMemoryBudget)
+		evictTextures();
 	return true;
 }
 
@@ -283,17 +311,15 @@ void CNullDriver::removeTexture(ITexture* texture)
 {
 	if (!texture)
 		return;
-	SSurface s;
-	s.Surface = texture;
 
-	s32 last;
-	s32 first = Textures.binary_search_multi(s, last);
-	if (first == -1)
-		return;
-	for (u32 i = first; i <= (u32)last; i++) {
-		if (Textures[i].Surface == texture) {
+	const auto range = TextureNames.equal_range(hashTextureName(texture->getName().getInternalName()));
+	for (auto it = range.first; it != range.second; ++it) {
+		if (it->second == texture) {
+			TextureNames.erase(it);
+			TextureAliases.clear();
+			TextureSources.erase(texture);
+			Textures.erase(Textures.linear_search(texture));
 			texture->drop();
-			Textures.erase(i);
 			return;
 		}
 	}
@@ -316,6 +342,119 @@ u32 CNullDriver::getTextureCount() const
 }
 
 
+//! Limits the video memory used by textures
+void CNullDriver::setTextureMemoryBudget(u64 budget, u32 minUnusedFrames)
+{
+	TextureMemoryBudget = budget;
+	TextureEvictionFrames = minUnusedFrames;
+}
+
+
+//! Returns the memory used by textures
+STextureMemoryStats CNullDriver::getTextureMemoryStats() const
+{
+	STextureMemoryStats stats = {};
+
+	for (u32 i = 0; i < Textures.size(); ++i)
+	{
+		stats.VideoMemory += Textures[i]->getVideoMemorySize();
+		stats.ImageMemory += Textures[i]->getImageMemorySize();
+		if (Textures[i]->isResident())
+			++stats.ResidentTextures;
+		else
+			++stats.EvictedTextures;
+	}
+	stats.Evictions = TextureEvictions;
+	stats.Reloads = TextureReloads;
+
+	return stats;
+}
+
+
+//! Evicts least recently used textures while over TextureMemoryBudget
+void CNullDriver::evictTextures()
+{
+	u64 used = 0;
+	for (u32 i = 0; i < Textures.size(); ++i)
+		used += Textures[i]->getVideoMemorySize();
+
+	if (used <= TextureMemoryBudget)
+		return;
+
+	// only textures which can be uploaded again are evicted
+	core::array<ITexture*> candidates;
+	for (u32 i = 0; i < Textures.size(); ++i)
+	{
+		ITexture* texture = Textures[i];
+		if (texture->isResident() && FrameNumber - texture->getLastUsedFrame() >= TextureEvictionFrames &&
+			(texture->getImageMemorySize() || TextureSources.count(texture)))
+			candidates.push_back(texture);
+	}
+
+	std::sort(candidates.pointer(), candidates.pointer() + candidates.size(),
+		[](const ITexture* a, const ITexture* b) { return a->getLastUsedFrame() < b->getLastUsedFrame(); });
+
+	for (u32 i = 0; i < candidates.size() && used > TextureMemoryBudget; ++i)
+	{
+		const u32 size = candidates[i]->getVideoMemorySize();
+		if (candidates[i]->evict())
+		{
+			used -= size;
+			++TextureEvictions;
+		}
+	}
+}
+
+
+//! Uploads an evicted texture again
+bool CNullDriver::restoreTexture(ITexture* texture)
+{
+	core::array<IImage*> images;
+
+	if (!texture->getImageMemorySize())
+	{
+		const auto source = TextureSources.find(texture);
+		if (source == TextureSources.end())
+			return false;
+
+		IImage* image = 0;
+		io::IReadFile* file = FileSystem->createAndOpenFile(source->second.FileName);
+		if (file)
+		{
+			image = createImageFromFile(file);
+			file->drop();
+		}
+
+		if (image && (source->second.Flags & ETCF_COMPRESS_TEXTURES))
+		{
+			IImage* compressed = compressTextureImage(image, source->second.Flags);
+			image->drop();
+			image = compressed;
+		}
+
+		if (!image)
+		{
+			os::Printer::log("Could not reload evicted texture", source->second.FileName, ELL_ERROR);
+			// don't try again on every bind
+			TextureSources.erase(source);
+			return false;
+		}
+
+		images.push_back(image);
+	}
+
+	const bool restored = texture->restore(images);
+
+	for (u32 i = 0; i < images.size(); ++i)
+		images[i]->drop();
+
+	if (restored)
+		++TextureReloads;
+
+	return restored;
+}
+
+
 ITexture* CNullDriver::addTexture(const core::dimension2d<u32>& size, const io::path& name, ECOLOR_FORMAT format)
 {
 	if (0 == name.size())
@@ -436,13 +575,31 @@ ITexture* CNullDriver::addTextureCubemap(const irr::u32 sideLen, const io::path&
 //! loads a Texture
 ITexture* CNullDriver::getTexture(const io::path& filename)
 {
+	// Names which were resolved before need no file system access, unless
+	// they are relative to another working directory now
+	const u32 directoryChanges = FileSystem->getWorkingDirectoryChanges();
+	if (directoryChanges != TextureAliasesDirectoryChanges)
+	{
+		TextureAliases.clear();
+		TextureAliasesDirectoryChanges = directoryChanges;
+	}
+	const auto alias = TextureAliases.find(filename);
+	if (alias != TextureAliases.end())
+	{
+		alias->second->updateSource(ETS_FROM_CACHE);
+		io::getIOStatistics().addCacheLookup(io::EIOC_TEXTURE, true);
+		return alias->second;
+	}
+
 	// Identify textures by their absolute filenames if possible.
-	const io::path absolutePath = FileSystem->getAbsolutePath(filename);
+	const io::path absolutePath = FileSystem->getCachedAbsolutePath(filename);
 
 	ITexture* texture = findTexture(absolutePath);
 	if (texture)
 	{
 		texture->updateSource(ETS_FROM_CACHE);
+		io::getIOStatistics().addCacheLookup(io::EIOC_TEXTURE, true);
+		TextureAliases[filename] = texture;
 		return texture;
 	}
 
@@ -451,6 +608,8 @@ ITexture* CNullDriver::getTexture(const io::path& filename)
 	if (texture)
 	{
 		texture->updateSource(ETS_FROM_CACHE);
+		io::getIOStatistics().addCacheLookup(io::EIOC_TEXTURE, true);
+		TextureAliases[filename] = texture;
 		return texture;
 	}
 
@@ -470,10 +629,13 @@ ITexture* CNullDriver::getTexture(const io::path& filename)
 		if (texture)
 		{
 			texture->updateSource(ETS_FROM_CACHE);
+			io::getIOStatistics().addCacheLookup(io::EIOC_TEXTURE, true);
+			TextureAliases[filename] = texture;
 			file->drop();
 			return texture;
 		}
 
+		io::getIOStatistics().addCacheLookup(io::EIOC_TEXTURE, false);
 		texture = loadTextureFromFile(file);
 		file->drop();
 
@@ -482,6 +644,7 @@ ITexture* CNullDriver::getTexture(const io::path& filename)
 			texture->updateSource(ETS_FROM_FILE);
 			addTexture(texture);
 			texture->drop(); // drop it because we created it, one grab too much
+			TextureAliases[filename] = texture;
 		}
 		else
 			os::Printer::log("Could not load texture", filename, ELL_ERROR);
@@ -489,6 +652,7 @@ ITexture* CNullDriver::getTexture(const io::path& filename)
 	}
 	else
 	{
+		io::getIOStatistics().addCacheLookup(io::EIOC_TEXTURE, false);
 		os::Printer::log("Could not open file of texture", filename, ELL_WARNING);
 		return 0;
 	}
@@ -507,9 +671,11 @@ ITexture* CNullDriver::getTexture(io::IReadFile* file)
 		if (texture)
 		{
 			texture->updateSource(ETS_FROM_CACHE);
+			io::getIOStatistics().addCacheLookup(io::EIOC_TEXTURE, true);
 			return texture;
 		}
 
+		io::getIOStatistics().addCacheLookup(io::EIOC_TEXTURE, false);
 		texture = loadTextureFromFile(file);
 
 		if (texture)
@@ -527,6 +693,170 @@ ITexture* CNullDriver::getTexture(io::IReadFile* file)
 }
 
 
+//! loads Textures on worker threads
+void CNullDriver::getTexturesAsync(const core::array<io::path>& filenames, const TextureLoadedCallback& callback)
+{
+	// shared by all requests of this call
+	auto shared = std::make_shared<const TextureLoadedCallback>(callback);
+
+	for (u32 i = 0; i < filenames.size(); ++i)
+	{
+		ITexture* texture = findTexture(FileSystem->getCachedAbsolutePath(filenames[i]));
+		if (!texture)
+			texture = findTexture(filenames[i]);
+
+		if (texture)
+		{
+			texture->updateSource(ETS_FROM_CACHE);
+			io::getIOStatistics().addCacheLookup(io::EIOC_TEXTURE, true);
+			callback(filenames[i], texture);
+			continue;
+		}
+
+		io::getIOStatistics().addCacheLookup(io::EIOC_TEXTURE, false);
+
+		// opened here like in getTexture(), the workers don't use the file system
+		io::IReadFile* file = FileSystem->createAndOpenFile(FileSystem->getCachedAbsolutePath(filenames[i]));
+		if (!file)
+			file = FileSystem->createAndOpenFile(filenames[i]);
+		if (!file)
+		{
+			os::Printer::log("Could not open file of texture", filenames[i], ELL_WARNING);
+			callback(filenames[i], 0);
+			continue;
+		}
+
+		if (!AsyncTextures)
+			AsyncTextures = new CAsyncTextureLoader(this);
+		AsyncTextures->add(filenames[i], file, shared, TextureCreationFlags);
+		file->drop();
+	}
+}
+
+
+//! creates the textures of decoded images
+u32 CNullDriver::uploadAsyncTextures(u32 timeBudgetMs)
+{
+	if (!AsyncTextures)
+		return 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto budget = std::chrono::milliseconds(timeBudgetMs);
+
+	CAsyncTextureLoader::SDecoded decoded;
+	while (AsyncTextures->popDecoded(decoded))
+	{
+		decoded.Log.flush();
+		decoded.File->drop();
+
+		// the same file might have been requested twice or loaded meanwhile
+		ITexture* texture = findTexture(decoded.FileName);
+		if (texture)
+		{
+			texture->updateSource(ETS_FROM_CACHE);
+		}
+		else if (decoded.Image)
+		{
+			if (checkImage(decoded.Image))
+				texture = createDeviceDependentTexture(decoded.FileName, decoded.Image);
+
+			if (texture)
+			{
+				os::Printer::log("Loaded texture", decoded.FileName, ELL_DEBUG);
+				texture->updateSource(ETS_FROM_FILE);
+				TextureSources[texture] = STextureSource{decoded.FileName, decoded.Flags};
+				addTexture(texture);
+				texture->drop(); // drop it because we created it, one grab too much
+			}
+		}
+
+		if (decoded.Image)
+			decoded.Image->drop();
+
+		if (!texture)
+			os::Printer::log("Could not load texture", decoded.Name, ELL_ERROR);
+
+		(*decoded.Callback)(decoded.Name, texture);
+
+		if (std::chrono::steady_clock::now() - start >= budget)
+			break;
+	}
+
+	return AsyncTextures->getPendingCount();
+}
+
+
+//! sets the directory for compressed textures
+void CNullDriver::setCompressedTextureCacheDirectory(const io::path& directory)
+{
+	std::lock_guard<std::mutex> lock(CompressedTextureCacheMutex);
+	CompressedTextureCache = directory;
+}
+
+
+//! creates a texture atlas
+ITextureAtlas* CNullDriver::createTextureAtlas(const io::path& name, const core::dimension2d<u32>& pageSize, u32 padding)
+{
+	return new CTextureAtlas(this, name, pageSize, padding);
+}
+
+
+//! compresses an image for a texture if ETCF_COMPRESS_TEXTURES is set
+IImage* CNullDriver::compressTextureImage(IImage* image, u32 flags) const
+{
+	image->grab();
+	if (!(flags & ETCF_COMPRESS_TEXTURES) || IImage::isCompressedFormat(image->getColorFormat()) ||
+		!CColorConverter::canConvertFormat(image->getColorFormat(), ECF_A8R8G8B8))
+		return image;
+
+	const core::dimension2d<u32>& size = image->getDimension();
+	const bool alpha = !(flags & ETCF_NO_ALPHA_CHANNEL) && hasTransparentPixels(image);
+	ECOLOR_FORMAT format = ECF_UNKNOWN;
+	if (queryFeature(EVDF_TEXTURE_COMPRESSED_DXT) && size.getOptimalSize(true, false) == size)
+		format = alpha ? ECF_DXT5 : ECF_DXT1;
+	else if (queryFeature(EVDF_TEXTURE_COMPRESSED_ETC2))
+		format = alpha ? ECF_ETC2_ARGB : ECF_ETC2_RGB;
+	if (format == ECF_UNKNOWN)
+		return image;
+
+	// compressed formats can't be mipmapped by the driver
+	const bool createMipMaps = (flags & ETCF_CREATE_MIP_MAPS) && !image->getMipMapsData();
+
+	io::path cacheFile;
+	{
+		std::lock_guard<std::mutex> lock(CompressedTextureCacheMutex);
+		cacheFile = CompressedTextureCache;
+	}
+	if (cacheFile.size())
+	{
+		c8 name[32];
+		snprintf_irr(name, sizeof(name), "%016llx.itc",
+			(unsigned long long)hashImage(image, (format << 1) | (createMipMaps ? 1 : 0)));
+		cacheFile += "/";
+		cacheFile += name;
+
+		if (IImage* cached = readCompressedImageCache(cacheFile))
+		{
+			image->drop();
+			return cached;
+		}
+	}
+
+	if (createMipMaps)
+		image->generateMipMaps();
+
+	IImage* compressed = compressImage(image, format);
+	if (!compressed)
+		return image;
+
+	if (cacheFile.size() && !writeCompressedImageCache(cacheFile, compressed))
+		os::Printer::log("Could not write compressed texture cache", cacheFile, ELL_WARNING);
+
+	image->drop();
+	return compressed;
+}
+
+
 //! opens the file and loads it into the surface
 video::ITexture* CNullDriver::loadTextureFromFile(io::IReadFile* file, const io::path& hashName )
 {
@@ -536,10 +866,20 @@ video::ITexture* CNullDriver::loadTextureFromFile(io::IReadFile* file, const io:
 	if (!image)
 		return nullptr;
 
+	if (TextureCreationFlags & ETCF_COMPRESS_TEXTURES) {
+		IImage *compressed = compressTextureImage(image, TextureCreationFlags);
+		image->drop();
+		image = compressed;
+	}
+
 	if (checkImage(image)) {
 		texture = createDeviceDependentTexture(hashName.size() ? hashName : file->getFileName(), image);
-		if (texture)
+		if (texture) {
 			os::Printer::log("Loaded texture", file->getFileName(), ELL_DEBUG);
+			// files which are not in the file system, e.g. memory files, can not be reloaded
+			if (FileSystem->existFile(file->getFileName()))
+				TextureSources[texture] = STextureSource{file->getFileName(), TextureCreationFlags};
+		}
 	}
 
 	image->drop();
@@ -553,15 +893,14 @@ void CNullDriver::addTexture(video::ITexture* texture)
 {
 	if (texture)
 	{
-		SSurface s;
-		s.Surface = texture;
 		texture->grab();
+		texture->updateLastUsedFrame(FrameNumber);
+		Textures.push_back(texture);
+		TextureNames.emplace(hashTextureName(texture->getName().getInternalName()), texture);
 
-		Textures.push_back(s);
-
-		// the new texture is now at the end of the texture list. when searching for
-		// the next new texture, the texture array will be sorted and the index of this texture
-		// will be changed.
+		// the new texture may take precedence over what a name resolved to before
+		if (!TextureAliases.empty())
+			TextureAliases.clear();
 	}
 }
 
@@ -569,21 +908,43 @@ void CNullDriver::addTexture(video::ITexture* texture)
 //! looks if the image is already loaded
 video::ITexture* CNullDriver::findTexture(const io::path& filename)
 {
-	SSurface s;
-	SDummyTexture dummy(filename, ETT_2D);
-	s.Surface = &dummy;
+	const auto range = TextureNames.equal_range(hashTextureName(filename));
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		// compare like the internal name of io::SNamedPath, which is lower case with forward slashes
+		const io::path& name = it->second->getName().getInternalName();
+		if (name.size() != filename.size())
+			continue;
 
-	s32 index = Textures.binary_search(s);
-	if (index != -1)
-		return Textures[index].Surface;
+		u32 i = 0;
+		while (i < name.size() && (u32)name[i] == (filename[i] == '\\' ? '/' : core::locale_lower(filename[i])))
+			++i;
+		if (i == name.size())
+			return it->second;
+	}
 
 	return 0;
 }
 
+
+//! hashes a name as it would be after io::SNamedPath::PathToName
+u64 CNullDriver::hashTextureName(const io::path& name)
+{
+	// FNV-1a
+	u64 hash = 0xcbf29ce484222325ULL;
+	for (u32 i = 0; i < name.size(); ++i)
+	{
+		const u32 c = name[i] == '\\' ? '/' : core::locale_lower(name[i]);
+		hash = (hash ^ c) * 0x100000001b3ULL;
+	}
+	return hash;
+}
+
 ITexture* CNullDriver::createDeviceDependentTexture(const io::path& name, IImage* image)
 {
 	SDummyTexture* dummy = new SDummyTexture(name, ETT_2D);
 	dummy->setSize(image->getDimension());
+	dummy->setColorFormat(image->getColorFormat());
 	return dummy;
 }
 
@@ -1139,7 +1500,7 @@ IImage *CNullDriver::createImageFromFile(io::IReadFile* file)
 			continue;
 
 		file->seek(0); // reset file position which might have changed due to previous loadImage calls
-		if (IImage *image = SurfaceLoader[i]->loadImage(file))
+		if (IImage *image = loadImage(SurfaceLoader[i], file))
 			return image;
 	}
 
@@ -1152,7 +1513,7 @@ IImage *CNullDriver::createImageFromFile(io::IReadFile* file)
 			continue;
 
 		file->seek(0);
-		if (IImage *image = SurfaceLoader[i]->loadImage(file))
+		if (IImage *image = loadImage(SurfaceLoader[i], file))
 			return image;
 	}
 
@@ -1160,6 +1521,16 @@ IImage *CNullDriver::createImageFromFile(io::IReadFile* file)
 }
 
 
+//! loads an image with a loader and counts the time spent
+IImage* CNullDriver::loadImage(IImageLoader* loader, io::IReadFile* file)
+{
+	const u64 start = io::CIOStatistics::getTime();
+	IImage* image = loader->loadImage(file);
+	io::getIOStatistics().addLoaderTime("image", file->getFileName(), io::CIOStatistics::getTime() - start);
+	return image;
+}
+
+
 //! Writes the provided image to disk file
 bool CNullDriver::writeImageToFile(IImage* image, const io::path& filename,u32 param)
 {
@@ -1192,6 +1563,45 @@ bool CNullDriver::writeImageToFile(IImage* image, io::IWriteFile * file, u32 par
 }
 
 
+//! Writes a copy of the image to a file on a worker thread
+void CNullDriver::writeImageToFileAsync(IImage* image, const io::path& filename, u32 param,
+	const ImageWrittenCallback& callback)
+{
+	if (!image)
+	{
+		if (callback)
+			callback(filename, false);
+		return;
+	}
+
+	IImage* copy = new CImage(image->getColorFormat(), image->getDimension());
+	memcpy(copy->getData(), image->getData(), image->getImageDataSizeInBytes());
+
+	if (!AsyncImageWriter)
+		AsyncImageWriter = new CAsyncImageWriter(this);
+	AsyncImageWriter->add(copy, filename, param, callback);
+}
+
+
+//! Calls the callbacks of images written on the worker thread
+u32 CNullDriver::finishAsyncImageWrites(bool wait)
+{
+	if (!AsyncImageWriter)
+		return 0;
+
+	CAsyncImageWriter::SWrite write;
+	while (AsyncImageWriter->popWritten(write, wait))
+	{
+		if (!write.Written)
+			os::Printer::log("Could not write image", write.Filename, ELL_ERROR);
+		if (write.Callback)
+			write.Callback(write.Filename, write.Written);
+	}
+
+	return AsyncImageWriter->getPendingCount();
+}
+
+
 //! Creates a software image from a byte array.
 IImage* CNullDriver::createImageFromData(ECOLOR_FORMAT format,
 	const core::dimension2d<u32>& size, void *data, bool ownForeignMemory,
@@ -1281,6 +1691,30 @@ void CNullDriver::drawMeshBuffer(const scene::IMeshBuffer* mb)
 	if (!mb)
 		return;
 
+	const bool compact = (mb->getVertexType() == EVT_COMPACT);
+	if (compact && !supportsCompactVertices())
+	{
+		// decoded to object space, so lighting gets the real normals
+		const u32 count = mb->getVertexCount();
+		const S3DVertexCompact* vertices = static_cast<const S3DVertexCompact*>(mb->getVertices());
+		DecodedCompactVertices.set_used(count);
+		for (u32 i=0; i<count; ++i)
+			DecodedCompactVertices[i] = S3DVertex(mb->getPosition(i), vertices[i].getNormal(),
+				vertices[i].Color, vertices[i].getTCoords());
+
+		drawVertexPrimitiveList(DecodedCompactVertices.const_pointer(), count, mb->getIndices(),
+			mb->getPrimitiveCount(), EVT_STANDARD, mb->getPrimitiveType(), mb->getIndexType());
+		return;
+	}
+
+	// quantized positions are mapped to object space by the world matrix
+	core::matrix4 world;
+	if (compact)
+	{
+		world = getTransform(ETS_WORLD);
+		setTransform(ETS_WORLD, world * mb->getVertexPositionTransform());
+	}
+
 	//IVertexBuffer and IIndexBuffer later
 	SHWBufferLink *HWBuffer=getBufferLink(mb);
 
@@ -1288,6 +1722,20 @@ void CNullDriver::drawMeshBuffer(const scene::IMeshBuffer* mb)
 		drawHardwareBuffer(HWBuffer);
 	else
 		drawVertexPrimitiveList(mb->getVertices(), mb->getVertexCount(), mb->getIndices(), mb->getPrimitiveCount(), mb->getVertexType(), mb->getPrimitiveType(), mb->getIndexType());
+
+	if (compact)
+		setTransform(ETS_WORLD, world);
+}
+
+
+//! Logs an error the first time EVT_COMPACT vertices are drawn without drawMeshBuffer() by such a driver
+void CNullDriver::logCompactVerticesUnsupported()
+{
+	if (CompactVerticesLogged)
+		return;
+
+	os::Printer::log("This driver draws compact vertices only with drawMeshBuffer()", ELL_ERROR);
+	CompactVerticesLogged = true;
 }
 
 
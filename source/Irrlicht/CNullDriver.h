@@ -9,6 +9,7 @@
 #include "IGPUProgrammingServices.h"
 #include "irrArray.h"
 #include "irrString.h"
+#include "irrStringHash.h"
 #include "IAttributes.h"
 #include "IMesh.h"
 #include "IMeshBuffer.h"
@@ -18,6 +19,8 @@
 #include "SVertexIndex.h"
 #include "SExposedVideoData.h"
 #include <list>
+#include <mutex>
+#include <unordered_map>
 
 namespace irr
 {
@@ -30,6 +33,8 @@ namespace video
 {
 	class IImageLoader;
 	class IImageWriter;
+	class CAsyncTextureLoader;
+	class CAsyncImageWriter;
 
 	class CNullDriver : public IVideoDriver, public IGPUProgrammingServices
 	{
@@ -79,9 +84,42 @@ namespace video
 		//! loads a Texture
 		ITexture* getTexture(io::IReadFile* file) override;
 
+		//! loads Textures on worker threads
+		void getTexturesAsync(const core::array<io::path>& filenames,
+			const TextureLoadedCallback& callback) override;
+
+		//! creates the textures of decoded images
+		u32 uploadAsyncTextures(u32 timeBudgetMs = 2) override;
+
+		//! sets the directory for compressed textures
+		void setCompressedTextureCacheDirectory(const io::path& directory) override;
+
+		ITextureAtlas* createTextureAtlas(const io::path& name, const core::dimension2d<u32>& pageSize, u32 padding) override;
+
+		//! Compresses an image for a texture if ETCF_COMPRESS_TEXTURES is set in flags
+		/** Thread safe, used by the async texture loader workers, which
+		collect what it logs with os::Printer::setDeferredLog().
+		\return The compressed image, or the given one, grabbed. */
+		IImage* compressTextureImage(IImage* image, u32 flags) const;
+
 		//! Returns amount of textures currently loaded
 		u32 getTextureCount() const override;
 
+		//! Limits the video memory used by textures
+		void setTextureMemoryBudget(u64 budget, u32 minUnusedFrames = 60) override;
+
+		//! Returns the memory used by textures
+		STextureMemoryStats getTextureMemoryStats() const override;
+
+		//! Called by the drivers whenever a texture is bound
+		/** Uploads the texture again if it was evicted. */
+		void markTextureUsed(const ITexture* texture)
+		{
+			texture->updateLastUsedFrame(FrameNumber);
+			if (!texture->isResident())
+				restoreTexture(const_cast<ITexture*>(texture));
+		}
+
 		ITexture* addTexture(const core::dimension2d<u32>& size, const io::path& name, ECOLOR_FORMAT format = ECF_A8R8G8B8) override;
 
 		ITexture* addTexture(const io::path& name, IImage* image) override;
@@ -385,6 +423,12 @@ namespace video
 		//! Create hardware buffer from mesh (only some drivers can)
 		virtual SHWBufferLink *createHardwareBuffer(const scene::IMeshBuffer* mb) {return 0;}
 
+		//! False if the driver can't read EVT_COMPACT vertices, drawMeshBuffer() decodes them then
+		virtual bool supportsCompactVertices() const {return true;}
+
+		//! Logs an error the first time EVT_COMPACT vertices are drawn without drawMeshBuffer() by such a driver
+		void logCompactVerticesUnsupported();
+
 	public:
 		//! Remove hardware buffer
 		void removeHardwareBuffer(const scene::IMeshBuffer* mb) override;
@@ -568,6 +612,13 @@ namespace video
 		//! Writes the provided image to a file.
 		bool writeImageToFile(IImage* image, io::IWriteFile * file, u32 param = 0) override;
 
+		//! Writes a copy of the image to a file on a worker thread
+		void writeImageToFileAsync(IImage* image, const io::path& filename, u32 param = 0,
+			const ImageWrittenCallback& callback = ImageWrittenCallback()) override;
+
+		//! Calls the callbacks of images written on the worker thread
+		u32 finishAsyncImageWrites(bool wait = false) override;
+
 		//! Sets the name of a material renderer.
 		void setMaterialRendererName(u32 idx, const char* name) override;
 
@@ -642,9 +693,15 @@ namespace video
 		//! deletes all textures
 		void deleteAllTextures();
 
+		//! Hash of a name as SNamedPath::getInternalName() would make it, without building that string
+		static u64 hashTextureName(const io::path& name);
+
 		//! opens the file and loads it into the surface
 		ITexture* loadTextureFromFile(io::IReadFile* file, const io::path& hashName = "");
 
+		//! loads an image with a loader and counts the time spent
+		IImage* loadImage(IImageLoader* loader, io::IReadFile* file);
+
 		//! adds a surface, not loaded or created by the Irrlicht Engine
 		void addTexture(ITexture* surface);
 
@@ -682,16 +739,6 @@ namespace video
 			return true; // never should get here, but some compilers don't know and complain
 		}
 
-		struct SSurface
-		{
-			video::ITexture* Surface;
-
-			bool operator < (const SSurface& other) const
-			{
-				return Surface->getName() < other.Surface->getName();
-			}
-		};
-
 		struct SMaterialRenderer
 		{
 			core::stringc Name;
@@ -704,11 +751,49 @@ namespace video
 
 			void setSize(const core::dimension2d<u32>& size) { Size = OriginalSize = size; }
 
+			void setColorFormat(ECOLOR_FORMAT format) { ColorFormat = OriginalColorFormat = format; }
+
 			void* lock(E_TEXTURE_LOCK_MODE mode = ETLM_READ_WRITE, u32 mipmapLevel=0, u32 layer = 0, E_TEXTURE_LOCK_FLAGS lockFlags = ETLF_FLIP_Y_UP_RTT) override { return 0; }
 			void unlock()override {}
 			void regenerateMipMapLevels(void* data = 0, u32 layer = 0) override {}
+
+			bool evict() override { Resident = false; return true; }
+			bool restore(const core::array<IImage*>& images) override { Resident = true; return true; }
+		};
+		//! Textures in the order they were added
+		core::array<ITexture*> Textures;
+
+		//! Textures by the hash of their internal name, see hashTextureName()
+		std::unordered_multimap<u64, ITexture*> TextureNames;
+
+		//! Names getTexture() was called with and the texture they resolved to
+		/** Hits skip the absolute path lookup. Cleared whenever a texture
+		is added or removed, as that can change what a name resolves to,
+		and when the working directory changed. */
+		std::unordered_map<io::path, ITexture*> TextureAliases;
+		//! IFileSystem::getWorkingDirectoryChanges() when TextureAliases were resolved
+		u32 TextureAliasesDirectoryChanges;
+
+		//! Where a texture was loaded from, to load it again after it was evicted
+		struct STextureSource
+		{
+			io::path FileName;
+			u32 Flags;
 		};
-		core::array<SSurface> Textures;
+		std::unordered_map<const ITexture*, STextureSource> TextureSources;
+
+		//! Evicts least recently used textures while over TextureMemoryBudget
+		void evictTextures();
+
+		//! Uploads an evicted texture again
+		bool restoreTexture(ITexture* texture);
+
+		u64 TextureMemoryBudget;
+		u32 TextureEvictionFrames;
+		u32 TextureEvictions;
+		u32 TextureReloads;
+		//! Number of the current frame, counted by beginScene()
+		u32 FrameNumber;
 
 		struct SOccQuery
 		{
@@ -784,9 +869,23 @@ namespace video
 
 		io::IFileSystem* FileSystem;
 
+		//! created on the first getTexturesAsync call
+		CAsyncTextureLoader* AsyncTextures;
+
+		//! created on the first writeImageToFileAsync call
+		CAsyncImageWriter* AsyncImageWriter;
+
+		//! read by the async texture loader workers
+		io::path CompressedTextureCache;
+		mutable std::mutex CompressedTextureCacheMutex;
+
 		//! mesh manipulator
 		scene::IMeshManipulator* MeshManipulator;
 
+		//! compact vertices decoded by drawMeshBuffer()
+		core::array<S3DVertex> DecodedCompactVertices;
+		bool CompactVerticesLogged;
+
 		core::rect<s32> ViewPort;
 		core::dimension2d<u32> ScreenSize;
 		core::matrix4 TransformationMatrix;
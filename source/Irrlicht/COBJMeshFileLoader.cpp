@@ -9,6 +9,7 @@
 #include "SMeshBuffer.h"
 #include "SAnimatedMesh.h"
 #include "IReadFile.h"
+#include "CIOStatistics.h"
 #include "IAttributes.h"
 #include "fast_atof.h"
 #include "coreutil.h"
@@ -72,13 +73,21 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 
 	const io::path fullName = file->getFileName();
 
-	c8* buf = new c8[filesize+1]; // plus null-terminator
-	memset(buf, 0, filesize+1);
-	file->read((void*)buf, filesize);
-	const c8* const bufEnd = buf+filesize;
+	// mapped files are parsed in place
+	c8* buf = 0;
+	const c8* data = (const c8*)file->getMappedData();
+	if (!data)
+	{
+		buf = new c8[filesize];
+		file->read((void*)buf, filesize);
+		data = buf;
+	}
+	else
+		io::addBytesMapped(file, filesize);
+	const c8* const bufEnd = data+filesize;
 
 	// Process obj information
-	const c8* bufPtr = buf;
+	const c8* bufPtr = data;
 	core::stringc grpName, mtlName;
 	bool mtlChanged=false;
 	bool useGroups = !SceneManager->getParameters()->getAttributeAsBool(OBJ_LOADER_IGNORE_GROUPS);
@@ -107,7 +116,7 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 			break;
 
 		case 'v':               // v, vn, vt
-			switch(bufPtr[1])
+			switch(bufPtr+1 != bufEnd ? bufPtr[1] : 0)
 			{
 			case ' ':          // vertex
 				{
@@ -313,6 +322,8 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 	{
 		if ( Materials[m]->Meshbuffer->getIndexCount() > 0 )
 		{
+			Materials[m]->Meshbuffer->Vertices.shrink_to_fit();
+			Materials[m]->Meshbuffer->Indices.shrink_to_fit();
 			Materials[m]->Meshbuffer->recalculateBoundingBox();
 			if (Materials[m]->RecalculateNormals)
 				SceneManager->getMeshManipulator()->recalculateNormals(Materials[m]->Meshbuffer);
@@ -483,9 +494,9 @@ u32 COBJMeshFileLoader::copyWord(c8* outBuf, const c8* const inBuf, u32 outBufLe
 	}
 
 	u32 i = 0;
-	while(inBuf[i])
+	while(&(inBuf[i]) != bufEnd && inBuf[i])
 	{
-		if (core::isspace(inBuf[i]) || &(inBuf[i]) == bufEnd)
+		if (core::isspace(inBuf[i]))
 			break;
 		++i;
 	}
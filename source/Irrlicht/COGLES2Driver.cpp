@@ -645,6 +645,22 @@ COGLES2Driver::~COGLES2Driver()
 				glVertexAttribPointer(EVA_BINORMAL, 3, GL_FLOAT, false, sizeof(S3DVertexTangents), buffer_offset(48));
 			}
 			break;
+		case EVT_COMPACT:
+			if (vertices)
+			{
+				glVertexAttribPointer(EVA_POSITION, 3, GL_SHORT, true, sizeof(S3DVertexCompact), &(static_cast<const S3DVertexCompact*>(vertices))[0].Pos);
+				glVertexAttribPointer(EVA_NORMAL, 2, GL_SHORT, true, sizeof(S3DVertexCompact), &(static_cast<const S3DVertexCompact*>(vertices))[0].Normal);
+				glVertexAttribPointer(EVA_COLOR, 4, GL_UNSIGNED_BYTE, true, sizeof(S3DVertexCompact), &(static_cast<const S3DVertexCompact*>(vertices))[0].Color);
+				glVertexAttribPointer(EVA_TCOORD0, 2, GL_UNSIGNED_SHORT, true, sizeof(S3DVertexCompact), &(static_cast<const S3DVertexCompact*>(vertices))[0].TCoords);
+			}
+			else
+			{
+				glVertexAttribPointer(EVA_POSITION, 3, GL_SHORT, true, sizeof(S3DVertexCompact), 0);
+				glVertexAttribPointer(EVA_NORMAL, 2, GL_SHORT, true, sizeof(S3DVertexCompact), buffer_offset(8));
+				glVertexAttribPointer(EVA_COLOR, 4, GL_UNSIGNED_BYTE, true, sizeof(S3DVertexCompact), buffer_offset(12));
+				glVertexAttribPointer(EVA_TCOORD0, 2, GL_UNSIGNED_SHORT, true, sizeof(S3DVertexCompact), buffer_offset(16));
+			}
+			break;
 		}
 
 		GLenum indexSize = 0;
@@ -545,6 +545,13 @@ void COGLES1Driver::drawVertexPrimitiveList2d3d(const void* vertices, u32 vertex
 	if (!primitiveCount || !vertexCount)
 		return;
 
+	// quantized vertices are decoded by drawMeshBuffer()
+	if (vType == EVT_COMPACT)
+	{
+		logCompactVerticesUnsupported();
+		return;
+	}
+
 	if (!threed && !checkPrimitiveCount(primitiveCount))
 		return;
 
@@ -589,6 +596,8 @@ void COGLES1Driver::drawVertexPrimitiveList2d3d(const void* vertices, u32 vertex
 				}
 			}
 			break;
+			default:
+				break;
 		}
 	}
 
@@ -695,6 +704,8 @@ void COGLES1Driver::drawVertexPrimitiveList2d3d(const void* vertices, u32 vertex
 					glTexCoordPointer(3, GL_FLOAT, sizeof(S3DVertexTangents), buffer_offset(48));
 			}
 			break;
+		default:
+			break;
 	}
 
 	GLenum indexSize=0;
@@ -61,6 +61,9 @@ namespace video
 		//! Create hardware buffer from mesh
 		SHWBufferLink *createHardwareBuffer(const scene::IMeshBuffer* mb) override;
 
+		//! The fixed function pipeline can't read quantized vertices
+		bool supportsCompactVertices() const override {return false;}
+
 		//! Delete hardware buffer (only some drivers can)
 		void deleteHardwareBuffer(SHWBufferLink *HWBuffer) override;
 
@@ -59,6 +59,10 @@ class COpenGLCoreCacheHandler
 		{
 			bool status = false;
 
+			// evicted textures are uploaded again before they are bound
+			if (texture && texture->getDriverType() == DriverType)
+				CacheHandler.Driver->markTextureUsed(texture);
+
 			E_DRIVER_TYPE type = DriverType;
 
 			if (index < MATERIAL_MAX_TEXTURES && index < TextureCount)
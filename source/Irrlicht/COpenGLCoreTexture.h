@@ -58,92 +58,15 @@ public:
 
 		getImageValues(images[0]);
 
-		const core::array<IImage*>* tmpImages = &images;
-
-		if (KeepImage || OriginalSize != Size || OriginalColorFormat != ColorFormat)
-		{
-			Images.set_used(images.size());
-
-			for (u32 i = 0; i < images.size(); ++i)
-			{
-				Images[i] = Driver->createImage(ColorFormat, Size);
-
-				if (images[i]->getDimension() == Size)
-					images[i]->copyTo(Images[i]);
-				else
-					images[i]->copyToScaling(Images[i]);
-
-				if ( images[i]->getMipMapsData() )
-				{
-					if ( OriginalSize == Size && OriginalColorFormat == ColorFormat )
-					{
-						Images[i]->setMipMapsData( images[i]->getMipMapsData(), false);
-					}
-					else
-					{
-						// TODO: handle at least mipmap with changing color format
-						os::Printer::log("COpenGLCoreTexture: Can't handle format changes for mipmap data. Mipmap data dropped", ELL_WARNING);
-					}
-				}
-			}
-
-			tmpImages = &Images;
-		}
-
-		glGenTextures(1, &TextureName);
-
-		const COpenGLCoreTexture* prevTexture = Driver->getCacheHandler()->getTextureCache().get(0);
-		Driver->getCacheHandler()->getTextureCache().set(0, this);
-
-		glTexParameteri(TextureType, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(TextureType, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-#ifdef GL_GENERATE_MIPMAP_HINT
-		if (HasMipMaps)
-		{
-			if (Driver->getTextureCreationFlag(ETCF_OPTIMIZED_FOR_SPEED))
-				glHint(GL_GENERATE_MIPMAP_HINT, GL_FASTEST);
-			else if (Driver->getTextureCreationFlag(ETCF_OPTIMIZED_FOR_QUALITY))
-				glHint(GL_GENERATE_MIPMAP_HINT, GL_NICEST);
-			else
-				glHint(GL_GENERATE_MIPMAP_HINT, GL_DONT_CARE);
-		}
-#endif
-
 #if !defined(IRR_OPENGL_HAS_glGenerateMipmap) && defined(GL_GENERATE_MIPMAP)
 		if (HasMipMaps)
 		{
 			LegacyAutoGenerateMipMaps = Driver->getTextureCreationFlag(ETCF_AUTO_GENERATE_MIP_MAPS)  &&
 										Driver->queryFeature(EVDF_MIP_MAP_AUTO_UPDATE);
-			glTexParameteri(TextureType, GL_GENERATE_MIPMAP, LegacyAutoGenerateMipMaps ? GL_TRUE : GL_FALSE);
 		}
 #endif
 
-		for (u32 i = 0; i < (*tmpImages).size(); ++i)
-			uploadTexture(true, i, 0, (*tmpImages)[i]->getData());
-
-		if (HasMipMaps && !LegacyAutoGenerateMipMaps)
-		{
-			// Create mipmaps (either from image mipmaps or generate them)
-			for (u32 i = 0; i < (*tmpImages).size(); ++i)
-			{
-				void* mipmapsData = (*tmpImages)[i]->getMipMapsData();
-				regenerateMipMapLevels(mipmapsData, i);
-			}
-		}
-
-		if (!KeepImage)
-		{
-			for (u32 i = 0; i < Images.size(); ++i)
-				Images[i]->drop();
-
-			Images.clear();
-		}
-
-
-		Driver->getCacheHandler()->getTextureCache().set(0, prevTexture);
-
-		Driver->testGLError(__LINE__);
+		createTexture(images);
 	}
 
 	COpenGLCoreTexture(const io::path& name, const core::dimension2d<u32>& size, E_TEXTURE_TYPE type, ECOLOR_FORMAT format, TOpenGLDriver* driver)
@@ -234,6 +157,14 @@ public:
 		if (LockImage)
 			return getLockImageData(MipLevelStored);
 
+		// reading back and unlock() need the texture object
+		if (!Resident)
+		{
+			Driver->markTextureUsed(this);
+			if (!Resident)
+				return 0;
+		}
+
 		if (IImage::isCompressedFormat(ColorFormat))
 			return 0;
 
@@ -398,6 +329,13 @@ public:
 		if (!HasMipMaps || LegacyAutoGenerateMipMaps || (Size.Width <= 1 && Size.Height <= 1))
 			return;
 
+		if (!Resident)
+		{
+			Driver->markTextureUsed(this);
+			if (!Resident)
+				return;
+		}
+
 		const COpenGLCoreTexture* prevTexture = Driver->getCacheHandler()->getTextureCache().get(0);
 		Driver->getCacheHandler()->getTextureCache().set(0, this);
 
@@ -451,8 +389,159 @@ public:
 		return StatesCache;
 	}
 
+	u32 getImageMemorySize() const override
+	{
+		u32 size = 0;
+
+		for (u32 i = 0; i < Images.size(); ++i)
+		{
+			size += Images[i]->getImageDataSizeInBytes();
+			if (Images[i]->getMipMapsData())
+				size += Images[i]->getMipMapsDataSize();
+		}
+
+		return size;
+	}
+
+	bool evict() override
+	{
+		if (!TextureName || IsRenderTarget || LockImage)
+			return false;
+
+		Driver->getCacheHandler()->getTextureCache().remove(this);
+
+		glDeleteTextures(1, &TextureName);
+		TextureName = 0;
+		Resident = false;
+
+		// the sampler states belong to the deleted texture object
+		StatesCache.IsCached = false;
+
+		return true;
+	}
+
+	bool restore(const core::array<IImage*>& images) override
+	{
+		if (Resident)
+			return true;
+
+		if (KeepImage)
+			createTexture(Images);
+		else if (images.size() > 0)
+		{
+			// the file might have changed since the texture was created
+			bool convert = false;
+			for (u32 i = 0; i < images.size(); ++i)
+			{
+				if (images[i]->getDimension() == OriginalSize && images[i]->getColorFormat() == OriginalColorFormat)
+					continue;
+
+				if (IImage::isCompressedFormat(images[i]->getColorFormat()) || IImage::isCompressedFormat(ColorFormat))
+				{
+					os::Printer::log("COpenGLCoreTexture: Reloaded image doesn't fit the evicted texture", getName().getPath(), ELL_WARNING);
+					return false;
+				}
+				convert = true;
+			}
+
+			createTexture(images, convert);
+		}
+
+		return Resident;
+	}
+
 protected:
 
+	//! Creates the texture object and uploads the images with their mipmaps
+	/** \param convert Convert the images even if they were fine when the texture was created */
+	void createTexture(const core::array<IImage*>& images, bool convert = false)
+	{
+		const core::array<IImage*>* tmpImages = &images;
+
+		// restoring a texture which kept its images uploads them directly
+		if (&images != &Images && (KeepImage || convert || OriginalSize != Size || OriginalColorFormat != ColorFormat))
+		{
+			Images.set_used(images.size());
+
+			for (u32 i = 0; i < images.size(); ++i)
+			{
+				Images[i] = Driver->createImage(ColorFormat, Size);
+
+				if (images[i]->getDimension() == Size)
+					images[i]->copyTo(Images[i]);
+				else
+					images[i]->copyToScaling(Images[i]);
+
+				if ( images[i]->getMipMapsData() )
+				{
+					if ( !convert && OriginalSize == Size && OriginalColorFormat == ColorFormat )
+					{
+						Images[i]->setMipMapsData( images[i]->getMipMapsData(), false);
+					}
+					else
+					{
+						// TODO: handle at least mipmap with changing color format
+						os::Printer::log("COpenGLCoreTexture: Can't handle format changes for mipmap data. Mipmap data dropped", ELL_WARNING);
+					}
+				}
+			}
+
+			tmpImages = &Images;
+		}
+
+		glGenTextures(1, &TextureName);
+		Resident = true;
+
+		const COpenGLCoreTexture* prevTexture = Driver->getCacheHandler()->getTextureCache().get(0);
+		Driver->getCacheHandler()->getTextureCache().set(0, this);
+
+		glTexParameteri(TextureType, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(TextureType, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+#ifdef GL_GENERATE_MIPMAP_HINT
+		if (HasMipMaps)
+		{
+			if (Driver->getTextureCreationFlag(ETCF_OPTIMIZED_FOR_SPEED))
+				glHint(GL_GENERATE_MIPMAP_HINT, GL_FASTEST);
+			else if (Driver->getTextureCreationFlag(ETCF_OPTIMIZED_FOR_QUALITY))
+				glHint(GL_GENERATE_MIPMAP_HINT, GL_NICEST);
+			else
+				glHint(GL_GENERATE_MIPMAP_HINT, GL_DONT_CARE);
+		}
+#endif
+
+#if !defined(IRR_OPENGL_HAS_glGenerateMipmap) && defined(GL_GENERATE_MIPMAP)
+		if (HasMipMaps)
+			glTexParameteri(TextureType, GL_GENERATE_MIPMAP, LegacyAutoGenerateMipMaps ? GL_TRUE : GL_FALSE);
+#endif
+
+		for (u32 i = 0; i < (*tmpImages).size(); ++i)
+			uploadTexture(true, i, 0, (*tmpImages)[i]->getData());
+
+		if (HasMipMaps && !LegacyAutoGenerateMipMaps)
+		{
+			// Create mipmaps (either from image mipmaps or generate them)
+			for (u32 i = 0; i < (*tmpImages).size(); ++i)
+			{
+				void* mipmapsData = (*tmpImages)[i]->getMipMapsData();
+				regenerateMipMapLevels(mipmapsData, i);
+			}
+		}
+
+		if (!KeepImage)
+		{
+			for (u32 i = 0; i < Images.size(); ++i)
+				Images[i]->drop();
+
+			Images.clear();
+		}
+
+		Driver->getCacheHandler()->getTextureCache().set(0, prevTexture);
+
+		Driver->testGLError(__LINE__);
+	}
+
+
 	void * getLockImageData(irr::u32 miplevel) const
 	{
 		if ( KeepImage && MipLevelStored > 0
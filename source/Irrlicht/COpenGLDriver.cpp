@@ -739,6 +739,13 @@ void COpenGLDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCoun
 	if (!primitiveCount || !vertexCount)
 		return;
 
+	// quantized vertices are decoded by drawMeshBuffer()
+	if (vType == EVT_COMPACT)
+	{
+		logCompactVerticesUnsupported();
+		return;
+	}
+
 	if (!checkPrimitiveCount(primitiveCount))
 		return;
 
@@ -777,6 +784,8 @@ void COpenGLDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCoun
 				case EVT_TANGENTS:
 					glColorPointer(colorSize, GL_UNSIGNED_BYTE, sizeof(S3DVertexTangents), &(static_cast<const S3DVertexTangents*>(vertices))[0].Color);
 					break;
+				default:
+					break;
 			}
 		}
 		else
@@ -872,6 +881,8 @@ void COpenGLDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCoun
 					glTexCoordPointer(3, GL_FLOAT, sizeof(S3DVertexTangents), buffer_offset(48));
 			}
 			break;
+		default:
+			break;
 	}
 
 	renderArray(indexList, primitiveCount, pType, iType);
@@ -932,6 +943,8 @@ void COpenGLDriver::getColorBuffer(const void* vertices, u32 vertexCount, E_VERT
 			}
 		}
 		break;
+		default:
+			break;
 	}
 }
 
@@ -1046,6 +1059,13 @@ void COpenGLDriver::draw2DVertexPrimitiveList(const void* vertices, u32 vertexCo
 	if (!primitiveCount || !vertexCount)
 		return;
 
+	// quantized vertices are decoded by drawMeshBuffer()
+	if (vType == EVT_COMPACT)
+	{
+		logCompactVerticesUnsupported();
+		return;
+	}
+
 	if (!checkPrimitiveCount(primitiveCount))
 		return;
 
@@ -1095,6 +1115,8 @@ void COpenGLDriver::draw2DVertexPrimitiveList(const void* vertices, u32 vertexCo
 				case EVT_TANGENTS:
 					glColorPointer(colorSize, GL_UNSIGNED_BYTE, sizeof(S3DVertexTangents), &(static_cast<const S3DVertexTangents*>(vertices))[0].Color);
 					break;
+				default:
+					break;
 			}
 		}
 		else
@@ -1166,6 +1188,8 @@ void COpenGLDriver::draw2DVertexPrimitiveList(const void* vertices, u32 vertexCo
 				glVertexPointer(2, GL_FLOAT, sizeof(S3DVertexTangents), buffer_offset(0));
 			}
 
+			break;
+		default:
 			break;
 	}
 
@@ -0,0 +1,401 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CPackReader.h"
+
+#include "os.h"
+#include "coreutil.h"
+#include "CMemoryFile.h"
+#include "CMappedReadFile.h"
+#include "CInflateReadFile.h"
+#include <string.h>
+
+namespace irr
+{
+namespace io
+{
+
+//! 'IPAK' little endian
+static const u32 PACK_SIG = 0x4b415049;
+static const u32 PACK_VERSION = 1;
+//! Alignment of stored entries, the page size of most systems
+static const u32 PACK_ALIGNMENT = 4096;
+
+
+#ifdef __BIG_ENDIAN__
+static void byteswap(SPackHeader& header)
+{
+	header.Sig = os::Byteswap::byteswap(header.Sig);
+	header.Version = os::Byteswap::byteswap(header.Version);
+	header.EntryCount = os::Byteswap::byteswap(header.EntryCount);
+	header.Alignment = os::Byteswap::byteswap(header.Alignment);
+	header.DirectoryOffset = os::Byteswap::byteswap(header.DirectoryOffset);
+	header.NamesSize = os::Byteswap::byteswap(header.NamesSize);
+}
+
+static void byteswap(SPackEntry& entry)
+{
+	entry.Offset = os::Byteswap::byteswap(entry.Offset);
+	entry.Size = os::Byteswap::byteswap(entry.Size);
+	entry.UncompressedSize = os::Byteswap::byteswap(entry.UncompressedSize);
+	entry.NameOffset = os::Byteswap::byteswap(entry.NameOffset);
+	entry.NameLength = os::Byteswap::byteswap(entry.NameLength);
+	entry.Flags = os::Byteswap::byteswap(entry.Flags);
+}
+#endif
+
+
+// -----------------------------------------------------------------------------
+// pack loader
+// -----------------------------------------------------------------------------
+
+//! Constructor
+CArchiveLoaderPack::CArchiveLoaderPack(io::IFileSystem* fs)
+: FileSystem(fs)
+{
+	#ifdef _DEBUG
+	setDebugName("CArchiveLoaderPack");
+	#endif
+}
+
+//! returns true if the file maybe is able to be loaded by this class
+bool CArchiveLoaderPack::isALoadableFileFormat(const io::path& filename) const
+{
+	return core::hasFileExtension(filename, "ipk");
+}
+
+//! Check to see if the loader can create archives of this type.
+bool CArchiveLoaderPack::isALoadableFileFormat(E_FILE_ARCHIVE_TYPE fileType) const
+{
+	return fileType == EFAT_IRR_PACK;
+}
+
+//! Check if the file might be loaded by this class
+bool CArchiveLoaderPack::isALoadableFileFormat(io::IReadFile* file) const
+{
+	u32 sig = 0;
+	file->read(&sig, 4);
+#ifdef __BIG_ENDIAN__
+	sig = os::Byteswap::byteswap(sig);
+#endif
+	return sig == PACK_SIG;
+}
+
+//! Creates an archive from the filename, mapping it if possible
+IFileArchive* CArchiveLoaderPack::createArchive(const io::path& filename, bool ignoreCase, bool ignorePaths) const
+{
+	IFileArchive *archive = 0;
+	io::IReadFile* file = FileSystem->createAndOpenFile(filename);
+
+	// small files on disk are not mapped by the file system, but
+	// stored entries are only views into the pack when it is
+	if (file && !file->getMappedData() && file->getType() == ERFT_READ_FILE)
+	{
+		io::IReadFile* mapped = CMappedReadFile::createMappedReadFile(file->getFileName(), 0);
+		if (mapped)
+		{
+			file->drop();
+			file = mapped;
+		}
+	}
+
+	if (file)
+	{
+		archive = createArchive(file, ignoreCase, ignorePaths);
+		file->drop();
+	}
+
+	return archive;
+}
+
+//! creates/loads an archive from the file.
+//! \return Pointer to the created archive. Returns 0 if loading failed.
+IFileArchive* CArchiveLoaderPack::createArchive(io::IReadFile* file, bool ignoreCase, bool ignorePaths) const
+{
+	if (!file)
+		return 0;
+
+	CPackReader* archive = new CPackReader(file, ignoreCase, ignorePaths);
+	if (!archive->readDirectory())
+	{
+		os::Printer::log("Broken pack archive", file->getFileName(), ELL_ERROR);
+		archive->drop();
+		return 0;
+	}
+	return archive;
+}
+
+
+// -----------------------------------------------------------------------------
+// pack archive
+// -----------------------------------------------------------------------------
+
+CPackReader::CPackReader(IReadFile* file, bool ignoreCase, bool ignorePaths)
+ : CFileList((file ? file->getFileName() : io::path("")), ignoreCase, ignorePaths), File(file)
+{
+	#ifdef _DEBUG
+	setDebugName("CPackReader");
+	#endif
+
+	if (File)
+		File->grab();
+}
+
+CPackReader::~CPackReader()
+{
+	if (File)
+		File->drop();
+}
+
+
+//! get the archive type
+E_FILE_ARCHIVE_TYPE CPackReader::getType() const
+{
+	return EFAT_IRR_PACK;
+}
+
+const IFileList* CPackReader::getFileList() const
+{
+	return this;
+}
+
+
+//! reads the directory, returns false if the archive is broken
+bool CPackReader::readDirectory()
+{
+	if (!File)
+		return false;
+
+	SPackHeader header;
+	if (File->readAt(&header, sizeof(header), 0) != sizeof(header))
+		return false;
+#ifdef __BIG_ENDIAN__
+	byteswap(header);
+#endif
+
+	const u64 fileSize = (u64)File->getSize();
+	const u64 directorySize = (u64)header.EntryCount * sizeof(SPackEntry) + header.NamesSize;
+	if (header.Sig != PACK_SIG || header.Version != PACK_VERSION ||
+		header.DirectoryOffset > fileSize || directorySize > fileSize - header.DirectoryOffset)
+		return false;
+
+	Entries.set_used(header.EntryCount);
+	core::array<c8> names;
+	names.set_used(header.NamesSize);
+	const long entriesSize = (long)(header.EntryCount * sizeof(SPackEntry));
+	if (File->readAt(Entries.pointer(), entriesSize, (long)header.DirectoryOffset) != (size_t)entriesSize ||
+		File->readAt(names.pointer(), names.size(), (long)header.DirectoryOffset + entriesSize) != names.size())
+		return false;
+
+	for (u32 i = 0; i < Entries.size(); ++i)
+	{
+		SPackEntry& entry = Entries[i];
+#ifdef __BIG_ENDIAN__
+		byteswap(entry);
+#endif
+		if (entry.Offset > fileSize || entry.Size > fileSize - entry.Offset ||
+			(u64)entry.NameOffset + entry.NameLength > names.size())
+			return false;
+
+		addItem(io::path(names.const_pointer() + entry.NameOffset, entry.NameLength),
+			(u32)entry.Offset, (u32)entry.UncompressedSize, false, i);
+	}
+
+	sort();
+	return true;
+}
+
+
+//! opens a file by file name
+IReadFile* CPackReader::createAndOpenFile(const io::path& filename)
+{
+	s32 index = findFile(filename, false);
+
+	if (index != -1)
+		return createAndOpenFile(index);
+
+	return 0;
+}
+
+//! opens a file by index
+IReadFile* CPackReader::createAndOpenFile(u32 index)
+{
+	if (index >= Files.size())
+		return 0;
+
+	const SPackEntry& entry = Entries[Files[index].ID];
+	const io::path& name = Files[index].FullName;
+
+	if (!entry.Flags)
+		return createLimitReadFile(name, File, (long)entry.Offset, (long)entry.Size);
+
+	if (entry.Flags != EPEF_DEFLATED)
+	{
+		os::Printer::log("Unsupported flags of pack entry", name, ELL_ERROR);
+		return 0;
+	}
+
+	IReadFile* compressed = createLimitReadFile(name, File, (long)entry.Offset, (long)entry.Size);
+	IReadFile* file = new CInflateReadFile(compressed, (long)entry.UncompressedSize, name);
+	compressed->drop();
+
+	// big entries are inflated while they are read, small ones at once
+	// so seeking in them stays cheap
+	if (entry.UncompressedSize >= 64 * 1024)
+		return file;
+
+	const size_t size = (size_t)entry.UncompressedSize;
+	c8* data = new c8[size];
+	const bool complete = file->read(data, size) == size;
+	file->drop();
+	if (!complete)
+	{
+		delete [] data;
+		return 0;
+	}
+	return new CMemoryReadFile(data, (long)size, name, true);
+}
+
+
+// -----------------------------------------------------------------------------
+// pack writer
+// -----------------------------------------------------------------------------
+
+//! Deflates data without zlib header, returns false on errors
+static bool deflateData(const c8* data, u32 size, core::array<c8>& packed)
+{
+	z_stream stream;
+	stream.zalloc = (alloc_func)0;
+	stream.zfree = (free_func)0;
+	stream.opaque = 0;
+	if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		return false;
+
+	packed.set_used(deflateBound(&stream, size));
+	stream.next_in = (Bytef*)data;
+	stream.avail_in = size;
+	stream.next_out = (Bytef*)packed.pointer();
+	stream.avail_out = packed.size();
+
+	const int err = deflate(&stream, Z_FINISH);
+	packed.set_used(stream.total_out);
+	deflateEnd(&stream);
+	return err == Z_STREAM_END;
+}
+
+
+//! Writes a pack archive, see IFileSystem::writePackArchive
+bool writePackArchive(IFileSystem* fileSystem, IWriteFile* file,
+	const core::array<io::path>& filenames, bool compress)
+{
+	if (!file)
+		return false;
+
+	// offsets in the pack are from the start of the file, which is
+	// where readers look for the header
+	if (file->getPos() != 0)
+	{
+		os::Printer::log("Pack archive must be written at the start of the file", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	static const c8 zeros[PACK_ALIGNMENT] = {};
+
+	// the header is written again when the directory is known
+	SPackHeader header;
+	memset(&header, 0, sizeof(header));
+	if (file->write(&header, sizeof(header)) != sizeof(header))
+		return false;
+	u64 pos = sizeof(header);
+
+	core::array<SPackEntry> entries;
+	core::stringc names;
+	core::array<c8> data;
+	core::array<c8> packed;
+
+	for (u32 i = 0; i < filenames.size(); ++i)
+	{
+		IReadFile* in = fileSystem->createAndOpenFile(filenames[i]);
+		if (!in)
+		{
+			os::Printer::log("Could not open file for pack archive", filenames[i], ELL_ERROR);
+			return false;
+		}
+
+		const u32 size = (u32)in->getSize();
+		data.set_used(size);
+		const bool complete = in->read(data.pointer(), size) == size;
+		in->drop();
+		if (!complete)
+		{
+			os::Printer::log("Could not read file for pack archive", filenames[i], ELL_ERROR);
+			return false;
+		}
+
+		io::path name = filenames[i];
+		name.replace('\\', '/');
+		const core::stringc utf8Name(name);
+		if (utf8Name.size() > 0xffff)
+		{
+			os::Printer::log("File name too long for pack archive", filenames[i], ELL_ERROR);
+			return false;
+		}
+
+		SPackEntry entry;
+		entry.UncompressedSize = size;
+		entry.NameOffset = names.size();
+		entry.NameLength = (u16)utf8Name.size();
+		entry.Flags = 0;
+
+		// only keep compressed data which is clearly smaller, stored
+		// entries can be used straight from the mapped archive
+		const c8* blob = data.const_pointer();
+		u32 blobSize = size;
+		if (compress && size && deflateData(data.const_pointer(), size, packed) &&
+			packed.size() < size - size / 8)
+		{
+			blob = packed.const_pointer();
+			blobSize = packed.size();
+			entry.Flags = EPEF_DEFLATED;
+		}
+		else
+		{
+			const u32 padding = (PACK_ALIGNMENT - (u32)(pos % PACK_ALIGNMENT)) % PACK_ALIGNMENT;
+			if (file->write(zeros, padding) != padding)
+				return false;
+			pos += padding;
+		}
+
+		entry.Offset = pos;
+		entry.Size = blobSize;
+		if (file->write(blob, blobSize) != blobSize)
+			return false;
+		pos += blobSize;
+
+		names += utf8Name;
+#ifdef __BIG_ENDIAN__
+		byteswap(entry);
+#endif
+		entries.push_back(entry);
+	}
+
+	header.Sig = PACK_SIG;
+	header.Version = PACK_VERSION;
+	header.EntryCount = entries.size();
+	header.Alignment = PACK_ALIGNMENT;
+	header.DirectoryOffset = pos;
+	header.NamesSize = names.size();
+#ifdef __BIG_ENDIAN__
+	byteswap(header);
+#endif
+
+	const size_t entriesSize = entries.size() * sizeof(SPackEntry);
+	return file->write(entries.const_pointer(), entriesSize) == entriesSize &&
+		file->write(names.c_str(), names.size()) == names.size() &&
+		file->seek(0) &&
+		file->write(&header, sizeof(header)) == sizeof(header) &&
+		file->seek((long)(pos + entriesSize + names.size()));
+}
+
+} // end namespace io
+} // end namespace irr
@@ -0,0 +1,132 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IReadFile.h"
+#include "IWriteFile.h"
+#include "irrArray.h"
+#include "IFileSystem.h"
+#include "CFileList.h"
+
+namespace irr
+{
+namespace io
+{
+	//! Flags of a pack entry
+	enum E_PACK_ENTRY_FLAGS
+	{
+		//! The entry is raw deflate data
+		EPEF_DEFLATED = 1
+	};
+
+// byte-align structures
+#include "irrpack.h"
+
+	//! Header at the start of a pack archive, all numbers are little endian
+	/** The header is followed by the data of the entries. Stored entries
+	start at multiples of Alignment, so they are page aligned when the
+	archive is mapped. The directory holds EntryCount SPackEntry and
+	then the names of all entries. */
+	struct SPackHeader
+	{
+		u32 Sig;			// 'IPAK' little endian (0x4b415049)
+		u32 Version;
+		u32 EntryCount;
+		u32 Alignment;
+		u64 DirectoryOffset;
+		u32 NamesSize;
+		u32 Reserved;
+	} PACK_STRUCT;
+
+	//! Directory entry of a pack archive
+	struct SPackEntry
+	{
+		//! Position of the data in the archive
+		u64 Offset;
+		//! Size of the data in the archive
+		u64 Size;
+		u64 UncompressedSize;
+		//! Position of the name in the names of the directory
+		u32 NameOffset;
+		u16 NameLength;
+		//! E_PACK_ENTRY_FLAGS
+		u16 Flags;
+	} PACK_STRUCT;
+
+// Default alignment
+#include "irrunpack.h"
+
+	//! Archiveloader capable of loading pack archives
+	class CArchiveLoaderPack : public IArchiveLoader
+	{
+	public:
+
+		//! Constructor
+		CArchiveLoaderPack(io::IFileSystem* fs);
+
+		//! returns true if the file maybe is able to be loaded by this class
+		//! based on the file extension (".ipk")
+		bool isALoadableFileFormat(const io::path& filename) const override;
+
+		//! Check if the file might be loaded by this class
+		bool isALoadableFileFormat(io::IReadFile* file) const override;
+
+		//! Check to see if the loader can create archives of this type.
+		bool isALoadableFileFormat(E_FILE_ARCHIVE_TYPE fileType) const override;
+
+		//! Creates an archive from the filename, mapping it if possible
+		IFileArchive* createArchive(const io::path& filename, bool ignoreCase, bool ignorePaths) const override;
+
+		//! creates/loads an archive from the file.
+		//! \return Pointer to the created archive. Returns 0 if loading failed.
+		io::IFileArchive* createArchive(io::IReadFile* file, bool ignoreCase, bool ignorePaths) const override;
+
+	private:
+		io::IFileSystem* FileSystem;
+	};
+
+	//! Reader of pack archives written by IFileSystem::writePackArchive
+	/** When the archive is mapped, stored entries are limited files
+	whose getMappedData() points right into the mapping, so they are
+	read without copies or system calls. */
+	class CPackReader : public virtual IFileArchive, virtual CFileList
+	{
+	public:
+
+		//! constructor
+		CPackReader(IReadFile* file, bool ignoreCase, bool ignorePaths);
+
+		//! destructor
+		virtual ~CPackReader();
+
+		//! opens a file by file name
+		IReadFile* createAndOpenFile(const io::path& filename) override;
+
+		//! opens a file by index
+		IReadFile* createAndOpenFile(u32 index) override;
+
+		//! returns the list of files
+		const IFileList* getFileList() const override;
+
+		//! get the archive type
+		E_FILE_ARCHIVE_TYPE getType() const override;
+
+		//! return the id of the file Archive
+		const io::path& getArchiveName() const override {return Path;}
+
+		//! reads the directory, returns false if the archive is broken
+		bool readDirectory();
+
+	private:
+
+		IReadFile* File;
+		core::array<SPackEntry> Entries;
+	};
+
+	//! Writes a pack archive, see IFileSystem::writePackArchive
+	bool writePackArchive(IFileSystem* fileSystem, IWriteFile* file,
+		const core::array<io::path>& filenames, bool compress);
+
+} // end namespace io
+} // end namespace irr
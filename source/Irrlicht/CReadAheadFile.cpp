@@ -0,0 +1,230 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CReadAheadFile.h"
+#include "irrMath.h"
+#include <string.h>
+
+namespace irr
+{
+namespace io
+{
+
+//! Size of the blocks read ahead
+static const size_t READ_AHEAD_BLOCK_SIZE = 256 * 1024;
+
+//! Blocks in memory, one is read from while the others are filled
+static const u32 READ_AHEAD_BLOCK_COUNT = 3;
+
+
+CReadAheadFile::CReadAheadFile(IReadFile* source)
+	: Source(source), Size(source->getSize()), Pos(source->getPos()),
+	SourcePos(0), Allocated(false), End(false), Stop(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CReadAheadFile");
+	#endif
+
+	Source->grab();
+	Current.Data = 0;
+	Current.Start = 0;
+	Current.Size = 0;
+}
+
+
+CReadAheadFile::~CReadAheadFile()
+{
+	stop();
+	for (u8* data : Free)
+		delete [] data;
+
+	Source->drop();
+}
+
+
+//! returns how much was read
+size_t CReadAheadFile::read(void* buffer, size_t sizeToRead)
+{
+	os::CDeferredLog log;
+	size_t done = 0;
+	while (done < sizeToRead)
+	{
+		if (Current.Data && Pos >= Current.Start && Pos < Current.Start + (long)Current.Size)
+		{
+			const size_t offset = (size_t)(Pos - Current.Start);
+			const size_t amount = core::min_(sizeToRead - done, Current.Size - offset);
+			memcpy((u8*)buffer + done, Current.Data + offset, amount);
+			done += amount;
+			Pos += (long)amount;
+			continue;
+		}
+
+		if (!Worker.joinable())
+			start();
+
+		std::unique_lock<std::mutex> lock(Mutex);
+		if (Current.Data)
+		{
+			Free.push_back(Current.Data);
+			Current.Data = 0;
+			Wake.notify_all();
+		}
+
+		Wake.wait(lock, [this] { return !Ready.empty() || End; });
+		log.append(Log);
+		if (Ready.empty())
+			break;
+
+		Current = Ready.front();
+		Ready.pop_front();
+	}
+
+	// errors of the source are reported on the thread which reads
+	log.flush();
+	return done;
+}
+
+
+//! changes position in file, returns true if successful
+bool CReadAheadFile::seek(long finalPos, bool relativeMovement)
+{
+	if (relativeMovement)
+		finalPos += Pos;
+
+	if (finalPos < 0 || finalPos > Size)
+		return false;
+
+	if (Current.Data && finalPos >= Current.Start && finalPos <= Current.Start + (long)Current.Size)
+	{
+		Pos = finalPos;
+		return true;
+	}
+
+	if (Worker.joinable() && finalPos > Pos)
+	{
+		// skip blocks which were read ahead already
+		std::lock_guard<std::mutex> lock(Mutex);
+		while (!Ready.empty() && finalPos >= Ready.front().Start + (long)Ready.front().Size)
+		{
+			Free.push_back(Ready.front().Data);
+			Ready.pop_front();
+		}
+		if (!Ready.empty() && finalPos >= Ready.front().Start)
+		{
+			if (Current.Data)
+				Free.push_back(Current.Data);
+			Current = Ready.front();
+			Ready.pop_front();
+			Wake.notify_all();
+			Pos = finalPos;
+			return true;
+		}
+	}
+
+	stop();
+	const bool success = Source->seek(finalPos);
+	Pos = Source->getPos();
+	return success;
+}
+
+
+//! returns size of file
+long CReadAheadFile::getSize() const
+{
+	return Size;
+}
+
+
+//! returns where in the file we are.
+long CReadAheadFile::getPos() const
+{
+	return Pos;
+}
+
+
+//! returns name of file
+const io::path& CReadAheadFile::getFileName() const
+{
+	return Source->getFileName();
+}
+
+
+//! Starts the worker at the current position
+void CReadAheadFile::start()
+{
+	if (!Allocated)
+	{
+		for (u32 i = 0; i < READ_AHEAD_BLOCK_COUNT; ++i)
+			Free.push_back(new u8[READ_AHEAD_BLOCK_SIZE]);
+		Allocated = true;
+	}
+
+	// the source is at Pos when the worker isn't running
+	SourcePos = Pos;
+	Worker = std::thread(&CReadAheadFile::run, this);
+}
+
+
+//! Stops the worker and frees all blocks
+void CReadAheadFile::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Stop = true;
+	}
+	Wake.notify_all();
+	if (Worker.joinable())
+		Worker.join();
+	Log.flush();
+
+	Stop = false;
+	End = false;
+	if (Current.Data)
+		Free.push_back(Current.Data);
+	Current.Data = 0;
+	for (SBlock& block : Ready)
+		Free.push_back(block.Data);
+	Ready.clear();
+}
+
+
+//! Reads blocks of the source until stopped or at its end
+void CReadAheadFile::run()
+{
+	os::CDeferredLog log;
+	os::Printer::setDeferredLog(&log);
+
+	std::unique_lock<std::mutex> lock(Mutex);
+	while (true)
+	{
+		Wake.wait(lock, [this] { return Stop || !Free.empty(); });
+		if (Stop)
+			return;
+
+		SBlock block;
+		block.Data = Free.front();
+		block.Start = SourcePos;
+		Free.pop_front();
+
+		lock.unlock();
+		block.Size = Source->read(block.Data, READ_AHEAD_BLOCK_SIZE);
+		lock.lock();
+		Log.append(log);
+
+		SourcePos += (long)block.Size;
+		if (block.Size)
+			Ready.push_back(block);
+		else
+			Free.push_back(block.Data);
+
+		if (block.Size < READ_AHEAD_BLOCK_SIZE)
+			End = true;
+		Wake.notify_all();
+		if (End)
+			return;
+	}
+}
+
+
+} // end namespace io
+} // end namespace irr
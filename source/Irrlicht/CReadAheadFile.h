@@ -0,0 +1,98 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "IReadFile.h"
+#include "os.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace irr
+{
+namespace io
+{
+
+	//! Read file which reads its source ahead on a worker thread
+	/** Made for sources which are slow to read, like inflating ones,
+	when loaders read them from begin to end. While the loader works on
+	one block, the worker fills the next ones, and memory use stays
+	constant. The worker is started by the first read. Seeking out of
+	the blocks which were read ahead stops it and seeks the source.
+	What the source logs on the worker is logged by read() and seek(). */
+	class CReadAheadFile : public IReadFile
+	{
+	public:
+
+		//! \param source File to read, it is grabbed and must not be used elsewhere meanwhile
+		CReadAheadFile(IReadFile* source);
+
+		virtual ~CReadAheadFile();
+
+		//! returns how much was read
+		size_t read(void* buffer, size_t sizeToRead) override;
+
+		//! changes position in file, returns true if successful
+		bool seek(long finalPos, bool relativeMovement = false) override;
+
+		//! returns size of file
+		long getSize() const override;
+
+		//! returns where in the file we are.
+		long getPos() const override;
+
+		//! returns name of file
+		const io::path& getFileName() const override;
+
+		//! Get the type of the class implementing this interface
+		EREAD_FILE_TYPE getType() const override
+		{
+			return ERFT_READ_AHEAD_FILE;
+		}
+
+	private:
+
+		struct SBlock
+		{
+			u8* Data;
+			//! Position of the block in the source
+			long Start;
+			size_t Size;
+		};
+
+		//! Reads blocks of the source until stopped or at its end
+		void run();
+
+		//! Starts the worker at the current position
+		void start();
+
+		//! Stops the worker and frees all blocks
+		void stop();
+
+		IReadFile* Source;
+		long Size;
+		long Pos;
+		//! Block which is read from, Data is 0 if there is none
+		SBlock Current;
+
+		std::thread Worker;
+		std::mutex Mutex;
+		//! Signals filled blocks to the reader and free ones to the worker
+		std::condition_variable Wake;
+		//! Blocks filled by the worker, following Current
+		std::deque<SBlock> Ready;
+		//! Buffers for the worker to fill
+		std::deque<u8*> Free;
+		//! What the source logged on the worker
+		os::CDeferredLog Log;
+		//! Position in the source the worker reads next
+		long SourcePos;
+		bool Allocated;
+		bool End;
+		bool Stop;
+	};
+
+} // end namespace io
+} // end namespace irr
@@ -3,6 +3,13 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CReadFile.h"
+#include "CIOStatistics.h"
+
+#if (defined(_IRR_POSIX_API_) || defined(_IRR_OSX_PLATFORM_) || defined(_IRR_ANDROID_PLATFORM_))
+	#include <errno.h>
+	#include <unistd.h>
+	#define _IRR_HAS_PREAD_
+#endif
 
 namespace irr
 {
@@ -34,7 +41,37 @@ size_t CReadFile::read(void* buffer, size_t sizeToRead)
 	if (!isOpen())
 		return 0;
 
-	return fread(buffer, 1, sizeToRead, File);
+	const size_t count = fread(buffer, 1, sizeToRead, File);
+	getIOStatistics().addBytesRead(count);
+	return count;
+}
+
+
+//! reads from a position, thread safe
+size_t CReadFile::readAt(void* buffer, size_t sizeToRead, long pos)
+{
+	if (!isOpen())
+		return 0;
+
+#ifdef _IRR_HAS_PREAD_
+	// pread neither uses nor changes the file offset or the stdio buffer
+	size_t total = 0;
+	while (total < sizeToRead)
+	{
+		const ssize_t r = pread(fileno(File), (c8*)buffer + total, sizeToRead - total, pos + (long)total);
+		if (r < 0 && errno == EINTR)
+			continue;
+		if (r <= 0)
+			break;
+		total += r;
+	}
+	getIOStatistics().addBytesRead(total);
+	return total;
+#else
+	// counted by read()
+	std::lock_guard<std::mutex> lock(ReadAtMutex);
+	return IReadFile::readAt(buffer, sizeToRead, pos);
+#endif
 }
 
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <stdio.h>
+#include <mutex>
 #include "IReadFile.h"
 #include "irrString.h"
 
@@ -28,6 +29,9 @@ namespace io
 		//! returns how much was read
 		size_t read(void* buffer, size_t sizeToRead) override;
 
+		//! reads from a position, thread safe
+		size_t readAt(void* buffer, size_t sizeToRead, long pos) override;
+
 		//! changes position in file, returns true if successful
 		bool seek(long finalPos, bool relativeMovement = false) override;
 
@@ -63,6 +67,9 @@ namespace io
 		FILE* File;
 		long FileSize;
 		io::path Filename;
+
+		//! Serializes readAt where there is no pread
+		std::mutex ReadAtMutex;
 	};
 
 } // end namespace io
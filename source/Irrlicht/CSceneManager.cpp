@@ -7,6 +7,7 @@
 #include "IFileSystem.h"
 #include "SAnimatedMesh.h"
 #include "CMeshCache.h"
+#include "CIOStatistics.h"
 #include "IGUIEnvironment.h"
 #include "IMaterialRenderer.h"
 #include "IReadFile.h"
@@ -18,6 +19,7 @@
 #include "CXMeshFileLoader.h"
 #include "COBJMeshFileLoader.h"
 #include "CB3DMeshFileLoader.h"
+#include "CGLTFMeshFileLoader.h"
 #include "CBillboardSceneNode.h"
 #include "CAnimatedMeshSceneNode.h"
 #include "CCameraSceneNode.h"
@@ -33,9 +35,9 @@ namespace scene
 {
 
 //! constructor
-CSceneManager::CSceneManager(video::IVideoDriver* driver,
+CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 		gui::ICursorControl* cursorControl, IMeshCache* cache)
-: ISceneNode(0, 0), Driver(driver),
+: ISceneNode(0, 0), Driver(driver), FileSystem(fs),
 	CursorControl(cursorControl),
 	ActiveCamera(0), ShadowColor(150,0,0,0), AmbientLight(0,0,0,0), Parameters(0),
 	MeshCache(cache), CurrentRenderPass(ESNRP_NONE)
@@ -51,6 +53,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver,
 	if (Driver)
 		Driver->grab();
 
+	if (FileSystem)
+		FileSystem->grab();
+
 	if (CursorControl)
 		CursorControl->grab();
 
@@ -75,6 +80,7 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver,
 	MeshLoaderList.push_back(new CXMeshFileLoader(this));
 	MeshLoaderList.push_back(new COBJMeshFileLoader(this));
 	MeshLoaderList.push_back(new CB3DMeshFileLoader(this));
+	MeshLoaderList.push_back(new CGLTFMeshFileLoader(this, FileSystem));
 }
 
 
@@ -89,6 +95,9 @@ CSceneManager::~CSceneManager()
 	if (Driver)
 		Driver->removeAllHardwareBuffers();
 
+	if (FileSystem)
+		FileSystem->drop();
+
 	if (CursorControl)
 		CursorControl->drop();
 
@@ -148,7 +157,9 @@ IAnimatedMesh* CSceneManager::getUncachedMesh(io::IReadFile* file, const io::pat
 		{
 			// reset file to avoid side effects of previous calls to createMesh
 			file->seek(0);
+			const u64 start = io::CIOStatistics::getTime();
 			msh = MeshLoaderList[i]->createMesh(file);
+			io::getIOStatistics().addLoaderTime("mesh", filename, io::CIOStatistics::getTime() - start);
 			if (msh)
 			{
 				MeshCache->addMesh(cachename, msh);
@@ -837,7 +848,7 @@ IMeshCache* CSceneManager::getMeshCache()
 //! Creates a new scene manager.
 ISceneManager* CSceneManager::createNewSceneManager(bool cloneContent)
 {
-	CSceneManager* manager = new CSceneManager(Driver, CursorControl, MeshCache);
+	CSceneManager* manager = new CSceneManager(Driver, FileSystem, CursorControl, MeshCache);
 
 	if (cloneContent)
 		manager->cloneMembers(this, manager);
@@ -874,9 +885,10 @@ IMeshWriter* CSceneManager::createMeshWriter(EMESH_WRITER_TYPE type)
 
 
 // creates a scenemanager
-ISceneManager* createSceneManager(video::IVideoDriver* driver, gui::ICursorControl* cursorcontrol)
+ISceneManager* createSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
+		gui::ICursorControl* cursorcontrol)
 {
-	return new CSceneManager(driver, cursorcontrol, nullptr);
+	return new CSceneManager(driver, fs, cursorcontrol, nullptr);
 }
 
 
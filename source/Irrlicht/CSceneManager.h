@@ -30,7 +30,8 @@ namespace scene
 	public:
 
 		//! constructor
-		CSceneManager(video::IVideoDriver* driver, gui::ICursorControl* cursorControl, IMeshCache* cache = 0);
+		CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
+				gui::ICursorControl* cursorControl, IMeshCache* cache = 0);
 
 		//! destructor
 		virtual ~CSceneManager();
@@ -270,6 +271,9 @@ namespace scene
 		//! video driver
 		video::IVideoDriver* Driver;
 
+		//! file system
+		io::IFileSystem* FileSystem;
+
 		//! cursor control
 		gui::ICursorControl* CursorControl;
 
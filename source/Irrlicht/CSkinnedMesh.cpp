@@ -987,9 +987,10 @@ void CSkinnedMesh::finalize()
 	LastAnimatedFrame=-1;
 	SkinnedLastFrame=false;
 
-	//calculate bounding box
+	//narrow vertex types, keeping second uvs for shaders, and calculate bounding box
 	for (i=0; i<LocalBuffers.size(); ++i)
 	{
+		LocalBuffers[i]->compact();
 		LocalBuffers[i]->recalculateBoundingBox();
 	}
 
@@ -1122,6 +1123,10 @@ void CSkinnedMesh::finalize()
 					Key->frame=EndFrame;
 				}
 			}
+
+			PositionKeys.shrink_to_fit();
+			ScaleKeys.shrink_to_fit();
+			RotationKeys.shrink_to_fit();
 		}
 
 		if ( redundantPosKeys > 0 )
@@ -0,0 +1,454 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CTextureAtlas.h"
+#include "CImage.h"
+#include "CColorConverter.h"
+#include "IVideoDriver.h"
+#include "IMesh.h"
+#include "IMeshBuffer.h"
+#include "os.h"
+#include <algorithm>
+#include <cstring>
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+
+u32 roundUp(u32 value, u32 alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+u32 nextPowerOfTwo(u32 value)
+{
+	u32 result = 1;
+	while (result < value)
+		result <<= 1;
+	return result;
+}
+
+//! Number of mipmap levels of an image, counting the image itself
+u32 getLevelCount(const core::dimension2d<u32>& size)
+{
+	u32 levels = 1;
+	for (u32 longest = core::max_(size.Width, size.Height); longest > 1; longest >>= 1)
+		++levels;
+	return levels;
+}
+
+//! Size of a level, which is at least 1x1
+core::dimension2d<u32> getLevelSize(const core::dimension2d<u32>& size, u32 level)
+{
+	return core::dimension2d<u32>(core::max_(size.Width >> level, 1u), core::max_(size.Height >> level, 1u));
+}
+
+const u32* getLevelData(const IImage* image, u32 level)
+{
+	return (const u32*)(level ? image->getMipMapsData(level) : image->getData());
+}
+
+} // end anonymous namespace
+
+
+CTextureAtlas::CTextureAtlas(IVideoDriver* driver, const io::path& name, const core::dimension2d<u32>& pageSize, u32 padding)
+	: Driver(driver), Name(name), PageSize(pageSize), Padding(padding), Built(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CTextureAtlas");
+	#endif
+
+	// the lowest set bit of the padding, the padding then halves exactly down to one pixel
+	Alignment = padding ? (padding & (~padding + 1)) : 1;
+}
+
+
+CTextureAtlas::~CTextureAtlas()
+{
+	for (u32 i = 0; i < Images.size(); ++i)
+	{
+		if (Images[i].Image)
+			Images[i].Image->drop();
+	}
+	for (u32 i = 0; i < Pages.size(); ++i)
+	{
+		if (Pages[i])
+			Pages[i]->drop();
+	}
+}
+
+
+s32 CTextureAtlas::addImage(const io::path& name, IImage* image)
+{
+	if (Built)
+	{
+		os::Printer::log("Can not add images to a texture atlas after building it", name, ELL_WARNING);
+		return -1;
+	}
+
+	if (!image || IImage::isCompressedFormat(image->getColorFormat()) ||
+		!CColorConverter::canConvertFormat(image->getColorFormat(), ECF_A8R8G8B8))
+	{
+		os::Printer::log("Unsupported image for texture atlas", name, ELL_WARNING);
+		return -1;
+	}
+
+	const s32 existing = getHandle(name);
+	if (existing >= 0)
+		return existing;
+
+	SImage entry;
+	entry.Image = image;
+	entry.Slot.set(0, 0);
+	entry.SlotSize.set(roundUp(image->getDimension().Width + 2 * Padding, Alignment),
+		roundUp(image->getDimension().Height + 2 * Padding, Alignment));
+	entry.Entry.Page = 0;
+	entry.Packed = false;
+	image->grab();
+
+	const s32 handle = (s32)Images.size();
+	Images.push_back(entry);
+	NameIndex[name] = handle;
+	return handle;
+}
+
+
+s32 CTextureAtlas::getHandle(const io::path& name) const
+{
+	const auto it = NameIndex.find(name);
+	return it != NameIndex.end() ? it->second : -1;
+}
+
+
+bool CTextureAtlas::build()
+{
+	if (Built)
+		return false;
+	Built = true;
+
+	// tall images first keep the skyline flat
+	core::array<u32> order(Images.size());
+	for (u32 i = 0; i < Images.size(); ++i)
+		order.push_back(i);
+	std::stable_sort(order.pointer(), order.pointer() + order.size(), [this](u32 a, u32 b) {
+		const core::dimension2d<u32>& sa = Images[a].SlotSize;
+		const core::dimension2d<u32>& sb = Images[b].SlotSize;
+		return sa.Height != sb.Height ? sa.Height > sb.Height : sa.Width > sb.Width;
+	});
+
+	bool allPacked = true;
+	core::array<SPage> pages;
+	for (u32 i = 0; i < order.size(); ++i)
+	{
+		SImage& image = Images[order[i]];
+		if (image.SlotSize.Width > PageSize.Width || image.SlotSize.Height > PageSize.Height)
+		{
+			os::Printer::log("Image is too big for the texture atlas page size", ELL_WARNING);
+			allPacked = false;
+			continue;
+		}
+
+		u32 page = 0;
+		u32 node = 0;
+		core::vector2d<u32> pos;
+		while (page < pages.size() && !findPosition(pages[page], image.SlotSize, node, pos))
+			++page;
+
+		if (page == pages.size())
+		{
+			SPage empty;
+			SSkylineNode ground = {0, 0, PageSize.Width};
+			empty.Skyline.push_back(ground);
+			empty.Used.set(0, 0);
+			pages.push_back(empty);
+			findPosition(pages[page], image.SlotSize, node, pos);
+		}
+
+		placeSlot(pages[page], node, pos, image.SlotSize);
+		image.Slot = pos;
+		image.Entry.Page = page;
+		image.Packed = true;
+	}
+
+	for (u32 page = 0; page < pages.size(); ++page)
+	{
+		// the last pages are often mostly empty
+		const core::dimension2d<u32> size(core::min_(nextPowerOfTwo(pages[page].Used.Width), PageSize.Width),
+			core::min_(nextPowerOfTwo(pages[page].Used.Height), PageSize.Height));
+
+		for (u32 i = 0; i < Images.size(); ++i)
+		{
+			SImage& image = Images[i];
+			if (!image.Packed || image.Entry.Page != page)
+				continue;
+
+			const core::dimension2d<u32>& imageSize = image.Image->getDimension();
+			image.Entry.Rect = core::rect<s32>(image.Slot.X + Padding, image.Slot.Y + Padding,
+				image.Slot.X + Padding + imageSize.Width, image.Slot.Y + Padding + imageSize.Height);
+			image.Entry.TCoords = core::rect<f32>(
+				(f32)image.Entry.Rect.UpperLeftCorner.X / size.Width, (f32)image.Entry.Rect.UpperLeftCorner.Y / size.Height,
+				(f32)image.Entry.Rect.LowerRightCorner.X / size.Width, (f32)image.Entry.Rect.LowerRightCorner.Y / size.Height);
+		}
+
+		ITexture* texture = createPage(page, size);
+		if (!texture)
+			allPacked = false;
+		Pages.push_back(texture);
+	}
+
+	// the pixels live in the page textures now
+	for (u32 i = 0; i < Images.size(); ++i)
+	{
+		Images[i].Image->drop();
+		Images[i].Image = 0;
+	}
+
+	return allPacked;
+}
+
+
+bool CTextureAtlas::findPosition(const SPage& page, const core::dimension2d<u32>& size, u32& node, core::vector2d<u32>& pos) const
+{
+	const core::array<SSkylineNode>& skyline = page.Skyline;
+	bool found = false;
+	for (u32 i = 0; i < skyline.size(); ++i)
+	{
+		const u32 x = skyline[i].X;
+		if (x + size.Width > PageSize.Width)
+			break;
+
+		// the slot rests on the highest node below it
+		u32 y = 0;
+		u32 covered = 0;
+		for (u32 j = i; covered < size.Width; ++j)
+		{
+			y = core::max_(y, skyline[j].Y);
+			covered += skyline[j].Width;
+		}
+
+		if (y + size.Height <= PageSize.Height && (!found || y < pos.Y))
+		{
+			found = true;
+			node = i;
+			pos.set(x, y);
+		}
+	}
+	return found;
+}
+
+
+void CTextureAtlas::placeSlot(SPage& page, u32 node, const core::vector2d<u32>& pos, const core::dimension2d<u32>& size)
+{
+	core::array<SSkylineNode>& skyline = page.Skyline;
+	const SSkylineNode top = {pos.X, pos.Y + size.Height, size.Width};
+	skyline.insert(top, node);
+
+	// cut away the nodes below the new one
+	const u32 right = pos.X + size.Width;
+	for (u32 i = node + 1; i < skyline.size();)
+	{
+		if (skyline[i].X >= right)
+			break;
+
+		const u32 overlap = right - skyline[i].X;
+		if (overlap >= skyline[i].Width)
+		{
+			skyline.erase(i);
+			continue;
+		}
+		skyline[i].X += overlap;
+		skyline[i].Width -= overlap;
+		break;
+	}
+
+	for (u32 i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].Y == skyline[i + 1].Y)
+		{
+			skyline[i].Width += skyline[i + 1].Width;
+			skyline.erase(i + 1);
+		}
+		else
+			++i;
+	}
+
+	page.Used.Width = core::max_(page.Used.Width, right);
+	page.Used.Height = core::max_(page.Used.Height, pos.Y + size.Height);
+}
+
+
+ITexture* CTextureAtlas::createPage(u32 page, const core::dimension2d<u32>& size)
+{
+	const bool mipMaps = Driver->getTextureCreationFlag(ETCF_CREATE_MIP_MAPS);
+	const u32 pageLevels = mipMaps ? getLevelCount(size) : 1;
+
+	// levels which are drawn from the mipmaps of the images, the padding is at least a pixel there
+	u32 drawnLevels = 1;
+	while (drawnLevels < pageLevels && (1u << drawnLevels) <= Alignment)
+		++drawnLevels;
+
+	IImage* pageImage = new CImage(ECF_A8R8G8B8, size);
+	memset(pageImage->getData(), 0, pageImage->getImageDataSizeInBytes());
+	u8* mipMapsData = pageLevels > 1 ? new u8[pageImage->getMipMapsDataSize()] : 0;
+	if (mipMapsData)
+		memset(mipMapsData, 0, pageImage->getMipMapsDataSize());
+
+	for (u32 i = 0; i < Images.size(); ++i)
+	{
+		const SImage& image = Images[i];
+		if (!image.Packed || image.Entry.Page != page)
+			continue;
+
+		const core::dimension2d<u32>& imageSize = image.Image->getDimension();
+		IImage* tile = new CImage(ECF_A8R8G8B8, imageSize);
+		for (u32 y = 0; y < imageSize.Height; ++y)
+		{
+			CColorConverter::convert_viaFormat((const u8*)image.Image->getData() + (size_t)y * image.Image->getPitch(),
+				image.Image->getColorFormat(), imageSize.Width, (u8*)tile->getData() + (size_t)y * tile->getPitch(), ECF_A8R8G8B8);
+		}
+		if (drawnLevels > 1)
+			tile->generateMipMaps();
+		const u32 tileLevels = tile->getMipMapsData() ? getLevelCount(imageSize) : 1;
+
+		u8* level = (u8*)pageImage->getData();
+		for (u32 k = 0; k < drawnLevels; ++k)
+		{
+			const core::dimension2d<u32> levelSize = getLevelSize(size, k);
+			const u32 tileLevel = core::min_(k, tileLevels - 1);
+			const core::dimension2d<u32> tileSize = getLevelSize(imageSize, tileLevel);
+			const u32* src = getLevelData(tile, tileLevel);
+
+			// fill the whole slot, repeating the border of the image into the padding
+			const s32 left = (image.Slot.X + Padding) >> k;
+			const s32 top = (image.Slot.Y + Padding) >> k;
+			const u32 x1 = core::min_((image.Slot.X + image.SlotSize.Width) >> k, levelSize.Width);
+			const u32 y1 = core::min_((image.Slot.Y + image.SlotSize.Height) >> k, levelSize.Height);
+			for (u32 y = image.Slot.Y >> k; y < y1; ++y)
+			{
+				const u32* srcRow = src + core::clamp((s32)y - top, 0, (s32)tileSize.Height - 1) * tileSize.Width;
+				u32* dst = (u32*)level + (size_t)y * levelSize.Width;
+				for (u32 x = image.Slot.X >> k; x < x1; ++x)
+					dst[x] = srcRow[core::clamp((s32)x - left, 0, (s32)tileSize.Width - 1)];
+			}
+
+			level = (k == 0 ? mipMapsData : level + levelSize.getArea() * 4);
+		}
+		tile->drop();
+	}
+
+	if (mipMapsData)
+	{
+		// below the drawn levels the padding is gone, so the rest is filtered from the last drawn level
+		u8* last = mipMapsData;
+		for (u32 k = 1; k + 1 < drawnLevels; ++k)
+			last += getLevelSize(size, k).getArea() * 4;
+
+		if (drawnLevels < pageLevels)
+		{
+			const u32 lastLevel = drawnLevels - 1;
+			IImage* source = new CImage(ECF_A8R8G8B8, getLevelSize(size, lastLevel),
+				lastLevel ? (void*)last : pageImage->getData(), true, false);
+			source->generateMipMaps();
+			u8* rest = lastLevel ? last + source->getImageDataSizeInBytes() : mipMapsData;
+			memcpy(rest, source->getMipMapsData(), source->getMipMapsDataSize());
+			source->drop();
+		}
+		pageImage->setMipMapsData(mipMapsData, true, true);
+	}
+
+	io::path pageName(Name);
+	pageName += "#";
+	pageName += io::path(page);
+	ITexture* texture = Driver->addTexture(pageName, pageImage);
+	pageImage->drop();
+
+	if (texture)
+		texture->grab();
+	else
+		os::Printer::log("Could not create texture atlas page", pageName, ELL_ERROR);
+	return texture;
+}
+
+
+u32 CTextureAtlas::getPageCount() const
+{
+	return Pages.size();
+}
+
+
+ITexture* CTextureAtlas::getPageTexture(u32 page) const
+{
+	return page < Pages.size() ? Pages[page] : 0;
+}
+
+
+const STextureAtlasEntry* CTextureAtlas::getEntry(s32 handle) const
+{
+	if (handle < 0 || (u32)handle >= Images.size() || !Images[handle].Packed || !Built)
+		return 0;
+	return &Images[handle].Entry;
+}
+
+
+core::vector2df CTextureAtlas::remapTCoords(s32 handle, const core::vector2df& tcoords) const
+{
+	const STextureAtlasEntry* entry = getEntry(handle);
+	if (!entry)
+		return tcoords;
+
+	const core::rect<f32>& rect = entry->TCoords;
+	return core::vector2df(rect.UpperLeftCorner.X + tcoords.X * rect.getWidth(),
+		rect.UpperLeftCorner.Y + tcoords.Y * rect.getHeight());
+}
+
+
+bool CTextureAtlas::remapMeshBuffer(scene::IMeshBuffer* buffer, s32 handle) const
+{
+	const STextureAtlasEntry* entry = getEntry(handle);
+	if (!buffer || !entry || !Pages[entry->Page])
+		return false;
+
+	const u32 count = buffer->getVertexCount();
+	const f32 tolerance = 1.f / 4096.f;
+	for (u32 i = 0; i < count; ++i)
+	{
+		const core::vector2df& tcoords = buffer->getTCoords(i);
+		if (tcoords.X < -tolerance || tcoords.X > 1.f + tolerance || tcoords.Y < -tolerance || tcoords.Y > 1.f + tolerance)
+			return false;
+	}
+
+	for (u32 i = 0; i < count; ++i)
+		buffer->setTCoords(i, remapTCoords(handle, buffer->getTCoords(i)));
+
+	buffer->getMaterial().setTexture(0, Pages[entry->Page]);
+	buffer->setDirty(scene::EBT_VERTEX);
+	return true;
+}
+
+
+u32 CTextureAtlas::remapMesh(scene::IMesh* mesh) const
+{
+	if (!mesh)
+		return 0;
+
+	u32 remapped = 0;
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i)
+	{
+		scene::IMeshBuffer* buffer = mesh->getMeshBuffer(i);
+		ITexture* texture = buffer->getMaterial().getTexture(0);
+		if (!texture)
+			continue;
+
+		const s32 handle = getHandle(texture->getName().getPath());
+		if (handle >= 0 && remapMeshBuffer(buffer, handle))
+			++remapped;
+	}
+	return remapped;
+}
+
+} // end namespace video
+} // end namespace irr
@@ -0,0 +1,97 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "ITextureAtlas.h"
+#include "IImage.h"
+#include "irrArray.h"
+#include "dimension2d.h"
+#include "irrStringHash.h"
+#include <unordered_map>
+
+namespace irr
+{
+namespace video
+{
+
+class IVideoDriver;
+
+//! Texture atlas with a skyline packer, see ITextureAtlas
+class CTextureAtlas : public ITextureAtlas
+{
+public:
+
+	CTextureAtlas(IVideoDriver* driver, const io::path& name, const core::dimension2d<u32>& pageSize, u32 padding);
+
+	~CTextureAtlas();
+
+	s32 addImage(const io::path& name, IImage* image) override;
+
+	s32 getHandle(const io::path& name) const override;
+
+	bool build() override;
+
+	u32 getPageCount() const override;
+
+	ITexture* getPageTexture(u32 page) const override;
+
+	const STextureAtlasEntry* getEntry(s32 handle) const override;
+
+	core::vector2df remapTCoords(s32 handle, const core::vector2df& tcoords) const override;
+
+	bool remapMeshBuffer(scene::IMeshBuffer* buffer, s32 handle) const override;
+
+	u32 remapMesh(scene::IMesh* mesh) const override;
+
+private:
+
+	//! Horizontal segment of the top outline of the packed images
+	struct SSkylineNode
+	{
+		u32 X;
+		u32 Y;
+		u32 Width;
+	};
+
+	struct SPage
+	{
+		core::array<SSkylineNode> Skyline;
+		//! Size actually covered by images
+		core::dimension2d<u32> Used;
+	};
+
+	struct SImage
+	{
+		IImage* Image;
+		//! Position of the padded slot on the page
+		core::vector2d<u32> Slot;
+		core::dimension2d<u32> SlotSize;
+		STextureAtlasEntry Entry;
+		bool Packed;
+	};
+
+	//! Finds the lowest position for a slot, returns false if it does not fit
+	bool findPosition(const SPage& page, const core::dimension2d<u32>& size, u32& node, core::vector2d<u32>& pos) const;
+
+	//! Raises the skyline over a newly placed slot
+	void placeSlot(SPage& page, u32 node, const core::vector2d<u32>& pos, const core::dimension2d<u32>& size);
+
+	//! Draws all images of a page with mipmaps and creates its texture
+	ITexture* createPage(u32 page, const core::dimension2d<u32>& size);
+
+	IVideoDriver* Driver;
+	io::path Name;
+	core::dimension2d<u32> PageSize;
+	u32 Padding;
+	//! Slots are aligned to this power of two, so mip levels up to it stay exact
+	u32 Alignment;
+	bool Built;
+
+	core::array<SImage> Images;
+	std::unordered_map<io::path, s32> NameIndex;
+	core::array<ITexture*> Pages;
+};
+
+} // end namespace video
+} // end namespace irr
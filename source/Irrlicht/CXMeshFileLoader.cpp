@@ -11,6 +11,9 @@
 #include "ISceneManager.h"
 #include "IVideoDriver.h"
 #include "IReadFile.h"
+#include "CIOStatistics.h"
+
+#include <zlib.h> // use system lib
 
 #ifdef _DEBUG
 #define _XREADER_DEBUG
@@ -19,6 +22,15 @@
 
 #define SET_ERR_AND_RETURN() do { ErrorState = true; return false; } while (0)
 
+namespace
+{
+	//! copies a token out of the file buffer
+	inline irr::core::stringc toString(std::string_view token)
+	{
+		return irr::core::stringc(token.data(), (irr::u32)token.size());
+	}
+}
+
 namespace irr
 {
 namespace scene
@@ -392,27 +404,35 @@ bool CXMeshFileLoader::load(io::IReadFile* file)
 bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 {
 	const long size = file->getSize();
-	if (size < 12)
+	if (size < 16)
 	{
 		os::Printer::log("X File is too small.", ELL_WARNING);
 		return false;
 	}
 
-	Buffer = new c8[size+1];
-	Buffer[size] = 0x0; // null-terminate
-
-	//! read all into memory
-	if (file->read(Buffer, size) != static_cast<size_t>(size))
+	// compressed files are decompressed straight from a mapped file
+	const c8* data = (const c8*)file->getMappedData();
+	if (!data)
 	{
-		os::Printer::log("Could not read from x file.", ELL_WARNING);
-		return false;
+		Buffer = new c8[size+1];
+		Buffer[size] = 0x0; // null-terminate
+
+		//! read all into memory
+		if (file->read(Buffer, size) != static_cast<size_t>(size))
+		{
+			os::Printer::log("Could not read from x file.", ELL_WARNING);
+			return false;
+		}
+		data = Buffer;
 	}
+	else
+		io::addBytesMapped(file, size);
 
 	Line = 1;
-	End = Buffer + size;
+	End = (c8*)data + size;
 
 	//! check header "xof "
-	if (strncmp(Buffer, "xof ", 4)!=0)
+	if (strncmp(data, "xof ", 4)!=0)
 	{
 		os::Printer::log("Not an x file, wrong header.", ELL_WARNING);
 		return false;
@@ -420,31 +440,36 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 
 	//! read minor and major version, e.g. 0302 or 0303
 	c8 tmp[3];
-	tmp[0] = Buffer[4];
-	tmp[1] = Buffer[5];
+	tmp[0] = data[4];
+	tmp[1] = data[5];
 	tmp[2] = 0x0;
 	MajorVersion = core::strtoul10(tmp);
 
-	tmp[0] = Buffer[6];
-	tmp[1] = Buffer[7];
+	tmp[0] = data[6];
+	tmp[1] = data[7];
 	MinorVersion = core::strtoul10(tmp);
 
 	//! read format
-	if (strncmp(&Buffer[8], "txt ", 4) ==0)
+	bool compressed = false;
+	if (strncmp(&data[8], "txt ", 4) ==0)
 		BinaryFormat = false;
-	else if (strncmp(&Buffer[8], "bin ", 4) ==0)
+	else if (strncmp(&data[8], "bin ", 4) ==0)
 		BinaryFormat = true;
+	else if (strncmp(&data[8], "tzip", 4) ==0)
+		BinaryFormat = false, compressed = true;
+	else if (strncmp(&data[8], "bzip", 4) ==0)
+		BinaryFormat = true, compressed = true;
 	else
 	{
-		os::Printer::log("Only uncompressed x files currently supported.", ELL_WARNING);
+		os::Printer::log("Unknown x file format.", ELL_WARNING);
 		return false;
 	}
 	BinaryNumCount=0;
 
 	//! read float size
-	if (strncmp(&Buffer[12], "0032", 4) ==0)
+	if (strncmp(&data[12], "0032", 4) ==0)
 		FloatSize = 4;
-	else if (strncmp(&Buffer[12], "0064", 4) ==0)
+	else if (strncmp(&data[12], "0064", 4) ==0)
 		FloatSize = 8;
 	else
 	{
@@ -452,6 +477,21 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 		return false;
 	}
 
+	if (compressed && !decompressMSZip(data))
+	{
+		os::Printer::log("Could not decompress x file.", ELL_WARNING);
+		return false;
+	}
+
+	// the tokenizer relies on the terminating zero, which mappings lack
+	if (!Buffer)
+	{
+		Buffer = new c8[size+1];
+		memcpy(Buffer, data, size);
+		Buffer[size] = 0x0;
+		End = Buffer + size;
+	}
+
 	P = &Buffer[16];
 
 	readUntilEndOfLine();
@@ -460,6 +500,81 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 }
 
 
+//! Replaces Buffer with the decompressed content
+/** After the header follows the size of the uncompressed file and a
+sequence of MSZIP blocks. Each block consists of its uncompressed and
+compressed size (two words, the latter including the "CK" signature),
+"CK" and raw deflate data. Blocks may refer to the output of the
+previous block, which is therefore passed as dictionary. */
+bool CXMeshFileLoader::decompressMSZip(const c8* data)
+{
+	const u8* in = (const u8*)data + 16;
+	const u8* const inEnd = (const u8*)End;
+	if (inEnd - in < 4)
+		return false;
+
+	// the stored size includes the header in files written by D3DX,
+	// leave room for writers which don't count it
+	const u32 fileSize = in[0] | (in[1] << 8) | (in[2] << 16) | ((u32)in[3] << 24);
+	in += 4;
+	const u32 capacity = fileSize + 16;
+	if (fileSize > 0x40000000)
+		return false;
+
+	c8* out = new c8[capacity + 1];
+	memcpy(out, data, 16);
+	u32 outSize = 16;
+
+	while (inEnd - in >= 4)
+	{
+		const u32 blockSize = in[0] | (in[1] << 8);
+		const u32 compressedSize = in[2] | (in[3] << 8);
+		in += 4;
+		if (compressedSize < 2 || (u32)(inEnd - in) < compressedSize ||
+			in[0] != 'C' || in[1] != 'K' || blockSize > capacity - outSize)
+		{
+			delete [] out;
+			return false;
+		}
+
+		z_stream stream;
+		stream.zalloc = (alloc_func)0;
+		stream.zfree = (free_func)0;
+		stream.opaque = 0;
+		stream.next_in = (Bytef*)in + 2;
+		stream.avail_in = compressedSize - 2;
+		stream.next_out = (Bytef*)out + outSize;
+		stream.avail_out = blockSize;
+
+		// wbits < 0 indicates no zlib header inside the data.
+		int err = inflateInit2(&stream, -MAX_WBITS);
+		if (err == Z_OK && outSize > 16)
+		{
+			const u32 history = core::min_(outSize - 16, 32768u);
+			err = inflateSetDictionary(&stream, (const Bytef*)out + outSize - history, history);
+		}
+		if (err == Z_OK)
+			err = inflate(&stream, Z_FINISH);
+		inflateEnd(&stream);
+
+		if ((err != Z_STREAM_END && err != Z_OK && err != Z_BUF_ERROR) || stream.total_out != blockSize)
+		{
+			delete [] out;
+			return false;
+		}
+
+		outSize += blockSize;
+		in += compressedSize;
+	}
+
+	out[outSize] = 0x0; // null-terminate
+	delete [] Buffer;
+	Buffer = out;
+	End = Buffer + outSize;
+	return true;
+}
+
+
 //! Parses the file
 bool CXMeshFileLoader::parseFile()
 {
@@ -475,14 +590,14 @@ bool CXMeshFileLoader::parseFile()
 //! Parses the next Data object in the file
 bool CXMeshFileLoader::parseDataObject()
 {
-	core::stringc objectName = getNextToken();
+	std::string_view objectName = getNextToken();
 
 	if (objectName.size() == 0)
 		return false;
 
 	// parse specific object
 #ifdef _XREADER_DEBUG
-	os::Printer::log("debug DataObject", objectName.c_str(), ELL_DEBUG);
+	os::Printer::log("debug DataObject", toString(objectName).c_str(), ELL_DEBUG);
 #endif
 
 	if (objectName == "template")
@@ -527,7 +642,7 @@ bool CXMeshFileLoader::parseDataObject()
 		return true;
 	}
 
-	os::Printer::log("Unknown data object in animation of .x file", objectName.c_str(), ELL_WARNING);
+	os::Printer::log("Unknown data object in animation of .x file", toString(objectName).c_str(), ELL_WARNING);
 
 	return parseUnknownDataObject();
 }
@@ -556,7 +671,7 @@ bool CXMeshFileLoader::parseDataObjectTemplate()
 	// read and ignore data members
 	while(true)
 	{
-		core::stringc s = getNextToken();
+		std::string_view s = getNextToken();
 
 		if (s == "}")
 			break;
@@ -630,10 +745,10 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		std::string_view objectName = getNextToken();
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in frame:", objectName.c_str(), ELL_DEBUG);
+		os::Printer::log("debug DataObject in frame:", toString(objectName).c_str(), ELL_DEBUG);
 #endif
 
 		if (objectName.size() == 0)
@@ -683,7 +798,7 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in frame in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in frame in x file", toString(objectName).c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -829,7 +944,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		std::string_view objectName = getNextToken();
 
 		if (objectName.size() == 0)
 		{
@@ -844,7 +959,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in mesh", objectName.c_str(), ELL_DEBUG);
+		os::Printer::log("debug DataObject in mesh", toString(objectName).c_str(), ELL_DEBUG);
 #endif
 
 		if (objectName == "MeshNormals")
@@ -1087,7 +1202,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in mesh in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in mesh in x file", toString(objectName).c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1470,7 +1585,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		std::string_view objectName = getNextToken();
 
 		if (objectName.size() == 0)
 		{
@@ -1505,7 +1620,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in material list in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in material list in x file", toString(objectName).c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1532,7 +1647,7 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		std::string_view objectName = getNextToken();
 
 		if (objectName.size() == 0)
 		{
@@ -1553,7 +1668,7 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in animation set in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in animation set in x file", toString(objectName).c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1616,7 +1731,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		std::string_view objectName = getNextToken();
 
 		if (objectName.size() == 0)
 		{
@@ -1646,7 +1761,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 		if (objectName == "{")
 		{
 			// read frame name
-			FrameName = getNextToken();
+			FrameName = toString(getNextToken());
 
 			if (!checkForClosingBrace())
 			{
@@ -1657,7 +1772,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in animation in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in animation in x file", toString(objectName).c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				SET_ERR_AND_RETURN();
 		}
@@ -1925,7 +2040,7 @@ bool CXMeshFileLoader::parseUnknownDataObject()
 	// find opening delimiter
 	while(true)
 	{
-		core::stringc t = getNextToken();
+		std::string_view t = getNextToken();
 
 		if (t.size() == 0)
 			return false;
@@ -1940,7 +2055,7 @@ bool CXMeshFileLoader::parseUnknownDataObject()
 
 	while(counter)
 	{
-		core::stringc t = getNextToken();
+		std::string_view t = getNextToken();
 
 		if (t.size() == 0)
 			return false;
@@ -2003,11 +2118,11 @@ bool CXMeshFileLoader::checkForTwoFollowingSemicolons()
 //! if there is one
 bool CXMeshFileLoader::readHeadOfDataObject(core::stringc* outname)
 {
-	core::stringc nameOrBrace = getNextToken();
+	const std::string_view nameOrBrace = getNextToken();
 	if (nameOrBrace != "{")
 	{
 		if (outname)
-			(*outname) = nameOrBrace;
+			(*outname) = toString(nameOrBrace);
 
 		if (getNextToken() != "{")
 			return false;
@@ -2018,10 +2133,8 @@ bool CXMeshFileLoader::readHeadOfDataObject(core::stringc* outname)
 
 
 //! returns next parseable token. Returns empty string if no token there
-core::stringc CXMeshFileLoader::getNextToken()
+std::string_view CXMeshFileLoader::getNextToken()
 {
-	core::stringc s;
-
 	// process binary-formatted file
 	if (BinaryFormat)
 	{
@@ -2034,17 +2147,25 @@ core::stringc CXMeshFileLoader::getNextToken()
 		// standalone tokens
 		switch (tok) {
 			case 1:
+			{
 				// name token
 				len = readBinDWord();
-				s = core::stringc(P, len);
+				if (len > (u32)(End - P))
+					return std::string_view();
+				const std::string_view s(P, len);
 				P += len;
 				return s;
+			}
 			case 2:
+			{
 				// string token
 				len = readBinDWord();
-				s = core::stringc(P, len);
+				if (len + 2 > (u32)(End - P))
+					return std::string_view();
+				const std::string_view s(P, len);
 				P += (len + 2);
 				return s;
+			}
 			case 3:
 				// integer token
 				P += 4;
@@ -2119,25 +2240,20 @@ core::stringc CXMeshFileLoader::getNextToken()
 		findNextNoneWhiteSpace();
 
 		if (P >= End)
-			return s;
+			return std::string_view();
 
-		while((P < End) && !core::isspace(P[0]))
-		{
-			// either keep token delimiters when already holding a token, or return if first valid char
-			if (P[0]==';' || P[0]=='}' || P[0]=='{' || P[0]==',')
-			{
-				if (!s.size())
-				{
-					s.append(P[0]);
-					++P;
-				}
-				break; // stop for delimiter
-			}
-			s.append(P[0]);
+		// delimiters are tokens of their own
+		const c8* start = P;
+		if (P[0]==';' || P[0]=='}' || P[0]=='{' || P[0]==',')
+			return std::string_view(P++, 1);
+
+		while((P < End) && !core::isspace(P[0]) &&
+			P[0]!=';' && P[0]!='}' && P[0]!='{' && P[0]!=',')
 			++P;
-		}
+
+		return std::string_view(start, P - start);
 	}
-	return s;
+	return std::string_view();
 }
 
 
@@ -2193,7 +2309,7 @@ bool CXMeshFileLoader::getNextTokenAsString(core::stringc& out)
 {
 	if (BinaryFormat)
 	{
-		out=getNextToken();
+		out=toString(getNextToken());
 		return true;
 	}
 	findNextNoneWhiteSpace();
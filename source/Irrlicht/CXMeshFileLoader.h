@@ -7,6 +7,7 @@
 #include "IMeshLoader.h"
 #include "irrString.h"
 #include "CSkinnedMesh.h"
+#include <string_view>
 
 
 namespace irr
@@ -82,6 +83,10 @@ private:
 
 	bool readFileIntoMemory(io::IReadFile* file);
 
+	//! replaces Buffer with the decompressed content of a MSZIP compressed file
+	/** \param data The whole file, which ends at End. */
+	bool decompressMSZip(const c8* data);
+
 	bool parseFile();
 
 	bool parseDataObject();
@@ -126,7 +131,8 @@ private:
 	void findNextNoneWhiteSpaceNumber();
 
 	//! returns next parseable token. Returns empty string if no token there
-	core::stringc getNextToken();
+	/** The token points into the file buffer and stays valid while the file is parsed. */
+	std::string_view getNextToken();
 
 	//! reads header of dataobject including the opening brace.
 	//! returns false if error happened, and writes name of object
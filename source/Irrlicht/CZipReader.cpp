@@ -9,6 +9,9 @@
 
 #include "CFileList.h"
 #include "CReadFile.h"
+#include "CInflateReadFile.h"
+#include "CReadAheadFile.h"
+#include "CIOStatistics.h"
 #include "coreutil.h"
 
 #include <zlib.h> // use system lib
@@ -460,6 +463,27 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 	case 8:
 		{
 			const u32 uncompressedSize = e.header.DataDescriptor.UncompressedSize;
+
+			// big entries are inflated while they are read, so neither the
+			// compressed nor the uncompressed data is ever held completely
+			if (uncompressedSize >= 64 * 1024 && !decrypted)
+			{
+				IReadFile* compressed = createLimitReadFile(Files[index].FullName, File, e.Offset, decryptedSize);
+				IReadFile* file = new CInflateReadFile(compressed, uncompressedSize, Files[index].FullName);
+				compressed->drop();
+
+				// a gzip archive holds a single dump, which loaders usually
+				// read from begin to end, so it's inflated ahead meanwhile.
+				// Smaller dumps are not worth starting a thread.
+				if (IsGZip && uncompressedSize >= 1024 * 1024)
+				{
+					IReadFile* ahead = new CReadAheadFile(file);
+					file->drop();
+					return ahead;
+				}
+				return file;
+			}
+
 			c8* pBuf = new c8[ uncompressedSize ];
 			if (!pBuf)
 			{
@@ -483,8 +507,8 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 				}
 
 				//memset(pcData, 0, decryptedSize);
-				File->seek(e.Offset);
-				File->read(pcData, decryptedSize);
+				// entries may be opened on several threads
+				File->readAt(pcData, decryptedSize, e.Offset);
 			}
 
 			// Setup the inflate stream.
@@ -499,6 +523,7 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 			stream.zfree = (free_func)0;
 
 			// Perform inflation. wbits < 0 indicates no zlib header inside the data.
+			const u64 start = CIOStatistics::getTime();
 			err = inflateInit2(&stream, -MAX_WBITS);
 			if (err == Z_OK)
 			{
@@ -509,6 +534,7 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 				err = Z_OK;
 				inflateEnd(&stream);
 			}
+			getIOStatistics().addInflated(uncompressedSize - stream.avail_out, CIOStatistics::getTime() - start);
 
 			if (decrypted)
 				decrypted->drop();
@@ -92,6 +92,15 @@ namespace video
 		},
 	};
 
+	static const VertexType vtCompact = {
+		sizeof(S3DVertexCompact), {
+			{EVA_POSITION, 3, GL_SHORT, VertexAttribute::Mode::Normalized, offsetof(S3DVertexCompact, Pos)},
+			{EVA_NORMAL, 2, GL_SHORT, VertexAttribute::Mode::Normalized, offsetof(S3DVertexCompact, Normal)},
+			{EVA_COLOR, 4, GL_UNSIGNED_BYTE, VertexAttribute::Mode::Normalized, offsetof(S3DVertexCompact, Color)},
+			{EVA_TCOORD0, 2, GL_UNSIGNED_SHORT, VertexAttribute::Mode::Normalized, offsetof(S3DVertexCompact, TCoords)},
+		},
+	};
+
 #pragma GCC diagnostic pop
 
 	static const VertexType &getVertexTypeDescription(E_VERTEX_TYPE type)
@@ -100,6 +109,7 @@ namespace video
 			case EVT_STANDARD: return vtStandard;
 			case EVT_2TCOORDS: return vt2TCoords;
 			case EVT_TANGENTS: return vtTangents;
+			case EVT_COMPACT: return vtCompact;
 			default: assert(false);
 		}
 	}
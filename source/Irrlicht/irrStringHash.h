@@ -0,0 +1,23 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#pragma once
+
+#include "irrString.h"
+#include <functional>
+
+namespace std
+{
+
+//! Hash support, so strings and paths can be used as keys of std::unordered_map
+template <typename T>
+struct hash<irr::core::string<T>>
+{
+	size_t operator()(const irr::core::string<T> &s) const noexcept
+	{
+		return hash<basic_string_view<T>>()(s.view());
+	}
+};
+
+} // end namespace std
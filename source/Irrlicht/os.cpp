@@ -257,30 +257,70 @@ namespace os
 	// The platform independent implementation of the printer
 	ILogger* Printer::Logger = 0;
 
+	//! set on worker threads which must not call the logger
+	static thread_local CDeferredLog* DeferredLog = 0;
+
 	void Printer::log(const c8* message, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (DeferredLog)
+			DeferredLog->add(message, 0, ll);
+		else if (Logger)
 			Logger->log(message, ll);
 	}
 
 	void Printer::log(const wchar_t* message, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (DeferredLog)
+			DeferredLog->add(core::stringc(message).c_str(), 0, ll);
+		else if (Logger)
 			Logger->log(message, ll);
 	}
 
 	void Printer::log(const c8* message, const c8* hint, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (DeferredLog)
+			DeferredLog->add(message, hint, ll);
+		else if (Logger)
 			Logger->log(message, hint, ll);
 	}
 
 	void Printer::log(const c8* message, const io::path& hint, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (DeferredLog)
+			DeferredLog->add(message, core::stringc(hint).c_str(), ll);
+		else if (Logger)
 			Logger->log(message, hint.c_str(), ll);
 	}
 
+	void Printer::setDeferredLog(CDeferredLog* log)
+	{
+		DeferredLog = log;
+	}
+
+	void CDeferredLog::add(const c8* message, const c8* hint, ELOG_LEVEL ll)
+	{
+		Messages.push_back(SMessage{message, hint ? hint : "", ll});
+	}
+
+	void CDeferredLog::flush()
+	{
+		for (u32 i = 0; i < Messages.size(); ++i)
+		{
+			if (Messages[i].Hint.size())
+				Printer::log(Messages[i].Text.c_str(), Messages[i].Hint.c_str(), Messages[i].Level);
+			else
+				Printer::log(Messages[i].Text.c_str(), Messages[i].Level);
+		}
+		Messages.clear();
+	}
+
+	void CDeferredLog::append(CDeferredLog& other)
+	{
+		for (u32 i = 0; i < other.Messages.size(); ++i)
+			Messages.push_back(other.Messages[i]);
+		other.Messages.clear();
+	}
+
 	// ------------------------------------------------------
 	// virtual timer implementation
 
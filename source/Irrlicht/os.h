@@ -6,6 +6,7 @@
 
 #include "irrTypes.h"
 #include "irrString.h"
+#include "irrArray.h"
 #include "path.h"
 #include "ILogger.h"
 #include "ITimer.h"
@@ -30,6 +31,30 @@ namespace os
 		static inline c8 byteswap(c8 num) { return num; }
 	};
 
+	//! Messages logged by a worker thread, passed to the logger later
+	/** Loggers are not thread safe. Workers collect what they log with
+	Printer::setDeferredLog() and the main thread flushes it. */
+	class CDeferredLog
+	{
+	public:
+		void add(const c8* message, const c8* hint, ELOG_LEVEL ll);
+
+		//! Logs the messages and removes them, call it on the main thread
+		void flush();
+
+		//! Moves the messages of other to the end of this log
+		void append(CDeferredLog& other);
+
+	private:
+		struct SMessage
+		{
+			core::stringc Text;
+			core::stringc Hint;
+			ELOG_LEVEL Level;
+		};
+		core::array<SMessage> Messages;
+	};
+
 	class Printer
 	{
 	public:
@@ -41,6 +66,10 @@ namespace os
 		// The string ": " is added between message and hint
 		static void log(const c8* message, const c8* hint, ELOG_LEVEL ll = ELL_INFORMATION);
 		static void log(const c8* message, const io::path& hint, ELOG_LEVEL ll = ELL_INFORMATION);
+
+		//! Collects what the calling thread logs in log, 0 to log directly again
+		static void setDeferredLog(CDeferredLog* log);
+
 		static ILogger* Logger;
 	};
 
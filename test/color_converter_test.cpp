@@ -0,0 +1,134 @@
+// Compares the vectorized colour conversions against the scalar loops.
+// Run with --benchmark to print the throughput of every implementation.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+#include "CColorConverter.h"
+
+using namespace irr;
+using video::CColorConverter;
+
+struct Conversion {
+	const char *name;
+	void (*convert)(const void *sP, s32 sN, void *dP);
+	u32 src_bpp;
+	u32 dst_bpp;
+};
+
+static const Conversion conversions[] = {
+	{"A1R5G5B5toA8R8G8B8", CColorConverter::convert_A1R5G5B5toA8R8G8B8, 2, 4},
+	{"R5G6B5toA8R8G8B8", CColorConverter::convert_R5G6B5toA8R8G8B8, 2, 4},
+	{"A8R8G8B8toA1R5G5B5", CColorConverter::convert_A8R8G8B8toA1R5G5B5, 4, 2},
+	{"A8R8G8B8toR5G6B5", CColorConverter::convert_A8R8G8B8toR5G6B5, 4, 2},
+	{"A8R8G8B8toR8G8B8", CColorConverter::convert_A8R8G8B8toR8G8B8, 4, 3},
+	{"A8R8G8B8toB8G8R8", CColorConverter::convert_A8R8G8B8toB8G8R8, 4, 3},
+	{"R8G8B8toA8R8G8B8", CColorConverter::convert_R8G8B8toA8R8G8B8, 3, 4},
+	{"B8G8R8toA8R8G8B8", CColorConverter::convert_B8G8R8toA8R8G8B8, 3, 4},
+	{"R8G8B8toB8G8R8", CColorConverter::convert_R8G8B8toB8G8R8, 3, 3},
+	{"A8R8G8B8toA8B8G8R8", CColorConverter::convert_A8R8G8B8toA8B8G8R8, 4, 4},
+	{"A8R8G8B8toR8G8B8A8", CColorConverter::convert_A8R8G8B8toR8G8B8A8, 4, 4},
+	{"B8G8R8A8toA8R8G8B8", CColorConverter::convert_B8G8R8A8toA8R8G8B8, 4, 4},
+};
+
+static const u8 guard_byte = 0xcd;
+static const u32 guard_size = 64;
+
+// Converts count pixels starting at a byte offset, so unaligned buffers are covered too
+static std::vector<u8> run(const Conversion &conv, const std::vector<u8> &src, u32 offset, u32 count)
+{
+	std::vector<u8> in(offset + count * conv.src_bpp);
+	memcpy(in.data() + offset, src.data(), count * conv.src_bpp);
+	std::vector<u8> out(offset + count * conv.dst_bpp + guard_size, guard_byte);
+	conv.convert(in.data() + offset, count, out.data() + offset);
+
+	for (u32 i = 0; i < guard_size; i++) {
+		if (out[offset + count * conv.dst_bpp + i] != guard_byte)
+			throw std::runtime_error(std::string(conv.name) + " wrote past the end");
+	}
+	return std::vector<u8>(out.begin() + offset, out.begin() + offset + count * conv.dst_bpp);
+}
+
+static void test_conformance()
+{
+	std::mt19937 rng(42);
+	std::vector<u8> src(4 * 1024);
+	for (auto &b : src)
+		b = (u8)rng();
+
+	std::vector<u32> counts;
+	for (u32 n = 0; n <= 70; n++)
+		counts.push_back(n);
+	counts.push_back(1000);
+	counts.push_back(1023);
+
+	for (int level = CColorConverter::ESL_SSSE3; level < CColorConverter::ESL_COUNT; level++) {
+		const auto simd = (CColorConverter::E_SIMD_LEVEL)level;
+		if (!CColorConverter::setSIMDLevel(simd))
+			continue;
+		std::printf("Testing %s\n", CColorConverter::getSIMDLevelName(simd));
+
+		for (auto &&conv : conversions) {
+			for (u32 count : counts) {
+				for (u32 offset = 0; offset < 4; offset++) {
+					CColorConverter::setSIMDLevel(CColorConverter::ESL_SCALAR);
+					const auto expected = run(conv, src, offset, count);
+					CColorConverter::setSIMDLevel(simd);
+					if (run(conv, src, offset, count) != expected) {
+						throw std::runtime_error(std::string(conv.name) + " differs from the scalar version with " +
+								CColorConverter::getSIMDLevelName(simd) + " for " + std::to_string(count) + " pixels");
+					}
+				}
+			}
+		}
+	}
+}
+
+static void benchmark()
+{
+	// 1024x1024 pixels, big enough to leave the caches
+	const u32 count = 1024 * 1024;
+	std::vector<u8> src(count * 4, 0x5a);
+	std::vector<u8> dst(count * 4);
+
+	for (int level = CColorConverter::ESL_SCALAR; level < CColorConverter::ESL_COUNT; level++) {
+		const auto simd = (CColorConverter::E_SIMD_LEVEL)level;
+		if (!CColorConverter::setSIMDLevel(simd))
+			continue;
+
+		for (auto &&conv : conversions) {
+			const int rounds = 20;
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < rounds; i++)
+				conv.convert(src.data(), count, dst.data());
+			const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+
+			// bytes read plus bytes written
+			const double bytes = (double)rounds * count * (conv.src_bpp + conv.dst_bpp);
+			std::printf("%-8s %-20s %6.2f GB/s\n", CColorConverter::getSIMDLevelName(simd),
+					conv.name, bytes / time.count() / 1e9);
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+try {
+	const auto best = CColorConverter::getSIMDLevel();
+	std::printf("Detected %s\n", CColorConverter::getSIMDLevelName(best));
+
+	if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+		benchmark();
+	else
+		test_conformance();
+
+	CColorConverter::setSIMDLevel(best);
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
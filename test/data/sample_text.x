@@ -0,0 +1,27 @@
+xof 0303txt 0032
+// tokens are separated by delimiters as well as white space
+template Header {
+ <3D82AB43-62DA-11cf-AB39-0020AF71E433>
+ WORD major;
+ WORD minor;
+ DWORD flags;
+}
+
+Header{1;0;1;}
+Empty{}
+Frame Root{
+  FrameTransformMatrix {
+    1.0,0.0,0.0,0.0,0.0,1.0,0.0,0.0,0.0,0.0,1.0,0.0,5.0,0.0,0.0,1.0;;
+  }
+  Mesh Quad{
+    4;
+    0.0;0.0;0.0;,
+    1.0;0.0;0.0;,
+    0.0;1.0;0.0;,
+    0.0;0.0;2.0;;
+    2;
+    3;0,1,2;,
+    3;0,2,3;;
+    MeshMaterialList{1;2;0,0;;Material Red{1.0;0.0;0.0;1.0;;0.0;0.0;0.0;0.0;;0.0;0.0;0.0;;}}
+  }
+}
\ No newline at end of file
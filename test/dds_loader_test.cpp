@@ -0,0 +1,44 @@
+// Loads a DXT1 compressed DDS file with all its mipmaps from memory and
+// checks that the blocks are kept as they are.
+
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+#include <irrlicht.h>
+
+using namespace irr;
+
+int main(int argc, char *argv[])
+try {
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.LoggingLevel = ELL_DEBUG;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	// 8x4 image, the header is followed by the pixel format and the caps
+	std::vector<u32> dds = {0x20534444, 124, 0x2100f, 4, 8, 16, 0, 4};
+	dds.resize(dds.size() + 11);
+	dds.insert(dds.end(), {32, 4, 0x31545844, 0, 0, 0, 0, 0, 0x401008, 0, 0, 0, 0});
+	dds.resize(dds.size() + (16 + 8 + 8 + 8) / 4, 0x12345678);
+
+	io::IReadFile *file = device->getFileSystem()->createMemoryReadFile(dds.data(), (s32)dds.size() * 4, "test.dds");
+	video::IImage *img = device->getVideoDriver()->createImageFromFile(file);
+	file->drop();
+	if (!img)
+		throw std::runtime_error("Failed to load image");
+
+	if (img->getColorFormat() != video::ECF_DXT1 || img->getDimension() != core::dimension2du(8, 4))
+		throw std::runtime_error("Wrong image format or dimensions");
+	if (!img->getMipMapsData(3) || *(const u32 *)img->getMipMapsData(3) != 0x12345678)
+		throw std::runtime_error("Wrong mipmap contents");
+
+	img->drop();
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
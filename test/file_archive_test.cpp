@@ -0,0 +1,167 @@
+// Opens files from several archives and checks that the file index picks
+// the archive with the highest priority, follows the ignore paths rule of
+// each archive and falls back to the next archive if an entry can't be read.
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+
+using namespace irr;
+
+// Archive holding strings, or failing to open any of its entries
+class CTestArchive : public io::IFileArchive
+{
+public:
+	CTestArchive(io::IFileSystem *fs, const char *name, bool ignorePaths, bool broken = false) :
+			FileSystem(fs), Name(name), Broken(broken)
+	{
+		List = fs->createEmptyFileList("", true, ignorePaths);
+	}
+
+	~CTestArchive()
+	{
+		List->drop();
+	}
+
+	void add(const char *name, const char *contents)
+	{
+		List->addItem(name, 0, (u32)strlen(contents), false, (u32)Contents.size());
+		Contents.push_back(contents);
+		List->sort();
+	}
+
+	io::IReadFile *createAndOpenFile(const io::path &filename) override
+	{
+		const s32 index = List->findFile(filename);
+		return index < 0 ? nullptr : createAndOpenFile((u32)index);
+	}
+
+	io::IReadFile *createAndOpenFile(u32 index) override
+	{
+		if (Broken)
+			return nullptr;
+		const char *contents = Contents[List->getID(index)];
+		return FileSystem->createMemoryReadFile(contents, (s32)strlen(contents), List->getFullFileName(index));
+	}
+
+	const io::IFileList *getFileList() const override { return List; }
+
+	const io::path &getArchiveName() const override { return Name; }
+
+private:
+	io::IFileSystem *FileSystem;
+	io::IFileList *List;
+	io::path Name;
+	bool Broken;
+	std::vector<const char *> Contents;
+};
+
+static void add_archive(io::IFileSystem *fs, CTestArchive *archive)
+{
+	if (!fs->addFileArchive(archive))
+		throw std::runtime_error("could not add an archive");
+	archive->drop();
+}
+
+static std::string read(io::IFileSystem *fs, const char *name)
+{
+	io::IReadFile *file = fs->createAndOpenFile(name);
+	if (!file)
+		return "";
+	std::string contents(file->getSize(), '\0');
+	file->read(&contents[0], contents.size());
+	file->drop();
+	return contents;
+}
+
+static void check(io::IFileSystem *fs, const char *name, const char *expected, const char *what)
+{
+	if (read(fs, name) != expected)
+		throw std::runtime_error(std::string("wrong contents ") + what);
+}
+
+// Archives added first hide the same names in later ones, until they are moved
+static void test_priority(io::IFileSystem *fs)
+{
+	CTestArchive *first = new CTestArchive(fs, "first", false);
+	first->add("shared.txt", "first");
+	CTestArchive *second = new CTestArchive(fs, "second", false);
+	second->add("shared.txt", "second");
+	second->add("only_second.txt", "only second");
+	add_archive(fs, first);
+	add_archive(fs, second);
+
+	check(fs, "shared.txt", "first", "of a name in two archives");
+	check(fs, "SHARED.TXT", "first", "when ignoring the case");
+	check(fs, "only_second.txt", "only second", "of a name in the second archive");
+
+	fs->moveFileArchive(1, -1);
+	check(fs, "shared.txt", "second", "after moving an archive up");
+
+	fs->removeFileArchive(1u);
+	fs->removeFileArchive(0u);
+}
+
+// Only archives ignoring paths find entries under other directories
+static void test_ignore_paths(io::IFileSystem *fs)
+{
+	CTestArchive *paths = new CTestArchive(fs, "paths", false);
+	paths->add("models/kept.txt", "kept");
+	CTestArchive *flat = new CTestArchive(fs, "flat", true);
+	flat->add("models/flat.txt", "flat");
+	add_archive(fs, paths);
+	add_archive(fs, flat);
+
+	check(fs, "models/kept.txt", "kept", "of an entry with its path");
+	check(fs, "kept.txt", "", "of an entry without its path");
+	check(fs, "flat.txt", "flat", "of an entry in an archive ignoring paths");
+	check(fs, "textures/flat.txt", "flat", "of an entry under another path");
+
+	fs->removeFileArchive(1u);
+	fs->removeFileArchive(0u);
+}
+
+// An entry which can't be read is taken from the next archive holding it
+static void test_fallback(io::IFileSystem *fs)
+{
+	CTestArchive *broken = new CTestArchive(fs, "broken", false, true);
+	broken->add("fallback.txt", "broken");
+	CTestArchive *empty = new CTestArchive(fs, "empty", false);
+	empty->add("other.txt", "other");
+	CTestArchive *working = new CTestArchive(fs, "working", false);
+	working->add("fallback.txt", "working");
+	add_archive(fs, broken);
+	add_archive(fs, empty);
+	add_archive(fs, working);
+
+	check(fs, "fallback.txt", "working", "of an entry failing in the first archive");
+
+	fs->removeFileArchive(2u);
+	fs->removeFileArchive(1u);
+	fs->removeFileArchive(0u);
+}
+
+int main(int argc, char *argv[])
+try {
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.LoggingLevel = ELL_DEBUG;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	io::IFileSystem *fs = device->getFileSystem();
+	test_priority(fs);
+	test_ignore_paths(fs);
+	test_fallback(fs);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,105 @@
+// Prefetches entries of a pack archive and checks that the cache hands
+// them out once and drops the entries which were prefetched longest ago.
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <irrlicht.h>
+#include "CFilePrefetcher.h"
+
+using namespace irr;
+
+static const long ENTRY_SIZE = 1000;
+static const char *const names[] = {"prefetch_a.bin", "prefetch_b.bin", "prefetch_c.bin"};
+
+static io::IFileArchive *write_pack(io::IFileSystem *fs)
+{
+	core::array<io::path> files;
+	c8 data[ENTRY_SIZE];
+	for (u32 i = 0; i < 3; ++i) {
+		memset(data, 'a' + i, sizeof(data));
+		io::IWriteFile *out = fs->createAndWriteFile(names[i]);
+		if (!out || out->write(data, sizeof(data)) != sizeof(data))
+			throw std::runtime_error("could not write the packed files");
+		out->drop();
+		files.push_back(names[i]);
+	}
+
+	io::IWriteFile *out = fs->createAndWriteFile("file_prefetcher_test.ipk");
+	const bool written = out && fs->writePackArchive(out, files);
+	if (out)
+		out->drop();
+	for (const char *name : names)
+		std::remove(name);
+
+	io::IFileArchive *archive = nullptr;
+	if (!written || !fs->addFileArchive("file_prefetcher_test.ipk", true, false, io::EFAT_UNKNOWN, "", &archive))
+		throw std::runtime_error("could not write the pack");
+	return archive;
+}
+
+static bool take(io::CFilePrefetcher &prefetcher, u32 index)
+{
+	long size = 0;
+	c8 *data = prefetcher.take(0, index, size);
+	if (!data)
+		return false;
+
+	const bool same = size == ENTRY_SIZE && data[0] == 'a' + (c8)index && data[size - 1] == 'a' + (c8)index;
+	delete[] data;
+	if (!same)
+		throw std::runtime_error("wrong contents of a prefetched entry");
+	return true;
+}
+
+int main(int argc, char *argv[])
+try {
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.LoggingLevel = ELL_DEBUG;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	io::IFileSystem *fs = device->getFileSystem();
+	io::IFileArchive *archive = write_pack(fs);
+	u32 index[3];
+	for (u32 i = 0; i < 3; ++i)
+		index[i] = (u32)archive->getFileList()->findFile(names[i]);
+
+	{
+		// room for two entries
+		io::CFilePrefetcher prefetcher(2 * ENTRY_SIZE + ENTRY_SIZE / 2);
+
+		prefetcher.addArchiveFile(archive, 0, index[0]);
+		prefetcher.wait();
+		if (!take(prefetcher, index[0]))
+			throw std::runtime_error("prefetched entry not cached");
+		if (take(prefetcher, index[0]))
+			throw std::runtime_error("entry handed out twice");
+
+		// prefetching a cached entry again keeps it longer than b
+		prefetcher.addArchiveFile(archive, 0, index[0]);
+		prefetcher.wait();
+		prefetcher.addArchiveFile(archive, 0, index[1]);
+		prefetcher.wait();
+		prefetcher.addArchiveFile(archive, 0, index[0]);
+		prefetcher.wait();
+		prefetcher.addArchiveFile(archive, 0, index[2]);
+		prefetcher.wait();
+
+		if (take(prefetcher, index[1]))
+			throw std::runtime_error("oldest entry not evicted");
+		if (!take(prefetcher, index[0]) || !take(prefetcher, index[2]))
+			throw std::runtime_error("recent entries evicted");
+	}
+
+	fs->removeFileArchive(archive);
+	std::remove("file_prefetcher_test.ipk");
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,314 @@
+// Compresses test images with the texture compressor and decodes them again
+// with independent reference decoders, checking the quality of every format.
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+#include "CImage.h"
+#include "CImageCompressor.h"
+
+using namespace irr;
+
+static const s32 etc_modifiers[8][2] = {
+	{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}
+};
+
+static const s32 eac_modifiers[16][8] = {
+	{-3, -6, -9, -15, 2, 5, 8, 14},
+	{-3, -7, -10, -13, 2, 6, 9, 12},
+	{-2, -5, -8, -13, 1, 4, 7, 12},
+	{-2, -4, -6, -13, 1, 3, 5, 12},
+	{-3, -6, -8, -12, 2, 5, 7, 11},
+	{-3, -7, -9, -11, 2, 6, 8, 10},
+	{-4, -7, -8, -11, 3, 6, 7, 10},
+	{-3, -5, -8, -11, 2, 4, 7, 10},
+	{-2, -6, -8, -10, 1, 5, 7, 9},
+	{-2, -5, -8, -10, 1, 4, 7, 9},
+	{-2, -4, -8, -10, 1, 3, 7, 9},
+	{-2, -5, -7, -10, 1, 4, 6, 9},
+	{-3, -4, -7, -10, 2, 3, 6, 9},
+	{-1, -2, -3, -10, 0, 1, 2, 9},
+	{-4, -6, -8, -9, 3, 5, 7, 8},
+	{-3, -5, -7, -9, 2, 4, 6, 8},
+};
+
+static s32 clamp255(s32 v)
+{
+	return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+// Decoders write 16 A8R8G8B8 pixels, row by row
+
+static void decode_bc1(const u8 *in, u32 *out)
+{
+	const u16 c[2] = {(u16)(in[0] | in[1] << 8), (u16)(in[2] | in[3] << 8)};
+	s32 palette[4][4];
+	for (int i = 0; i < 2; i++) {
+		const s32 r = c[i] >> 11, g = (c[i] >> 5) & 0x3f, b = c[i] & 0x1f;
+		palette[i][0] = 255;
+		palette[i][1] = (r << 3) | (r >> 2);
+		palette[i][2] = (g << 2) | (g >> 4);
+		palette[i][3] = (b << 3) | (b >> 2);
+	}
+	for (int k = 0; k < 4; k++) {
+		if (c[0] > c[1]) {
+			palette[2][k] = (2 * palette[0][k] + palette[1][k]) / 3;
+			palette[3][k] = (palette[0][k] + 2 * palette[1][k]) / 3;
+		} else {
+			palette[2][k] = (palette[0][k] + palette[1][k]) / 2;
+			palette[3][k] = 0;
+		}
+	}
+	const u32 indices = in[4] | in[5] << 8 | in[6] << 16 | (u32)in[7] << 24;
+	for (int i = 0; i < 16; i++) {
+		const s32 *p = palette[(indices >> (i * 2)) & 3];
+		out[i] = (u32)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+	}
+}
+
+static void decode_bc3_alpha(const u8 *in, u32 *out)
+{
+	const s32 a0 = in[0], a1 = in[1];
+	s32 palette[8] = {a0, a1};
+	if (a0 > a1) {
+		for (int i = 1; i < 7; i++)
+			palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+	} else {
+		for (int i = 1; i < 5; i++)
+			palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+	u64 indices = 0;
+	for (int i = 0; i < 6; i++)
+		indices |= (u64)in[2 + i] << (i * 8);
+	for (int i = 0; i < 16; i++)
+		out[i] = (out[i] & 0xffffff) | (u32)palette[(indices >> (i * 3)) & 7] << 24;
+}
+
+static void decode_etc1(const u8 *in, u32 *out)
+{
+	u64 bits = 0;
+	for (int i = 0; i < 8; i++)
+		bits = bits << 8 | in[i];
+
+	const bool flip = bits >> 32 & 1;
+	const bool differential = bits >> 33 & 1;
+	s32 base[2][3];
+	for (int c = 0; c < 3; c++) {
+		const u32 byte = (bits >> (56 - c * 8)) & 0xff;
+		if (differential) {
+			const s32 q0 = byte >> 3;
+			const s32 q1 = q0 + ((s32)(byte << 29) >> 29);
+			if (q1 < 0 || q1 > 31)
+				throw std::runtime_error("ETC2 block uses a non ETC1 mode");
+			base[0][c] = (q0 << 3) | (q0 >> 2);
+			base[1][c] = (q1 << 3) | (q1 >> 2);
+		} else {
+			base[0][c] = (byte >> 4) * 17;
+			base[1][c] = (byte & 15) * 17;
+		}
+	}
+	const u32 tables[2] = {(u32)(bits >> 37) & 7, (u32)(bits >> 34) & 7};
+
+	for (int x = 0; x < 4; x++) {
+		for (int y = 0; y < 4; y++) {
+			const int half = flip ? y / 2 : x / 2;
+			const int pos = x * 4 + y;
+			const int index = (bits >> (16 + pos) & 1) << 1 | (bits >> pos & 1);
+			const s32 *t = etc_modifiers[tables[half]];
+			const s32 modifier = index == 0 ? t[0] : index == 1 ? t[1] : index == 2 ? -t[0] : -t[1];
+			out[y * 4 + x] = 0xff000000 | clamp255(base[half][0] + modifier) << 16 |
+				clamp255(base[half][1] + modifier) << 8 | clamp255(base[half][2] + modifier);
+		}
+	}
+}
+
+static void decode_eac(const u8 *in, u32 *out)
+{
+	const s32 base = in[0];
+	const s32 multiplier = in[1] >> 4;
+	const s32 *table = eac_modifiers[in[1] & 15];
+	u64 indices = 0;
+	for (int i = 0; i < 6; i++)
+		indices = indices << 8 | in[2 + i];
+	for (int i = 0; i < 16; i++) {
+		// stored column major
+		const s32 a = clamp255(base + table[(indices >> (45 - i * 3)) & 7] * multiplier);
+		const int pixel = (i % 4) * 4 + i / 4;
+		out[pixel] = (out[pixel] & 0xffffff) | (u32)a << 24;
+	}
+}
+
+static std::vector<u32> decode(const u8 *data, video::ECOLOR_FORMAT format, u32 width, u32 height)
+{
+	std::vector<u32> pixels(width * height);
+	const u32 blocks_x = (width + 3) / 4, blocks_y = (height + 3) / 4;
+	const bool has_alpha = format == video::ECF_DXT5 || format == video::ECF_ETC2_ARGB;
+	for (u32 by = 0; by < blocks_y; by++) {
+		for (u32 bx = 0; bx < blocks_x; bx++) {
+			u32 block[16];
+			const u8 *in = data + (by * blocks_x + bx) * (has_alpha ? 16 : 8);
+			const u8 *color = has_alpha ? in + 8 : in;
+			if (format == video::ECF_DXT1 || format == video::ECF_DXT5)
+				decode_bc1(color, block);
+			else
+				decode_etc1(color, block);
+			if (format == video::ECF_DXT5)
+				decode_bc3_alpha(in, block);
+			else if (format == video::ECF_ETC2_ARGB)
+				decode_eac(in, block);
+
+			for (u32 y = 0; y < 4 && by * 4 + y < height; y++)
+				for (u32 x = 0; x < 4 && bx * 4 + x < width; x++)
+					pixels[(by * 4 + y) * width + bx * 4 + x] = block[y * 4 + x];
+		}
+	}
+	return pixels;
+}
+
+// Gradients with noise and a soft alpha ramp, colours vary in two directions
+// within a block, which limits the quality of every format to around 30 dB
+static video::IImage *create_test_image(u32 width, u32 height)
+{
+	auto *image = new video::CImage(video::ECF_A8R8G8B8, core::dimension2du(width, height));
+	u32 *pixels = (u32 *)image->getData();
+	u32 seed = 1;
+	for (u32 y = 0; y < height; y++) {
+		for (u32 x = 0; x < width; x++) {
+			seed = seed * 1664525 + 1013904223;
+			const s32 noise = (s32)(seed >> 28) - 8;
+			const u32 r = clamp255(x * 255 / width + noise);
+			const u32 g = clamp255(y * 255 / height - noise);
+			const u32 b = clamp255(128 + (s32)(96 * std::sin(x * 0.2 + y * 0.1)));
+			const u32 a = clamp255((x + y) * 255 / (width + height));
+			pixels[y * width + x] = a << 24 | r << 16 | g << 8 | b;
+		}
+	}
+	return image;
+}
+
+static double psnr(const std::vector<u32> &a, const u32 *b, u32 shift)
+{
+	double error = 0;
+	for (size_t i = 0; i < a.size(); i++) {
+		const s32 d = (s32)((a[i] >> shift) & 0xff) - (s32)((b[i] >> shift) & 0xff);
+		error += d * d;
+	}
+	error /= a.size();
+	return error == 0 ? 100 : 10 * std::log10(255.0 * 255.0 / error);
+}
+
+static void test_format(video::ECOLOR_FORMAT format, const char *name, u32 width, u32 height)
+{
+	video::IImage *image = create_test_image(width, height);
+	if (!image->generateMipMaps())
+		throw std::runtime_error("mipmap generation failed");
+
+	video::IImage *compressed = video::compressImage(image, format, 1);
+	video::IImage *parallel = video::compressImage(image, format, 4);
+	if (!compressed || !parallel || compressed->getColorFormat() != format || !compressed->getMipMapsData())
+		throw std::runtime_error(std::string(name) + ": compression failed");
+
+	// bands must not change the output
+	if (video::hashImage(compressed) != video::hashImage(parallel))
+		throw std::runtime_error(std::string(name) + ": threads change the result");
+
+	const std::vector<u32> pixels = decode((const u8 *)compressed->getData(), format, width, height);
+	const u32 *original = (const u32 *)image->getData();
+	const bool has_alpha = format == video::ECF_DXT5 || format == video::ECF_ETC2_ARGB;
+	for (u32 shift = 0; shift < (has_alpha ? 32u : 24u); shift += 8) {
+		const double quality = psnr(pixels, original, shift);
+		std::printf("%-10s %ux%u channel %u: %.1f dB\n", name, width, height, shift / 8, quality);
+		if (quality < 26)
+			throw std::runtime_error(std::string(name) + ": poor quality");
+	}
+
+	// the smallest mipmap is a single block with the average color
+	const u32 levels = compressed->getMipMapsDataSize() / (has_alpha ? 16 : 8);
+	const u8 *last = (const u8 *)compressed->getMipMapsData() + compressed->getMipMapsDataSize() - (has_alpha ? 16 : 8);
+	const u32 expected = *((const u32 *)image->getMipMapsData() + image->getMipMapsDataSize() / 4 - 1);
+	const u32 decoded = decode(last, format, 1, 1)[0];
+	for (u32 shift = 0; shift < (has_alpha ? 32u : 24u) && levels; shift += 8) {
+		if (std::abs((s32)((decoded >> shift) & 0xff) - (s32)((expected >> shift) & 0xff)) > 8)
+			throw std::runtime_error(std::string(name) + ": wrong mipmap");
+	}
+
+	parallel->drop();
+	compressed->drop();
+	image->drop();
+}
+
+static void test_constant_alpha()
+{
+	// opaque blocks have to stay exactly opaque
+	video::IImage *image = new video::CImage(video::ECF_A8R8G8B8, core::dimension2du(8, 8));
+	image->fill(video::SColor(255, 200, 100, 50));
+	if (video::hasTransparentPixels(image))
+		throw std::runtime_error("opaque image reported as transparent");
+
+	for (auto format : {video::ECF_DXT5, video::ECF_ETC2_ARGB}) {
+		video::IImage *compressed = video::compressImage(image, format);
+		for (u32 pixel : decode((const u8 *)compressed->getData(), format, 8, 8)) {
+			if ((pixel >> 24) != 255)
+				throw std::runtime_error("opaque pixel lost its alpha");
+		}
+		compressed->drop();
+	}
+	image->drop();
+}
+
+static void test_cache()
+{
+	video::IImage *image = create_test_image(64, 32);
+	image->generateMipMaps();
+	video::IImage *compressed = video::compressImage(image, video::ECF_ETC2_ARGB);
+
+	const io::path filename = "image_compressor_test.itc";
+	if (!video::writeCompressedImageCache(filename, compressed))
+		throw std::runtime_error("writing the cache failed");
+	// another thread storing the same entry replaces it as a whole
+	if (!video::writeCompressedImageCache(filename, compressed))
+		throw std::runtime_error("writing an existing cache entry failed");
+	video::IImage *loaded = video::readCompressedImageCache(filename);
+	std::remove(filename.c_str());
+
+	if (!loaded || video::hashImage(loaded) != video::hashImage(compressed))
+		throw std::runtime_error("cache roundtrip changed the image");
+	if (video::hashImage(compressed, 1) == video::hashImage(compressed))
+		throw std::runtime_error("seed is ignored by the hash");
+
+	loaded->drop();
+	compressed->drop();
+	image->drop();
+
+	if (video::readCompressedImageCache("image_compressor_test_missing.itc"))
+		throw std::runtime_error("missing cache file loaded");
+}
+
+int main(int argc, char *argv[])
+try {
+	const struct {
+		video::ECOLOR_FORMAT format;
+		const char *name;
+	} formats[] = {
+		{video::ECF_DXT1, "DXT1"},
+		{video::ECF_DXT5, "DXT5"},
+		{video::ECF_ETC2_RGB, "ETC2_RGB"},
+		{video::ECF_ETC2_ARGB, "ETC2_ARGB"},
+	};
+	for (auto &&f : formats) {
+		test_format(f.format, f.name, 64, 64);
+		// sizes which are not a multiple of the block size
+		test_format(f.format, f.name, 37, 22);
+	}
+	test_constant_alpha();
+	test_cache();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
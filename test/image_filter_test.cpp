@@ -0,0 +1,90 @@
+// Scales an image with every filter and builds mipmap chains, and checks
+// the results.
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <irrlicht.h>
+
+using namespace irr;
+
+// A uniform color has to stay the same with every filter
+static void test_uniform(video::IVideoDriver *driver)
+{
+	video::IImage *src = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(37, 21));
+	video::IImage *dst = driver->createImage(video::ECF_R8G8B8, core::dimension2du(64, 9));
+	src->fill(video::SColor(255, 10, 120, 250));
+	bool same = true;
+	for (int f = video::EIF_NEAREST; f <= video::EIF_LANCZOS3; ++f) {
+		src->copyToScalingFiltered(dst, (video::E_IMAGE_FILTER)f);
+		same &= dst->getPixel(0, 0) == src->getPixel(0, 0) && dst->getPixel(63, 8) == src->getPixel(0, 0);
+	}
+	src->drop();
+	dst->drop();
+	if (!same)
+		throw std::runtime_error("uniform color changed by scaling");
+}
+
+// A checkerboard averages to grey, brighter in linear space
+static void test_mipmaps(video::IVideoDriver *driver)
+{
+	video::IImage *img = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(64, 32));
+	for (u32 y = 0; y < 32; ++y)
+		for (u32 x = 0; x < 64; ++x)
+			img->setPixel(x, y, ((x ^ y) & 1) ? video::SColor(255, 255, 255, 255) : video::SColor(0, 0, 0, 0));
+	if (!img->generateMipMaps())
+		throw std::runtime_error("could not generate mipmaps");
+
+	const u32 *level = (const u32 *)img->getMipMapsData(1);
+	const u32 *last = (const u32 *)img->getMipMapsData(6);
+	if (!level || !last || level[0] != 0x80808080 || last[0] != 0x80808080 ||
+			img->getMipMapsDataSize() != (32 * 16 + 16 * 8 + 8 * 4 + 4 * 2 + 2 + 1) * 4)
+		throw std::runtime_error("wrong box filtered mipmaps");
+
+	img->generateMipMaps(true, 0.75f);
+	level = (const u32 *)img->getMipMapsData(1);
+	if ((level[0] & 0xffffff) != 0xbcbcbc || (level[0] >> 24) <= 191)
+		throw std::runtime_error("wrong sRGB mipmaps with alpha coverage");
+	img->drop();
+}
+
+// Big images are split into bands, which must not change the result
+static void test_mipmap_threads(video::IVideoDriver *driver)
+{
+	video::IImage *img = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(512, 512));
+	for (u32 y = 0; y < 512; ++y)
+		for (u32 x = 0; x < 512; ++x)
+			img->setPixel(x, y, video::SColor(255, x ^ y, x * 3, y * 5));
+
+	img->generateMipMaps(true, 0.f, 1);
+	const u32 size = img->getMipMapsDataSize();
+	u8 *single = new u8[size];
+	memcpy(single, img->getMipMapsData(), size);
+	img->generateMipMaps(true, 0.f, 4);
+	const bool same = memcmp(single, img->getMipMapsData(), size) == 0;
+	delete[] single;
+	img->drop();
+	if (!same)
+		throw std::runtime_error("mipmaps depend on the number of threads");
+}
+
+int main(int argc, char *argv[])
+try {
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.LoggingLevel = ELL_DEBUG;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	test_uniform(device->getVideoDriver());
+	test_mipmaps(device->getVideoDriver());
+	test_mipmap_threads(device->getVideoDriver());
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
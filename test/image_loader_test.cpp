@@ -110,8 +110,8 @@ void printImageBytes(const video::IImage *img)
 
 int main(int argc, char *argv[])
 try {
-	if (argc != 3)
-		throw std::runtime_error("Invalid arguments. Expected sample ID and image file name");
+	if (argc != 3 && !(argc == 4 && strcmp(argv[3], "mipmaps") == 0))
+		throw std::runtime_error("Invalid arguments. Expected sample ID, image file name and optionally \"mipmaps\"");
 
 	const ImageDesc *sample = nullptr;
 	for (auto &&image: test_images) {
@@ -150,6 +150,9 @@ try {
 		throw std::runtime_error("Wrong image contents");
 	}
 
+	if (argc == 4 && !img->getMipMapsData())
+		throw std::runtime_error("Mipmaps not loaded");
+
 	img->drop();
 	device->drop();
 
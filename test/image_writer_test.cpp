@@ -0,0 +1,76 @@
+// Writes PNG images into a growable memory file and, on the worker thread of
+// the driver, into the temp directory, and reads them back.
+
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <irrlicht.h>
+
+using namespace irr;
+
+static const video::SColor COLOR(255, 0, 128, 255);
+
+static void check_image(video::IImage *img, const char *what)
+{
+	const bool same = img && img->getPixel(3, 3) == COLOR;
+	if (img)
+		img->drop();
+	if (!same)
+		throw std::runtime_error(what);
+}
+
+// Encoding into memory of unknown size
+static void test_memory(IrrlichtDevice *device, video::IImage *img)
+{
+	io::IFileSystem *fs = device->getFileSystem();
+	video::IVideoDriver *driver = device->getVideoDriver();
+
+	io::IMemoryWriteFile *out = fs->createGrowableMemoryWriteFile("image.png");
+	if (!driver->writeImageToFile(img, out) || out->getSize() == 0)
+		throw std::runtime_error("could not write the image to memory");
+	io::IReadFile *in = fs->createMemoryReadFile(out->getData(), out->getSize(), "image.png");
+	check_image(driver->createImageFromFile(in), "wrong image read from memory");
+	in->drop();
+	out->drop();
+}
+
+// The image is copied, so changing it right away must not matter
+static void test_async(IrrlichtDevice *device, video::IImage *img)
+{
+	video::IVideoDriver *driver = device->getVideoDriver();
+	const io::path filename = (std::filesystem::temp_directory_path() / "irrlicht_image_writer_test.png").string().c_str();
+
+	bool written = false;
+	driver->writeImageToFileAsync(img, filename, 0, [&](const io::path &name, bool ok) {
+		written = ok && name == filename;
+	});
+	img->fill(video::SColor(255, 255, 0, 0));
+	if (driver->finishAsyncImageWrites(true) != 0 || !written)
+		throw std::runtime_error("could not write the image asynchronously");
+
+	check_image(driver->createImageFromFile(filename), "wrong image written asynchronously");
+	std::remove(filename.c_str());
+}
+
+int main(int argc, char *argv[])
+try {
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.LoggingLevel = ELL_DEBUG;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	video::IImage *img = device->getVideoDriver()->createImage(video::ECF_A8R8G8B8, core::dimension2du(16, 16));
+	img->fill(COLOR);
+	test_memory(device, img);
+	test_async(device, img);
+	img->drop();
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,173 @@
+// Reads deflated ZIP entries, which are inflated while they are read, and
+// checks seeking in them and the handling of broken compressed data. Also
+// streams a big gzip member, which is inflated ahead on a worker thread.
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+
+using namespace irr;
+
+class LogReceiver : public IEventReceiver
+{
+public:
+	bool OnEvent(const SEvent &event) override
+	{
+		if (event.EventType == EET_LOG_TEXT_EVENT) {
+			Text += event.LogEvent.Text;
+			Text += '\n';
+		}
+		return false;
+	}
+
+	std::string Text;
+};
+
+// content of both entries, as written by the script which made the archive
+static u8 expected_byte(long pos)
+{
+	return (u8)((pos % 251) ^ (pos >> 12));
+}
+
+static const long ENTRY_SIZE = 200 * 1024;
+
+static void check_read(io::IReadFile *file, long pos, size_t size, size_t expected, const char *what)
+{
+	std::vector<u8> buffer(size);
+	if (file->read(buffer.data(), size) != expected)
+		throw std::runtime_error(std::string("wrong read size after ") + what);
+	for (size_t i = 0; i < expected; ++i) {
+		if (buffer[i] != expected_byte(pos + (long)i))
+			throw std::runtime_error(std::string("wrong data after ") + what);
+	}
+	if (file->getPos() != pos + (long)expected)
+		throw std::runtime_error(std::string("wrong position after ") + what);
+}
+
+static void test_seeking(io::IFileSystem *fs)
+{
+	io::IReadFile *file = fs->createAndOpenFile("data.bin");
+	if (!file)
+		throw std::runtime_error("could not open the deflated entry");
+	if (file->getType() != io::ERFT_INFLATE_READ_FILE || file->getSize() != ENTRY_SIZE)
+		throw std::runtime_error("deflated entry is not inflated while reading");
+
+	check_read(file, 0, 1000, 1000, "reading from the start");
+
+	// skipped by inflating, without going back to the start
+	if (!file->seek(150000))
+		throw std::runtime_error("forward seek failed");
+	check_read(file, 150000, 100, 100, "a forward seek");
+	if (!file->seek(5000, true))
+		throw std::runtime_error("relative seek failed");
+	check_read(file, 155100, 100, 100, "a relative seek");
+
+	// inflated again from the start
+	if (!file->seek(10))
+		throw std::runtime_error("backward seek failed");
+	check_read(file, 10, 5000, 5000, "a backward seek");
+
+	if (!file->seek(ENTRY_SIZE - 50))
+		throw std::runtime_error("seek to the end failed");
+	check_read(file, ENTRY_SIZE - 50, 100, 50, "reading past the end");
+	check_read(file, ENTRY_SIZE, 100, 0, "reading at the end");
+	if (file->seek(ENTRY_SIZE + 1))
+		throw std::runtime_error("seek past the end succeeded");
+
+	file->drop();
+}
+
+static void test_truncated(io::IFileSystem *fs, LogReceiver &log)
+{
+	io::IReadFile *file = fs->createAndOpenFile("truncated.bin");
+	if (!file)
+		throw std::runtime_error("could not open the truncated entry");
+
+	log.Text.clear();
+	std::vector<u8> buffer(ENTRY_SIZE);
+	const size_t read = file->read(buffer.data(), buffer.size());
+	if (read == 0 || read >= buffer.size())
+		throw std::runtime_error("truncated entry read completely or not at all");
+	for (size_t i = 0; i < read; ++i) {
+		if (buffer[i] != expected_byte((long)i))
+			throw std::runtime_error("wrong data before the end of the truncated entry");
+	}
+	if (log.Text.find("Unexpected end") == std::string::npos)
+		throw std::runtime_error("truncated entry not reported");
+	if (file->read(buffer.data(), 1) != 0)
+		throw std::runtime_error("read after the broken end");
+
+	file->drop();
+}
+
+// Stored deflate blocks, big enough to be inflated ahead in several blocks
+static void test_gzip(io::IFileSystem *fs)
+{
+	std::vector<u8> gz = {0x1f, 0x8b, 8, 8, 0, 0, 0, 0, 0, 3};
+	const char name[] = "dump.bin";
+	gz.insert(gz.end(), name, name + sizeof(name));
+	const size_t size = 6 * ENTRY_SIZE;
+	for (size_t done = 0; done < size;) {
+		const u16 len = (u16)std::min<size_t>(65535, size - done);
+		const u16 nlen = ~len;
+		gz.insert(gz.end(), {(u8)(done + len == size), (u8)len, (u8)(len >> 8), (u8)nlen, (u8)(nlen >> 8)});
+		for (u16 i = 0; i < len; ++i)
+			gz.push_back(expected_byte((long)(done + i)));
+		done += len;
+	}
+	// the CRC isn't checked
+	gz.insert(gz.end(), {0, 0, 0, 0, (u8)size, (u8)(size >> 8), (u8)(size >> 16), (u8)(size >> 24)});
+
+	io::IReadFile *gzFile = fs->createMemoryReadFile(gz.data(), (s32)gz.size(), "test.gz");
+	io::IFileArchive *archive = nullptr;
+	const bool added = fs->addFileArchive(gzFile, true, true, io::EFAT_GZIP, "", &archive);
+	gzFile->drop();
+	if (!added)
+		throw std::runtime_error("could not add the gzip archive");
+
+	io::IReadFile *file = fs->createAndOpenFile("dump.bin");
+	if (!file)
+		throw std::runtime_error("could not open the gzip member");
+	if (file->getType() != io::ERFT_READ_AHEAD_FILE || file->getSize() != (long)size)
+		throw std::runtime_error("gzip member is not inflated ahead");
+
+	for (size_t pos = 0; pos < size; pos += 1000)
+		check_read(file, (long)pos, 1000, std::min<size_t>(1000, size - pos), "streaming the gzip member");
+	if (!file->seek(123))
+		throw std::runtime_error("seek in the gzip member failed");
+	check_read(file, 123, 1, 1, "a seek in the gzip member");
+
+	file->drop();
+	fs->removeFileArchive(archive);
+}
+
+int main(int argc, char *argv[])
+try {
+	LogReceiver log;
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.WindowSize = core::dimension2du(640, 480);
+	p.LoggingLevel = ELL_DEBUG;
+	p.EventReceiver = &log;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	io::IFileSystem *fs = device->getFileSystem();
+	if (!fs->addFileArchive("data/sample_deflated.zip", true, true, io::EFAT_ZIP))
+		throw std::runtime_error("could not add the archive");
+
+	test_seeking(fs);
+	test_truncated(fs, log);
+	test_gzip(fs);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
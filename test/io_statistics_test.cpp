@@ -0,0 +1,64 @@
+// Loads a mesh and a texture twice each and checks what the I/O statistics
+// counted for the files, the loaders and the caches.
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <irrlicht.h>
+
+using namespace irr;
+
+static scene::IAnimatedMesh *load_mesh(IrrlichtDevice *device, const char *filename)
+{
+	io::IReadFile *file = device->getFileSystem()->createAndOpenFile(filename);
+	if (!file)
+		throw std::runtime_error(std::string("could not open ") + filename);
+	scene::IAnimatedMesh *mesh = device->getSceneManager()->getMesh(file);
+	file->drop();
+	return mesh;
+}
+
+int main(int argc, char *argv[])
+try {
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.LoggingLevel = ELL_DEBUG;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	// the second calls are cache hits
+	video::IVideoDriver *driver = device->getVideoDriver();
+	if (!load_mesh(device, "data/sample_text.x") || !load_mesh(device, "data/sample_text.x"))
+		throw std::runtime_error("could not load the mesh");
+	if (!driver->getTexture("data/sample_24bpp.png") || !driver->getTexture("data/sample_24bpp.png"))
+		throw std::runtime_error("could not load the texture");
+
+	io::IIOStatistics *stats = device->getFileSystem()->getStatistics();
+	if (stats->getFilesOpened("") < 2 || stats->getBytesRead() == 0)
+		throw std::runtime_error("wrong file statistics");
+
+	u32 meshCalls = 0, imageCalls = 0;
+	stats->getLoaderTime("mesh/x", &meshCalls);
+	stats->getLoaderTime("image/png", &imageCalls);
+	if (meshCalls != 1 || imageCalls != 1)
+		throw std::runtime_error("wrong loader statistics");
+
+	if (stats->getCacheLookups("texture", true) != 1 || stats->getCacheLookups("texture", false) != 1 ||
+			stats->getCacheLookups("mesh", true) != 1 || stats->getCacheLookups("mesh", false) != 1)
+		throw std::runtime_error("wrong cache statistics");
+
+	if (stats->getJSON().find("\"image/png\":{\"calls\":1,") < 0)
+		throw std::runtime_error("loader missing in the JSON dump");
+
+	stats->reset();
+	if (stats->getFilesOpened("") != 0 || stats->getBytesRead() != 0 || stats->getCacheLookups("texture", true) != 0)
+		throw std::runtime_error("statistics not reset");
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,206 @@
+// Loads small glTF and .x files and checks the meshes, transformations and
+// joints the loaders make of them.
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <irrlicht.h>
+
+using namespace irr;
+
+static void check_vector(const core::vector3df &v, f32 x, f32 y, f32 z, const char *what)
+{
+	if (std::fabs(v.X - x) > 1e-4f || std::fabs(v.Y - y) > 1e-4f || std::fabs(v.Z - z) > 1e-4f)
+		throw std::runtime_error(std::string("wrong ") + what);
+}
+
+static scene::IAnimatedMesh *load_mesh(IrrlichtDevice *device, const char *filename)
+{
+	io::IReadFile *file = device->getFileSystem()->createAndOpenFile(filename);
+	if (!file)
+		throw std::runtime_error(std::string("could not open ") + filename);
+	scene::IAnimatedMesh *mesh = device->getSceneManager()->getMesh(file);
+	file->drop();
+	return mesh;
+}
+
+// Buffer in a data URI, the node is translated and scaled
+static void test_static(IrrlichtDevice *device)
+{
+	scene::IAnimatedMesh *mesh = load_mesh(device, "data/sample_static.gltf");
+	if (!mesh)
+		throw std::runtime_error("static mesh not loaded");
+	if (mesh->getMeshType() != scene::EAMT_STATIC || mesh->getMeshBufferCount() != 1)
+		throw std::runtime_error("wrong static mesh type or buffers");
+
+	const scene::IMeshBuffer *buffer = mesh->getMeshBuffer(0);
+	if (buffer->getVertexCount() != 3 || buffer->getIndexCount() != 3)
+		throw std::runtime_error("wrong vertex or index count");
+
+	// scaled by 2 and moved by 10 along X, with Z mirrored to the left handed system
+	const core::aabbox3df &box = mesh->getBoundingBox();
+	check_vector(box.MinEdge, 10.f, 0.f, -2.f, "static bounding box minimum");
+	check_vector(box.MaxEdge, 12.f, 2.f, 0.f, "static bounding box maximum");
+}
+
+// Indices, normals and positions each in their own buffer
+static void test_buffers(IrrlichtDevice *device)
+{
+	scene::IAnimatedMesh *mesh = load_mesh(device, "data/sample_buffers.gltf");
+	if (!mesh)
+		throw std::runtime_error("mesh with several buffers not loaded");
+
+	const scene::IMeshBuffer *buffer = mesh->getMeshBuffer(0);
+	if (buffer->getVertexCount() != 4 || buffer->getIndexCount() != 6)
+		throw std::runtime_error("wrong vertex or index count from several buffers");
+	check_vector(buffer->getPosition(2), 1.f, 1.f, 0.f, "position from the last buffer");
+	check_vector(buffer->getNormal(3), 0.f, 0.f, -1.f, "normal from the middle buffer");
+
+	const u16 *indices = buffer->getIndices();
+	const u16 expected[] = {0, 1, 2, 0, 2, 3};
+	for (u32 i = 0; i < 6; ++i) {
+		if (indices[i] != expected[i])
+			throw std::runtime_error("wrong indices from the first buffer");
+	}
+}
+
+// Buffer in an escaped file name next to the .gltf file in an archive
+static void test_archive(IrrlichtDevice *device)
+{
+	io::IFileSystem *fs = device->getFileSystem();
+	io::IFileArchive *archive = nullptr;
+	if (!fs->addFileArchive("data/sample_gltf.zip", true, false, io::EFAT_ZIP, "", &archive))
+		throw std::runtime_error("could not add the glTF archive");
+
+	scene::IAnimatedMesh *mesh = load_mesh(device, "models/sample external.gltf");
+	if (!mesh)
+		throw std::runtime_error("mesh with a buffer in the archive not loaded");
+	if (mesh->getMeshBuffer(0)->getVertexCount() != 3)
+		throw std::runtime_error("wrong vertex count from the archive");
+	check_vector(mesh->getBoundingBox().MaxEdge, 3.f, 3.f, 0.f, "bounding box from the archive");
+
+	fs->removeFileArchive(archive);
+}
+
+// Binary container, one mesh skinned to a chain of two joints
+static void test_skinned(IrrlichtDevice *device)
+{
+	scene::IAnimatedMesh *mesh = load_mesh(device, "data/sample_skinned.glb");
+	if (!mesh)
+		throw std::runtime_error("skinned mesh not loaded");
+	if (mesh->getMeshType() != scene::EAMT_SKINNED || mesh->getMeshBufferCount() != 1)
+		throw std::runtime_error("wrong skinned mesh type or buffers");
+
+	if (mesh->getMeshBuffer(0)->getVertexCount() != 3)
+		throw std::runtime_error("wrong skinned vertex count");
+	check_vector(mesh->getBoundingBox().MinEdge, 0.f, 0.f, 0.f, "skinned bounding box minimum");
+	check_vector(mesh->getBoundingBox().MaxEdge, 1.f, 2.f, 0.f, "skinned bounding box maximum");
+
+	// every node of the scene becomes a joint
+	scene::ISkinnedMesh *skinned = static_cast<scene::ISkinnedMesh *>(mesh);
+	if (skinned->getJointCount() != 3)
+		throw std::runtime_error("wrong joint count");
+
+	const s32 root = skinned->getJointNumber("root");
+	const s32 arm = skinned->getJointNumber("arm");
+	if (root < 0 || arm < 0 || skinned->getJointNumber("body") < 0)
+		throw std::runtime_error("joint names lost");
+
+	const core::array<scene::ISkinnedMesh::SJoint *> &joints = skinned->getAllJoints();
+	if (joints[root]->Children.size() != 1 || joints[root]->Children[0] != joints[arm])
+		throw std::runtime_error("wrong joint hierarchy");
+	check_vector(joints[arm]->LocalMatrix.getTranslation(), 0.f, 1.f, 0.f, "joint translation");
+	check_vector(joints[arm]->GlobalInversedMatrix.getTranslation(), 0.f, -1.f, 0.f, "inverse bind matrix");
+
+	// the first two vertices follow the root, the last one the arm
+	if (joints[root]->Weights.size() != 2 || joints[arm]->Weights.size() != 1 ||
+			joints[arm]->Weights[0].vertex_id != 2 || joints[arm]->Weights[0].strength != 1.f)
+		throw std::runtime_error("wrong joint weights");
+}
+
+// The text file puts delimiters right after names and numbers, ends lists
+// with doubled separators, has objects without content and no final newline.
+// The MSZIP file holds the same text in two blocks, where the second one
+// refers back into the first.
+static void test_x(IrrlichtDevice *device, const char *filename)
+{
+	scene::IAnimatedMesh *mesh = load_mesh(device, filename);
+	if (!mesh)
+		throw std::runtime_error(std::string("could not load ") + filename);
+	if (mesh->getMeshBufferCount() != 1)
+		throw std::runtime_error("wrong .x buffer count");
+
+	const scene::IMeshBuffer *buffer = mesh->getMeshBuffer(0);
+	if (buffer->getVertexCount() != 4 || buffer->getIndexCount() != 6)
+		throw std::runtime_error("wrong .x vertex or index count");
+
+	// moved by 5 along X by the frame
+	check_vector(mesh->getBoundingBox().MinEdge, 5.f, 0.f, 0.f, ".x bounding box minimum");
+	check_vector(mesh->getBoundingBox().MaxEdge, 6.f, 1.f, 2.f, ".x bounding box maximum");
+}
+
+// A header cut off before the float size must be refused
+static void test_x_truncated(IrrlichtDevice *device)
+{
+	static const char header[] = "xof 0302txt ";
+	io::IReadFile *file = device->getFileSystem()->createMemoryReadFile(
+			header, sizeof(header) - 1, "truncated.x");
+	scene::IAnimatedMesh *mesh = device->getSceneManager()->getMesh(file);
+	file->drop();
+	if (mesh)
+		throw std::runtime_error("loaded a truncated .x file");
+}
+
+// Loaded meshes are cached by name and counted in the memory usage, runs
+// first so the mesh isn't cached yet
+static void test_cache(IrrlichtDevice *device)
+{
+	scene::IMeshCache *cache = device->getSceneManager()->getMeshCache();
+	const u32 hits = cache->getHitCount(), misses = cache->getMissCount();
+
+	scene::IAnimatedMesh *mesh = load_mesh(device, "data/sample_static.gltf");
+	if (!mesh || load_mesh(device, "data/sample_static.gltf") != mesh)
+		throw std::runtime_error("cached mesh loaded again");
+	if (cache->getMeshByName(cache->getMeshName(mesh)) != mesh)
+		throw std::runtime_error("cached mesh not found by its name");
+	if (cache->getHitCount() != hits + 2 || cache->getMissCount() != misses + 1)
+		throw std::runtime_error("wrong mesh cache statistics");
+	if (cache->getMemoryUsage() == 0)
+		throw std::runtime_error("mesh cache memory not counted");
+
+	// a lower budget applies to the mesh added last as well
+	const u32 count = cache->getMeshCount();
+	cache->setMemoryBudget(1);
+	const bool evicted = cache->getMeshCount() == count - 1;
+	cache->setMemoryBudget(0);
+	if (!evicted)
+		throw std::runtime_error("unused mesh kept over the budget");
+}
+
+int main(int argc, char *argv[])
+try {
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.WindowSize = core::dimension2du(640, 480);
+	p.LoggingLevel = ELL_DEBUG;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	test_cache(device);
+	test_static(device);
+	test_buffers(device);
+	test_archive(device);
+	test_skinned(device);
+	test_x(device, "data/sample_text.x");
+	test_x(device, "data/sample_mszip.x");
+	test_x_truncated(device);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,100 @@
+// Writes a pack archive in a directory below the temp directory, then reads
+// its entry from the mapping and looks names up in its file list.
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+
+using namespace irr;
+
+static const char *const ENTRY = "packed_file.bin";
+
+static io::IWriteFile *create_file(io::IFileSystem *fs, const char *filename)
+{
+	io::IWriteFile *out = fs->createAndWriteFile(filename);
+	if (!out)
+		throw std::runtime_error(std::string("could not create ") + filename);
+	return out;
+}
+
+// Stored entries of a mapped pack are aligned views into the mapping
+static void test_mapped(io::IFileSystem *fs, const std::vector<u8> &data)
+{
+	core::array<io::path> packed;
+	packed.push_back(ENTRY);
+	io::IWriteFile *out = create_file(fs, "test.ipk");
+	const bool written = fs->writePackArchive(out, packed);
+	out->drop();
+	io::IFileArchive *pack = nullptr;
+	if (!written || !fs->addFileArchive("test.ipk", true, false, io::EFAT_UNKNOWN, "", &pack))
+		throw std::runtime_error("could not write the pack");
+
+	io::IReadFile *in = fs->createAndOpenFile("PACKED_FILE.BIN");
+	if (!in)
+		throw std::runtime_error("could not open the entry");
+	const u8 *mapped = (const u8 *)in->getMappedData();
+	const bool same = in->getSize() == (long)data.size() && mapped && ((size_t)mapped & 4095) == 0 &&
+			memcmp(mapped, data.data(), data.size()) == 0;
+	in->drop();
+	if (!same)
+		throw std::runtime_error("wrong mapping of the entry");
+
+	const io::IFileList *list = pack->getFileList();
+	if (list->findFile("Packed_File.BIN") != 0 || list->findFile("packed_file.bin/") != -1 ||
+			list->findFile("sub\\packed_file.bin") != -1)
+		throw std::runtime_error("wrong file list lookup");
+
+	fs->removeFileArchive(pack);
+}
+
+// Offsets are from the start of the file, so packs after other data are refused
+static void test_prefixed(io::IFileSystem *fs)
+{
+	core::array<io::path> packed;
+	packed.push_back(ENTRY);
+	io::IWriteFile *out = create_file(fs, "prefixed.ipk");
+	const bool refused = out->write("prefix", 6) == 6 && !fs->writePackArchive(out, packed);
+	out->drop();
+	if (!refused)
+		throw std::runtime_error("pack written after other data");
+}
+
+int main(int argc, char *argv[])
+try {
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.LoggingLevel = ELL_DEBUG;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	// entries are named like the packed files, so they are written relative to the directory
+	io::IFileSystem *fs = device->getFileSystem();
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "irrlicht_pack_archive_test";
+	std::filesystem::create_directories(dir);
+	fs->changeWorkingDirectoryTo(dir.string().c_str());
+
+	std::vector<u8> data(100 * 1024);
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = (u8)(i * 7);
+	io::IWriteFile *out = create_file(fs, ENTRY);
+	const bool written = out->write(data.data(), data.size()) == data.size();
+	out->drop();
+	if (!written)
+		throw std::runtime_error("could not write the packed file");
+
+	test_mapped(fs, data);
+	test_prefixed(fs);
+
+	device->drop();
+	std::filesystem::remove_all(dir);
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,146 @@
+// Checks that the cached and view variants of the path lookups give the
+// same results as the ones copying strings. Run with --benchmark to print
+// calls per second and allocations per call of each, optionally followed by
+// a factor like 100 for stable numbers.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <irrlicht.h>
+
+using namespace irr;
+
+static std::atomic<u64> allocations(0);
+
+void *operator new(size_t size)
+{
+	++allocations;
+	void *p = std::malloc(size ? size : 1);
+	if (!p)
+		std::abort();
+	return p;
+}
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+void operator delete[](void *p) noexcept
+{
+	std::free(p);
+}
+void operator delete(void *p, size_t) noexcept
+{
+	std::free(p);
+}
+void operator delete[](void *p, size_t) noexcept
+{
+	std::free(p);
+}
+
+static volatile size_t sink = 0;
+
+template <class F>
+static void bench(const char *name, u32 calls, F f)
+{
+	f(0);
+	const u64 before = allocations;
+	const auto start = std::chrono::steady_clock::now();
+	for (u32 i = 0; i < calls; ++i)
+		f(i);
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::printf("%-26s %12.0f calls/s %6.2f allocs/call\n", name, calls / seconds,
+			(double)(allocations - before) / calls);
+}
+
+// Names of files on disk, some of them not flat
+static const char *const files[] = {"data/sample_24bpp.png", "data/sample_8bpp_up.tga",
+		"./data/sample_24bpp_v3.bmp", "data/../data/sample_24bpp.png"};
+
+static void test_lookups(io::IFileSystem *fs)
+{
+	for (const char *file : files) {
+		if (fs->getCachedAbsolutePath(file) != fs->getAbsolutePath(file) ||
+				fs->getCachedAbsolutePath(file) != fs->getAbsolutePath(file))
+			throw std::runtime_error("cached path differs");
+	}
+
+	// views into the name, which allocate nothing
+	const u64 before = allocations;
+	const bool same = fs->getFileDirView("a/b\\c.png") == "a/b" && fs->getFileDirView("c.png") == "." &&
+			fs->getFileBasenameView("a/b\\c.d.png", false) == "c.d" &&
+			fs->getFileBasenameView("a/b/c.d.png", true) == "c.d.png";
+	if (!same || allocations != before)
+		throw std::runtime_error("wrong path view");
+	if (fs->getFileBasename("a/b/c.d.png", false) != "c.d")
+		throw std::runtime_error("wrong basename");
+}
+
+static void benchmark(io::IFileSystem *fs, u32 factor)
+{
+	core::array<io::path> disk;
+	for (u32 i = 0; i < 64; ++i)
+		disk.push_back(files[i % 4]);
+
+	// names in a big archive
+	io::IFileList *list = fs->createEmptyFileList("", true, false);
+	for (u32 i = 0; i < 2000; ++i) {
+		c8 name[64];
+		std::snprintf(name, sizeof(name), "textures/environment/set%u/texture_%04u.png", i % 20, i);
+		list->addItem(name, 0, 0, false, i);
+	}
+	list->sort();
+	core::array<io::path> packed;
+	for (u32 i = 0; i < 64; ++i)
+		packed.push_back(list->getFullFileName((i * 31) % 2000));
+
+	bench("getAbsolutePath", 10000 * factor, [&](u32 i) { sink += fs->getAbsolutePath(disk[i & 63]).size(); });
+	bench("getCachedAbsolutePath", 100000 * factor, [&](u32 i) { sink += fs->getCachedAbsolutePath(disk[i & 63]).size(); });
+	bench("getFileDir", 100000 * factor, [&](u32 i) { sink += fs->getFileDir(packed[i & 63]).size(); });
+	bench("getFileDirView", 100000 * factor, [&](u32 i) { sink += fs->getFileDirView(packed[i & 63].view()).size(); });
+	bench("getFileBasename", 100000 * factor, [&](u32 i) { sink += fs->getFileBasename(packed[i & 63], false).size(); });
+	bench("getFileBasenameView", 100000 * factor, [&](u32 i) { sink += fs->getFileBasenameView(packed[i & 63].view(), false).size(); });
+	bench("IFileList::findFile", 100000 * factor, [&](u32 i) { sink += list->findFile(packed[i & 63]); });
+	bench("createAndOpenFile", 2000 * factor, [&](u32 i) {
+		io::IReadFile *file = fs->createAndOpenFile(disk[i & 63]);
+		sink += file->getSize();
+		file->drop();
+	});
+
+	list->drop();
+}
+
+int main(int argc, char *argv[])
+try {
+	const bool run_benchmark = argc > 1 && strcmp(argv[1], "--benchmark") == 0;
+	const u32 factor = run_benchmark && argc > 2 ? (u32)std::atoi(argv[2]) : 1;
+	if (!factor)
+		throw std::runtime_error("Invalid factor");
+
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.LoggingLevel = ELL_WARNING;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	io::IFileSystem *fs = device->getFileSystem();
+	if (run_benchmark)
+		benchmark(fs, factor);
+	else
+		test_lookups(fs);
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
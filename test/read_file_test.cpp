@@ -0,0 +1,113 @@
+// Writes a file big enough to be memory mapped and a small one into the temp
+// directory and checks what is read from them, also from several threads.
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <irrlicht.h>
+
+using namespace irr;
+
+static std::vector<u8> make_data(size_t size)
+{
+	std::vector<u8> data(size);
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = (u8)(i * 7);
+	return data;
+}
+
+static void write_file(io::IFileSystem *fs, const io::path &filename, const std::vector<u8> &data)
+{
+	io::IWriteFile *out = fs->createAndWriteFile(filename);
+	const bool written = out && out->write(data.data(), data.size()) == data.size();
+	if (out)
+		out->drop();
+	if (!written)
+		throw std::runtime_error("could not write the file");
+}
+
+// Mapping must not change what is read
+static void test_mapped(io::IFileSystem *fs, const io::path &filename, const std::vector<u8> &data)
+{
+	io::IReadFile *in = fs->createAndOpenFile(filename);
+	if (!in)
+		throw std::runtime_error("could not open the file");
+
+	u8 tail[16];
+	const u8 *mapped = (const u8 *)in->getMappedData();
+	const bool same = in->getSize() == (long)data.size() && in->seek((long)data.size() - 16) &&
+			in->read(tail, 32) == 16 && memcmp(tail, &data[data.size() - 16], 16) == 0 &&
+			(!mapped || memcmp(mapped, data.data(), data.size()) == 0);
+	in->drop();
+	if (!same)
+		throw std::runtime_error("wrong contents of the mapped file");
+}
+
+// readAt from several threads at once must neither mix up positions nor move
+// the read position
+static void test_concurrent(io::IFileSystem *fs, const io::path &filename, const std::vector<u8> &data)
+{
+	io::IReadFile *in = fs->createAndOpenFile(filename);
+	if (!in)
+		throw std::runtime_error("could not open the file");
+	in->seek(5);
+
+	const size_t chunk = 1000;
+	bool ok[4];
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < 4; ++t) {
+		ok[t] = true;
+		threads.emplace_back([&, t] {
+			u8 buffer[chunk];
+			for (size_t i = 0; i < 50; ++i) {
+				const size_t pos = ((t * 50 + i) * 997) % (data.size() - chunk);
+				ok[t] &= in->readAt(buffer, chunk, (long)pos) == chunk &&
+						memcmp(buffer, &data[pos], chunk) == 0;
+			}
+		});
+	}
+	for (std::thread &thread : threads)
+		thread.join();
+
+	const bool same = ok[0] && ok[1] && ok[2] && ok[3] && in->getPos() == 5;
+	in->drop();
+	if (!same)
+		throw std::runtime_error("wrong concurrent reads");
+}
+
+int main(int argc, char *argv[])
+try {
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.LoggingLevel = ELL_DEBUG;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	io::IFileSystem *fs = device->getFileSystem();
+	const std::filesystem::path dir = std::filesystem::temp_directory_path();
+	const io::path filename = (dir / "irrlicht_read_file_test.bin").string().c_str();
+	const std::vector<u8> data = make_data(100 * 1024);
+	write_file(fs, filename, data);
+
+	// too small to be mapped
+	const io::path smallname = (dir / "irrlicht_read_file_test_small.bin").string().c_str();
+	const std::vector<u8> small = make_data(16 * 1024);
+	write_file(fs, smallname, small);
+
+	test_mapped(fs, filename, data);
+	test_concurrent(fs, filename, data);
+	test_concurrent(fs, smallname, small);
+
+	std::remove(filename.c_str());
+	std::remove(smallname.c_str());
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,60 @@
+// Packs more images than fit on one atlas page and remaps a mesh using one
+// of them to the page it ended up on.
+
+#include <cstdio>
+#include <stdexcept>
+#include <irrlicht.h>
+
+using namespace irr;
+
+int main(int argc, char *argv[])
+try {
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.LoggingLevel = ELL_DEBUG;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+	video::IVideoDriver *driver = device->getVideoDriver();
+
+	// 20x20 slots with the padding, 36 fit on a 128x128 page
+	video::ITextureAtlas *atlas = driver->createTextureAtlas("atlas", core::dimension2du(128, 128), 2);
+	video::IImage *img = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(16, 16));
+	for (u32 i = 0; i < 40; ++i) {
+		img->fill(video::SColor(255, i * 6, 0, 0));
+		atlas->addImage(io::path("tile") + io::path(i), img);
+	}
+	img->drop();
+	if (!atlas->build() || atlas->getPageCount() != 2 || !atlas->getPageTexture(1))
+		throw std::runtime_error("wrong packing");
+
+	video::ITexture *tile = driver->addTexture(core::dimension2du(16, 16), "tile3");
+	scene::SMeshBuffer *buffer = new scene::SMeshBuffer();
+	buffer->Vertices.push_back(video::S3DVertex(0, 0, 0, 0, 0, 1, video::SColor(255, 255, 255, 255), 0, 0));
+	buffer->Vertices.push_back(video::S3DVertex(1, 1, 0, 0, 0, 1, video::SColor(255, 255, 255, 255), 1, 1));
+	buffer->Material.setTexture(0, tile);
+	scene::SMesh *mesh = new scene::SMesh();
+	mesh->addMeshBuffer(buffer);
+	buffer->drop();
+
+	const video::STextureAtlasEntry *entry = atlas->getEntry(atlas->getHandle("tile3"));
+	if (!entry || entry->Rect.getWidth() != 16)
+		throw std::runtime_error("wrong entry");
+	if (atlas->remapMesh(mesh) != 1)
+		throw std::runtime_error("buffer not remapped");
+	if (buffer->Vertices[0].TCoords != entry->TCoords.UpperLeftCorner ||
+			buffer->Vertices[1].TCoords != entry->TCoords.LowerRightCorner)
+		throw std::runtime_error("wrong remapped texture coordinates");
+	if (buffer->Material.getTexture(0) != atlas->getPageTexture(entry->Page))
+		throw std::runtime_error("wrong remapped texture");
+
+	mesh->drop();
+	driver->removeTexture(tile);
+	atlas->drop();
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}
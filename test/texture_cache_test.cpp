@@ -0,0 +1,129 @@
+// Loads textures through the texture cache of the null driver, also in the
+// background and from another working directory, and checks the lookups of
+// cached textures and their eviction over a memory budget.
+
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <irrlicht.h>
+
+using namespace irr;
+
+static const char *const TEXTURE = "data/sample_24bpp.png";
+
+// The same file is found again by its name or by its full name in any case
+static void test_lookup(video::IVideoDriver *driver)
+{
+	video::ITexture *tex = driver->getTexture(TEXTURE);
+	if (!tex)
+		throw std::runtime_error("could not load the texture");
+	if (driver->getTexture(TEXTURE) != tex)
+		throw std::runtime_error("texture loaded twice");
+
+	io::path upper = tex->getName().getPath();
+	upper.make_upper();
+	if (driver->findTexture(upper) != tex)
+		throw std::runtime_error("texture not found by its upper case name");
+}
+
+// A relative name resolves to another file after changing the working directory
+static void test_working_directory(IrrlichtDevice *device)
+{
+	io::IFileSystem *fs = device->getFileSystem();
+	video::IVideoDriver *driver = device->getVideoDriver();
+	video::ITexture *tex = driver->getTexture(TEXTURE);
+
+	const io::path old = fs->getWorkingDirectory();
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "irrlicht_texture_cache_test";
+	std::filesystem::create_directories(dir / "data");
+	fs->changeWorkingDirectoryTo(dir.string().c_str());
+
+	video::IImage *img = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(16, 16));
+	img->fill(video::SColor(255, 0, 128, 255));
+	const bool ok = driver->writeImageToFile(img, TEXTURE);
+	img->drop();
+	video::ITexture *other = ok ? driver->getTexture(TEXTURE) : nullptr;
+
+	fs->changeWorkingDirectoryTo(old);
+	std::filesystem::remove_all(dir);
+	if (!other || other == tex || other->getOriginalSize() != core::dimension2du(16, 16))
+		throw std::runtime_error("texture of the old working directory returned");
+	if (driver->getTexture(TEXTURE) != tex)
+		throw std::runtime_error("texture not found again in the first working directory");
+}
+
+// One cached, one decoded in the background and one missing texture
+static void test_async(IrrlichtDevice *device)
+{
+	video::IVideoDriver *driver = device->getVideoDriver();
+	const io::path written = (std::filesystem::temp_directory_path() / "irrlicht_texture_cache_test.png").string().c_str();
+	video::IImage *img = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(16, 16));
+	img->fill(video::SColor(255, 0, 128, 255));
+	const bool ok = driver->writeImageToFile(img, written);
+	img->drop();
+	if (!ok)
+		throw std::runtime_error("could not write the texture file");
+
+	core::array<io::path> names;
+	names.push_back(TEXTURE);
+	names.push_back(written);
+	names.push_back("data/missing.png");
+	u32 loaded = 0, failed = 0;
+	driver->getTexturesAsync(names, [&](const io::path &name, video::ITexture *t) {
+		t ? ++loaded : ++failed;
+	});
+	while (driver->uploadAsyncTextures(100))
+		device->sleep(1);
+	std::remove(written.c_str());
+
+	if (loaded != 2 || failed != 1)
+		throw std::runtime_error("wrong async texture callbacks");
+	if (!driver->findTexture(device->getFileSystem()->getAbsolutePath(written)))
+		throw std::runtime_error("async texture not cached");
+}
+
+// The null driver binds nothing, so all textures are least recently used
+static void test_eviction(video::IVideoDriver *driver)
+{
+	video::ITexture *tex = driver->getTexture(TEXTURE);
+	if (!driver->getTexture("data/sample_8bpp.png"))
+		throw std::runtime_error("could not load the second texture");
+
+	const video::STextureMemoryStats before = driver->getTextureMemoryStats();
+	if (tex->getVideoMemorySize() == 0 || before.VideoMemory < tex->getVideoMemorySize())
+		throw std::runtime_error("wrong texture memory accounting");
+
+	driver->setTextureMemoryBudget(1, 1);
+	for (int i = 0; i < 2; ++i) {
+		driver->beginScene();
+		driver->endScene();
+	}
+	driver->setTextureMemoryBudget(0);
+
+	const video::STextureMemoryStats after = driver->getTextureMemoryStats();
+	if (tex->isResident() || after.Evictions < 2 || after.EvictedTextures != after.Evictions ||
+			after.VideoMemory >= before.VideoMemory)
+		throw std::runtime_error("textures not evicted");
+}
+
+int main(int argc, char *argv[])
+try {
+	SIrrlichtCreationParameters p;
+	p.DriverType = video::EDT_NULL;
+	p.LoggingLevel = ELL_DEBUG;
+
+	auto *device = createDeviceEx(p);
+	if (!device)
+		throw std::runtime_error("Failed to create device");
+
+	test_lookup(device->getVideoDriver());
+	test_working_directory(device);
+	test_async(device);
+	test_eviction(device->getVideoDriver());
+
+	device->drop();
+	return 0;
+} catch (const std::exception &e) {
+	std::printf("Test failed: %s\n", e.what());
+	return 1;
+}